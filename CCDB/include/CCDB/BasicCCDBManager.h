@@ -17,11 +17,13 @@
 
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CCDBTimeStampUtils.h"
+#include "CCDB/CCDBNodeCache.h"
 #include "CommonUtils/NameConf.h"
 #include <string>
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <cstdlib>
 
 class TGeoManager; // we need to forward-declare those classes which should not be cleaned up
 
@@ -37,6 +39,10 @@ namespace o2::ccdb
 ///
 /// In cases where caching is not needed or just 1 instance of the manager is enough, one case use
 /// a singleton version BasicCCDBManager
+///
+/// Independently of the per-instance cache, the retrieved object images can be shared by all the
+/// processes of a node through a CCDBNodeCache, enabled with setNodeCache or the environment variable
+/// ALICEO2_CCDB_NODECACHE (set to the cache directory, or empty for the default /dev/shm/aliceccdb)
 
 class CCDBManagerInstance
 {
@@ -65,6 +71,9 @@ class CCDBManagerInstance
   CCDBManagerInstance(std::string const& path) : mCCDBAccessor{}
   {
     mCCDBAccessor.init(path);
+    if (const char* nodeCacheDir = getenv("ALICEO2_CCDB_NODECACHE")) {
+      setNodeCache(nodeCacheDir);
+    }
   }
   /// set a URL to query from
   void setURL(const std::string& url);
@@ -157,6 +166,23 @@ class CCDBManagerInstance
   /// set the fatal property (when false; nullptr object responses will not abort)
   void setFatalWhenNull(bool b) { mFatalWhenNull = b; }
 
+  /// share the retrieved objects with the other processes of the node through the cache in the given directory
+  /// objects valid for the requested timestamp are then served from the node cache without querying the server
+  void setNodeCache(std::string const& dir = CCDBNodeCache::DefaultDir) { mNodeCache = CCDBNodeCache::getInstance(dir); }
+
+  /// stop using the node cache
+  void resetNodeCache() { mNodeCache.reset(); }
+
+  /// retrieve once all the versions of the objects at the given paths valid in [from, to), the retrievals
+  /// of these paths for timestamps in this range are then served from memory, see CcdbApi::prefetch
+  int prefetch(std::vector<std::string> const& paths, long from, long to, MD const& metadata = MD())
+  {
+    return mCCDBAccessor.prefetch(paths, from, to, metadata);
+  }
+
+  /// check if the node cache is used
+  bool isNodeCacheEnabled() const { return mNodeCache != nullptr; }
+
  private:
   // method to print (fatal) error
   void reportFatal(std::string_view s);
@@ -164,6 +190,8 @@ class CCDBManagerInstance
                    MD const& metadata, long timestamp,
                    MD* headers, std::string const& etag,
                    const std::string& createdNotAfter, const std::string& createdNotBefore);
+  template <typename T>
+  T* getFromNodeCache(std::string const& path, long timestamp, CachedObject* cached);
   // we access the CCDB via the CURL based C++ API
   o2::ccdb::CcdbApi mCCDBAccessor;
   std::unordered_map<std::string, CachedObject> mCache; //! map for {path, CachedObject} associations
@@ -176,6 +204,7 @@ class CCDBManagerInstance
   long mCreatedNotAfter = 0;                            // upper limit for object creation timestamp (TimeMachine mode) - If-Not-After HTTP header
   long mCreatedNotBefore = 0;                           // lower limit for object creation timestamp (TimeMachine mode) - If-Not-Before HTTP header
   bool mFatalWhenNull = true;                           // if nullptr blob replies should be treated as fatal (can be set by user)
+  std::shared_ptr<CCDBNodeCache> mNodeCache;            //! node-level cache of the object images, if used
 
   ClassDefNV(CCDBManagerInstance, 1);
 };
@@ -184,6 +213,15 @@ template <typename T>
 T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
 {
   T* ptr = nullptr;
+  if (mNodeCache) {
+    ptr = getFromNodeCache<T>(path, timestamp, isCachingEnabled() ? &mCache[path] : nullptr);
+    mHeaders.clear();
+    mMetaData.clear();
+    if (!ptr && mFatalWhenNull) {
+      reportFatal(std::string("Got nullptr from CCDB for path ") + path + std::string(" and timestamp ") + std::to_string(timestamp));
+    }
+    return ptr;
+  }
   if (!isCachingEnabled()) {
     if constexpr (std::is_same<T, BLOB>::value) {
       ptr = createBlob(path, mMetaData, timestamp, nullptr, "",
@@ -233,8 +271,8 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
       cached.isBlob = false;
     }
     cached.uuid = mHeaders["ETag"];
-    cached.startvalidity = std::stol(mHeaders["Valid-From"]);
-    cached.endvalidity = std::stol(mHeaders["Valid-Until"]);
+    cached.startvalidity = CcdbApi::getHeaderValue(mHeaders, "Valid-From", 0);
+    cached.endvalidity = CcdbApi::getHeaderValue(mHeaders, "Valid-Until", 0);
   } else if (mHeaders.count("Error")) { // in case of errors the pointer is 0 and headers["Error"] should be set
     clearCache(path);                   // in case of any error clear cache for this object
   } else {                              // the old object is valid
@@ -248,6 +286,48 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
   return ptr;
 }
 
+template <typename T>
+T* CCDBManagerInstance::getFromNodeCache(std::string const& path, long timestamp, CachedObject* cached)
+{
+  constexpr bool isBlob = std::is_same<T, BLOB>::value;
+  if (mCheckObjValidityEnabled && cached && cached->isBlob == isBlob && (cached->noCleanupPtr || cached->objPtr) && cached->isValid(timestamp)) {
+    return reinterpret_cast<T*>(cached->noCleanupPtr ? cached->noCleanupPtr : cached->objPtr.get()); // no need to query the node cache
+  }
+  auto blob = mNodeCache->get(mCCDBAccessor, path, mMetaData, timestamp,
+                              mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
+                              mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
+  if (!blob) {
+    if (cached) {
+      clearCache(path);
+    }
+    return nullptr;
+  }
+  mHeaders = blob->getHeaders(); // the response headers of the query which stored the image
+  if (cached && cached->isBlob == isBlob && cached->uuid == mHeaders["ETag"] && cached->startvalidity == blob->getStartValidity() && (cached->noCleanupPtr || cached->objPtr)) {
+    return reinterpret_cast<T*>(cached->noCleanupPtr ? cached->noCleanupPtr : cached->objPtr.get()); // this image was already deserialized
+  }
+  T* ptr = nullptr;
+  if constexpr (isBlob) {
+    ptr = new BLOB(blob->data(), blob->data() + blob->size());
+  } else {
+    ptr = CcdbApi::extractFromMemoryBlob<T>(blob->data(), blob->size());
+  }
+  if (!ptr || !cached) {
+    return ptr;
+  }
+  cached->clear();
+  if constexpr (std::is_same<TGeoManager, T>::value) { // some special objects cannot be cached to shared_ptr since root may delete their raw global pointer
+    cached->noCleanupPtr = ptr;
+  } else {
+    cached->objPtr.reset(ptr);
+  }
+  cached->isBlob = isBlob;
+  cached->uuid = mHeaders["ETag"];
+  cached->startvalidity = CcdbApi::getHeaderValue(mHeaders, "Valid-From", 0);
+  cached->endvalidity = CcdbApi::getHeaderValue(mHeaders, "Valid-Until", 0);
+  return ptr;
+}
+
 class BasicCCDBManager : public CCDBManagerInstance
 {
  public:
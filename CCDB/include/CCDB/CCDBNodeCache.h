@@ -0,0 +1,140 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBNodeCache.h
+/// \brief  Cache of CCDB object images shared by all the processes of a node
+///
+
+#ifndef O2_CCDBNODECACHE_H
+#define O2_CCDBNODECACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace o2::ccdb
+{
+
+class CcdbApi;
+
+/// Node-level cache of the CCDB object images (the serialized TFiles as served by the CCDB).
+///
+/// The images are stored as plain files in a directory shared by all processes of the node:
+/// on tmpfs (default /dev/shm/aliceccdb) the cache lives in shared memory, on any other
+/// file system it is file-backed. Each image is mapped read-only, so its pages are shared
+/// by all the processes using it. The first process needing an object which is not cached
+/// yet downloads it while holding a file lock on the path, the others wait for it and then
+/// map the stored image.
+///
+/// Images are indexed by their validity interval: a query for a timestamp inside the
+/// validity of a cached image is served without contacting the server. The response headers
+/// of the server are stored next to each image.
+///
+/// Images stored more than the max age ago are not served anymore but downloaded again, and
+/// after each download the expired images and, if the cache exceeds the max size, the oldest
+/// ones are removed. The limits can be set with ALICEO2_CCDB_NODECACHE_MAXAGE (in seconds) and
+/// ALICEO2_CCDB_NODECACHE_MAXSIZE (in MB), 0 meaning no limit. A removed image stays mapped
+/// for the processes already using it.
+/// The class is thread safe, lookups of already indexed images only take a shared lock.
+class CCDBNodeCache
+{
+ public:
+  /// read-only image of a CCDB object mapped in memory
+  class Blob
+  {
+   public:
+    Blob(std::string const& fileName, long startValidity, long endValidity, std::string etag);
+    ~Blob();
+    Blob(const Blob&) = delete;
+    Blob& operator=(const Blob&) = delete;
+
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+    bool isMapped() const { return mData != nullptr; }
+    long getStartValidity() const { return mStartValidity; }
+    long getEndValidity() const { return mEndValidity; }
+    std::string const& getETag() const { return mETag; }
+    /// response headers of the server for this object, at least with the ETag and validity
+    std::map<std::string, std::string> const& getHeaders() const { return mHeaders; }
+    /// time when the image was stored in the cache, in seconds since epoch
+    long getStoreTime() const { return mStoreTime; }
+    bool isValid(long timestamp) const { return timestamp >= mStartValidity && timestamp < mEndValidity; }
+
+   private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+    long mStartValidity = 0;
+    long mEndValidity = 0;
+    long mStoreTime = 0;
+    std::string mETag{};
+    std::map<std::string, std::string> mHeaders{};
+  };
+  using BlobPtr = std::shared_ptr<const Blob>;
+  using MD = std::map<std::string, std::string>;
+
+  static constexpr const char* DefaultDir = "/dev/shm/aliceccdb";
+  static constexpr long DefaultMaxAge = 24 * 3600;          // s
+  static constexpr size_t DefaultMaxSize = size_t(4) << 30; // bytes
+
+  explicit CCDBNodeCache(std::string const& dir = DefaultDir);
+
+  /// get the cache for a given directory, all the users of the same directory in a process share the same instance
+  static std::shared_ptr<CCDBNodeCache> getInstance(std::string const& dir = DefaultDir);
+
+  /// retrieve the image of the object valid for the timestamp, downloading it with the api only if
+  /// no process of the node did it yet. Returns nullptr if the object could not be retrieved
+  BlobPtr get(CcdbApi const& api, std::string const& path, MD const& metadata, long timestamp,
+              std::string const& createdNotAfter = "", std::string const& createdNotBefore = "");
+
+  /// look for an image valid for the timestamp among the ones already cached on the node, without downloading
+  BlobPtr find(std::string const& path, MD const& metadata, long timestamp,
+               std::string const& createdNotAfter = "", std::string const& createdNotBefore = "");
+
+  /// remove the images stored more than the max age ago, then the oldest ones until the cache is below the max size.
+  /// Returns the number of images removed
+  size_t cleanup();
+
+  /// images stored more than maxAge seconds ago are downloaded again, 0 for no limit
+  void setMaxAge(long maxAge) { mMaxAge = maxAge; }
+  long getMaxAge() const { return mMaxAge; }
+
+  /// max total size in bytes of the images in the cache directory, 0 for no limit
+  void setMaxSize(size_t maxSize) { mMaxSize = maxSize; }
+  size_t getMaxSize() const { return mMaxSize; }
+
+  std::string const& getDir() const { return mDir; }
+
+ private:
+  using Index = std::map<long, BlobPtr>; // images of a given query, by start of validity
+
+  std::string getKey(std::string const& path, MD const& metadata,
+                     std::string const& createdNotAfter, std::string const& createdNotBefore) const;
+  BlobPtr lookup(std::string const& key, long timestamp) const;
+  void scan(std::string const& key);
+  BlobPtr download(CcdbApi const& api, std::string const& key, std::string const& path, MD const& metadata, long timestamp,
+                   std::string const& createdNotAfter, std::string const& createdNotBefore);
+  BlobPtr store(std::string const& key, const char* image, size_t size, MD const& headers);
+  bool isExpired(Blob const& blob) const;
+
+  std::string mDir{};
+  long mMaxAge = DefaultMaxAge;
+  size_t mMaxSize = DefaultMaxSize;
+  mutable std::shared_mutex mMutex;                // protects mIndex
+  std::unordered_map<std::string, Index> mIndex{}; // cached images, by query key
+};
+
+} // namespace o2::ccdb
+
+#endif // O2_CCDBNODECACHE_H
@@ -235,6 +235,35 @@ class CcdbApi //: public DatabaseInterface
    */
   void snapshot(std::string const& ccdbrootpath, std::string const& localDir, long timestamp) const;
 
+  /**
+   * Retrieve once all the versions of the objects at the given paths which are valid in the time range [from, to)
+   * and index them in memory by validity interval. Later retrievals of these paths with the same metadata and
+   * a timestamp in the range are served from memory, without querying the server.
+   * The versions are found by walking the range from one validity interval to the next one, i.e. they are assumed
+   * not to be partially superseded by newer objects. A gap without any object is skipped up to the start of the
+   * next version found in the listing of the path. Not thread safe with respect to concurrent retrievals.
+   *
+   * @param paths The paths of the objects to prefetch.
+   * @param from Start of the time range.
+   * @param to End of the time range.
+   * @param metadata Key-values representing the metadata to filter out objects.
+   * @return The number of objects retrieved.
+   */
+  int prefetch(std::vector<std::string> const& paths, long from, long to, std::map<std::string, std::string> const& metadata = {});
+
+  /**
+   * Drop all the prefetched objects.
+   */
+  void clearPrefetched() { mPrefetched.clear(); }
+
+  /**
+   * Check whether an object for this path and timestamp was prefetched.
+   */
+  bool isPrefetched(std::string const& path, long timestamp, std::map<std::string, std::string> const& metadata = {}) const
+  {
+    return getPrefetched(path, metadata, timestamp, "", "") != nullptr;
+  }
+
   /**
    * Check whether the url is reachable.
    * @param url The url to test.
@@ -251,6 +280,14 @@ class CcdbApi //: public DatabaseInterface
   */
   std::vector<std::string> parseSubFolders(std::string const& reply) const;
 
+  /**
+   * Helper function to extract the sorted starts of validity of the objects from a JSON list reply.
+   *
+   * @param reply The reply that we got from a list request with the application/json format.
+   * @return The vector of distinct validity starts.
+   */
+  static std::vector<long> parseValidityStarts(std::string const& reply);
+
   /**
    * Function returning the complete list of (recursive) paths below a given top path
    *
@@ -305,6 +342,14 @@ class CcdbApi //: public DatabaseInterface
    */
   static void parseCCDBHeaders(std::vector<std::string> const& headers, std::vector<std::string>& pfns, std::string& etag);
 
+  /**
+   * Get the numerical value of a header, such as the validity limits.
+   * @param headers the headers of the reply
+   * @param key the name of the header
+   * @param defaultValue the value returned when the header is missing, empty or not a number
+   */
+  static long getHeaderValue(std::map<std::string, std::string> const& headers, std::string const& key, long defaultValue);
+
   /**
    * Extracts meta-information of the query from a TFile containing the CCDB blob.
    */
@@ -350,7 +395,15 @@ class CcdbApi //: public DatabaseInterface
   template <typename T>
   static T* extractFromMemoryBlob(o2::pmr::vector<char>& blob)
   {
-    auto obj = static_cast<T*>(interpretAsTMemFileAndExtract(blob.data(), blob.size(), typeid(T)));
+    return extractFromMemoryBlob<T>(blob.data(), blob.size());
+  }
+#endif
+
+  /// deserialize an object of type T from the image of a CCDB file in memory, e.g. as mapped by CCDBNodeCache
+  template <typename T>
+  static T* extractFromMemoryBlob(const char* data, size_t size)
+  {
+    auto obj = static_cast<T*>(interpretAsTMemFileAndExtract(const_cast<char*>(data), size, typeid(T)));
     if constexpr (std::is_base_of<o2::conf::ConfigurableParam, T>::value) {
       auto& param = const_cast<typename std::remove_const<T&>::type>(T::Instance());
       param.syncCCDBandRegistry(obj);
@@ -358,7 +411,6 @@ class CcdbApi //: public DatabaseInterface
     }
     return obj;
   }
-#endif
 
  private:
   /**
@@ -518,6 +570,28 @@ class CcdbApi //: public DatabaseInterface
   bool mHaveAlienToken = false;                                  // stores if an alien token is available
   static std::unique_ptr<TJAlienCredentials> mJAlienCredentials; // access JAliEn credentials
 
+  struct PrefetchedObject {
+    long endValidity = 0;
+    std::vector<char> image{};                    // content of the object file as served
+    std::map<std::string, std::string> headers{}; // headers of the reply
+  };
+  struct PrefetchedPath {
+    std::map<std::string, std::string> metadata{};
+    long from = 0;
+    long to = 0;
+    std::map<long, PrefetchedObject> objects{}; // by start of validity
+  };
+  std::map<std::string, PrefetchedPath> mPrefetched; //! prefetched objects, by path
+
+  // find the prefetched object for this query, if any
+  const PrefetchedObject* getPrefetched(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                                        const std::string& createdNotAfter, const std::string& createdNotBefore) const;
+  // serve the query from the prefetched objects: return false if there is none, otherwise fill the headers and set object
+  // to the prefetched one, or to null if the caller already has it (matching ETag, as for a 304 reply)
+  bool servePrefetched(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                       std::map<std::string, std::string>* headers, std::string const& etag,
+                       const std::string& createdNotAfter, const std::string& createdNotBefore, const PrefetchedObject*& object) const;
+
   ClassDefNV(CcdbApi, 1);
 };
 
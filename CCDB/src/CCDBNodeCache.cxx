@@ -0,0 +1,419 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBNodeCache.cxx
+/// \brief  Cache of CCDB object images shared by all the processes of a node
+///
+
+#include "CCDB/CCDBNodeCache.h"
+#include "CCDB/CcdbApi.h"
+#include "MemoryResources/MemoryResources.h"
+#include <FairLogger.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o2::ccdb
+{
+
+namespace
+{
+constexpr const char* ImageExtension = ".root";
+constexpr const char* HeadersExtension = ".hdr"; // response headers of <image> are stored in <image>.hdr
+
+// keep only the characters which are safe in a file name
+std::string sanitize(std::string const& s)
+{
+  std::string res;
+  for (auto c : s) {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '-') {
+      res += c;
+    }
+  }
+  return res.substr(0, 64);
+}
+
+// write to a temporary file and rename it, such that other processes never see a partial file
+bool writeFile(std::string const& fileName, const char* data, size_t size)
+{
+  auto tmpName = fileName + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    out.write(data, size);
+    if (!out.good()) {
+      LOG(error) << "Could not write CCDB node cache file " << tmpName;
+      out.close();
+      std::filesystem::remove(tmpName);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpName, fileName, ec);
+  if (ec) {
+    LOG(error) << "Could not create CCDB node cache file " << fileName << ": " << ec.message();
+    std::filesystem::remove(tmpName, ec);
+    return false;
+  }
+  return true;
+}
+
+// headers stored as one "key: value" line per header
+std::string printHeaders(std::map<std::string, std::string> const& headers)
+{
+  std::string res;
+  for (auto const& [key, value] : headers) {
+    if (key.find_first_of(":\n") == std::string::npos && value.find('\n') == std::string::npos) {
+      res += key + ": " + value + "\n";
+    }
+  }
+  return res;
+}
+
+std::map<std::string, std::string> readHeaders(std::string const& fileName)
+{
+  std::map<std::string, std::string> headers;
+  std::ifstream in(fileName);
+  std::string line;
+  while (std::getline(in, line)) {
+    auto pos = line.find(": ");
+    if (pos != std::string::npos) {
+      headers[line.substr(0, pos)] = line.substr(pos + 2);
+    }
+  }
+  return headers;
+}
+
+// exclusive lock on a file of the cache, shared by all processes and threads of the node
+class FileLock
+{
+ public:
+  explicit FileLock(std::string const& fileName)
+  {
+    mFD = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0666);
+    if (mFD < 0 || ::flock(mFD, LOCK_EX) != 0) {
+      LOG(warn) << "Could not lock CCDB node cache file " << fileName << "; Continuing without";
+    }
+  }
+  ~FileLock()
+  {
+    if (mFD >= 0) {
+      ::flock(mFD, LOCK_UN);
+      ::close(mFD);
+    }
+  }
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+ private:
+  int mFD = -1;
+};
+} // namespace
+
+CCDBNodeCache::Blob::Blob(std::string const& fileName, long startValidity, long endValidity, std::string etag)
+  : mStartValidity(startValidity), mEndValidity(endValidity), mETag(std::move(etag)), mHeaders(readHeaders(fileName + HeadersExtension))
+{
+  // the file name only keeps the sanitized ETag, and images may have been stored without their headers
+  if (auto it = mHeaders.find("ETag"); it != mHeaders.end()) {
+    mETag = it->second;
+  } else {
+    mHeaders["ETag"] = mETag;
+  }
+  mHeaders.try_emplace("Valid-From", std::to_string(mStartValidity));
+  mHeaders.try_emplace("Valid-Until", std::to_string(mEndValidity));
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(error) << "Could not open CCDB node cache file " << fileName;
+    return;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr != MAP_FAILED) {
+      mData = static_cast<const char*>(ptr);
+      mSize = st.st_size;
+      mStoreTime = st.st_mtime;
+    } else {
+      LOG(error) << "Could not map CCDB node cache file " << fileName;
+    }
+  }
+  ::close(fd); // the mapping stays valid
+}
+
+CCDBNodeCache::Blob::~Blob()
+{
+  if (mData) {
+    ::munmap(const_cast<char*>(mData), mSize);
+  }
+}
+
+CCDBNodeCache::CCDBNodeCache(std::string const& dir) : mDir(dir.empty() ? DefaultDir : dir)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(mDir, ec);
+  if (!std::filesystem::is_directory(mDir)) {
+    LOG(error) << "Could not create CCDB node cache directory " << mDir;
+  }
+  if (const char* maxAge = getenv("ALICEO2_CCDB_NODECACHE_MAXAGE")) {
+    mMaxAge = std::atol(maxAge);
+  }
+  if (const char* maxSize = getenv("ALICEO2_CCDB_NODECACHE_MAXSIZE")) {
+    mMaxSize = size_t(std::atol(maxSize)) << 20;
+  }
+}
+
+std::shared_ptr<CCDBNodeCache> CCDBNodeCache::getInstance(std::string const& dir)
+{
+  static std::mutex instancesMutex;
+  static std::unordered_map<std::string, std::weak_ptr<CCDBNodeCache>> instances;
+  std::lock_guard<std::mutex> guard(instancesMutex);
+  auto& instance = instances[dir.empty() ? DefaultDir : dir];
+  auto cache = instance.lock();
+  if (!cache) {
+    cache = std::make_shared<CCDBNodeCache>(dir);
+    instance = cache;
+  }
+  return cache;
+}
+
+std::string CCDBNodeCache::getKey(std::string const& path, MD const& metadata,
+                                  std::string const& createdNotAfter, std::string const& createdNotBefore) const
+{
+  // queries with extra selections are cached in a sub-folder of the path specific to these selections
+  if (metadata.empty() && createdNotAfter.empty() && createdNotBefore.empty()) {
+    return path;
+  }
+  std::string selection = createdNotAfter + ";" + createdNotBefore;
+  for (auto const& [key, value] : metadata) {
+    selection += ";" + key + "=" + value;
+  }
+  return path + "/@" + std::to_string(std::hash<std::string>{}(selection));
+}
+
+CCDBNodeCache::BlobPtr CCDBNodeCache::lookup(std::string const& key, long timestamp) const
+{
+  auto itIndex = mIndex.find(key);
+  if (itIndex == mIndex.end()) {
+    return nullptr;
+  }
+  auto const& index = itIndex->second;
+  auto it = index.upper_bound(timestamp); // first image starting after timestamp
+  if (it == index.begin()) {
+    return nullptr;
+  }
+  --it;
+  return it->second->isValid(timestamp) && !isExpired(*it->second) ? it->second : nullptr;
+}
+
+bool CCDBNodeCache::isExpired(Blob const& blob) const
+{
+  return mMaxAge > 0 && std::time(nullptr) - blob.getStoreTime() > mMaxAge;
+}
+
+void CCDBNodeCache::scan(std::string const& key)
+{
+  // index the images of this query stored by any process of the node and not yet known here
+  std::error_code ec;
+  std::filesystem::directory_iterator dirIt(mDir + "/" + key, ec);
+  if (ec) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> lock(mMutex);
+  auto& index = mIndex[key];
+  for (auto const& entry : dirIt) {
+    if (!entry.is_regular_file() || entry.path().extension() != ImageExtension) {
+      continue;
+    }
+    auto name = entry.path().stem().string();
+    long start = 0, end = 0;
+    int nChar = 0;
+    if (std::sscanf(name.c_str(), "%ld_%ld_%n", &start, &end, &nChar) != 2 || nChar == 0) {
+      continue;
+    }
+    struct stat st;
+    if (::stat(entry.path().c_str(), &st) != 0) {
+      continue;
+    }
+    auto it = index.find(start);
+    if (it != index.end() && it->second->getEndValidity() == end && it->second->getStoreTime() >= st.st_mtime) {
+      continue; // already indexed, and not downloaded again since
+    }
+    auto blob = std::make_shared<const Blob>(entry.path().string(), start, end, name.substr(nChar));
+    if (blob->isMapped()) {
+      index[start] = std::move(blob);
+    }
+  }
+}
+
+CCDBNodeCache::BlobPtr CCDBNodeCache::store(std::string const& key, const char* image, size_t size, MD const& headers)
+{
+  long start = CcdbApi::getHeaderValue(headers, "Valid-From", 0);
+  long end = CcdbApi::getHeaderValue(headers, "Valid-Until", std::numeric_limits<long>::max());
+  auto etagIt = headers.find("ETag");
+  std::string etag = sanitize(etagIt == headers.end() ? "" : etagIt->second);
+  auto dir = mDir + "/" + key;
+  auto fileName = dir + "/" + std::to_string(start) + "_" + std::to_string(end) + "_" + etag + ImageExtension;
+
+  // the headers go first, such that they are there as soon as the image is
+  auto headersStr = printHeaders(headers);
+  if (!writeFile(fileName + HeadersExtension, headersStr.data(), headersStr.size()) || !writeFile(fileName, image, size)) {
+    return nullptr;
+  }
+
+  auto blob = std::make_shared<const Blob>(fileName, start, end, etag);
+  if (!blob->isMapped()) {
+    return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(mMutex);
+  mIndex[key][start] = blob;
+  return blob;
+}
+
+CCDBNodeCache::BlobPtr CCDBNodeCache::find(std::string const& path, MD const& metadata, long timestamp,
+                                           std::string const& createdNotAfter, std::string const& createdNotBefore)
+{
+  auto key = getKey(path, metadata, createdNotAfter, createdNotBefore);
+  {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    if (auto blob = lookup(key, timestamp)) {
+      return blob;
+    }
+  }
+  scan(key);
+  std::shared_lock<std::shared_mutex> lock(mMutex);
+  return lookup(key, timestamp);
+}
+
+CCDBNodeCache::BlobPtr CCDBNodeCache::get(CcdbApi const& api, std::string const& path, MD const& metadata, long timestamp,
+                                          std::string const& createdNotAfter, std::string const& createdNotBefore)
+{
+  auto key = getKey(path, metadata, createdNotAfter, createdNotBefore);
+  {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    if (auto blob = lookup(key, timestamp)) {
+      return blob;
+    }
+  }
+  auto blob = download(api, key, path, metadata, timestamp, createdNotAfter, createdNotBefore);
+  if (blob && (mMaxAge > 0 || mMaxSize > 0)) {
+    cleanup(); // the cache grows only here
+  }
+  return blob;
+}
+
+CCDBNodeCache::BlobPtr CCDBNodeCache::download(CcdbApi const& api, std::string const& key, std::string const& path, MD const& metadata, long timestamp,
+                                               std::string const& createdNotAfter, std::string const& createdNotBefore)
+{
+  // only one process (or thread) of the node downloads a given path at a time, the others
+  // wait and will find the image it stored when scanning
+  std::error_code ec;
+  std::filesystem::create_directories(mDir + "/" + key, ec);
+  FileLock fileLock(mDir + "/" + key + "/.lock");
+  scan(key);
+  {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    if (auto blob = lookup(key, timestamp)) {
+      return blob;
+    }
+  }
+
+  o2::pmr::vector<char> image;
+  MD headers;
+  api.loadFileToMemory(image, path, metadata, timestamp, &headers, "", createdNotAfter, createdNotBefore);
+  if (headers.count("Error") || image.empty()) {
+    return nullptr;
+  }
+  auto blob = store(key, image.data(), image.size(), headers);
+  if (blob && !blob->isValid(timestamp)) {
+    LOG(warn) << "CCDB object " << path << " for timestamp " << timestamp << " has validity [" << blob->getStartValidity()
+              << ", " << blob->getEndValidity() << "[, it will not be reused from the node cache";
+  }
+  return blob;
+}
+
+size_t CCDBNodeCache::cleanup()
+{
+  struct Image {
+    std::string key;
+    std::string fileName;
+    long start;
+    long storeTime;
+    size_t size;
+  };
+  std::vector<Image> images;
+  size_t totalSize = 0;
+  std::error_code ec;
+  std::filesystem::recursive_directory_iterator dirIt(mDir, ec), dirEnd;
+  for (; !ec && dirIt != dirEnd; dirIt.increment(ec)) {
+    auto const& entry = *dirIt;
+    if (!entry.is_regular_file() || entry.path().extension() != ImageExtension) {
+      continue;
+    }
+    struct stat st;
+    long start = 0, end = 0;
+    if (::stat(entry.path().c_str(), &st) != 0 || std::sscanf(entry.path().stem().c_str(), "%ld_%ld_", &start, &end) != 2) {
+      continue;
+    }
+    auto key = std::filesystem::relative(entry.path().parent_path(), mDir, ec).string();
+    images.push_back({key, entry.path().string(), start, st.st_mtime, size_t(st.st_size)});
+    totalSize += st.st_size;
+  }
+  std::sort(images.begin(), images.end(), [](Image const& a, Image const& b) { return a.storeTime < b.storeTime; });
+
+  // the oldest images go first
+  auto now = std::time(nullptr);
+  std::unordered_map<std::string, std::vector<long>> removed;
+  size_t nRemoved = 0;
+  for (auto const& image : images) {
+    bool expired = mMaxAge > 0 && now - image.storeTime > mMaxAge;
+    if (!expired && (mMaxSize == 0 || totalSize <= mMaxSize)) {
+      break;
+    }
+    totalSize -= image.size;
+    FileLock fileLock(mDir + "/" + image.key + "/.lock"); // not while a process downloads this path
+    struct stat st;
+    if (::stat(image.fileName.c_str(), &st) != 0 || st.st_mtime != image.storeTime) {
+      continue; // removed or downloaded again meanwhile
+    }
+    std::filesystem::remove(image.fileName, ec);
+    std::filesystem::remove(image.fileName + HeadersExtension, ec);
+    removed[image.key].push_back(image.start);
+    nRemoved++;
+  }
+  if (nRemoved) {
+    // the processes which mapped the removed images keep them until they release them
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    for (auto const& [key, starts] : removed) {
+      if (auto it = mIndex.find(key); it != mIndex.end()) {
+        for (auto start : starts) {
+          it->second.erase(start);
+        }
+      }
+    }
+    LOG(info) << "Removed " << nRemoved << " images from the CCDB node cache " << mDir;
+  }
+  return nRemoved;
+}
+
+} // namespace o2::ccdb
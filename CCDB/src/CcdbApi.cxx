@@ -41,6 +41,8 @@
 #include <boost/interprocess/sync/named_semaphore.hpp>
 #include <regex>
 #include <cstdio>
+#include <cstdlib>
+#include <limits>
 
 namespace o2::ccdb
 {
@@ -705,6 +707,115 @@ void CcdbApi::snapshot(std::string const& ccdbrootpath, std::string const& local
   }
 }
 
+int CcdbApi::prefetch(std::vector<std::string> const& paths, long from, long to, std::map<std::string, std::string> const& metadata)
+{
+  int nObjects = 0;
+  for (auto const& path : paths) {
+    mPrefetched.erase(path);
+    PrefetchedPath prefetched{metadata, from, to};
+    std::vector<long> starts; // validity starts of all the versions of the path, listed at the 1st gap in the range
+    bool listed = false;
+    // walk the range from one validity interval to the next one
+    long timestamp = from;
+    while (timestamp < to) {
+      o2::pmr::vector<char> image;
+      std::map<std::string, std::string> headers;
+      loadFileToMemory(image, path, metadata, timestamp, &headers, "", "", "");
+      if (headers.count("Error") || image.empty()) {
+        // skip the gap up to the next object starting in the range, if any
+        if (!listed) {
+          starts = mInSnapshotMode ? std::vector<long>{} : parseValidityStarts(list(path, false, "application/json"));
+          listed = true;
+        }
+        auto next = std::upper_bound(starts.begin(), starts.end(), timestamp);
+        if (next == starts.end() || *next >= to) {
+          LOG(warn) << "No object at " << path << " for timestamp " << timestamp << " nor later in the prefetched range";
+          break;
+        }
+        LOG(warn) << "No object at " << path << " for timestamp " << timestamp << ", prefetching continues from " << *next;
+        timestamp = *next;
+        continue;
+      }
+      long start = getHeaderValue(headers, "Valid-From", from);
+      long end = getHeaderValue(headers, "Valid-Until", std::numeric_limits<long>::max());
+      if (end <= timestamp) {
+        break; // e.g. a snapshot, serving the same object for any timestamp
+      }
+      // the part of the validity before timestamp is already covered by the previous objects
+      auto& object = prefetched.objects[std::max(start, timestamp)];
+      object.endValidity = end;
+      object.image.assign(image.begin(), image.end());
+      object.headers = std::move(headers);
+      timestamp = end;
+      nObjects++;
+    }
+    LOG(info) << "Prefetched " << prefetched.objects.size() << " object(s) at " << path << " for [" << from << ", " << to << "[";
+    mPrefetched[path] = std::move(prefetched);
+  }
+  return nObjects;
+}
+
+const CcdbApi::PrefetchedObject* CcdbApi::getPrefetched(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                                                        const std::string& createdNotAfter, const std::string& createdNotBefore) const
+{
+  if (mPrefetched.empty() || !createdNotAfter.empty() || !createdNotBefore.empty()) {
+    return nullptr;
+  }
+  auto itPath = mPrefetched.find(path);
+  if (itPath == mPrefetched.end()) {
+    return nullptr;
+  }
+  auto const& prefetched = itPath->second;
+  if (timestamp < prefetched.from || timestamp >= prefetched.to || metadata != prefetched.metadata) {
+    return nullptr;
+  }
+  auto it = prefetched.objects.upper_bound(timestamp); // first object starting after timestamp
+  if (it == prefetched.objects.begin()) {
+    return nullptr;
+  }
+  --it;
+  return timestamp < it->second.endValidity ? &it->second : nullptr;
+}
+
+bool CcdbApi::servePrefetched(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                              std::map<std::string, std::string>* headers, std::string const& etag,
+                              const std::string& createdNotAfter, const std::string& createdNotBefore, const PrefetchedObject*& object) const
+{
+  object = getPrefetched(path, metadata, timestamp, createdNotAfter, createdNotBefore);
+  if (!object) {
+    return false;
+  }
+  if (headers) {
+    *headers = object->headers;
+  }
+  auto etagIt = object->headers.find("ETag");
+  if (!etag.empty() && etagIt != object->headers.end() && etagIt->second == etag) {
+    object = nullptr; // as for a 304 reply, the caller already has this object
+  }
+  return true;
+}
+
+std::vector<long> CcdbApi::parseValidityStarts(std::string const& reply)
+{
+  // the objects of a JSON list reply have their validity as "validFrom":<start>,"validUntil":<end>
+  const std::string key = "\"validFrom\"";
+  std::vector<long> starts;
+  for (auto pos = reply.find(key); pos != std::string::npos; pos = reply.find(key, pos)) {
+    pos = reply.find_first_not_of(" :\"", pos + key.size());
+    if (pos == std::string::npos) {
+      break;
+    }
+    char* end = nullptr;
+    long start = std::strtol(reply.c_str() + pos, &end, 10);
+    if (end != reply.c_str() + pos) {
+      starts.push_back(start);
+    }
+  }
+  std::sort(starts.begin(), starts.end());
+  starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+  return starts;
+}
+
 void* CcdbApi::extractFromTFile(TFile& file, TClass const* cl)
 {
   if (!cl) {
@@ -948,6 +1059,12 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
                                  std::map<std::string, std::string>* headers, std::string const& etag,
                                  const std::string& createdNotAfter, const std::string& createdNotBefore) const
 {
+  // serve from the prefetched objects if possible
+  const PrefetchedObject* prefetched = nullptr;
+  if (servePrefetched(path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore, prefetched)) {
+    return prefetched ? interpretAsTMemFileAndExtract(const_cast<char*>(prefetched->image.data()), prefetched->image.size(), tinfo) : nullptr;
+  }
+
   // The environment option ALICEO2_CCDB_LOCALCACHE allows
   // to reduce the number of queries to the server, by collecting the objects in a local
   // cache folder, and serving from this folder for repeated queries.
@@ -1292,6 +1409,20 @@ void CcdbApi::parseCCDBHeaders(std::vector<std::string> const& headers, std::vec
   }
 }
 
+long CcdbApi::getHeaderValue(std::map<std::string, std::string> const& headers, std::string const& key, long defaultValue)
+{
+  auto it = headers.find(key);
+  if (it == headers.end() || it->second.empty()) {
+    return defaultValue;
+  }
+  try {
+    return std::stol(it->second);
+  } catch (std::exception const&) {
+    LOG(warn) << "Malformed header " << key << ": " << it->second;
+    return defaultValue;
+  }
+}
+
 CCDBQuery* CcdbApi::retrieveQueryInfo(TFile& file)
 {
   auto object = file.GetObjectChecked(CCDBQUERY_ENTRY, TClass::GetClass(typeid(o2::ccdb::CCDBQuery)));
@@ -1416,6 +1547,15 @@ void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, std::string const& p
                                std::map<std::string, std::string>* headers, std::string const& etag,
                                const std::string& createdNotAfter, const std::string& createdNotBefore) const
 {
+  // serve from the prefetched objects if possible
+  const PrefetchedObject* prefetched = nullptr;
+  if (servePrefetched(path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore, prefetched)) {
+    if (prefetched) {
+      dest.assign(prefetched->image.begin(), prefetched->image.end());
+    }
+    return;
+  }
+
   // The environment option ALICEO2_CCDB_LOCALCACHE allows
   // to reduce the number of queries to the server, by collecting the objects in a local
   // cache folder, and serving from this folder for repeated queries.
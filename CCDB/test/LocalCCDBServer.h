@@ -0,0 +1,62 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   LocalCCDBServer.h
+/// \brief  A local directory in the snapshot layout standing for the CCDB server in the tests
+///
+
+#ifndef O2_CCDB_TEST_LOCALCCDBSERVER_H
+#define O2_CCDB_TEST_LOCALCCDBSERVER_H
+
+#include "CCDB/CcdbApi.h"
+#include <TFile.h>
+#include <TClass.h>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+namespace o2::ccdb::test
+{
+// a local directory standing for the CCDB server, in the snapshot layout
+struct LocalServer {
+  explicit LocalServer(std::string const& name)
+  {
+    auto base = std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()));
+    std::filesystem::remove_all(base);
+    serverDir = (base / "server").string();
+    cacheDir = (base / "cache").string();
+    api.init("file://" + serverDir);
+  }
+  ~LocalServer() { std::filesystem::remove_all(std::filesystem::path(serverDir).parent_path()); }
+
+  // store an object as done by o2-ccdb-downloadccdbfile
+  void store(std::string const& path, std::string const& obj, long start, long end)
+  {
+    auto dir = serverDir + "/" + path;
+    std::filesystem::create_directories(dir);
+    TFile f((dir + "/snapshot.root").c_str(), "RECREATE");
+    std::map<std::string, std::string> headers{{"Valid-From", std::to_string(start)}, {"Valid-Until", std::to_string(end)}};
+    f.WriteObjectAny(&obj, TClass::GetClass(typeid(obj)), CcdbApi::CCDBOBJECT_ENTRY);
+    f.WriteObjectAny(&headers, TClass::GetClass(typeid(headers)), CcdbApi::CCDBMETA_ENTRY);
+    f.Close();
+  }
+
+  void remove(std::string const& path) { std::filesystem::remove_all(serverDir + "/" + path); }
+
+  CcdbApi api;
+  std::string serverDir;
+  std::string cacheDir;
+};
+} // namespace o2::ccdb::test
+
+#endif
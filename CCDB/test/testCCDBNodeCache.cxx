@@ -0,0 +1,186 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBNodeCache.cxx
+/// \brief  Test the node-level cache of CCDB objects, using a local snapshot as server
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include "CCDB/CCDBNodeCache.h"
+#include "CCDB/BasicCCDBManager.h"
+#include "LocalCCDBServer.h"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace o2::ccdb;
+using o2::ccdb::test::LocalServer;
+
+namespace
+{
+std::string extract(CCDBNodeCache::BlobPtr const& blob)
+{
+  std::unique_ptr<std::string> obj(CcdbApi::extractFromMemoryBlob<std::string>(blob->data(), blob->size()));
+  return obj ? *obj : std::string{};
+}
+
+// pretend that the images of the path were stored age seconds ago
+void setAge(std::string const& dir, int age)
+{
+  for (auto const& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.path().extension() == ".root") {
+      std::filesystem::last_write_time(entry.path(), std::filesystem::file_time_type::clock::now() - std::chrono::seconds(age));
+    }
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestNodeCacheValidity)
+{
+  LocalServer server("ccdbnodecache");
+  const std::string path = "Test/NodeCache";
+  const std::map<std::string, std::string> md;
+  server.store(path, "objectA", 1000, 2000);
+
+  CCDBNodeCache cache(server.cacheDir);
+  auto blob = cache.get(server.api, path, md, 1500);
+  BOOST_REQUIRE(blob);
+  BOOST_CHECK_EQUAL(blob->getStartValidity(), 1000);
+  BOOST_CHECK_EQUAL(blob->getEndValidity(), 2000);
+  BOOST_CHECK_EQUAL(extract(blob), "objectA");
+
+  // the server is not queried anymore inside the validity interval
+  server.remove(path);
+  auto blob2 = cache.get(server.api, path, md, 1999);
+  BOOST_CHECK(blob2 == blob);
+  BOOST_CHECK(cache.find(path, md, 2000) == nullptr);
+  BOOST_CHECK(cache.get(server.api, path, md, 2500) == nullptr);
+
+  // another validity interval of the same path
+  server.store(path, "objectB", 2000, 3000);
+  auto blob3 = cache.get(server.api, path, md, 2500);
+  BOOST_REQUIRE(blob3);
+  BOOST_CHECK_EQUAL(extract(blob3), "objectB");
+  BOOST_CHECK(cache.find(path, md, 1500) == blob);
+
+  // queries with metadata are cached separately
+  BOOST_CHECK(cache.find(path, {{"key", "value"}}, 1500) == nullptr);
+
+  // the response headers are kept with the image, also for the other processes
+  BOOST_CHECK_EQUAL(blob->getHeaders().at("Valid-From"), "1000");
+  BOOST_CHECK_EQUAL(blob->getHeaders().at("Valid-Until"), "2000");
+  BOOST_CHECK_EQUAL(blob->getHeaders().at("ETag"), blob->getETag());
+  CCDBNodeCache cache2(server.cacheDir);
+  auto blob4 = cache2.find(path, md, 1500);
+  BOOST_REQUIRE(blob4);
+  BOOST_CHECK(blob4->getHeaders() == blob->getHeaders());
+}
+
+BOOST_AUTO_TEST_CASE(TestNodeCacheSharing)
+{
+  LocalServer server("ccdbnodecache");
+  const std::string path = "Test/NodeCacheShared";
+  const std::map<std::string, std::string> md;
+  server.store(path, "shared", 0, 1000);
+
+  // a second cache on the same directory stands for another process of the node
+  CCDBNodeCache cache1(server.cacheDir), cache2(server.cacheDir);
+  BOOST_REQUIRE(cache1.get(server.api, path, md, 10));
+  server.remove(path);
+  auto blob = cache2.get(server.api, path, md, 20);
+  BOOST_REQUIRE(blob);
+  BOOST_CHECK_EQUAL(extract(blob), "shared");
+
+  // concurrent readers all get the same mapped image
+  std::vector<CCDBNodeCache::BlobPtr> blobs(8);
+  std::vector<std::thread> threads;
+  CCDBNodeCache cache3(server.cacheDir);
+  for (size_t i = 0; i < blobs.size(); i++) {
+    threads.emplace_back([&, i]() { blobs[i] = cache3.get(server.api, path, md, 100 + i); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& b : blobs) {
+    BOOST_CHECK(b && b == blobs[0]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestNodeCacheCleanup)
+{
+  LocalServer server("ccdbnodecache");
+  const std::string path = "Test/NodeCacheCleanup";
+  const std::map<std::string, std::string> md;
+  CCDBNodeCache cache(server.cacheDir);
+  cache.setMaxAge(0);
+  cache.setMaxSize(0);
+  std::vector<CCDBNodeCache::BlobPtr> blobs;
+  for (int i = 0; i < 3; i++) {
+    server.store(path + std::to_string(i), "object" + std::to_string(i), 0, 1000);
+    blobs.push_back(cache.get(server.api, path + std::to_string(i), md, 10));
+    BOOST_REQUIRE(blobs.back());
+    setAge(server.cacheDir + "/" + path + std::to_string(i), 30 - 10 * i);
+  }
+  BOOST_CHECK_EQUAL(cache.cleanup(), 0);
+
+  // the oldest image is removed to fit in the max size, it stays valid for its users
+  cache.setMaxSize(blobs[1]->size() + blobs[2]->size());
+  BOOST_CHECK_EQUAL(cache.cleanup(), 1);
+  BOOST_CHECK(cache.find(path + "0", md, 10) == nullptr);
+  BOOST_CHECK(cache.find(path + "1", md, 10) == blobs[1]);
+  BOOST_CHECK_EQUAL(extract(blobs[0]), "object0");
+
+  // the images older than the max age are removed
+  cache.setMaxSize(0);
+  cache.setMaxAge(15);
+  BOOST_CHECK_EQUAL(cache.cleanup(), 1);
+  BOOST_CHECK(cache.find(path + "1", md, 10) == nullptr);
+  BOOST_CHECK(cache.find(path + "2", md, 10) == blobs[2]);
+
+  // or not served anymore but downloaded again by the processes which did not map them yet
+  setAge(server.cacheDir + "/" + path + "2", 20);
+  server.store(path + "2", "renewed", 0, 1000);
+  CCDBNodeCache cache2(server.cacheDir);
+  cache2.setMaxAge(15);
+  auto blob = cache2.get(server.api, path + "2", md, 10);
+  BOOST_REQUIRE(blob);
+  BOOST_CHECK_EQUAL(extract(blob), "renewed");
+  BOOST_CHECK_EQUAL(extract(blobs[2]), "object2");
+}
+
+BOOST_AUTO_TEST_CASE(TestManagerWithNodeCache)
+{
+  LocalServer server("ccdbnodecache");
+  const std::string path = "Test/NodeCacheManager";
+  server.store(path, "managed", 1000, 2000);
+
+  CCDBManagerInstance cdb("file://" + server.serverDir);
+  cdb.setNodeCache(server.cacheDir);
+  BOOST_CHECK(cdb.isNodeCacheEnabled());
+  auto* obj = cdb.getForTimeStamp<std::string>(path, 1500);
+  BOOST_REQUIRE(obj);
+  BOOST_CHECK_EQUAL(*obj, "managed");
+  // the same image is not deserialized again
+  BOOST_CHECK(cdb.getForTimeStamp<std::string>(path, 1600) == obj);
+  auto* blob = cdb.getBlobForTimeStamp(path, 1700);
+  BOOST_REQUIRE(blob);
+  BOOST_CHECK(!blob->empty());
+
+  server.remove(path);
+  cdb.setFatalWhenNull(false);
+  BOOST_CHECK(cdb.getForTimeStamp<std::string>(path, 2500) == nullptr);
+}
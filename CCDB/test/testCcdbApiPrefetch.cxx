@@ -0,0 +1,91 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbApiPrefetch.cxx
+/// \brief  Test the prefetching of CCDB objects, using a local snapshot as server
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include "CCDB/BasicCCDBManager.h"
+#include "LocalCCDBServer.h"
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+
+using namespace o2::ccdb;
+
+namespace
+{
+struct Fixture : public o2::ccdb::test::LocalServer {
+  Fixture() : LocalServer("ccdbprefetch")
+  {
+    store("Test/PrefetchA", "objectA", 1000, 2000);
+    store("Test/PrefetchB", "objectB", 0, 10000);
+  }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(TestPrefetch, Fixture)
+{
+  const std::map<std::string, std::string> md;
+
+  BOOST_CHECK_EQUAL(api.prefetch({"Test/PrefetchA", "Test/PrefetchB", "Test/PrefetchMissing"}, 500, 5000), 2);
+  BOOST_CHECK(api.isPrefetched("Test/PrefetchA", 1500));
+  BOOST_CHECK(!api.isPrefetched("Test/PrefetchA", 2500)); // outside of the object validity
+  BOOST_CHECK(!api.isPrefetched("Test/PrefetchB", 6000)); // outside of the prefetched range
+  BOOST_CHECK(!api.isPrefetched("Test/PrefetchB", 1500, {{"key", "value"}}));
+
+  // the prefetched objects are served without accessing the snapshot anymore
+  std::filesystem::remove_all(serverDir);
+  std::unique_ptr<std::string> objA(api.retrieveFromTFileAny<std::string>("Test/PrefetchA", md, 1500));
+  BOOST_REQUIRE(objA);
+  BOOST_CHECK_EQUAL(*objA, "objectA");
+  std::unique_ptr<std::string> objB(api.retrieveFromTFileAny<std::string>("Test/PrefetchB", md, 4999));
+  BOOST_REQUIRE(objB);
+  BOOST_CHECK_EQUAL(*objB, "objectB");
+  std::map<std::string, std::string> headers;
+  o2::pmr::vector<char> image;
+  api.loadFileToMemory(image, "Test/PrefetchB", md, 600, &headers, "", "", "");
+  BOOST_CHECK(!image.empty());
+  BOOST_CHECK_EQUAL(headers["Valid-Until"], "10000");
+
+  // queries outside of the prefetched objects go to the (now empty) snapshot
+  BOOST_CHECK(api.retrieveFromTFileAny<std::string>("Test/PrefetchA", md, 2500) == nullptr);
+
+  api.clearPrefetched();
+  BOOST_CHECK(!api.isPrefetched("Test/PrefetchA", 1500));
+}
+
+BOOST_FIXTURE_TEST_CASE(TestManagerPrefetch, Fixture)
+{
+  CCDBManagerInstance cdb("file://" + serverDir);
+  BOOST_CHECK_EQUAL(cdb.prefetch({"Test/PrefetchA"}, 1000, 2000), 1);
+  std::filesystem::remove_all(serverDir);
+  auto* obj = cdb.getForTimeStamp<std::string>("Test/PrefetchA", 1200);
+  BOOST_REQUIRE(obj);
+  BOOST_CHECK_EQUAL(*obj, "objectA");
+  // same object within its validity: the cached instance is kept
+  BOOST_CHECK(cdb.getForTimeStamp<std::string>("Test/PrefetchA", 1800) == obj);
+}
+
+BOOST_AUTO_TEST_CASE(TestParseValidityStarts)
+{
+  // list reply of a path with two versions, the gaps of the prefetched range are skipped to these starts
+  const std::string reply = R"({"objects":[{"path":"Test/PrefetchA","createTime":1500,"lastModified":1500,"validFrom":3000,"validUntil":4000},
+                                           {"path":"Test/PrefetchA","createTime":1000,"lastModified":1000,"validFrom" : 1000,"validUntil":2000},
+                                           {"path":"Test/PrefetchA","createTime":1200,"lastModified":1200,"validFrom":"3000","validUntil":3500}],"subfolders":[]})";
+  BOOST_CHECK(CcdbApi::parseValidityStarts(reply) == std::vector<long>({1000, 3000}));
+  BOOST_CHECK(CcdbApi::parseValidityStarts("").empty());
+}
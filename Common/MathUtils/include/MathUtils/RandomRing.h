@@ -110,6 +110,11 @@ class RandomRing
   /// @return position in the ring buffer
   unsigned int getRingPosition() const { return mRingPosition; }
 
+  /// set the position in the ring buffer, e.g. to start independent streams of values in copies of the ring
+  /// for getNextValueVc the position must be a multiple of the vector size
+  /// @param [in] position new position, taken modulo the size of the ring
+  void setRingPosition(size_t position) { mRingPosition = position % mRandomNumbers.size(); }
+
  private:
   // =========================================================================
   // ===| members |===========================================================
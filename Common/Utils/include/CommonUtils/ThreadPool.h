@@ -0,0 +1,71 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// Fixed size pool of worker threads executing batches of independent tasks
+
+#ifndef ALICEO2_THREADPOOL_H_
+#define ALICEO2_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace utils
+{
+
+class ThreadPool
+{
+ public:
+  /// create a pool with nThreads workers in total, the thread calling run is one of them
+  explicit ThreadPool(size_t nThreads = 1);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t getNThreads() const { return mWorkers.size() + 1; }
+
+  /// execute task(i) for i in [0, nTasks) and wait for completion, the first exception thrown by a task is rethrown
+  void run(size_t nTasks, const std::function<void(size_t)>& task);
+
+  /// execute a batch of tasks and wait for completion
+  void run(const std::vector<std::function<void()>>& tasks)
+  {
+    run(tasks.size(), [&tasks](size_t i) { tasks[i](); });
+  }
+
+ private:
+  void work();
+  void process();
+
+  std::vector<std::thread> mWorkers;
+  std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::condition_variable mDone;
+  const std::function<void(size_t)>* mTask = nullptr; // current batch, valid only during run
+  size_t mNTasks = 0;
+  std::atomic<size_t> mNextTask{0};
+  size_t mNBusy = 0;         // number of workers processing the current batch
+  unsigned long mBatch = 0;  // batch counter to wake up the workers
+  std::exception_ptr mError; // first exception of the current batch
+  bool mStop = false;
+};
+
+} // namespace utils
+} // namespace o2
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "CommonUtils/ThreadPool.h"
+
+using namespace o2::utils;
+
+ThreadPool::ThreadPool(size_t nThreads)
+{
+  for (size_t i = 1; i < nThreads; i++) {
+    mWorkers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mWakeUp.notify_all();
+  for (auto& w : mWorkers) {
+    w.join();
+  }
+}
+
+void ThreadPool::run(size_t nTasks, const std::function<void(size_t)>& task)
+{
+  if (mWorkers.empty() || nTasks < 2) {
+    for (size_t i = 0; i < nTasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTask = &task;
+    mNTasks = nTasks;
+    mNextTask = 0;
+    mError = nullptr;
+    mNBusy = mWorkers.size();
+    mBatch++;
+  }
+  mWakeUp.notify_all();
+  process();
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDone.wait(lock, [this]() { return mNBusy == 0; });
+  mTask = nullptr;
+  if (mError) {
+    std::rethrow_exception(mError);
+  }
+}
+
+void ThreadPool::work()
+{
+  unsigned long batch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWakeUp.wait(lock, [this, batch]() { return mStop || mBatch != batch; });
+      if (mStop) {
+        return;
+      }
+      batch = mBatch;
+    }
+    process();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (--mNBusy == 0) {
+      mDone.notify_one();
+    }
+  }
+}
+
+void ThreadPool::process()
+{
+  size_t i;
+  while ((i = mNextTask++) < mNTasks) {
+    try {
+      (*mTask)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (!mError) {
+        mError = std::current_exception();
+      }
+      mNextTask = mNTasks; // skip what was not started yet
+    }
+  }
+}
@@ -0,0 +1,52 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ThreadPool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "CommonUtils/ThreadPool.h"
+#include <numeric>
+#include <stdexcept>
+
+using namespace o2;
+
+BOOST_AUTO_TEST_CASE(ThreadPool_test)
+{
+  for (size_t nThreads : {1, 2, 4}) {
+    utils::ThreadPool pool(nThreads);
+    BOOST_CHECK_EQUAL(pool.getNThreads(), nThreads);
+    for (size_t nTasks : {0, 1, 3, 1000}) { // the same pool is reused for several batches
+      std::vector<size_t> res(nTasks, 0);
+      pool.run(nTasks, [&res](size_t i) { res[i] = i * i; });
+      for (size_t i = 0; i < nTasks; i++) {
+        BOOST_CHECK_EQUAL(res[i], i * i);
+      }
+    }
+    std::vector<std::function<void()>> tasks;
+    std::vector<int> res(10, 0);
+    for (int i = 0; i < 10; i++) {
+      tasks.emplace_back([&res, i]() { res[i] = i; });
+    }
+    pool.run(tasks);
+    BOOST_CHECK_EQUAL(std::accumulate(res.begin(), res.end(), 0), 45);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPool_exception_test)
+{
+  utils::ThreadPool pool(4);
+  BOOST_CHECK_THROW(pool.run(100, [](size_t i) { if (i == 17) { throw std::runtime_error("task failed"); } }), std::runtime_error);
+  // the pool stays usable after a failed batch
+  std::atomic<size_t> n{0};
+  pool.run(100, [&n](size_t) { n++; });
+  BOOST_CHECK_EQUAL(n.load(), 100);
+}
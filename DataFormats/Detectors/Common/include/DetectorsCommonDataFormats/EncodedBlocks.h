@@ -120,6 +120,7 @@ struct Metadata {
   int nDictWords = 0;
   int nDataWords = 0;
   int nLiteralWords = 0;
+  uint8_t nStreams = 0; // number of interleaved rANS streams, 0 for data written before it was configurable (== 2)
 
   void clear()
   {
@@ -133,8 +134,10 @@ struct Metadata {
     nDictWords = 0;
     nDataWords = 0;
     nLiteralWords = 0;
+    nStreams = 0;
   }
-  ClassDefNV(Metadata, 2);
+  uint8_t getNStreams() const { return nStreams ? nStreams : uint8_t(rans::internal::DefaultNStreams); }
+  ClassDefNV(Metadata, 3);
 };
 
 /// registry struct for the buffer start and offsets of writable space
@@ -329,6 +332,24 @@ struct Block {
   ClassDefNV(Block, 1);
 }; // namespace ctf
 
+/// entropy-encoded column prepared outside of the flat EncodedBlocks buffer, allowing to encode the blocks concurrently
+template <typename W = uint32_t>
+struct EncodedSlot {
+  Metadata metadata;
+  std::vector<W> dict;
+  std::vector<W> data;
+  std::vector<W> literals;
+
+  size_t getNWords() const { return dict.size() + data.size() + literals.size(); }
+  void clear()
+  {
+    metadata.clear();
+    dict.clear();
+    data.clear();
+    literals.clear();
+  }
+};
+
 ///<<======================== Auxiliary classes =======================<<
 
 template <typename H, int N, typename W = uint32_t>
@@ -336,6 +357,7 @@ class EncodedBlocks
 {
  public:
   typedef EncodedBlocks<H, N, W> base;
+  typedef std::array<EncodedSlot<W>, N> encodedSlots;
 
   void setHeader(const H& h) { mHeader = h; }
   const H& getHeader() const { return mHeader; }
@@ -432,14 +454,29 @@ class EncodedBlocks
 
   /// encode vector src to bloc at provided slot
   template <typename VE, typename buffer_T>
-  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f)
+  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f, int nStreams = rans::internal::DefaultNStreams)
   {
-    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc);
+    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc, nStreams);
   }
 
   /// encode vector src to bloc at provided slot
   template <typename input_IT, typename buffer_T>
-  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f);
+  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f, int nStreams = rans::internal::DefaultNStreams);
+
+  /// encode vector src out of place to be stored later by storeSlots, thread-safe
+  template <typename VE>
+  static void encodeSlot(EncodedSlot<W>& dest, const VE& src, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f, int nStreams = rans::internal::DefaultNStreams)
+  {
+    encodeSlot(dest, std::begin(src), std::end(src), symbolTablePrecision, opt, encoderExt, memfc, nStreams);
+  }
+
+  /// encode source range out of place to be stored later by storeSlots, thread-safe
+  template <typename input_IT>
+  static void encodeSlot(EncodedSlot<W>& dest, const input_IT srcBegin, const input_IT srcEnd, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f, int nStreams = rans::internal::DefaultNStreams);
+
+  /// store the out of place encoded slots to the empty container in the buffer, the result is identical to the one of slot by slot encode calls
+  template <typename buffer_T>
+  static void storeSlots(buffer_T& buffer, const encodedSlots& slots);
 
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
@@ -801,7 +838,7 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
         // to D-word array
         literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals, md.getNStreams());
     } else { // data was stored as is
       using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
       destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
@@ -822,7 +859,8 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
                                     Metadata::OptStore opt,       // option for data compression
                                     buffer_T* buffer,             // optional buffer (vector) providing memory for encoded blocks
                                     const void* encoderExt,       // optional external encoder
-                                    float memfc)                  // memory allocation margin factor
+                                    float memfc,                  // memory allocation margin factor
+                                    int nStreams)                 // number of interleaved rANS streams for the internal encoder
 {
 
   using storageBuffer_t = W;
@@ -882,7 +920,9 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
       } else {
         rans::FrequencyTable frequencyTable = rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
         RenormedFrequencyTable renormedFrequencyTable = rans::renorm(frequencyTable, symbolTablePrecision);
-        return std::make_tuple(ransEncoder_t{renormedFrequencyTable}, frequencyTable);
+        ransEncoder_t encoder{renormedFrequencyTable};
+        encoder.setNStreams(nStreams);
+        return std::make_tuple(std::move(encoder), frequencyTable);
       }
     }();
     ransEncoder_t const* const encoder = encoderExt ? reinterpret_cast<ransEncoder_t const* const>(encoderExt) : &inplaceEncoder;
@@ -939,7 +979,8 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
                              encoder->getMaxSymbol(),
                              static_cast<int32_t>(frequencyTable.size()),
                              dataSize,
-                             static_cast<int32_t>(nLiteralWords)};
+                             static_cast<int32_t>(nLiteralWords),
+                             static_cast<uint8_t>(encoder->getNStreams())};
   } else { // store original data w/o EEncoding
     // FIXME(milettri): we should be able to do without an intermediate vector;
     //  provided iterator is not necessarily pointer, need to use intermediate vector!!!
@@ -957,6 +998,118 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
   }
 }
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT>
+void EncodedBlocks<H, N, W>::encodeSlot(EncodedSlot<W>& dest,        // destination of the encoded column
+                                        const input_IT srcBegin,      // iterator begin of source message
+                                        const input_IT srcEnd,        // iterator end of source message
+                                        uint8_t symbolTablePrecision, // encoding into
+                                        Metadata::OptStore opt,       // option for data compression
+                                        const void* encoderExt,       // optional external encoder
+                                        float memfc,                  // memory allocation margin factor
+                                        int nStreams)                 // number of interleaved rANS streams for the internal encoder
+{
+  using storageBuffer_t = W;
+  using input_t = typename std::iterator_traits<input_IT>::value_type;
+  using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
+  using ransState_t = typename ransEncoder_t::coder_t;
+  using ransStream_t = typename ransEncoder_t::stream_t;
+
+  static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
+  static_assert(std::is_same_v<storageBuffer_t, typename rans::count_t>);
+
+  dest.clear();
+  const size_t messageLength = std::distance(srcBegin, srcEnd);
+  if (messageLength == 0) {
+    dest.metadata = Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+    return;
+  }
+
+  if (opt == Metadata::OptStore::EENCODE) {
+    constexpr size_t SizeEstMarginAbs = 10 * 1024;
+    const float SizeEstMarginRel = 1.5 * memfc;
+
+    const auto [inplaceEncoder, frequencyTable] = [&]() {
+      if (encoderExt) {
+        return std::make_tuple(ransEncoder_t{}, rans::FrequencyTable{});
+      } else {
+        rans::FrequencyTable frequencyTable = rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
+        RenormedFrequencyTable renormedFrequencyTable = rans::renorm(frequencyTable, symbolTablePrecision);
+        ransEncoder_t encoder{renormedFrequencyTable};
+        encoder.setNStreams(nStreams);
+        return std::make_tuple(std::move(encoder), frequencyTable);
+      }
+    }();
+    ransEncoder_t const* const encoder = encoderExt ? reinterpret_cast<ransEncoder_t const* const>(encoderExt) : &inplaceEncoder;
+
+    dest.dict.assign(frequencyTable.data(), frequencyTable.data() + frequencyTable.size());
+    // pre-size the output region with the same margins as the in-place encoding
+    const size_t dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t));
+    dest.data.resize(SizeEstMarginAbs + size_t(SizeEstMarginRel * (dataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)));
+    std::vector<input_t> literals;
+    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, dest.data.data(), literals);
+    rans::utils::checkBounds(encodedMessageEnd, dest.data.data() + dest.data.size());
+    dest.data.resize(encodedMessageEnd - dest.data.data());
+
+    const size_t nLiteralSymbols = literals.size();
+    if (!literals.empty()) {
+      literals.resize(calculatePaddedSize<input_t, storageBuffer_t>(nLiteralSymbols), {});
+      const auto* literalsBegin = reinterpret_cast<const storageBuffer_t*>(literals.data());
+      dest.literals.assign(literalsBegin, literalsBegin + calculateNDestTElements<input_t, storageBuffer_t>(nLiteralSymbols));
+    }
+
+    dest.metadata = Metadata{messageLength,
+                             nLiteralSymbols,
+                             sizeof(input_t),
+                             sizeof(ransState_t),
+                             sizeof(ransStream_t),
+                             static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
+                             opt,
+                             encoder->getMinSymbol(),
+                             encoder->getMaxSymbol(),
+                             static_cast<int32_t>(dest.dict.size()),
+                             static_cast<int32_t>(dest.data.size()),
+                             static_cast<int32_t>(dest.literals.size()),
+                             static_cast<uint8_t>(encoder->getNStreams())};
+  } else { // store original data w/o EEncoding
+    std::vector<input_t> tmp(calculatePaddedSize<input_t, storageBuffer_t>(messageLength), {});
+    std::copy(srcBegin, srcEnd, std::begin(tmp));
+    const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
+    const auto* tmpBegin = reinterpret_cast<const storageBuffer_t*>(tmp.data());
+    dest.data.assign(tmpBegin, tmpBegin + nBufferElems);
+    dest.metadata = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+  }
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::storeSlots(buffer_T& buffer, const encodedSlots& slots)
+{
+  auto* ec = get(buffer.data());
+  assert(ec->mRegistry.nFilledBlocks == 0);
+  // single expansion for all blocks, then compact them one after the other
+  size_t needed = 0;
+  for (const auto& slot : slots) {
+    needed += estimateBlockSize(slot.getNWords());
+  }
+  if (needed > ec->getFreeSize()) {
+    ec = expand(buffer, ec->size() + (needed - ec->getFreeSize()));
+  }
+  for (int i = 0; i < N; i++) {
+    const auto& slot = slots[i];
+    ec->mRegistry.nFilledBlocks++;
+    if (slot.metadata.opt != Metadata::OptStore::NODATA) {
+      ec->mBlocks[i].store(slot.dict.size(), slot.data.size(), slot.literals.size(),
+                           slot.dict.empty() ? nullptr : slot.dict.data(),
+                           slot.data.empty() ? nullptr : slot.data.data(),
+                           slot.literals.empty() ? nullptr : slot.literals.data());
+    }
+    ec->mMetadata[i] = slot.metadata;
+  }
+}
+
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
 template <typename H, int N, typename W>
 std::vector<char> EncodedBlocks<H, N, W>::createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& vmd)
@@ -0,0 +1,193 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testEncodedBlocks.cxx
+/// @brief  Test that the blocks encoded concurrently out of place are stored as the ones encoded one by one
+
+#define BOOST_TEST_MODULE Test EncodedBlocks
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "CommonUtils/ThreadPool.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "rANS/rans.h"
+
+using namespace o2::ctf;
+
+namespace
+{
+struct TestHeader {
+  uint32_t run = 0;
+  uint32_t firstOrbit = 0;
+};
+
+enum Slots { SMALL,
+             WIDE,
+             EMPTY,
+             RAW,
+             LARGE,
+             SINGLE,
+             NSlots };
+
+using Blocks = EncodedBlocks<TestHeader, NSlots, uint32_t>;
+
+struct Columns {
+  std::vector<uint8_t> small;  // few frequent values
+  std::vector<int16_t> wide;   // encoded with an external dictionary which misses the rare values, stored as literals
+  std::vector<uint32_t> empty; // no data
+  std::vector<uint16_t> raw;   // stored w/o entropy encoding
+  std::vector<int32_t> large;  // large values
+  std::vector<uint8_t> single; // a single value repeated
+};
+
+Columns createColumns(size_t n)
+{
+  std::mt19937 gen(12345);
+  std::geometric_distribution<int> geom(0.3);
+  std::normal_distribution<float> gaus(0.f, 30.f);
+  std::uniform_int_distribution<int> outlier(-30000, 30000), flat(0, 0xffff), large(-(1 << 20), 1 << 20);
+  std::uniform_real_distribution<float> prob(0.f, 1.f);
+  Columns cols;
+  for (size_t i = 0; i < n; i++) {
+    cols.small.push_back(std::min(geom(gen), 255));
+    cols.wide.push_back(prob(gen) < 0.02f ? outlier(gen) : int(gaus(gen)));
+    cols.raw.push_back(flat(gen));
+    cols.large.push_back(large(gen));
+    cols.single.push_back(7);
+  }
+  return cols;
+}
+
+/// Dictionary of the core of the wide column, without its outliers
+o2::rans::RenormedFrequencyTable createWideTable()
+{
+  std::vector<int16_t> core;
+  for (int v = -200; v <= 200; v++) {
+    core.insert(core.end(), 1 + 200 - std::abs(v), v);
+  }
+  return o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(core.begin(), core.end()));
+}
+
+std::vector<BufferType> encodeSerial(const Columns& cols, const void* wideEncoder)
+{
+  std::vector<BufferType> buff;
+  auto ec = Blocks::create(buff);
+  ec->setHeader(TestHeader{1, 2});
+  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  Blocks::get(buff.data())->encode(cols.small, SMALL, 0, Metadata::OptStore::EENCODE, &buff);
+  Blocks::get(buff.data())->encode(cols.wide, WIDE, 0, Metadata::OptStore::EENCODE, &buff, wideEncoder);
+  Blocks::get(buff.data())->encode(cols.empty, EMPTY, 0, Metadata::OptStore::EENCODE, &buff);
+  Blocks::get(buff.data())->encode(cols.raw, RAW, 0, Metadata::OptStore::NONE, &buff);
+  Blocks::get(buff.data())->encode(cols.large, LARGE, 0, Metadata::OptStore::EENCODE, &buff);
+  Blocks::get(buff.data())->encode(cols.single, SINGLE, 0, Metadata::OptStore::EENCODE, &buff);
+  return buff;
+}
+
+std::vector<BufferType> encodeSlots(const Columns& cols, const void* wideEncoder, o2::utils::ThreadPool& pool)
+{
+  std::vector<BufferType> buff;
+  auto ec = Blocks::create(buff);
+  ec->setHeader(TestHeader{1, 2});
+  Blocks::encodedSlots slots;
+  std::vector<std::function<void()>> tasks;
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[SMALL], cols.small, 0, Metadata::OptStore::EENCODE); });
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[WIDE], cols.wide, 0, Metadata::OptStore::EENCODE, wideEncoder); });
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[EMPTY], cols.empty, 0, Metadata::OptStore::EENCODE); });
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[RAW], cols.raw, 0, Metadata::OptStore::NONE); });
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[LARGE], cols.large, 0, Metadata::OptStore::EENCODE); });
+  tasks.emplace_back([&]() { Blocks::encodeSlot(slots[SINGLE], cols.single, 0, Metadata::OptStore::EENCODE); });
+  pool.run(tasks);
+  Blocks::storeSlots(buff, slots);
+  return buff;
+}
+
+void checkMetadata(const Metadata& ref, const Metadata& test)
+{
+  BOOST_CHECK_EQUAL(ref.messageLength, test.messageLength);
+  BOOST_CHECK_EQUAL(ref.nLiterals, test.nLiterals);
+  BOOST_CHECK_EQUAL(ref.messageWordSize, test.messageWordSize);
+  BOOST_CHECK_EQUAL(ref.coderType, test.coderType);
+  BOOST_CHECK_EQUAL(ref.streamSize, test.streamSize);
+  BOOST_CHECK_EQUAL(ref.probabilityBits, test.probabilityBits);
+  BOOST_CHECK(ref.opt == test.opt);
+  BOOST_CHECK_EQUAL(ref.min, test.min);
+  BOOST_CHECK_EQUAL(ref.max, test.max);
+  BOOST_CHECK_EQUAL(ref.nDictWords, test.nDictWords);
+  BOOST_CHECK_EQUAL(ref.nDataWords, test.nDataWords);
+  BOOST_CHECK_EQUAL(ref.nLiteralWords, test.nLiteralWords);
+  BOOST_CHECK_EQUAL(ref.nStreams, test.nStreams);
+}
+
+/// Check that the stored blocks are the same bytes at the same place of the buffer, with the same metadata
+void checkIdentical(const std::vector<BufferType>& ref, const std::vector<BufferType>& test)
+{
+  const auto* ecRef = Blocks::get(ref.data());
+  const auto* ecTest = Blocks::get(test.data());
+  BOOST_REQUIRE_EQUAL(ecRef->getRegistry().nFilledBlocks, NSlots);
+  BOOST_REQUIRE_EQUAL(ecTest->getRegistry().nFilledBlocks, NSlots);
+  BOOST_REQUIRE_EQUAL(ecRef->getRegistry().offsFreeStart, ecTest->getRegistry().offsFreeStart);
+  for (int i = 0; i < NSlots; i++) {
+    checkMetadata(ecRef->getMetadata(i), ecTest->getMetadata(i));
+    const auto &blRef = ecRef->getBlock(i), &blTest = ecTest->getBlock(i);
+    BOOST_CHECK_EQUAL(blRef.getNDict(), blTest.getNDict());
+    BOOST_CHECK_EQUAL(blRef.getNData(), blTest.getNData());
+    BOOST_CHECK_EQUAL(blRef.getNLiterals(), blTest.getNLiterals());
+  }
+  // the payload area holds the blocks one after the other
+  const size_t payloadStart = alignSize(sizeof(Blocks)), payloadEnd = ecRef->getRegistry().offsFreeStart;
+  BOOST_CHECK(std::memcmp(ref.data() + payloadStart, test.data() + payloadStart, payloadEnd - payloadStart) == 0);
+}
+} // namespace
+
+/// The slots encoded concurrently and stored at the end give the blocks of the slot by slot encoding,
+/// which decode to the source columns
+BOOST_AUTO_TEST_CASE(EncodedBlocksSlots)
+{
+  const auto cols = createColumns(100000);
+  const auto wideTable = createWideTable();
+  const o2::rans::LiteralEncoder64<int16_t> wideEncoder{wideTable};
+  const o2::rans::LiteralDecoder64<int16_t> wideDecoder{wideTable};
+
+  const auto ref = encodeSerial(cols, &wideEncoder);
+  BOOST_CHECK(Blocks::get(ref.data())->getMetadata(WIDE).nLiterals > 0);
+  for (size_t nThreads : {1, 2, 4, 8}) {
+    o2::utils::ThreadPool pool(nThreads);
+    const auto test = encodeSlots(cols, &wideEncoder, pool);
+    checkIdentical(ref, test);
+
+    const auto* ec = Blocks::get(test.data());
+    BOOST_CHECK_EQUAL(ec->getHeader().run, 1u);
+    BOOST_CHECK_EQUAL(ec->getHeader().firstOrbit, 2u);
+    Columns dec;
+    std::vector<std::function<void()>> tasks;
+    tasks.emplace_back([&]() { ec->decode(dec.small, SMALL); });
+    tasks.emplace_back([&]() { ec->decode(dec.wide, WIDE, &wideDecoder); });
+    tasks.emplace_back([&]() { ec->decode(dec.empty, EMPTY); });
+    tasks.emplace_back([&]() { ec->decode(dec.raw, RAW); });
+    tasks.emplace_back([&]() { ec->decode(dec.large, LARGE); });
+    tasks.emplace_back([&]() { ec->decode(dec.single, SINGLE); });
+    pool.run(tasks);
+    BOOST_CHECK(dec.small == cols.small);
+    BOOST_CHECK(dec.wide == cols.wide);
+    BOOST_CHECK(dec.empty.empty());
+    BOOST_CHECK(dec.raw == cols.raw);
+    BOOST_CHECK(dec.large == cols.large);
+    BOOST_CHECK(dec.single == cols.single);
+  }
+}
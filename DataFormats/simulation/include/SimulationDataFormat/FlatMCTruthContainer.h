@@ -0,0 +1,251 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatMCTruthContainer.h
+/// \brief Append-only MC truth container filled directly in the flat layout of ConstMCTruthContainer
+
+#ifndef O2_FLATMCTRUTHCONTAINER_H
+#define O2_FLATMCTRUTHCONTAINER_H
+
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace dataformats
+{
+
+/// @class FlatMCTruthContainer
+/// @brief Append-only MC truth container keeping the labels in a single contiguous buffer
+///
+/// The buffer is made of the FlatHeader of the MCTruthContainer followed by the region of header
+/// elements and the region of truth elements. While the container is filled, both regions have a
+/// capacity which can be reserved beforehand, such that neither the addition of labels nor the merging
+/// of other containers leads to a reallocation. The merging copies once the labels of the merged
+/// container, while the header elements are shifted by the number of labels already stored.
+/// After finalize(), which moves the labels region right after the header elements in place, the
+/// buffer has exactly the layout of ConstMCTruthContainer: it can be sent as is through DPL when
+/// the buffer is the one of the output (e.g. obtained with make<ConstMCTruthContainer<T>>), written
+/// to a file and memory-mapped with MCTruthMappedFile.
+template <typename TruthElement>
+class FlatMCTruthContainer
+{
+ public:
+  using FlatHeader = typename MCTruthContainer<TruthElement>::FlatHeader;
+  using View = ConstMCTruthContainerView<TruthElement>;
+
+  /// create the container in the provided buffer (e.g. the DPL output) or in its own buffer if nullptr
+  explicit FlatMCTruthContainer(std::vector<char>* buffer = nullptr) : mBuffer(buffer ? buffer : &mOwnBuffer)
+  {
+    mBuffer->clear();
+  }
+  FlatMCTruthContainer(const FlatMCTruthContainer&) = delete;
+  FlatMCTruthContainer& operator=(const FlatMCTruthContainer&) = delete;
+
+  /// reserve the space for nIndexed data entries with nElements labels in total
+  void reserve(size_t nIndexed, size_t nElements)
+  {
+    if (mBuffer->size() >= sizeof(FlatHeader) && nIndexed <= mHeaderCapacity && nElements <= mTruthCapacity) {
+      return;
+    }
+    nIndexed = std::max(nIndexed, mHeaderCapacity);
+    nElements = std::max(nElements, mTruthCapacity);
+    bool empty = mBuffer->size() < sizeof(FlatHeader);
+    auto truthOffsetOld = getTruthOffset(mHeaderCapacity);
+    mBuffer->resize(getTruthOffset(nIndexed) + nElements * sizeof(TruthElement));
+    if (empty) {
+      new (mBuffer->data()) FlatHeader{};
+      getFlatHeader().nofHeaderElements = 0;
+      getFlatHeader().nofTruthElements = 0;
+    } else if (nIndexed > mHeaderCapacity && getNElements()) { // labels region is moved to leave space for the headers
+      std::memmove(mBuffer->data() + getTruthOffset(nIndexed), mBuffer->data() + truthOffsetOld, getNElements() * sizeof(TruthElement));
+    }
+    mHeaderCapacity = nIndexed;
+    mTruthCapacity = nElements;
+  }
+
+  /// add label for the dataindex, which must be the last one or a new one as in the MCTruthContainer
+  void addElement(uint32_t dataindex, TruthElement const& element)
+  {
+    auto nHeaders = getIndexedSize();
+    if (dataindex < nHeaders) {
+      if (dataindex != nHeaders - 1) {
+        throw std::runtime_error("FlatMCTruthContainer: unsupported code path");
+      }
+      grow(nHeaders, getNElements() + 1);
+    } else {
+      grow(dataindex + 1, getNElements() + 1);
+      for (auto i = nHeaders; i <= dataindex; i++) { // holes point to the next label as in the MCTruthContainer
+        getHeaderStart()[i] = MCTruthHeaderElement(getNElements());
+      }
+      getFlatHeader().nofHeaderElements = dataindex + 1;
+    }
+    std::memcpy(getTruthStart() + getNElements(), &element, sizeof(TruthElement));
+    getFlatHeader().nofTruthElements++;
+  }
+
+  template <typename CompatibleLabel>
+  void addElements(uint32_t dataindex, gsl::span<CompatibleLabel> elements)
+  {
+    for (auto& e : elements) {
+      addElement(dataindex, e);
+    }
+  }
+
+  /// append the labels of a flat container (e.g. incoming message or mapped file)
+  void mergeAtBack(View other)
+  {
+    if (!other.getIndexedSize()) {
+      return;
+    }
+    const auto* truth = reinterpret_cast<const TruthElement*>(other.getBuffer().data() + getTruthOffset(other.getIndexedSize()));
+    append(&other.getMCTruthHeader(0), other.getIndexedSize(), truth, other.getNElements());
+  }
+
+  /// append the labels of a MCTruthContainer
+  void mergeAtBack(MCTruthContainer<TruthElement> const& other)
+  {
+    if (!other.getIndexedSize()) {
+      return;
+    }
+    append(&other.getMCTruthHeader(0), other.getIndexedSize(), other.getTruthArray().data(), other.getNElements());
+  }
+
+  /// bring the buffer in place to the layout of ConstMCTruthContainer and release the unused capacity
+  View finalize()
+  {
+    reserve(0, 0); // make sure there is a valid header even for an empty container
+    if (mHeaderCapacity > getIndexedSize() && getNElements()) {
+      std::memmove(mBuffer->data() + getTruthOffset(getIndexedSize()), mBuffer->data() + getTruthOffset(mHeaderCapacity), getNElements() * sizeof(TruthElement));
+    }
+    mHeaderCapacity = getIndexedSize();
+    mTruthCapacity = getNElements();
+    mBuffer->resize(getTruthOffset(mHeaderCapacity) + mTruthCapacity * sizeof(TruthElement));
+    mBuffer->shrink_to_fit();
+    return View(gsl::span<const char>(mBuffer->data(), mBuffer->size()));
+  }
+
+  void clear()
+  {
+    if (mBuffer->size() >= sizeof(FlatHeader)) {
+      getFlatHeader().nofHeaderElements = 0;
+      getFlatHeader().nofTruthElements = 0;
+    }
+  }
+
+  // return the number of original data indexed here
+  size_t getIndexedSize() const { return mBuffer->size() >= sizeof(FlatHeader) ? getFlatHeader().nofHeaderElements : 0; }
+
+  // return the number of labels managed in this container
+  size_t getNElements() const { return mBuffer->size() >= sizeof(FlatHeader) ? getFlatHeader().nofTruthElements : 0; }
+
+  MCTruthHeaderElement const& getMCTruthHeader(uint32_t dataindex) const { return getHeaderStart()[dataindex]; }
+
+  gsl::span<const TruthElement> getLabels(uint32_t dataindex) const
+  {
+    if (dataindex >= getIndexedSize()) {
+      return gsl::span<const TruthElement>();
+    }
+    auto start = getMCTruthHeader(dataindex).index;
+    auto end = dataindex + 1 < getIndexedSize() ? getMCTruthHeader(dataindex + 1).index : getNElements();
+    return gsl::span<const TruthElement>(getTruthStart() + start, end - start);
+  }
+
+  /// size of the allocated buffer in bytes
+  size_t getBufferCapacity() const { return mBuffer->capacity(); }
+
+ private:
+  static size_t getTruthOffset(size_t nHeaders) { return sizeof(FlatHeader) + nHeaders * sizeof(MCTruthHeaderElement); }
+
+  FlatHeader& getFlatHeader() { return *reinterpret_cast<FlatHeader*>(mBuffer->data()); }
+  FlatHeader const& getFlatHeader() const { return *reinterpret_cast<FlatHeader const*>(mBuffer->data()); }
+  MCTruthHeaderElement* getHeaderStart() { return reinterpret_cast<MCTruthHeaderElement*>(mBuffer->data() + sizeof(FlatHeader)); }
+  MCTruthHeaderElement const* getHeaderStart() const { return reinterpret_cast<MCTruthHeaderElement const*>(mBuffer->data() + sizeof(FlatHeader)); }
+  TruthElement* getTruthStart() { return reinterpret_cast<TruthElement*>(mBuffer->data() + getTruthOffset(mHeaderCapacity)); }
+  TruthElement const* getTruthStart() const { return reinterpret_cast<TruthElement const*>(mBuffer->data() + getTruthOffset(mHeaderCapacity)); }
+
+  /// make sure there is a space for nIndexed headers and nElements labels, increasing the capacity geometrically
+  void grow(size_t nIndexed, size_t nElements)
+  {
+    if (mBuffer->size() >= sizeof(FlatHeader) && nIndexed <= mHeaderCapacity && nElements <= mTruthCapacity) {
+      return;
+    }
+    reserve(nIndexed > mHeaderCapacity ? std::max(nIndexed, 2 * mHeaderCapacity) : mHeaderCapacity,
+            nElements > mTruthCapacity ? std::max(nElements, 2 * mTruthCapacity) : mTruthCapacity);
+  }
+
+  void append(const MCTruthHeaderElement* headers, size_t nHeaders, const TruthElement* truth, size_t nTruth)
+  {
+    auto nHeadersOld = getIndexedSize(), nTruthOld = getNElements();
+    grow(nHeadersOld + nHeaders, nTruthOld + nTruth);
+    auto* headersDest = getHeaderStart() + nHeadersOld;
+    for (size_t i = 0; i < nHeaders; i++) {
+      headersDest[i].index = headers[i].index + nTruthOld;
+    }
+    std::memcpy(getTruthStart() + nTruthOld, truth, nTruth * sizeof(TruthElement));
+    getFlatHeader().nofHeaderElements = nHeadersOld + nHeaders;
+    getFlatHeader().nofTruthElements = nTruthOld + nTruth;
+  }
+
+  std::vector<char> mOwnBuffer; ///< buffer used if no external one is provided
+  std::vector<char>* mBuffer;   ///< buffer with the flat header, the headers region and the labels region
+  size_t mHeaderCapacity = 0;   ///< number of headers fitting before the labels region
+  size_t mTruthCapacity = 0;    ///< number of labels fitting in the labels region
+};
+
+/// @class MCTruthMappedFile
+/// @brief Read-only memory mapping of a file with the flat labels buffer, created w/o ROOT by write
+class MCTruthMappedFile
+{
+ public:
+  explicit MCTruthMappedFile(const std::string& fileName);
+  ~MCTruthMappedFile();
+  MCTruthMappedFile(const MCTruthMappedFile&) = delete;
+  MCTruthMappedFile& operator=(const MCTruthMappedFile&) = delete;
+
+  bool isMapped() const { return mData != nullptr; }
+  gsl::span<const char> getBuffer() const { return gsl::span<const char>(mData, mSize); }
+
+  /// view of the labels, throws if the file does not contain labels of this type
+  template <typename TruthElement>
+  ConstMCTruthContainerView<TruthElement> getView() const
+  {
+    using FlatHeader = typename MCTruthContainer<TruthElement>::FlatHeader;
+    if (!isMapped()) {
+      return ConstMCTruthContainerView<TruthElement>();
+    }
+    const auto* flatheader = reinterpret_cast<const FlatHeader*>(mData);
+    if (mSize < sizeof(FlatHeader) || flatheader->sizeofHeaderElement != sizeof(MCTruthHeaderElement) || flatheader->sizeofTruthElement != sizeof(TruthElement)) {
+      throw std::runtime_error("member element sizes don't match");
+    }
+    if (mSize < sizeof(FlatHeader) + sizeof(MCTruthHeaderElement) * flatheader->nofHeaderElements + sizeof(TruthElement) * flatheader->nofTruthElements) {
+      throw std::runtime_error("inconsistent buffer size: too small");
+    }
+    return ConstMCTruthContainerView<TruthElement>(getBuffer());
+  }
+
+  /// write the flat labels buffer (ConstMCTruthContainer layout) to the file
+  static bool write(const std::string& fileName, gsl::span<const char> buffer);
+
+ private:
+  const char* mData = nullptr;
+  size_t mSize = 0;
+};
+
+} // namespace dataformats
+} // namespace o2
+
+#endif
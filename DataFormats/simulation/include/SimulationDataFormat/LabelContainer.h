@@ -205,6 +205,9 @@ class LabelContainer
     mLabelArray.clear();
   }
 
+  /// memory allocated for the headers and the labels, in bytes
+  size_t getAllocatedSize() const { return mHeaderArray.capacity() * sizeof(HeaderElement) + mLabelArray.capacity() * sizeof(StoredLabelType); }
+
   /// add a label for a dataindex
   void addLabel(unsigned int dataindex, LabelType const& label)
   {
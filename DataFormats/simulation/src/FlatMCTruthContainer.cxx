@@ -0,0 +1,61 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatMCTruthContainer.cxx
+/// \brief Memory mapping of the flat MC truth labels files
+
+#include "SimulationDataFormat/FlatMCTruthContainer.h"
+#include "FairLogger.h"
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace o2::dataformats;
+
+MCTruthMappedFile::MCTruthMappedFile(const std::string& fileName)
+{
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(error) << "Could not open MC truth file " << fileName;
+    return;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr != MAP_FAILED) {
+      mData = static_cast<const char*>(ptr);
+      mSize = st.st_size;
+    } else {
+      LOG(error) << "Could not map MC truth file " << fileName;
+    }
+  }
+  ::close(fd); // the mapping stays valid
+}
+
+MCTruthMappedFile::~MCTruthMappedFile()
+{
+  if (mData) {
+    ::munmap(const_cast<char*>(mData), mSize);
+  }
+}
+
+bool MCTruthMappedFile::write(const std::string& fileName, gsl::span<const char> buffer)
+{
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out.write(buffer.data(), buffer.size());
+  if (!out.good()) {
+    LOG(error) << "Could not write MC truth file " << fileName;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchMCTruthContainer.cxx
+/// \brief Benchmark of the merging of per-event label chunks into the flat buffer to be sent
+///
+/// The MCTruthContainer chunks are merged with mergeAtBack and flattened to the ConstMCTruthContainer,
+/// as done by the digitizers, and compared with the FlatMCTruthContainer filled directly in the output
+/// buffer. The "residentMB" counter gives the memory held at the end of the merging: accumulated vectors
+/// plus the flat buffer for the former, the flat buffer only for the latter.
+/// The Pb-Pb TF case corresponds to ~1000 collisions with O(10^4) labelled digits each.
+
+#include <benchmark/benchmark.h>
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/FlatMCTruthContainer.h"
+#include <random>
+#include <vector>
+
+using namespace o2::dataformats;
+using Label = o2::MCCompLabel;
+
+namespace
+{
+constexpr int NChunks = 1000;
+
+// per event chunks, on average 1.5 labels per entry
+std::vector<MCTruthContainer<Label>> createChunks(int nChunks, int nEntries)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> nLabDist(1, 2), trackDist(0, 10000);
+  std::vector<MCTruthContainer<Label>> chunks(nChunks);
+  for (int ic = 0; ic < nChunks; ic++) {
+    for (int i = 0; i < nEntries; i++) {
+      for (int il = nLabDist(gen); il--;) {
+        chunks[ic].addElement(i, Label(trackDist(gen), ic, 0));
+      }
+    }
+  }
+  return chunks;
+}
+
+double toMB(size_t bytes) { return bytes / 1024. / 1024.; }
+} // namespace
+
+static void BM_MergeMCTruthContainer(benchmark::State& state)
+{
+  const auto chunks = createChunks(NChunks, state.range(0));
+  size_t resident = 0;
+  for (auto _ : state) {
+    MCTruthContainer<Label> accum;
+    ConstMCTruthContainer<Label> output;
+    for (const auto& chunk : chunks) {
+      accum.mergeAtBack(chunk);
+    }
+    accum.flatten_to(output);
+    benchmark::DoNotOptimize(output.data());
+    // the header array capacity is not exposed, its size is a lower bound
+    resident = accum.getTruthArray().capacity() * sizeof(Label) + accum.getIndexedSize() * sizeof(MCTruthHeaderElement) + output.capacity();
+  }
+  state.counters["residentMB"] = toMB(resident);
+  state.SetItemsProcessed(state.iterations() * NChunks);
+}
+
+static void BM_MergeFlatMCTruthContainer(benchmark::State& state)
+{
+  const auto chunks = createChunks(NChunks, state.range(0));
+  size_t resident = 0;
+  for (auto _ : state) {
+    ConstMCTruthContainer<Label> output;
+    FlatMCTruthContainer<Label> accum(&output);
+    size_t nIndexed = 0, nElements = 0;
+    for (const auto& chunk : chunks) {
+      nIndexed += chunk.getIndexedSize();
+      nElements += chunk.getNElements();
+    }
+    accum.reserve(nIndexed, nElements);
+    for (const auto& chunk : chunks) {
+      accum.mergeAtBack(chunk);
+    }
+    benchmark::DoNotOptimize(accum.finalize().getBuffer().data());
+    resident = output.capacity();
+  }
+  state.counters["residentMB"] = toMB(resident);
+  state.SetItemsProcessed(state.iterations() * NChunks);
+}
+
+static void BM_MergeFlatMCTruthContainerNoReserve(benchmark::State& state)
+{
+  const auto chunks = createChunks(NChunks, state.range(0));
+  size_t resident = 0;
+  for (auto _ : state) {
+    ConstMCTruthContainer<Label> output;
+    FlatMCTruthContainer<Label> accum(&output);
+    for (const auto& chunk : chunks) {
+      accum.mergeAtBack(chunk);
+    }
+    benchmark::DoNotOptimize(accum.finalize().getBuffer().data());
+    resident = output.capacity();
+  }
+  state.counters["residentMB"] = toMB(resident);
+  state.SetItemsProcessed(state.iterations() * NChunks);
+}
+
+// pp-like chunks and Pb-Pb TF
+BENCHMARK(BM_MergeMCTruthContainer)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MergeFlatMCTruthContainer)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MergeFlatMCTruthContainerNoReserve)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -15,9 +15,11 @@
 #include <boost/test/unit_test.hpp>
 #include "SimulationDataFormat/MCCompLabel.h"
 #include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/FlatMCTruthContainer.h"
 #include "SimulationDataFormat/LabelContainer.h"
 #include "SimulationDataFormat/IOMCTruthContainerView.h"
 #include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <TFile.h>
 #include <TTree.h>
@@ -200,6 +202,90 @@ BOOST_AUTO_TEST_CASE(MCTruthContainer_flatten)
   BOOST_CHECK(cc.getLabels(2)[0] == 10);
 }
 
+BOOST_AUTO_TEST_CASE(FlatMCTruthContainer_merge)
+{
+  using TruthElement = long;
+  using TruthContainer = dataformats::MCTruthContainer<TruthElement>;
+  TruthContainer container, container2;
+  container.addElement(0, TruthElement(1));
+  container.addElement(0, TruthElement(2));
+  container.addElement(2, TruthElement(10)); // with a hole
+  container2.addElement(0, TruthElement(20));
+  container2.addElement(1, TruthElement(21));
+  container2.addElement(1, TruthElement(22));
+
+  // reference
+  TruthContainer merged;
+  merged.mergeAtBack(container);
+  merged.mergeAtBack(container2);
+  dataformats::ConstMCTruthContainer<TruthElement> flatContainer2, reference;
+  container2.flatten_to(flatContainer2);
+  merged.flatten_to(reference);
+
+  // filling in the external buffer w/o reserving beforehand, from MCTruthContainer, flat view and single elements
+  dataformats::ConstMCTruthContainer<TruthElement> buffer;
+  dataformats::FlatMCTruthContainer<TruthElement> flat(&buffer);
+  flat.mergeAtBack(container);
+  flat.mergeAtBack(dataformats::ConstMCTruthContainerView<TruthElement>(flatContainer2));
+  flat.addElement(5, TruthElement(30));
+  flat.addElement(5, TruthElement(31));
+  BOOST_CHECK_THROW(flat.addElement(4, TruthElement(0)), std::runtime_error);
+  merged.addElement(5, TruthElement(30));
+  merged.addElement(5, TruthElement(31));
+  merged.flatten_to(reference);
+
+  auto view = flat.finalize();
+  BOOST_CHECK(buffer == reference);
+  BOOST_CHECK_EQUAL(flat.getBufferCapacity(), buffer.size());
+  BOOST_CHECK_EQUAL(view.getIndexedSize(), merged.getIndexedSize());
+  BOOST_CHECK_EQUAL(buffer.getNElements(), merged.getNElements());
+  for (uint32_t i = 0; i < merged.getIndexedSize(); i++) {
+    auto labels = buffer.getLabels(i), labelsRef = merged.getLabels(i);
+    BOOST_CHECK_EQUAL_COLLECTIONS(labels.begin(), labels.end(), labelsRef.begin(), labelsRef.end());
+  }
+
+  // with the space reserved the buffer is not reallocated
+  dataformats::FlatMCTruthContainer<TruthElement> flatReserved;
+  flatReserved.reserve(merged.getIndexedSize(), merged.getNElements());
+  auto capacity = flatReserved.getBufferCapacity();
+  flatReserved.mergeAtBack(view);
+  BOOST_CHECK_EQUAL(flatReserved.getBufferCapacity(), capacity);
+  BOOST_CHECK_EQUAL(flatReserved.getLabels(5).size(), 2);
+  BOOST_CHECK_EQUAL(flatReserved.getLabels(5)[1], 31);
+
+  // empty container is a valid flat buffer as well
+  dataformats::ConstMCTruthContainer<TruthElement> emptyBuffer;
+  dataformats::FlatMCTruthContainer<TruthElement> empty(&emptyBuffer);
+  empty.finalize();
+  BOOST_CHECK_EQUAL(emptyBuffer.size(), sizeof(TruthContainer::FlatHeader));
+  BOOST_CHECK_EQUAL(emptyBuffer.getIndexedSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMCTruthContainer_mapped)
+{
+  using TruthElement = o2::MCCompLabel;
+  dataformats::MCTruthContainer<TruthElement> container;
+  for (int i = 0; i < 100; i++) {
+    container.addElement(i, TruthElement(i, 1, 2));
+    container.addElement(i, TruthElement(i + 1, 1, 2));
+  }
+  dataformats::ConstMCTruthContainer<TruthElement> buffer;
+  container.flatten_to(buffer);
+  std::string fileName = "testFlatMCTruth.bin";
+  BOOST_REQUIRE(dataformats::MCTruthMappedFile::write(fileName, buffer));
+  {
+    dataformats::MCTruthMappedFile mapped(fileName);
+    BOOST_REQUIRE(mapped.isMapped());
+    auto view = mapped.getView<TruthElement>();
+    BOOST_CHECK_EQUAL(view.getIndexedSize(), container.getIndexedSize());
+    BOOST_CHECK_EQUAL(view.getNElements(), container.getNElements());
+    BOOST_CHECK(view.getLabels(99)[1] == TruthElement(100, 1, 2));
+    // the type of the labels is validated
+    BOOST_CHECK_THROW(mapped.getView<int>(), std::runtime_error);
+  }
+  std::remove(fileName.c_str());
+}
+
 BOOST_AUTO_TEST_CASE(LabelContainer_noncont)
 {
   using TruthElement = long;
@@ -23,6 +23,7 @@
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "CommonUtils/ThreadPool.h"
 #include "rANS/rans.h"
 #include <filesystem>
 
@@ -63,9 +64,12 @@ class CTFCoderBase
     }
 
     switch (op) {
-      case OpType::Encoder:
-        mCoders[slot].reset(new o2::rans::LiteralEncoder64<S>(renormedFrequencyTable));
+      case OpType::Encoder: {
+        auto encoder = new o2::rans::LiteralEncoder64<S>(renormedFrequencyTable);
+        encoder->setNStreams(mANSNStreams);
+        mCoders[slot].reset(encoder);
         break;
+      }
       case OpType::Decoder:
         mCoders[slot].reset(new o2::rans::LiteralDecoder64<S>(renormedFrequencyTable));
         break;
@@ -82,6 +86,18 @@ class CTFCoderBase
   void setMemMarginFactor(float v) { mMemMarginFactor = v > 1.f ? v : 1.f; }
   float getMemMarginFactor() const { return mMemMarginFactor; }
 
+  /// number of interleaved rANS streams used by the encoders, must be set before the coders are created
+  void setANSNStreams(int n)
+  {
+    o2::rans::internal::checkNStreams(n);
+    mANSNStreams = n;
+  }
+  int getANSNStreams() const { return mANSNStreams; }
+
+  /// number of threads used to encode/decode the blocks of a CTF concurrently
+  void setNThreads(int n);
+  int getNThreads() const { return mThreadPool ? mThreadPool->getNThreads() : 1; }
+
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
@@ -99,10 +115,15 @@ class CTFCoderBase
 
   void checkDictVersion(const CTFDictHeader& h) const;
 
+  /// execute independent per-block encoding/decoding tasks, concurrently if more than 1 thread was requested
+  void runBlockTasks(const std::vector<std::function<void()>>& tasks) const;
+
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
   DetID mDet;
   CTFDictHeader mExtHeader;      // external dictionary header
   float mMemMarginFactor = 1.0f; // factor for memory allocation in EncodedBlocks
+  int mANSNStreams = o2::rans::internal::DefaultNStreams; // number of interleaved rANS streams of the encoders
+  std::shared_ptr<o2::utils::ThreadPool> mThreadPool;     // workers for concurrent encoding/decoding of the blocks
   int mVerbosity = 0;
 };
 
@@ -288,6 +288,52 @@ TBranch* getOrMakeBranch(TTree& tree, const char* brname, T* ptr)
   return tree.Branch(brname, ptr);
 }
 
+// Pool of hit containers recycled between the events by the hit merger. The released containers keep their
+// capacity (up to a limit), such that the buffering and merging of the sub-events does not need new allocations
+// in the steady state. The pool is shared by the threads collecting and merging the hits.
+template <typename T>
+class HitBufferPool
+{
+ public:
+  static HitBufferPool& Instance()
+  {
+    static HitBufferPool pool;
+    return pool;
+  }
+
+  std::unique_ptr<T> acquire()
+  {
+    std::lock_guard<std::mutex> guard(mMutex);
+    if (mFree.empty()) {
+      return std::make_unique<T>();
+    }
+    auto buffer = std::move(mFree.back());
+    mFree.pop_back();
+    return buffer;
+  }
+
+  void release(std::unique_ptr<T> buffer)
+  {
+    if (!buffer) {
+      return;
+    }
+    buffer->clear();
+    if (buffer->capacity() * sizeof(typename T::value_type) > MaxPooledBytes) {
+      return; // don't keep memory of exceptionally large events
+    }
+    std::lock_guard<std::mutex> guard(mMutex);
+    if (mFree.size() < MaxPooled) {
+      mFree.push_back(std::move(buffer));
+    }
+  }
+
+ private:
+  static constexpr size_t MaxPooled = 32;
+  static constexpr size_t MaxPooledBytes = 64 * 1024 * 1024;
+  std::mutex mMutex;
+  std::vector<std::unique_ptr<T>> mFree;
+};
+
 // a trait to determine if we should use shared mem or serialize using TMessage
 template <typename Det>
 struct UseShm {
@@ -429,9 +475,10 @@ class DetImpl : public o2::base::Detector
                           std::vector<int> const& subevtsOrdered)
   {
     auto entries = hitbuffervector.size();
+    auto& pool = HitBufferPool<T>::Instance();
 
-    auto targetdata = new T;  // used to collect data inside a single container
-    T* filladdress = nullptr; // pointer used for final ROOT IO
+    std::unique_ptr<T> targetdata; // used to collect data inside a single container
+    T* filladdress = nullptr;      // pointer used for final ROOT IO
     if (entries == 1) {
       filladdress = hitbuffervector[0].get();
       // nothing to do; we can directly do IO from the existing buffer
@@ -445,7 +492,8 @@ class DetImpl : public o2::base::Detector
       int idelta0 = 0;
       // offset for secondary track index
       int idelta1 = nprimTot;
-      filladdress = targetdata;
+      targetdata = pool.acquire();
+      filladdress = targetdata.get();
       for (int entry = entries - 1; entry >= 0; --entry) {
         // proceed in the order of subevent Ids
         int index = subevtsOrdered[entry];
@@ -476,10 +524,13 @@ class DetImpl : public o2::base::Detector
     targetbr->SetAddress(&filladdress);
     targetbr->Fill();
     targetbr->ResetAddress();
-    targetdata->clear();
+    // give the buffers back for the next events
+    pool.release(std::move(targetdata));
+    for (auto& buffer : hitbuffervector) {
+      pool.release(std::move(buffer));
+    }
     hitbuffervector.clear();
     hitbuffervector = L(); // swap with empty vector to release mem
-    delete targetdata;
   }
 
   void mergeHitEntries(TTree& origin, TTree& target, std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevtsOrdered) final
@@ -540,7 +591,8 @@ class DetImpl : public o2::base::Detector
     using HitPtr_t = decltype(static_cast<Det*>(this)->Det::getHits(probe));
     std::string name = static_cast<Det*>(this)->getHitBranchNames(probe);
 
-    auto copyToBuffer = [this, eventID](HitPtr_t hitdata, Collector_t& collectbuffer, int probe) {
+    // hits decoded from the message are adopted by the buffer, those in shared memory are copied to a pooled container
+    auto copyToBuffer = [this, eventID](HitPtr_t hitdata, Collector_t& collectbuffer, int probe, bool adopt) {
       std::vector<std::vector<std::unique_ptr<Hit_t>>>* hitvector = nullptr;
       {
         auto eventIter = collectbuffer.find(eventID);
@@ -554,8 +606,12 @@ class DetImpl : public o2::base::Detector
       if (probe >= hitvector->size()) {
         hitvector->resize(probe + 1);
       }
+      if (adopt) {
+        (*hitvector)[probe].emplace_back(hitdata);
+        return;
+      }
       // add empty hit bucket to list for this event and probe
-      (*hitvector)[probe].emplace_back(new Hit_t());
+      (*hitvector)[probe].emplace_back(HitBufferPool<Hit_t>::Instance().acquire());
       // copy the data into this bucket
       *((*hitvector)[probe].back()) = *hitdata;
     };
@@ -565,15 +621,14 @@ class DetImpl : public o2::base::Detector
         // for each branch name we extract/decode hits from the message parts ...
         auto hitsptr = decodeTMessage<HitPtr_t>(parts, index++);
         if (hitsptr) {
-          // ... and copy them to the buffer
-          copyToBuffer(hitsptr, hitcollector, probe);
-          delete hitsptr;
+          // ... and move them to the buffer
+          copyToBuffer(hitsptr, hitcollector, probe, true);
         }
       } else {
         // for each branch name we extract/decode hits from the message parts ...
         auto hitsptr = decodeShmMessage<HitPtr_t>(parts, index++, busy);
         // ... and copy them to the buffer
-        copyToBuffer(hitsptr, hitcollector, probe);
+        copyToBuffer(hitsptr, hitcollector, probe, false);
       }
       // next name
       probe++;
@@ -79,6 +79,13 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   static MatLayerCylSet* loadFromFile(const std::string& inpFName = "matbud.root");
   static MatLayerCylSet* rectifyPtrFromFile(MatLayerCylSet* ptr);
 
+  // raw format: image of the flat buffer which is memory-mapped and used in place, w/o deserialization
+  bool writeRawFile(const std::string& outFName = "matbud.bin") const;
+  // the objects mapped from the same file share its read-only mapping, kept until the end of the process: they do not
+  // own their buffer and must not be modified. The file must be replaced (not rewritten in place) while it is mapped
+  static MatLayerCylSet* mapRawFile(const std::string& inpFName = "matbud.bin");
+  static bool isRawFile(const std::string& inpFName);
+
   void flatten();
 
 #endif // !GPUCA_ALIGPUCODE
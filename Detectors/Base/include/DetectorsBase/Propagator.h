@@ -26,6 +26,7 @@
 
 #ifndef GPUCA_GPUCODE
 #include <string>
+#include "DetectorsBase/TrackParCovBatch.h"
 #endif
 
 namespace o2
@@ -115,6 +116,14 @@ class PropagatorImpl
                                    gpu::gpustd::array<value_type, 2>* dca = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
                                    int signCorr = 0, value_type maxD = 999.f) const;
 
+#ifndef GPUCA_GPUCODE
+  /// batched version of propagateToX for the tracks of the batch, returns the number of successfully propagated tracks.
+  /// Failed tracks are flagged in the batch and left in the state reached at the failure, as in the scalar version.
+  int propagateToX(TrackParCovBatch<value_type>& batch, value_type x, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   int signCorr = 0) const;
+#endif
+
   PropagatorImpl(PropagatorImpl const&) = delete;
   PropagatorImpl(PropagatorImpl&&) = delete;
   PropagatorImpl& operator=(PropagatorImpl const&) = delete;
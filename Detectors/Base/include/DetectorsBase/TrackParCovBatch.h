@@ -0,0 +1,123 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TrackParCovBatch.h
+/// \brief Structure-of-arrays representation of a set of tracks with covariance, for batched propagation
+
+#ifndef ALICEO2_BASE_TRACKPARCOVBATCH_H
+#define ALICEO2_BASE_TRACKPARCOVBATCH_H
+
+#include "ReconstructionDataFormats/Track.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+
+/// Set of TrackParametrizationWithError stored as structure of arrays, such that the propagation
+/// of the whole set can be done in loops over contiguous arrays (see PropagatorImpl::propagateToX).
+/// The alpha frame, charge and PID of the tracks are not modified by the propagation.
+template <typename value_T>
+struct TrackParCovBatch {
+  using value_type = value_T;
+  using TrackParCov_t = o2::track::TrackParametrizationWithError<value_type>;
+
+  std::vector<value_type> x;                                     ///< X in the tracking frame
+  std::vector<value_type> alpha;                                 ///< tracking frame angle
+  std::vector<value_type> cosAlp;                                ///< cos of alpha
+  std::vector<value_type> sinAlp;                                ///< sin of alpha
+  std::array<std::vector<value_type>, o2::track::kNParams> par;    ///< track parameters, par[kY][i] etc.
+  std::array<std::vector<value_type>, o2::track::kCovMatSize> cov; ///< covariance matrix elements, cov[kSigY2][i] etc.
+  std::vector<value_type> mass;                                  ///< mass of the PID hypothesis
+  std::vector<value_type> mass2;                                 ///< mass^2 of the PID hypothesis
+  std::vector<uint8_t> absCharge;                                ///< absolute charge
+  std::vector<uint8_t> ok;                                       ///< false if the last operation on the track failed
+
+  size_t size() const { return x.size(); }
+  bool isOK(size_t i) const { return ok[i]; }
+
+  void resize(size_t n)
+  {
+    x.resize(n);
+    alpha.resize(n);
+    cosAlp.resize(n);
+    sinAlp.resize(n);
+    for (auto& p : par) {
+      p.resize(n);
+    }
+    for (auto& c : cov) {
+      c.resize(n);
+    }
+    mass.resize(n);
+    mass2.resize(n);
+    absCharge.resize(n);
+    ok.resize(n, 1);
+  }
+
+  void set(size_t i, const TrackParCov_t& trc)
+  {
+    x[i] = trc.getX();
+    alpha[i] = trc.getAlpha();
+    cosAlp[i] = std::cos(alpha[i]);
+    sinAlp[i] = std::sin(alpha[i]);
+    for (int j = 0; j < o2::track::kNParams; j++) {
+      par[j][i] = trc.getParam(j);
+    }
+    const auto& c = trc.getCov();
+    for (int j = 0; j < o2::track::kCovMatSize; j++) {
+      cov[j][i] = c[j];
+    }
+    mass[i] = trc.getPID().getMass();
+    mass2[i] = trc.getPID().getMass2();
+    absCharge[i] = trc.getAbsCharge();
+    ok[i] = 1;
+  }
+
+  /// update X, parameters and covariance of the track from the batch entry i
+  void get(size_t i, TrackParCov_t& trc) const
+  {
+    trc.setX(x[i]);
+    for (int j = 0; j < o2::track::kNParams; j++) {
+      trc.setParam(par[j][i], j);
+    }
+    for (int j = 0; j < o2::track::kCovMatSize; j++) {
+      trc.setCov(cov[j][i], j);
+    }
+  }
+
+  /// fill from any indexable container of tracks
+  template <typename C>
+  void load(const C& tracks)
+  {
+    resize(tracks.size());
+    for (size_t i = 0; i < tracks.size(); i++) {
+      set(i, tracks[i]);
+    }
+  }
+
+  /// copy back to the container of tracks used for the load
+  template <typename C>
+  void store(C& tracks) const
+  {
+    for (size_t i = 0; i < size(); i++) {
+      get(i, tracks[i]);
+    }
+  }
+};
+
+} // namespace base
+} // namespace o2
+
+#endif
@@ -25,3 +25,23 @@ void CTFCoderBase::checkDictVersion(const CTFDictHeader& h) const
     }
   }
 }
+
+void CTFCoderBase::setNThreads(int n)
+{
+  if (n > 1) {
+    mThreadPool = std::make_shared<o2::utils::ThreadPool>(n);
+  } else {
+    mThreadPool.reset();
+  }
+}
+
+void CTFCoderBase::runBlockTasks(const std::vector<std::function<void()>>& tasks) const
+{
+  if (mThreadPool) {
+    mThreadPool->run(tasks);
+  } else {
+    for (const auto& task : tasks) {
+      task();
+    }
+  }
+}
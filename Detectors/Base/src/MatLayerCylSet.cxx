@@ -20,6 +20,15 @@
 #include "GPUCommonLogger.h"
 #include <TFile.h>
 #include "CommonUtils/TreeStreamRedirector.h"
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 //#define _DBG_LOC_ // for local debugging only
 
 #endif // !GPUCA_ALIGPUCODE
@@ -172,6 +181,9 @@ void MatLayerCylSet::writeToFile(const std::string& outFName)
 //________________________________________________________________________________
 MatLayerCylSet* MatLayerCylSet::loadFromFile(const std::string& inpFName)
 {
+  if (isRawFile(inpFName)) {
+    return mapRawFile(inpFName);
+  }
   TFile inpf(inpFName.data());
   if (inpf.IsZombie()) {
     LOG(error) << "Failed to open input file " << inpFName;
@@ -195,6 +207,131 @@ MatLayerCylSet* MatLayerCylSet::rectifyPtrFromFile(MatLayerCylSet* ptr)
   return ptr;
 }
 
+namespace
+{
+// header of the raw mat.LUT file, the flat buffer follows it at mBufferOffset
+struct MatLUTRawHeader {
+  static constexpr char Magic[8] = {'O', '2', 'M', 'A', 'T', 'L', 'U', 'T'};
+  static constexpr uint32_t Version = 1;
+  static constexpr uint64_t BufferAlignment = 4096; // flat buffer starts at the page boundary
+
+  char mMagic[8] = {};
+  uint32_t mVersion = 0;
+  uint32_t mLayoutSize = 0; ///< sizeof(MatLayerCylSetLayout) of the writer
+  uint32_t mLayerSize = 0;  ///< sizeof(MatLayerCyl) of the writer
+  uint32_t mCellSize = 0;   ///< sizeof(MatCell) of the writer
+  uint64_t mBufferOffset = 0;
+  uint64_t mBufferSize = 0;
+
+  void init(uint64_t bufferSize)
+  {
+    std::memcpy(mMagic, Magic, sizeof(Magic));
+    mVersion = Version;
+    mLayoutSize = sizeof(MatLayerCylSetLayout);
+    mLayerSize = sizeof(MatLayerCyl);
+    mCellSize = sizeof(MatCell);
+    mBufferOffset = BufferAlignment;
+    mBufferSize = bufferSize;
+  }
+  bool isRaw() const { return std::memcmp(mMagic, Magic, sizeof(Magic)) == 0; }
+  // the buffer is used in place, hence the writer must have the same memory layout of the classes
+  bool isCompatible() const
+  {
+    return isRaw() && mVersion == Version && mLayoutSize == sizeof(MatLayerCylSetLayout) && mLayerSize == sizeof(MatLayerCyl) &&
+           mCellSize == sizeof(MatCell) && mBufferOffset >= sizeof(MatLUTRawHeader) && (mBufferOffset % MatLayerCylSet::getBufferAlignmentBytes()) == 0;
+  }
+};
+} // namespace
+
+//________________________________________________________________________________
+bool MatLayerCylSet::isRawFile(const std::string& inpFName)
+{
+  // check if the file is in the raw format
+  MatLUTRawHeader header;
+  std::ifstream inp(inpFName, std::ios::binary);
+  return inp.read(header.mMagic, sizeof(header.mMagic)) && header.isRaw();
+}
+
+//________________________________________________________________________________
+bool MatLayerCylSet::writeRawFile(const std::string& outFName) const
+{
+  /// store the flat buffer as it is, with the pointers replaced by the offsets wrt the buffer start
+  if (!isConstructed()) {
+    LOG(error) << "Only flattened mat.LUT can be stored in the raw format";
+    return false;
+  }
+  std::vector<char> buffer(getFlatBufferSize());
+  MatLayerCylSet tmp;
+  tmp.cloneFromObject(*this, buffer.data());
+  tmp.fixPointers(buffer.data(), nullptr, false); // relocate to the null base, the old pointers are still needed
+
+  MatLUTRawHeader header;
+  header.init(buffer.size());
+  std::vector<char> padding(header.mBufferOffset - sizeof(header), 0);
+  std::ofstream outf(outFName, std::ios::binary | std::ios::trunc);
+  outf.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outf.write(padding.data(), padding.size());
+  outf.write(buffer.data(), buffer.size());
+  if (!outf.good()) {
+    LOG(error) << "Failed to write mat.LUT to " << outFName;
+    return false;
+  }
+  return true;
+}
+
+//________________________________________________________________________________
+MatLayerCylSet* MatLayerCylSet::mapRawFile(const std::string& inpFName)
+{
+  /// Map the raw mat.LUT file and use its flat buffer in place. The mapping is private: relocating the offsets to
+  /// pointers touches only the pages with the layout and the layer headers, which are copied on write, while the
+  /// cells stay in the page cache shared by all processes mapping the same file.
+  /// All the loads of the same file in the process share one mapping, owned by this function and never unmapped:
+  /// the returned objects do not own their buffer and can be deleted at any time. The mapping is write-protected
+  /// after the relocation, since a modification through one object would be seen by all the others.
+  struct Mapping {
+    char* buffer = nullptr;
+    size_t size = 0;
+  };
+  static std::mutex mappingsMutex;
+  static std::unordered_map<std::string, Mapping> mappings;
+  std::lock_guard<std::mutex> guard(mappingsMutex);
+
+  auto mapping = mappings.find(inpFName);
+  if (mapping == mappings.end()) {
+    int fd = ::open(inpFName.c_str(), O_RDONLY);
+    if (fd < 0) {
+      LOG(error) << "Failed to open input file " << inpFName;
+      return nullptr;
+    }
+    MatLUTRawHeader header;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || ::pread(fd, &header, sizeof(header), 0) != sizeof(header) || !header.isCompatible() ||
+        uint64_t(st.st_size) < header.mBufferOffset + header.mBufferSize || header.mBufferSize < sizeof(MatLayerCylSetLayout)) {
+      LOG(error) << "File " << inpFName << " does not contain raw mat.LUT compatible with this build";
+      ::close(fd);
+      return nullptr;
+    }
+    void* ptr = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid
+    if (ptr == MAP_FAILED) {
+      LOG(error) << "Failed to map mat.LUT from " << inpFName;
+      return nullptr;
+    }
+    Mapping mp{static_cast<char*>(ptr) + header.mBufferOffset, header.mBufferSize};
+    MatLayerCylSet tmp;
+    tmp.mFlatBufferPtr = mp.buffer;
+    tmp.mFlatBufferSize = mp.size;
+    tmp.fixPointers(nullptr, mp.buffer); // offsets -> pointers, done once per mapping
+    ::mprotect(ptr, st.st_size, PROT_READ);
+    mapping = mappings.emplace(inpFName, mp).first;
+  }
+  auto* mb = new MatLayerCylSet();
+  mb->mFlatBufferPtr = mapping->second.buffer;
+  mb->mFlatBufferSize = mapping->second.size;
+  mb->mConstructionMask = Constructed;
+  return mb;
+}
+
 //________________________________________________________________________________
 void MatLayerCylSet::optimizePhiSlices(float maxRelDiff)
 {
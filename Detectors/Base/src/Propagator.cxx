@@ -16,6 +16,11 @@
 #include "GPUTPCGMPolynomialField.h"
 #include "MathUtils/Utils.h"
 #include "ReconstructionDataFormats/Vertex.h"
+#include "ReconstructionDataFormats/TrackUtils.h"
+#ifndef GPUCA_GPUCODE
+#include <initializer_list>
+#include <vector>
+#endif
 
 using namespace o2::base;
 using namespace o2::gpu;
@@ -620,6 +625,274 @@ GPUd() void PropagatorImpl<value_T>::estimateLTFast(o2::track::TrackLTIntegral&
   lt.addStep(length, trc.getP2Inv());
 }
 
+#ifndef GPUCA_GPUCODE
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateToX(TrackParCovBatch<value_type>& batch, value_type xToGo, value_type bZ, value_type maxSnp, value_type maxStep,
+                                          PropagatorImpl<value_T>::MatCorrType matCorr, int signCorr) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the tracks of the batch to the plane X=xk (cm) in the constant field bZ
+  // and corrects them for the crossed material, exactly as propagateToX for a single track.
+  //
+  // All tracks are advanced together step by step: at every step the parameters are updated, then
+  // the covariance matrices of the whole batch are transported in a branch-free loop over contiguous
+  // arrays (vectorizable by the compiler), the material budget is queried for all moved tracks and the
+  // material corrections are applied in a single pass.
+  //
+  // maxStep  - maximal step for propagation
+  // matCorr  - material correction type, it is up to the user to make sure the pointer is attached (if LUT is requested)
+  //----------------------------------------------------------------
+  using namespace o2::track;
+  constexpr value_type Epsilon = 0.00001;
+  constexpr value_type kMSConst2 = 0.0136f * 0.0136f;
+  constexpr value_type kMaxELossFrac = 0.3f; // max allowed fractional eloss
+  constexpr value_type kMinP = 0.01f;        // kill below this momentum
+  const auto n = batch.size();
+  auto& bx = batch.x;
+  auto &bY = batch.par[kY], &bZp = batch.par[kZ], &bSnp = batch.par[kSnp], &bTgl = batch.par[kTgl], &bQ2Pt = batch.par[kQ2Pt];
+  auto& cv = batch.cov;
+
+  std::vector<int8_t> sCorr(n);                              // sign of the e.loss correction
+  std::vector<uint8_t> moved(n);                             // track was moved at the current step
+  std::vector<double> f02(n), f04(n), f12(n), f13(n), f14(n), f24(n); // propagation jacobian, 0 for tracks not moved
+  std::vector<value_type> gx0, gy0, gz0;                     // global position before the step
+  std::vector<value_type> x2x0, xrho;                        // material crossed during the step
+  const bool useMat = matCorr != MatCorrType::USEMatCorrNONE;
+  if (useMat) {
+    gx0.resize(n);
+    gy0.resize(n);
+    gz0.resize(n);
+    x2x0.resize(n);
+    xrho.resize(n);
+  }
+  for (size_t i = 0; i < n; i++) {
+    int dir = xToGo - bx[i] > 0.f ? 1 : -1;
+    sCorr[i] = signCorr ? signCorr : -dir; // sign of eloss correction is not imposed
+  }
+
+  auto checkCovariance = [&cv](size_t i) {
+    auto limit = [&cv, i](int diag, value_type maxV, std::initializer_list<int> offDiag) {
+      cv[diag][i] = gpu::CAMath::Abs(cv[diag][i]);
+      if (cv[diag][i] > maxV) {
+        value_type scl = gpu::CAMath::Sqrt(maxV / cv[diag][i]);
+        cv[diag][i] = maxV;
+        for (auto j : offDiag) {
+          cv[j][i] *= scl;
+        }
+      }
+    };
+    limit(kSigY2, kCY2max, {kSigZY, kSigSnpY, kSigTglY, kSigQ2PtY});
+    limit(kSigZ2, kCZ2max, {kSigZY, kSigSnpZ, kSigTglZ, kSigQ2PtZ});
+    limit(kSigSnp2, kCSnp2max, {kSigSnpY, kSigSnpZ, kSigTglSnp, kSigQ2PtSnp});
+    limit(kSigTgl2, kCTgl2max, {kSigTglY, kSigTglZ, kSigTglSnp, kSigQ2PtTgl});
+    limit(kSigQ2Pt2, kC1Pt2max, {kSigQ2PtY, kSigQ2PtZ, kSigQ2PtSnp, kSigQ2PtTgl});
+  };
+
+  while (true) {
+    // parameters update, see TrackParametrizationWithError::propagateTo(x, bZ)
+    size_t nMoved = 0;
+    for (size_t i = 0; i < n; i++) {
+      f02[i] = f04[i] = f12[i] = f13[i] = f14[i] = f24[i] = 0.;
+      moved[i] = 0;
+      auto dxGo = xToGo - bx[i];
+      if (!batch.ok[i] || math_utils::detail::abs<value_type>(dxGo) <= Epsilon) {
+        continue;
+      }
+      auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dxGo), maxStep);
+      if (dxGo < 0) { // same as dir < 0 of the first step, the track never overshoots
+        step = -step;
+      }
+      value_type xk = bx[i] + step;
+      moved[i] = 1;
+      nMoved++;
+      if (useMat) {
+        gx0[i] = bx[i] * batch.cosAlp[i] - bY[i] * batch.sinAlp[i];
+        gy0[i] = bx[i] * batch.sinAlp[i] + bY[i] * batch.cosAlp[i];
+        gz0[i] = bZp[i];
+      }
+      value_type dx = xk - bx[i];
+      if (gpu::CAMath::Abs(dx) < constants::math::Almost0) {
+        continue;
+      }
+      value_type crv = batch.absCharge[i] ? bQ2Pt[i] * bZ * constants::math::B2C : 0.;
+      value_type x2r = crv * dx;
+      value_type f1 = bSnp[i], f2 = f1 + x2r;
+      if ((gpu::CAMath::Abs(f1) > constants::math::Almost1) || (gpu::CAMath::Abs(f2) > constants::math::Almost1)) {
+        batch.ok[i] = 0;
+        continue;
+      }
+      value_type r1 = gpu::CAMath::Sqrt((1.f - f1) * (1.f + f1));
+      value_type r2 = gpu::CAMath::Sqrt((1.f - f2) * (1.f + f2));
+      if (gpu::CAMath::Abs(r1) < constants::math::Almost0 || gpu::CAMath::Abs(r2) < constants::math::Almost0) {
+        batch.ok[i] = 0;
+        continue;
+      }
+      bx[i] = xk;
+      double dy2dx = (f1 + f2) / (r1 + r2);
+      value_type dY = dx * dy2dx, dZ;
+      if (gpu::CAMath::Abs(x2r) < 0.05f) {
+        dZ = dx * (r2 + f2 * dy2dx) * bTgl[i];
+      } else {
+        value_type rot = gpu::CAMath::ASin(r1 * f2 - r2 * f1);
+        if (f1 * f1 + f2 * f2 > 1.f && f1 * f2 < 0.f) {
+          rot = f2 > 0.f ? constants::math::PI - rot : -constants::math::PI - rot;
+        }
+        dZ = bTgl[i] / crv * rot;
+      }
+      bY[i] += dY;
+      bZp[i] += dZ;
+      bSnp[i] += x2r;
+
+      double rinv = 1. / r1;
+      double r3inv = rinv * rinv * rinv;
+      f24[i] = dx * bZ * constants::math::B2C;
+      f02[i] = dx * r3inv;
+      f04[i] = 0.5 * f24[i] * f02[i];
+      f12[i] = f02[i] * bTgl[i] * f1;
+      f14[i] = 0.5 * f24[i] * f12[i];
+      f13[i] = dx * rinv;
+    }
+    if (!nMoved) {
+      break;
+    }
+
+    // covariance transport F*C*Ft for the whole batch, no-op for the tracks with null jacobian
+    for (size_t i = 0; i < n; i++) {
+      value_type c20 = cv[kSigSnpY][i], c21 = cv[kSigSnpZ][i], c22 = cv[kSigSnp2][i], c30 = cv[kSigTglY][i], c31 = cv[kSigTglZ][i],
+                 c32 = cv[kSigTglSnp][i], c33 = cv[kSigTgl2][i], c40 = cv[kSigQ2PtY][i], c41 = cv[kSigQ2PtZ][i],
+                 c42 = cv[kSigQ2PtSnp][i], c43 = cv[kSigQ2PtTgl][i], c44 = cv[kSigQ2Pt2][i];
+      double b00 = f02[i] * c20 + f04[i] * c40, b01 = f12[i] * c20 + f14[i] * c40 + f13[i] * c30;
+      double b02 = f24[i] * c40;
+      double b10 = f02[i] * c21 + f04[i] * c41, b11 = f12[i] * c21 + f14[i] * c41 + f13[i] * c31;
+      double b12 = f24[i] * c41;
+      double b20 = f02[i] * c22 + f04[i] * c42, b21 = f12[i] * c22 + f14[i] * c42 + f13[i] * c32;
+      double b22 = f24[i] * c42;
+      double b40 = f02[i] * c42 + f04[i] * c44, b41 = f12[i] * c42 + f14[i] * c44 + f13[i] * c43;
+      double b42 = f24[i] * c44;
+      double b30 = f02[i] * c32 + f04[i] * c43, b31 = f12[i] * c32 + f14[i] * c43 + f13[i] * c33;
+      double b32 = f24[i] * c43;
+      double a00 = f02[i] * b20 + f04[i] * b40, a01 = f02[i] * b21 + f04[i] * b41, a02 = f02[i] * b22 + f04[i] * b42;
+      double a11 = f12[i] * b21 + f14[i] * b41 + f13[i] * b31, a12 = f12[i] * b22 + f14[i] * b42 + f13[i] * b32;
+      double a22 = f24[i] * b42;
+      cv[kSigY2][i] += b00 + b00 + a00;
+      cv[kSigZY][i] += b10 + b01 + a01;
+      cv[kSigSnpY][i] += b20 + b02 + a02;
+      cv[kSigTglY][i] += b30;
+      cv[kSigQ2PtY][i] += b40;
+      cv[kSigZ2][i] += b11 + b11 + a11;
+      cv[kSigSnpZ][i] += b21 + b12 + a12;
+      cv[kSigTglZ][i] += b31;
+      cv[kSigQ2PtZ][i] += b41;
+      cv[kSigSnp2][i] += b22 + b22 + a22;
+      cv[kSigTglSnp][i] += b32;
+      cv[kSigQ2PtSnp][i] += b42;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      if (!moved[i] || !batch.ok[i]) {
+        continue;
+      }
+      if (f13[i] != 0.) { // the track was really propagated
+        checkCovariance(i);
+      }
+      if (maxSnp > 0 && math_utils::detail::abs<value_type>(bSnp[i]) >= maxSnp) {
+        batch.ok[i] = 0;
+        moved[i] = 0;
+      }
+    }
+    if (!useMat) {
+      continue;
+    }
+
+    // material budget for all moved tracks
+    for (size_t i = 0; i < n; i++) {
+      if (moved[i] && batch.ok[i]) {
+        math_utils::Point3D<value_type> xyz0(gx0[i], gy0[i], gz0[i]);
+        math_utils::Point3D<value_type> xyz1(bx[i] * batch.cosAlp[i] - bY[i] * batch.sinAlp[i], bx[i] * batch.sinAlp[i] + bY[i] * batch.cosAlp[i], bZp[i]);
+        auto mb = getMatBudget(matCorr, xyz0, xyz1);
+        x2x0[i] = mb.meanX2X0;
+        xrho[i] = mb.getXRho(sCorr[i]);
+      }
+    }
+
+    // material corrections, see TrackParametrizationWithError::correctForMaterial
+    for (size_t i = 0; i < n; i++) {
+      if (!moved[i] || !batch.ok[i]) {
+        continue;
+      }
+      value_type snp = bSnp[i], tgl = bTgl[i], q2pt = bQ2Pt[i];
+      int absQ = batch.absCharge[i];
+      value_type mass = batch.mass[i], mass2 = batch.mass2[i];
+      value_type csp2 = (1.f - snp) * (1.f + snp);
+      value_type cst2I = (1.f + tgl * tgl);
+      value_type pInv = gpu::CAMath::Abs(q2pt) / gpu::CAMath::Sqrt(1.f + tgl * tgl);
+      if (absQ > 1) {
+        pInv /= absQ;
+      }
+      value_type p = pInv > constants::math::Almost0 ? 1.f / pInv : constants::math::VeryBig;
+      value_type p2 = p * p, e2 = p2 + mass2, beta2 = p2 / e2;
+      value_type charge2Pt = absQ ? q2pt : 0.f;
+      value_type cC22(0.f), cC33(0.f), cC43(0.f), cC44(0.f), cP4 = 1.f;
+      if (x2x0[i] != 0.f) {
+        value_type theta2 = kMSConst2 / (beta2 * p2) * gpu::CAMath::Abs(x2x0[i]);
+        if (absQ != 1) {
+          theta2 *= absQ * absQ;
+        }
+        if (theta2 > constants::math::PI * constants::math::PI) {
+          batch.ok[i] = 0;
+          continue;
+        }
+        value_type fp34 = tgl * charge2Pt;
+        value_type t2c2I = theta2 * cst2I;
+        cC22 = t2c2I * csp2;
+        cC33 = t2c2I * cst2I;
+        cC43 = t2c2I * fp34;
+        cC44 = theta2 * fp34 * fp34;
+      }
+      if ((xrho[i] != 0.f) && (beta2 < 1.f)) {
+        value_type dedx = BetheBlochSolid(p / mass);
+        if (absQ != 1) {
+          dedx *= absQ * absQ;
+        }
+        value_type dE = dedx * xrho[i];
+        value_type e = gpu::CAMath::Sqrt(e2);
+        if (gpu::CAMath::Abs(dE) > kMaxELossFrac * e) {
+          batch.ok[i] = 0;
+          continue;
+        }
+        value_type eupd = e + dE;
+        value_type pupd2 = eupd * eupd - mass2;
+        if (pupd2 < kMinP * kMinP) {
+          batch.ok[i] = 0;
+          continue;
+        }
+        cP4 = p / gpu::CAMath::Sqrt(pupd2);
+        constexpr value_type knst = 0.07f;
+        value_type sigmadE = knst * gpu::CAMath::Sqrt(gpu::CAMath::Abs(dE)) * e / p2 * charge2Pt;
+        cC44 += sigmadE * sigmadE;
+      }
+      cv[kSigSnp2][i] += cC22;
+      cv[kSigTgl2][i] += cC33;
+      cv[kSigQ2PtTgl][i] += cC43;
+      cv[kSigQ2Pt2][i] += cC44;
+      bQ2Pt[i] = q2pt * cP4;
+      checkCovariance(i);
+    }
+  }
+
+  int nOK = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (batch.ok[i]) {
+      bx[i] = xToGo;
+      nOK++;
+    }
+  }
+  return nOK;
+}
+#endif
+
 //____________________________________________________________
 template <typename value_T>
 GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type>::MatCorrType corrType, const math_utils::Point3D<value_type>& p0, const math_utils::Point3D<value_type>& p1) const
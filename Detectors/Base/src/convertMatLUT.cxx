@@ -0,0 +1,56 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file convertMatLUT.cxx
+/// \brief Conversion of the material LUT from the ROOT file to the memory-mappable raw format
+
+#include "DetectorsBase/MatLayerCylSet.h"
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <memory>
+
+namespace bpo = boost::program_options;
+
+int main(int argc, char* argv[])
+{
+  bpo::options_description options("Allowed options");
+  options.add_options()(
+    "input,i", bpo::value<std::string>()->default_value("matbud.root"), "input mat.LUT file (ROOT or raw format)")(
+    "output,o", bpo::value<std::string>()->default_value("matbud.bin"), "output mat.LUT file in the raw format")(
+    "help,h", "Produce help message.");
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(parse_command_line(argc, argv, options), vm);
+    if (vm.count("help")) {
+      std::cout << options << std::endl;
+      return 0;
+    }
+    bpo::notify(vm);
+  } catch (const bpo::error& e) {
+    std::cerr << e.what() << "\n\n";
+    std::cerr << "Error parsing command line arguments; Available options:\n";
+    std::cerr << options << std::endl;
+    return 1;
+  }
+
+  auto inpFName = vm["input"].as<std::string>(), outFName = vm["output"].as<std::string>();
+  std::unique_ptr<o2::base::MatLayerCylSet> lut(o2::base::MatLayerCylSet::rectifyPtrFromFile(o2::base::MatLayerCylSet::loadFromFile(inpFName)));
+  if (!lut) {
+    return 1;
+  }
+  if (!lut->writeRawFile(outFName)) {
+    return 1;
+  }
+  std::cout << "Converted mat.LUT " << inpFName << " to the raw format in " << outFName
+            << " (" << lut->getFlatBufferSize() << " bytes of flat buffer)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchMatLUTLoad.cxx
+/// \brief Benchmark of the material LUT loading from the ROOT file and from the memory-mapped raw file
+///
+/// Needs the material LUT matbud.root in the current directory, the raw file is created from it.
+/// The first raw load maps the file, the following ones reuse the mapping of the process, hence
+/// the ColdMap case measures the mapping and the pointers relocation with a fresh file name each time.
+
+#include <benchmark/benchmark.h>
+#include "DetectorsBase/MatLayerCylSet.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace o2::base;
+
+namespace
+{
+const std::string RootFile = "matbud.root";
+const std::string RawFile = "matbud_bench.bin";
+
+bool prepare(benchmark::State& state)
+{
+  if (!std::filesystem::exists(RootFile)) {
+    state.SkipWithError("matbud.root is not found");
+    return false;
+  }
+  if (!std::filesystem::exists(RawFile)) {
+    std::unique_ptr<MatLayerCylSet> lut(MatLayerCylSet::loadFromFile(RootFile));
+    if (!lut || !lut->writeRawFile(RawFile)) {
+      state.SkipWithError("failed to create the raw mat.LUT");
+      return false;
+    }
+  }
+  return true;
+}
+
+// touch all the layers such that the lazily mapped pages are accounted
+float probe(const MatLayerCylSet* lut)
+{
+  auto mb = lut->getMatBudget(0.f, 0.f, 0.f, lut->getRMax(), 0.f, 0.f);
+  return mb.meanX2X0;
+}
+} // namespace
+
+static void BM_LoadROOT(benchmark::State& state)
+{
+  if (!prepare(state)) {
+    return;
+  }
+  for (auto _ : state) {
+    std::unique_ptr<MatLayerCylSet> lut(MatLayerCylSet::loadFromFile(RootFile));
+    benchmark::DoNotOptimize(probe(lut.get()));
+  }
+}
+
+static void BM_LoadRawColdMap(benchmark::State& state)
+{
+  if (!prepare(state)) {
+    return;
+  }
+  int iter = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto link = RawFile + "." + std::to_string(iter++); // new name -> new mapping, the page cache is shared
+    std::filesystem::remove(link);
+    std::filesystem::create_symlink(RawFile, link);
+    state.ResumeTiming();
+    std::unique_ptr<MatLayerCylSet> lut(MatLayerCylSet::loadFromFile(link));
+    benchmark::DoNotOptimize(probe(lut.get()));
+    state.PauseTiming();
+    std::filesystem::remove(link);
+    state.ResumeTiming();
+  }
+}
+
+static void BM_LoadRawWarmMap(benchmark::State& state)
+{
+  if (!prepare(state)) {
+    return;
+  }
+  for (auto _ : state) {
+    std::unique_ptr<MatLayerCylSet> lut(MatLayerCylSet::loadFromFile(RawFile));
+    benchmark::DoNotOptimize(probe(lut.get()));
+  }
+}
+
+BENCHMARK(BM_LoadROOT)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadRawColdMap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadRawWarmMap)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchPropagatorBatch.cxx
+/// \brief Benchmark of the batched track propagation against the single track one
+///
+/// The material corrections are benchmarked only if the material LUT matbud.root is found in the
+/// current directory, otherwise only the propagation in the constant field is done.
+
+#include <benchmark/benchmark.h>
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsBase/TrackParCovBatch.h"
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+using TrackParCov = o2::track::TrackParCov;
+using MatCorrType = Propagator::MatCorrType;
+
+namespace
+{
+constexpr float Bz = -5.f, XStart = 2.f, XEnd = 80.f;
+
+// tracks at the beam line within the acceptance of the barrel, pT > 0.2 GeV
+std::vector<TrackParCov> createTracks(size_t n)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> alpDist(-3.14f, 3.14f), yzDist(-0.1f, 0.1f), snpDist(-0.5f, 0.5f), tglDist(-1.f, 1.f), q2ptDist(-5.f, 5.f);
+  std::vector<TrackParCov> tracks;
+  tracks.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    std::array<float, o2::track::kNParams> par{yzDist(gen), yzDist(gen), snpDist(gen), tglDist(gen), q2ptDist(gen)};
+    std::array<float, o2::track::kCovMatSize> cov{1e-4, 0., 1e-4, 0., 0., 1e-5, 0., 0., 0., 1e-5, 0., 0., 0., 0., 1e-3};
+    tracks.emplace_back(XStart, alpDist(gen), par, cov);
+  }
+  return tracks;
+}
+
+Propagator* getPropagator(MatCorrType matCorr)
+{
+  auto prop = Propagator::Instance(true); // no field map, the constant Bz is used
+  if (matCorr == MatCorrType::USEMatCorrLUT && !prop->getMatLUT()) {
+    prop->setMatLUT(MatLayerCylSet::rectifyPtrFromFile(MatLayerCylSet::loadFromFile("matbud.root")));
+  }
+  return prop;
+}
+
+bool skipMaterial(benchmark::State& state, MatCorrType matCorr)
+{
+  if (matCorr == MatCorrType::USEMatCorrLUT && !std::filesystem::exists("matbud.root")) {
+    state.SkipWithError("matbud.root is not found");
+    return true;
+  }
+  return false;
+}
+} // namespace
+
+static void BM_PropagateScalar(benchmark::State& state, MatCorrType matCorr)
+{
+  if (skipMaterial(state, matCorr)) {
+    return;
+  }
+  auto prop = getPropagator(matCorr);
+  const auto tracksOrig = createTracks(state.range(0));
+  std::vector<TrackParCov> tracks;
+  for (auto _ : state) {
+    state.PauseTiming();
+    tracks = tracksOrig;
+    state.ResumeTiming();
+    int nOK = 0;
+    for (auto& trc : tracks) {
+      nOK += prop->propagateToX(trc, XEnd, Bz, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr);
+    }
+    benchmark::DoNotOptimize(nOK);
+  }
+  state.SetItemsProcessed(state.iterations() * tracksOrig.size());
+}
+
+static void BM_PropagateBatch(benchmark::State& state, MatCorrType matCorr)
+{
+  if (skipMaterial(state, matCorr)) {
+    return;
+  }
+  auto prop = getPropagator(matCorr);
+  const auto tracksOrig = createTracks(state.range(0));
+  TrackParCovBatch<float> batch;
+  for (auto _ : state) {
+    state.PauseTiming();
+    batch.load(tracksOrig);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(prop->propagateToX(batch, XEnd, Bz, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr));
+  }
+  state.SetItemsProcessed(state.iterations() * tracksOrig.size());
+}
+
+BENCHMARK_CAPTURE(BM_PropagateScalar, noMat, MatCorrType::USEMatCorrNONE)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_CAPTURE(BM_PropagateBatch, noMat, MatCorrType::USEMatCorrNONE)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_CAPTURE(BM_PropagateScalar, matLUT, MatCorrType::USEMatCorrLUT)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_CAPTURE(BM_PropagateBatch, matLUT, MatCorrType::USEMatCorrLUT)->RangeMultiplier(8)->Range(64, 32768);
+
+BENCHMARK_MAIN();
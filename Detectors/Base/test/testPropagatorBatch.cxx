@@ -0,0 +1,69 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test batched track propagation
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsBase/TrackParCovBatch.h"
+#include <TRandom.h>
+#include <cmath>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+
+BOOST_AUTO_TEST_CASE(PropagatorBatch)
+{
+  // batched propagation must give the same result as the single track one
+  using TrackParCov = o2::track::TrackParCov;
+  auto prop = Propagator::Instance(true); // no field map, the constant Bz is used
+  const float bz = -5.f, xEnd = 85.f;
+  const int nTracks = 1000;
+  gRandom->SetSeed(1);
+  std::vector<TrackParCov> tracks, tracksBatch;
+  for (int i = 0; i < nTracks; i++) {
+    std::array<float, o2::track::kNParams> par{float(gRandom->Gaus(0, 0.1)), float(gRandom->Gaus(0, 0.1)), float(gRandom->Uniform(-0.6, 0.6)),
+                                               float(gRandom->Uniform(-1, 1)), float(gRandom->Uniform(-10, 10))};
+    std::array<float, o2::track::kCovMatSize> cov{1e-4, 1e-6, 1e-4, 1e-6, 1e-6, 1e-5, 1e-7, 1e-7, 1e-7, 1e-5, 1e-6, 1e-6, 1e-6, 1e-6, 1e-3};
+    tracks.emplace_back(gRandom->Uniform(0, 5), gRandom->Uniform(-3.14, 3.14), par, cov);
+  }
+  tracksBatch = tracks;
+  TrackParCovBatch<float> batch;
+  batch.load(tracksBatch);
+  int nOKBatch = prop->propagateToX(batch, xEnd, bz, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, Propagator::MatCorrType::USEMatCorrNONE);
+  batch.store(tracksBatch);
+
+  // same arithmetics, allow only for the differences in the instructions chosen by the compiler
+  auto isClose = [](float a, float b) { return std::abs(a - b) <= 1e-5f * (std::abs(a) + std::abs(b)) + 1e-12f; };
+  int nOK = 0;
+  for (int i = 0; i < nTracks; i++) {
+    bool ok = prop->propagateToX(tracks[i], xEnd, bz, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, Propagator::MatCorrType::USEMatCorrNONE);
+    nOK += ok;
+    BOOST_CHECK_EQUAL(ok, batch.isOK(i));
+    BOOST_CHECK(isClose(tracks[i].getX(), tracksBatch[i].getX()));
+    for (int j = 0; j < o2::track::kNParams; j++) {
+      BOOST_CHECK(isClose(tracks[i].getParam(j), tracksBatch[i].getParam(j)));
+    }
+    for (int j = 0; j < o2::track::kCovMatSize; j++) {
+      BOOST_CHECK(isClose(tracks[i].getCov()[j], tracksBatch[i].getCov()[j]));
+    }
+  }
+  BOOST_CHECK_EQUAL(nOK, nOKBatch);
+  BOOST_CHECK(nOK > 0 && nOK < nTracks); // some tracks must loop before reaching xEnd
+}
+
+} // namespace base
+} // namespace o2
@@ -35,6 +35,7 @@ void EntropyEncoderSpec::init(o2::framework::InitContext& ic)
 {
   std::string dictPath = ic.options().get<std::string>("ctf-dict");
   mCTFCoder.setMemMarginFactor(ic.options().get<float>("mem-factor"));
+  mCTFCoder.setANSNStreams(ic.options().get<int>("ans-streams"));
   if (!dictPath.empty() && dictPath != "none") {
     mCTFCoder.createCodersFromFile<CTF>(dictPath, o2::ctf::CTFCoderBase::OpType::Encoder);
   }
@@ -75,7 +76,8 @@ DataProcessorSpec getEntropyEncoderSpec()
     Outputs{{"CPV", "CTFDATA", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>()},
     Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF encoding dictionary"}},
-            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}}}};
+            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+            {"ans-streams", VariantType::Int, 2, {"Number of interleaved rANS streams of the entropy encoder (2, 4, 8, 16, 32)"}}}};
 }
 
 } // namespace cpv
@@ -181,6 +181,14 @@ class MatchTOF
   void setTS(unsigned long creationTime) { mTimestamp = creationTime; }
   unsigned long getTS() const { return mTimestamp; }
 
+  ///< number of threads used for the matching of the sectors
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
+  ///< with several threads, rerun the matching serially and report any difference (slow, for validation)
+  void setCheckThreads(bool v = true) { mCheckThreads = v; }
+  bool getCheckThreads() const { return mCheckThreads; }
+
  private:
   bool prepareFITData();
   int prepareInteractionTimes();
@@ -194,6 +202,7 @@ class MatchTOF
   bool prepareTOFClusters();
 
   void doMatching(int sec);
+  void checkMatchingThreads();
   void doMatchingForTPC(int sec);
   void selectBestMatches();
   void selectBestMatchesHP();
@@ -225,6 +234,8 @@ class MatchTOF
   float mTPCBin2Z = 0.;      ///< conversion coeff from TPC time-bin to Z
 
   bool mIsCosmics = false;    ///< switch on to reconstruct cosmics and match with TPC
+  int mNThreads = 1;          ///< number of OMP threads
+  bool mCheckThreads = false; ///< check the concurrent matching against the serial one
   float mTimeTolerance = 1e3; ///< tolerance in ns for track-TOF time bracket matching
   float mSpaceTolerance = 10; ///< tolerance in cm for track-TOF time bracket matching
   int mSigmaTimeCut = 30.;    ///< number of sigmas to cut on time when matching the track to the TOF cluster
@@ -278,6 +289,8 @@ class MatchTOF
 
   ///<array of track-TOFCluster pairs from the matching
   std::vector<o2::dataformats::MatchInfoTOFReco> mMatchedTracksPairs;
+  ///<per sector track-TOFCluster pairs, filled concurrently by the matching of the sectors
+  std::array<std::vector<o2::dataformats::MatchInfoTOFReco>, o2::constants::math::NSectors> mMatchedTracksPairsSec;
 
   ///<array of TOFChannel calibration info
   std::vector<o2::dataformats::CalibInfoTOF> mCalibInfoTOF;
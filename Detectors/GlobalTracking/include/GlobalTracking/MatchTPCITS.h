@@ -149,6 +149,14 @@ struct TrackLocITS : public o2::track::TrackParCov {
 
 ///< record TPC or ITS track associated with single ITS or TPC track and reference on
 ///< the next (worse chi2) MatchRecord of the same TPC or ITS track
+///< candidate match of ITS and TPC tracks, as found by the matching of a sector, before its registration in the MatchRecords
+struct MatchCandidate {
+  int itsID = MinusOne;     ///< entry of the ITS track in mITSWork
+  int tpcID = MinusOne;     ///< entry of the TPC track in mTPCWork
+  float chi2 = -1.f;        ///< matching chi2
+  int matchedIC = MinusOne; ///< index of eventually matched InteractionCandidate
+};
+
 struct MatchRecord {
   float chi2 = -1.f;        ///< matching chi2
   int partnerID = MinusOne; ///< id of parnter track entry in mTPCWork or mITSWork containers
@@ -418,9 +426,12 @@ class MatchTPCITS
   void flagUsedITSClusters(const o2::its::TrackITS& track);
 
   void doMatching(int sec);
+  void checkMatchingThreads();
 
   void refitWinners();
-  bool refitTrackTPCITS(int iTPC, int& iITS);
+  void checkRefitThreads(size_t firstTrack);
+  bool refitTrackTPCITS(int iTPC, int& iITS, std::vector<o2::dataformats::TrackTPCITS>& matchedTracks,
+                        MCLabContTr& matchLabels, std::vector<o2::dataformats::Pair<float, float>>& tglITSTPC);
   bool refitTPCInward(o2::track::TrackParCov& trcIn, float& chi2, float xTgt, int trcID, float timeTB) const;
 
   void selectBestMatches();
@@ -616,6 +627,9 @@ class MatchTPCITS
   ///< per sector indices of ITS track entry in mITSWork
   std::array<std::vector<int>, o2::constants::math::NSectors> mITSSectIndexCache;
 
+  ///< per sector candidate matches, registered in the match records once all sectors are processed
+  std::array<std::vector<MatchCandidate>, o2::constants::math::NSectors> mSectorMatchCandidates;
+
   ///< indices of 1st TPC tracks with time above the ITS ROF time
   std::array<std::vector<int>, o2::constants::math::NSectors> mTPCTimeStart;
   ///< indices of 1st entries of ITS tracks starting at given ROframe
@@ -72,6 +72,8 @@ struct MatchTPCITSParams : public o2::conf::ConfigurableParamHelper<MatchTPCITSP
 
   int verbosity = 0; ///< verbosit level
 
+  bool checkThreads = false; ///< with several threads, rerun the matching and the refit serially and report any difference (slow, for validation)
+
   o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT; /// Material correction type
 
   O2ParamDef(MatchTPCITSParams, "tpcitsMatch");
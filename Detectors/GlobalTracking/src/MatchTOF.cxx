@@ -45,6 +45,10 @@
 #include "DataFormatsGlobalTracking/RecoContainerCreateTracksVariadic.h"
 #include "TOFBase/Utils.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::globaltracking;
 using evGIdx = o2::dataformats::EvIndex<int, o2::dataformats::GlobalTrackID>;
 using trkType = o2::dataformats::MatchInfoTOFReco::TrackType;
@@ -115,22 +119,46 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
   LOGF(info, "Timing prepare FIT data: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
 
   mTimerTot.Start();
-  for (int sec = o2::constants::math::NSectors; sec--;) {
-    mMatchedTracksPairs.clear(); // new sector
-    LOG(debug) << "Doing matching for sector " << sec << "...";
-    if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
-      mTimerMatchITSTPC.Start(sec == o2::constants::math::NSectors - 1);
+  // every track is assigned to a single sector, so the sectors are matched concurrently, each to its own
+  // container of pairs
+  Geo::Init(); // make sure the geometry is not lazily initialized by the matching threads
+  for (auto& pairs : mMatchedTracksPairsSec) {
+    pairs.clear();
+  }
+  if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
+    mTimerMatchITSTPC.Start();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+      LOG(debug) << "Doing matching for sector " << sec << "...";
       doMatching(sec);
-      mTimerMatchITSTPC.Stop();
     }
-    if (mIsTPCused) {
-      mTimerMatchTPC.Start(sec == o2::constants::math::NSectors - 1);
+    mTimerMatchITSTPC.Stop();
+  }
+  if (mIsTPCused) {
+    mTimerMatchTPC.Start();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+      LOG(debug) << "Doing matching of TPC tracks for sector " << sec << "...";
       doMatchingForTPC(sec);
-      mTimerMatchTPC.Stop();
     }
-    LOG(debug) << "...done. Now check the best matches";
+    mTimerMatchTPC.Stop();
+  }
+  if (mCheckThreads && mNThreads > 1) {
+    checkMatchingThreads();
+  }
+  // a cluster may be matched by tracks of several sectors: the best matches are selected sector by
+  // sector in a fixed order, so that the result does not depend on the number of threads
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    LOG(debug) << "Check the best matches of sector " << sec;
+    mMatchedTracksPairs.swap(mMatchedTracksPairsSec[sec]);
+    mMatchedTracksPairsSec[sec].clear();
     selectBestMatches();
   }
+  mMatchedTracksPairs.clear();
 
   // re-arrange outputs from constrained/unconstrained to the 4 cases (TPC, ITS-TPC, TPC-TRD, ITS-TPC-TRD) to be implemented as soon as TPC-TRD and ITS-TPC-TRD tracks available
 
@@ -444,6 +472,55 @@ bool MatchTOF::prepareTOFClusters()
 
   return true;
 }
+//______________________________________________
+void MatchTOF::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  LOG(warning) << "Multithreading is not supported, imposing single thread";
+  mNThreads = 1;
+#endif
+}
+
+//______________________________________________
+void MatchTOF::checkMatchingThreads()
+{
+  ///< rerun serially the matching of all sectors and check that it finds the pairs found by the concurrent matching
+  auto pairsMT = mMatchedTracksPairsSec;
+  int nDiff = 0;
+  for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+    mMatchedTracksPairsSec[sec].clear();
+    if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
+      doMatching(sec);
+    }
+    if (mIsTPCused) {
+      doMatchingForTPC(sec);
+    }
+    const auto &pairs = mMatchedTracksPairsSec[sec], &pairsSecMT = pairsMT[sec];
+    if (pairs.size() != pairsSecMT.size()) {
+      LOGP(error, "Sector {} : {} track-TOF cluster pairs with {} threads vs {} serially", sec, pairsSecMT.size(), mNThreads, pairs.size());
+      nDiff++;
+      continue;
+    }
+    for (size_t i = 0; i < pairs.size(); i++) {
+      const auto &p = pairs[i], &pMT = pairsSecMT[i];
+      if (p.getTrackRef() != pMT.getTrackRef() || p.getTOFClIndex() != pMT.getTOFClIndex() || p.getIdLocal() != pMT.getIdLocal() ||
+          p.getTrackType() != pMT.getTrackType() || p.getChi2() != pMT.getChi2() || p.getSignal() != pMT.getSignal() ||
+          p.getDeltaT() != pMT.getDeltaT() || p.getZatTOF() != pMT.getZatTOF() || p.getDXatTOF() != pMT.getDXatTOF() || p.getDZatTOF() != pMT.getDZatTOF() ||
+          p.getLTIntegralOut().getL() != pMT.getLTIntegralOut().getL()) {
+        LOGP(error, "Sector {} : track-TOF cluster pair {} differs with {} threads: track {} cluster {} chi2 {} vs track {} cluster {} chi2 {} serially", sec, i, mNThreads,
+             pMT.getTrackRef().asString(), pMT.getTOFClIndex(), pMT.getChi2(), p.getTrackRef().asString(), p.getTOFClIndex(), p.getChi2());
+        nDiff++;
+        break;
+      }
+    }
+  }
+  if (!nDiff) {
+    LOGP(info, "Track-TOF cluster pairs found with {} threads are identical to the serial ones", mNThreads);
+  }
+}
+
 //______________________________________________
 void MatchTOF::doMatching(int sec)
 {
@@ -677,7 +754,7 @@ void MatchTOF::doMatching(int sec)
           foundCluster = true;
           // set event indexes (to be checked)
           int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-          mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type, (trefTOF.getTime() - (minTrkTime + maxTrkTime) * 0.5) * 1E-6, 0., resX, resZ); // TODO: check if this is correct!
+          mMatchedTracksPairsSec[sec].emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type, (trefTOF.getTime() - (minTrkTime + maxTrkTime) * 0.5) * 1E-6, 0., resX, resZ); // TODO: check if this is correct!
         }
       }
     }
@@ -1005,7 +1082,7 @@ void MatchTOF::doMatchingForTPC(int sec)
             foundCluster = true;
             // set event indexes (to be checked)
             int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-            mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ(), resX, resZ); // TODO: check if this is correct!
+            mMatchedTracksPairsSec[sec].emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ(), resX, resZ); // TODO: check if this is correct!
           }
         }
       }
@@ -11,6 +11,7 @@
 
 #include <TTree.h>
 #include <cassert>
+#include <cstring>
 
 #include "FairLogger.h"
 #include "Field/MagneticField.h"
@@ -87,9 +88,29 @@ void MatchTPCITS::run(const o2::globaltracking::RecoContainer& inp)
     }
 
     mTimer[SWDoMatching].Start(false);
-    for (int sec = o2::constants::math::NSectors; sec--;) {
+    int nThreadsMatch = mNThreads;
+#ifdef _ALLOW_DEBUG_TREES_
+    if (mDBGOut) {
+      nThreadsMatch = 1; // debug trees are filled during the matching
+    }
+#endif
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreadsMatch)
+#endif
+    for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
       doMatching(sec);
     }
+    if (mParams->checkThreads && nThreadsMatch > 1) {
+      checkMatchingThreads();
+    }
+    // the sectors share ITS and TPC tracks, their candidates are registered in a fixed sector order,
+    // so that the match records do not depend on the number of threads
+    for (int sec = o2::constants::math::NSectors; sec--;) {
+      for (const auto& cand : mSectorMatchCandidates[sec]) {
+        registerMatchRecordTPC(cand.itsID, cand.tpcID, cand.chi2, cand.matchedIC);
+      }
+      mSectorMatchCandidates[sec].clear();
+    }
     mTimer[SWDoMatching].Stop();
     if (0) { // enabling this creates very verbose output
       mTimer[SWTot].Stop();
@@ -685,7 +706,10 @@ bool MatchTPCITS::prepareFITData()
 //_____________________________________________________
 void MatchTPCITS::doMatching(int sec)
 {
-  ///< run matching for currently cached ITS data for given TPC sector
+  ///< run matching for currently cached ITS data for given TPC sector, storing the candidates in mSectorMatchCandidates[sec].
+  ///< Different sectors can be processed concurrently
+  auto& candidates = mSectorMatchCandidates[sec];
+  candidates.clear();
   auto& cacheITS = mITSSectIndexCache[sec];   // array of cached ITS track indices for this sector
   auto& cacheTPC = mTPCSectIndexCache[sec];   // array of cached ITS track indices for this sector
   auto& timeStartTPC = mTPCTimeStart[sec];    // array of 1st TPC track with timeMax in ITS ROFrame
@@ -821,7 +845,7 @@ void MatchTPCITS::doMatching(int sec)
           continue;
         }
       }
-      registerMatchRecordTPC(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // register matching candidate
+      candidates.push_back(MatchCandidate{cacheITS[iits], cacheTPC[itpc], chi2, matchedIC}); // store matching candidate
       nMatchesControl++;
     }
   }
@@ -832,6 +856,34 @@ void MatchTPCITS::doMatching(int sec)
   }
 }
 
+//_____________________________________________________
+void MatchTPCITS::checkMatchingThreads()
+{
+  ///< rerun serially the matching of all sectors and check that it finds the candidates found by the concurrent matching
+  auto candidatesMT = mSectorMatchCandidates;
+  int nDiff = 0;
+  for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+    doMatching(sec);
+    const auto &cands = mSectorMatchCandidates[sec], &candsMT = candidatesMT[sec];
+    if (cands.size() != candsMT.size()) {
+      LOGP(error, "Sector {} : {} matching candidates with {} threads vs {} serially", sec, candsMT.size(), mNThreads, cands.size());
+      nDiff++;
+      continue;
+    }
+    for (size_t i = 0; i < cands.size(); i++) {
+      if (cands[i].itsID != candsMT[i].itsID || cands[i].tpcID != candsMT[i].tpcID || cands[i].chi2 != candsMT[i].chi2 || cands[i].matchedIC != candsMT[i].matchedIC) {
+        LOGP(error, "Sector {} : matching candidate {} differs with {} threads: ITS {} TPC {} chi2 {} IC {} vs ITS {} TPC {} chi2 {} IC {} serially", sec, i, mNThreads,
+             candsMT[i].itsID, candsMT[i].tpcID, candsMT[i].chi2, candsMT[i].matchedIC, cands[i].itsID, cands[i].tpcID, cands[i].chi2, cands[i].matchedIC);
+        nDiff++;
+        break;
+      }
+    }
+  }
+  if (!nDiff) {
+    LOGP(info, "Matching candidates found with {} threads are identical to the serial ones", mNThreads);
+  }
+}
+
 //______________________________________________
 void MatchTPCITS::suppressMatchRecordITS(int itsID, int tpcID)
 {
@@ -1212,20 +1264,98 @@ void MatchTPCITS::refitWinners()
   mTimer[SWRefit].Start(false);
   LOG(debug) << "Refitting winner matches";
   mWinnerChi2Refit.resize(mITSWork.size(), -1.f);
+  int nTPC = mTPCWork.size();
+  if (mNThreads < 2) {
+    int iITS;
+    for (int iTPC = 0; iTPC < nTPC; iTPC++) {
+      if (!refitTrackTPCITS(iTPC, iITS, mMatchedTracks, mOutLabels, mTglITSTPC)) {
+        continue;
+      }
+      mWinnerChi2Refit[iITS] = mMatchedTracks.back().getChi2Refit();
+    }
+  } else {
+    // contiguous ranges of TPC tracks are refitted to separate buffers, which are then concatenated in order,
+    // giving the same output as the serial refit
+    struct RefitChunk {
+      std::vector<o2::dataformats::TrackTPCITS> tracks;
+      MCLabContTr labels;
+      std::vector<o2::dataformats::Pair<float, float>> tglITSTPC;
+      std::vector<int> itsIDs;
+    };
+    int nChunks = std::min(nTPC, 8 * mNThreads);
+    std::vector<RefitChunk> chunks(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int ich = 0; ich < nChunks; ich++) {
+      auto& chunk = chunks[ich];
+      int iITS, iTPCMax = int(int64_t(nTPC) * (ich + 1) / nChunks);
+      for (int iTPC = int(int64_t(nTPC) * ich / nChunks); iTPC < iTPCMax; iTPC++) {
+        if (refitTrackTPCITS(iTPC, iITS, chunk.tracks, chunk.labels, chunk.tglITSTPC)) {
+          chunk.itsIDs.push_back(iITS);
+        }
+      }
+    }
+    size_t nRefitted = 0;
+    for (const auto& chunk : chunks) {
+      nRefitted += chunk.tracks.size();
+    }
+    mMatchedTracks.reserve(mMatchedTracks.size() + nRefitted);
+    for (auto& chunk : chunks) {
+      for (size_t i = 0; i < chunk.tracks.size(); i++) {
+        mWinnerChi2Refit[chunk.itsIDs[i]] = chunk.tracks[i].getChi2Refit();
+      }
+      mMatchedTracks.insert(mMatchedTracks.end(), chunk.tracks.begin(), chunk.tracks.end());
+      mOutLabels.insert(mOutLabels.end(), chunk.labels.begin(), chunk.labels.end());
+      mTglITSTPC.insert(mTglITSTPC.end(), chunk.tglITSTPC.begin(), chunk.tglITSTPC.end());
+    }
+    if (mParams->checkThreads) {
+      checkRefitThreads(mMatchedTracks.size() - nRefitted);
+    }
+  }
+  mTimer[SWRefit].Stop();
+}
+
+//______________________________________________
+void MatchTPCITS::checkRefitThreads(size_t firstTrack)
+{
+  ///< rerun serially the refit of the winner matches and check that it gives the tracks refitted concurrently, stored from firstTrack on
+  std::vector<o2::dataformats::TrackTPCITS> tracks;
+  MCLabContTr labels;
+  std::vector<o2::dataformats::Pair<float, float>> tglITSTPC;
   int iITS;
   for (int iTPC = 0; iTPC < (int)mTPCWork.size(); iTPC++) {
-    if (!refitTrackTPCITS(iTPC, iITS)) {
-      continue;
+    refitTrackTPCITS(iTPC, iITS, tracks, labels, tglITSTPC);
+  }
+  auto isSame = [](const o2::track::TrackParCov& t1, const o2::track::TrackParCov& t2) {
+    return t1.getX() == t2.getX() && t1.getAlpha() == t2.getAlpha() &&
+           std::memcmp(t1.getParams(), t2.getParams(), o2::track::kNParams * sizeof(float)) == 0 &&
+           std::memcmp(&t1.getCov()[0], &t2.getCov()[0], o2::track::kCovMatSize * sizeof(float)) == 0;
+  };
+  size_t nRefitted = mMatchedTracks.size() - firstTrack;
+  if (tracks.size() != nRefitted || (mMCTruthON && labels.size() != nRefitted)) {
+    LOGP(error, "{} tracks refitted with {} threads vs {} serially", nRefitted, mNThreads, tracks.size());
+    return;
+  }
+  for (size_t i = 0; i < nRefitted; i++) {
+    const auto &trMT = mMatchedTracks[firstTrack + i], &tr = tracks[i];
+    if (trMT.getRefTPC() != tr.getRefTPC() || trMT.getRefITS() != tr.getRefITS() || trMT.getChi2Refit() != tr.getChi2Refit() ||
+        trMT.getChi2Match() != tr.getChi2Match() || trMT.getTimeMUS().getTimeStamp() != tr.getTimeMUS().getTimeStamp() ||
+        trMT.getTimeMUS().getTimeStampError() != tr.getTimeMUS().getTimeStampError() || !isSame(trMT, tr) || !isSame(trMT.getParamOut(), tr.getParamOut()) ||
+        (mMCTruthON && mOutLabels[firstTrack + i] != labels[i])) {
+      LOGP(error, "Refitted track {} differs with {} threads: {} vs {} serially", i, mNThreads, trMT.asString(), tr.asString());
+      return;
     }
-    mWinnerChi2Refit[iITS] = mMatchedTracks.back().getChi2Refit();
   }
-  mTimer[SWRefit].Stop();
+  LOGP(info, "{} tracks refitted with {} threads are identical to the serial ones", nRefitted, mNThreads);
 }
 
 //______________________________________________
-bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
+bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS, std::vector<o2::dataformats::TrackTPCITS>& matchedTracks,
+                                   MCLabContTr& matchLabels, std::vector<o2::dataformats::Pair<float, float>>& tglITSTPC)
 {
-  ///< refit in inward direction the pair of TPC and ITS tracks
+  ///< refit in inward direction the pair of TPC and ITS tracks, adding the result to the provided containers.
+  ///< Different TPC tracks can be refitted concurrently to different containers
 
   const float maxStep = 2.f; // max propagation step (TODO: tune)
   const auto& tTPC = mTPCWork[iTPC];
@@ -1237,8 +1367,8 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   const auto& tITS = mITSWork[iITS];
   const auto& itsTrOrig = mITSTracksArray[tITS.sourceID];
 
-  mMatchedTracks.emplace_back(tTPC, tITS); // create a copy of TPC track at xRef
-  auto& trfit = mMatchedTracks.back();
+  matchedTracks.emplace_back(tTPC, tITS); // create a copy of TPC track at xRef
+  auto& trfit = matchedTracks.back();
   // in continuos mode the Z of TPC track is meaningless, unless it is CE crossing
   // track (currently absent, TODO)
   if (!mCompareTracksDZ) {
@@ -1249,7 +1379,7 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   float timeErr = tTPC.constraint == TrackLocTPC::Constrained ? tTPC.timeErr : std::sqrt(tITS.getSigmaZ2() + tTPC.getSigmaZ2()) * mTPCVDrift0Inv; // estimate the error on time
   if (timeC < 0) {                                                                                                                                // RS TODO similar check is needed for other edge of TF
     if (timeC + std::min(timeErr, mParams->tfEdgeTimeToleranceMUS * mTPCTBinMUSInv) < 0) {
-      mMatchedTracks.pop_back(); // destroy failed track
+      matchedTracks.pop_back(); // destroy failed track
       return false;
     }
     timeC = 0.;
@@ -1290,7 +1420,7 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   if (nclRefit != ncl) {
     LOGP(debug, "Refit in ITS failed after ncl={}, match between TPC track #{} and ITS track #{}", nclRefit, tTPC.sourceID, tITS.sourceID);
     LOGP(debug, "{:s}", trfit.asString());
-    mMatchedTracks.pop_back(); // destroy failed track
+    matchedTracks.pop_back(); // destroy failed track
     return false;
   }
 
@@ -1312,7 +1442,7 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     if (!tracOut.getXatLabR(o2::constants::geom::XTPCInnerRef, xtogo, mBz, o2::track::DirOutward) ||
         !propagator->PropagateToXBxByBz(tracOut, xtogo, MaxSnp, 10., mUseMatCorrFlag, &tofL)) {
       LOG(debug) << "Propagation to inner TPC boundary X=" << xtogo << " failed, Xtr=" << tracOut.getX() << " snp=" << tracOut.getSnp();
-      mMatchedTracks.pop_back(); // destroy failed track
+      matchedTracks.pop_back(); // destroy failed track
       return false;
     }
     if (mVDriftCalibOn) {
@@ -1323,13 +1453,13 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     auto tImposed = timeC * mTPCTBinMUSInv;
     if (std::abs(tImposed - mTPCTracksArray[tTPC.sourceID].getTime0()) > 550) { // RS FIXME: should be removed once TOF fixes https://github.com/AliceO2Group/AliceO2/pull/6540#issuecomment-880060760
       LOG(error) << "Impossible imposed timebin " << tImposed << " for TPC track with timebin0 " << mTPCTracksArray[tTPC.sourceID].getTime0() << " TB";
-      mMatchedTracks.pop_back(); // destroy failed track
+      matchedTracks.pop_back(); // destroy failed track
       return false;
     }
     int retVal = mTPCRefitter->RefitTrackAsTrackParCov(tracOut, mTPCTracksArray[tTPC.sourceID].getClusterRef(), tImposed, &chi2Out, true, false); // outward refit
     if (retVal < 0) {
       LOG(debug) << "Refit failed";
-      mMatchedTracks.pop_back(); // destroy failed track
+      matchedTracks.pop_back(); // destroy failed track
       return false;
     }
     auto posEnd = tracOut.getXYZGlo();
@@ -1360,13 +1490,13 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   trfit.setRefITS({unsigned(tITS.sourceID), o2::dataformats::GlobalTrackID::ITS});
 
   if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
-    auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
+    auto& lbl = matchLabels.emplace_back(mTPCLblWork[iTPC]);
     lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
   }
 
   // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
   if (mVDriftCalibOn) {
-    mTglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
+    tglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
   }
   //  trfit.print(); // DBG
 
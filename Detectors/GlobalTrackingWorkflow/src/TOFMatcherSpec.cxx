@@ -93,6 +93,8 @@ void TOFMatcherSpec::init(InitContext& ic)
   if (mStrict) {
     mMatcher.setHighPurity();
   }
+  mMatcher.setNThreads(std::max(1, ic.options().get<int>("nthreads")));
+  mMatcher.setCheckThreads(ic.options().get<bool>("check-threads"));
 }
 
 void TOFMatcherSpec::run(ProcessingContext& pc)
@@ -216,7 +218,9 @@ DataProcessorSpec getTOFMatcherSpec(GID::mask_t src, bool useMC, bool useFIT, bo
     outputs,
     AlgorithmSpec{adaptFromTask<TOFMatcherSpec>(dataRequest, useMC, useFIT, tpcRefit, strict)},
     Options{
-      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads for the matching of the sectors"}},
+      {"check-threads", VariantType::Bool, false, {"Rerun the matching serially and report any difference to the multi-threaded one (validation)"}}}};
 }
 
 } // namespace globaltracking
@@ -78,6 +78,8 @@ struct TrackingParameters {
   bool UseMatBudLUT = false;
   unsigned long MaxMemory = 12000000000UL;
   std::array<float, 2> FitIterationMaxChi2 = {50, 20};
+  /// Number of CPU threads for tracklet and cell finding, the neighbour and road finding and the track fit are serial
+  int NThreads = 1;
 };
 
 struct MemoryParameters {
@@ -57,6 +57,8 @@ class ROFRecord;
 namespace its
 {
 
+class ROframe;
+
 using Vertex = o2::dataformats::Vertex<o2::dataformats::TimeStamp<int>>;
 
 class TimeFrame final
@@ -78,6 +80,9 @@ class TimeFrame final
                       const itsmft::TopologyDictionary* dict,
                       const dataformats::MCTruthContainer<MCCompLabel>* mcLabels = nullptr);
 
+  /// load the clusters of a RO frame already in the global and tracking frames, no geometry is needed
+  int loadROFrameData(const ROframe& rof);
+
   int getTotalClusters() const;
   bool empty() const;
 
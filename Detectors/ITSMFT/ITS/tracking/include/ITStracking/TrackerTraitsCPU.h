@@ -31,6 +31,7 @@
 #include "ITStracking/MathUtils.h"
 #include "ITStracking/TimeFrame.h"
 #include "ITStracking/Road.h"
+#include "CommonUtils/ThreadPool.h"
 
 namespace o2
 {
@@ -46,8 +47,12 @@ class TrackerTraitsCPU : public TrackerTraits
   void refitTracks(const std::vector<std::vector<TrackingFrameInfo>>& tf, std::vector<TrackITSExt>& tracks) final;
 
  protected:
+  /// pool with TrackingParameters::NThreads workers, recreated when the number of threads changes
+  o2::utils::ThreadPool& getThreadPool();
+
   std::vector<std::vector<Tracklet>> mTracklets;
   std::vector<std::vector<Cell>> mCells;
+  std::unique_ptr<o2::utils::ThreadPool> mThreadPool;
 };
 } // namespace its
 } // namespace o2
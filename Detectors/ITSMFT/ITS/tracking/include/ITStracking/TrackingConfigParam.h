@@ -51,6 +51,7 @@ struct TrackerParamConfig : public o2::conf::ConfigurableParamHelper<TrackerPara
   float diamondPos[3] = {0.f, 0.f, 0.f};
   bool useDiamond = false;
   unsigned long maxMemory = 0;
+  int nThreads = 1; // number of CPU threads for tracklet and cell finding
 
   O2ParamDef(TrackerParamConfig, "ITSCATrackerParam");
 };
@@ -20,6 +20,7 @@
 #include "DataFormatsITSMFT/TopologyDictionary.h"
 #include "ITSBase/GeometryTGeo.h"
 #include "ITSMFTBase/SegmentationAlpide.h"
+#include "ITStracking/ROframe.h"
 #include "ITStracking/TrackingConfigParam.h"
 
 #include <iostream>
@@ -118,6 +119,29 @@ int TimeFrame::loadROFrameData(const o2::itsmft::ROFRecord& rof, gsl::span<const
   return clusters_in_frame.size();
 }
 
+int TimeFrame::loadROFrameData(const ROframe& rof)
+{
+  for (unsigned int iL{0}; iL < mUnsortedClusters.size(); ++iL) {
+    for (auto& c : rof.getClustersOnLayer(iL)) {
+      const auto& tf = rof.getClusterTrackingFrameInfo(iL, c);
+      addTrackingFrameInfoToLayer(iL, tf.xCoordinate, tf.yCoordinate, tf.zCoordinate, tf.xTrackingFrame, tf.alphaTrackingFrame,
+                                  std::array<float, 2>{tf.positionTrackingFrame[0], tf.positionTrackingFrame[1]},
+                                  std::array<float, 3>{tf.covarianceTrackingFrame[0], tf.covarianceTrackingFrame[1], tf.covarianceTrackingFrame[2]});
+      addClusterToLayer(iL, c.xCoordinate, c.yCoordinate, c.zCoordinate, mUnsortedClusters[iL].size());
+      addClusterExternalIndexToLayer(iL, rof.getClusterExternalIndex(iL, c.clusterId));
+    }
+  }
+
+  for (unsigned int iL{0}; iL < mUnsortedClusters.size(); ++iL) {
+    mROframesClusters[iL].push_back(mUnsortedClusters[iL].size());
+    if (iL < 2) {
+      mTrackletsIndexROf[iL].push_back(mUnsortedClusters[1].size()); // Tracklets used in vertexer are always computed starting from L1
+    }
+  }
+  mNrof++;
+  return rof.getTotalClusters();
+}
+
 int TimeFrame::loadROFrameData(gsl::span<o2::itsmft::ROFRecord> rofs,
                                gsl::span<const itsmft::CompClusterExt> clusters,
                                gsl::span<const unsigned char>::iterator& pattIt,
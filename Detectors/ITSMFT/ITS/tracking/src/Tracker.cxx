@@ -152,6 +152,8 @@ void Tracker::findCellsNeighbours(int& iteration)
 
 void Tracker::findRoads(int& iteration)
 {
+  // Serial for any TrackingParameters::NThreads: the roads are only walks over the cell neighbours computed before, appended
+  // depth-first to a single vector whose order decides which of the tracks sharing clusters are kept in findTracks.
   for (int iLevel{mTrkParams[iteration].CellsPerRoad()}; iLevel >= mTrkParams[iteration].CellMinimumLevel(); --iLevel) {
     CA_DEBUGGER(int nRoads = -mTimeFrame->getRoads().size());
     const int minimumLevel{iLevel - 1};
@@ -682,6 +684,7 @@ void Tracker::getGlobalConfiguration()
     if (tc.maxMemory) {
       params.MaxMemory = tc.maxMemory;
     }
+    params.NThreads = tc.nThreads > 0 ? tc.nThreads : params.NThreads;
   }
 }
 
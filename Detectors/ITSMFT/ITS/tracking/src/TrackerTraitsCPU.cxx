@@ -22,6 +22,7 @@
 #include "ITStracking/Tracklet.h"
 #include <fmt/format.h>
 #include "ReconstructionDataFormats/Track.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -53,128 +54,152 @@ void TrackerTraitsCPU::computeLayerTracklets()
 
   const Vertex diamondVert({mTrkParams.Diamond[0], mTrkParams.Diamond[1], mTrkParams.Diamond[2]}, {25.e-6f, 0.f, 0.f, 25.e-6f, 0.f, 36.f}, 1, 1.f);
   gsl::span<const Vertex> diamondSpan(&diamondVert, 1);
-  for (int rof0{0}; rof0 < tf->getNrof(); ++rof0) {
-    gsl::span<const Vertex> primaryVertices = mTrkParams.UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
-    int minRof = (rof0 >= mTrkParams.DeltaROF) ? rof0 - mTrkParams.DeltaROF : 0;
-    int maxRof = (rof0 == tf->getNrof() - mTrkParams.DeltaROF) ? rof0 : rof0 + mTrkParams.DeltaROF;
-    for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
-      gsl::span<const Cluster> layer0 = tf->getClustersOnLayer(rof0, iLayer);
-      if (layer0.empty()) {
-        continue;
-      }
-      float meanDeltaR{mTrkParams.LayerRadii[iLayer + 1] - mTrkParams.LayerRadii[iLayer]};
 
-      const int currentLayerClustersNum{static_cast<int>(layer0.size())};
-      for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
-        const Cluster& currentCluster{layer0[iCluster]};
-        const int currentSortedIndex{tf->getSortedIndex(rof0, iLayer, iCluster)};
-
-        if (tf->isClusterUsed(iLayer, currentCluster.clusterId)) {
+  /// ROFs are split in contiguous chunks processed concurrently. The first chunk fills the TimeFrame directly, the
+  /// others are appended in ROF order afterwards: the output does not depend on the number of threads.
+  /// The tracklet LUT entries incremented by a chunk belong to the clusters of its own ROFs, thus are not shared.
+  auto& pool = getThreadPool();
+  const int nRof{tf->getNrof()};
+  const int nChunks{pool.getNThreads() > 1 ? std::min(nRof, int(pool.getNThreads()) * 4) : 1};
+  std::vector<std::vector<std::vector<Tracklet>>> chunkTracklets(nChunks > 1 ? nChunks - 1 : 0, std::vector<std::vector<Tracklet>>(mTrkParams.TrackletsPerRoad()));
+
+  pool.run(nChunks, [&](size_t iChunk) {
+    auto& tracklets = iChunk ? chunkTracklets[iChunk - 1] : tf->getTracklets();
+    const int firstRof = nRof * iChunk / nChunks, lastRof = nRof * (iChunk + 1) / nChunks;
+    for (int rof0{firstRof}; rof0 < lastRof; ++rof0) {
+      gsl::span<const Vertex> primaryVertices = mTrkParams.UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
+      int minRof = (rof0 >= mTrkParams.DeltaROF) ? rof0 - mTrkParams.DeltaROF : 0;
+      int maxRof = (rof0 == tf->getNrof() - mTrkParams.DeltaROF) ? rof0 : rof0 + mTrkParams.DeltaROF;
+      for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
+        gsl::span<const Cluster> layer0 = tf->getClustersOnLayer(rof0, iLayer);
+        if (layer0.empty()) {
           continue;
         }
-        const float inverseR0{1.f / currentCluster.radius};
-
-        for (auto& primaryVertex : primaryVertices) {
-          const float resolution = std::sqrt(Sq(mTrkParams.PVres) / primaryVertex.getNContributors() + Sq(tf->getPositionResolution(iLayer)));
+        float meanDeltaR{mTrkParams.LayerRadii[iLayer + 1] - mTrkParams.LayerRadii[iLayer]};
 
-          const float tanLambda{(currentCluster.zCoordinate - primaryVertex.getZ()) * inverseR0};
+        const int currentLayerClustersNum{static_cast<int>(layer0.size())};
+        for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
+          const Cluster& currentCluster{layer0[iCluster]};
+          const int currentSortedIndex{tf->getSortedIndex(rof0, iLayer, iCluster)};
 
-          const float zAtRmin{tanLambda * (tf->getMinR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
-          const float zAtRmax{tanLambda * (tf->getMaxR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
+          if (tf->isClusterUsed(iLayer, currentCluster.clusterId)) {
+            continue;
+          }
+          const float inverseR0{1.f / currentCluster.radius};
 
-          const float sqInverseDeltaZ0{1.f / (Sq(currentCluster.zCoordinate - primaryVertex.getZ()) + 2.e-8f)}; ///protecting from overflows adding the detector resolution
-          const float sigmaZ{std::sqrt(Sq(resolution) * Sq(tanLambda) * ((Sq(inverseR0) + sqInverseDeltaZ0) * Sq(meanDeltaR) + 1.f) + Sq(meanDeltaR * tf->getMSangle(iLayer)))};
+          for (auto& primaryVertex : primaryVertices) {
+            const float resolution = std::sqrt(Sq(mTrkParams.PVres) / primaryVertex.getNContributors() + Sq(tf->getPositionResolution(iLayer)));
 
-          const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, zAtRmin, zAtRmax,
-                                                  sigmaZ * mTrkParams.NSigmaCut, tf->getPhiCut(iLayer))};
+            const float tanLambda{(currentCluster.zCoordinate - primaryVertex.getZ()) * inverseR0};
 
-          if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
-            continue;
-          }
+            const float zAtRmin{tanLambda * (tf->getMinR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
+            const float zAtRmax{tanLambda * (tf->getMaxR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
 
-          int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
+            const float sqInverseDeltaZ0{1.f / (Sq(currentCluster.zCoordinate - primaryVertex.getZ()) + 2.e-8f)}; ///protecting from overflows adding the detector resolution
+            const float sigmaZ{std::sqrt(Sq(resolution) * Sq(tanLambda) * ((Sq(inverseR0) + sqInverseDeltaZ0) * Sq(meanDeltaR) + 1.f) + Sq(meanDeltaR * tf->getMSangle(iLayer)))};
 
-          if (phiBinsNum < 0) {
-            phiBinsNum += mTrkParams.PhiBins;
-          }
+            const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, zAtRmin, zAtRmax,
+                                                    sigmaZ * mTrkParams.NSigmaCut, tf->getPhiCut(iLayer))};
 
-          for (int rof1{minRof}; rof1 <= maxRof; ++rof1) {
-            gsl::span<const Cluster> layer1 = tf->getClustersOnLayer(rof1, iLayer + 1);
-            if (layer1.empty()) {
+            if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
               continue;
             }
 
-            for (int iPhiCount{0}; iPhiCount < phiBinsNum; iPhiCount++) {
-              int iPhiBin = (selectedBinsRect.y + iPhiCount) % mTrkParams.PhiBins;
-              const int firstBinIndex{tf->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
-              const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
-              if constexpr (debugLevel) {
-                if (firstBinIndex < 0 || firstBinIndex > tf->getIndexTables(rof1)[iLayer].size() ||
-                    maxBinIndex < 0 || maxBinIndex > tf->getIndexTables(rof1)[iLayer].size()) {
-                  std::cout << iLayer << "\t" << iCluster << "\t" << zAtRmin << "\t" << zAtRmax << "\t" << sigmaZ * mTrkParams.NSigmaCut << "\t" << tf->getPhiCut(iLayer) << std::endl;
-                  std::cout << currentCluster.zCoordinate << "\t" << primaryVertex.getZ() << "\t" << currentCluster.radius << std::endl;
-                  std::cout << tf->getMinR(iLayer + 1) << "\t" << currentCluster.radius << "\t" << currentCluster.zCoordinate << std::endl;
-                  std::cout << "Illegal access to IndexTable " << firstBinIndex << "\t" << maxBinIndex << "\t" << selectedBinsRect.z << "\t" << selectedBinsRect.x << std::endl;
-                  exit(1);
-                }
+            int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
+
+            if (phiBinsNum < 0) {
+              phiBinsNum += mTrkParams.PhiBins;
+            }
+
+            for (int rof1{minRof}; rof1 <= maxRof; ++rof1) {
+              gsl::span<const Cluster> layer1 = tf->getClustersOnLayer(rof1, iLayer + 1);
+              if (layer1.empty()) {
+                continue;
               }
-              const int firstRowClusterIndex = tf->getIndexTables(rof1)[iLayer][firstBinIndex];
-              const int maxRowClusterIndex = tf->getIndexTables(rof1)[iLayer][maxBinIndex];
 
-              for (int iNextCluster{firstRowClusterIndex}; iNextCluster < maxRowClusterIndex; ++iNextCluster) {
-                if (iNextCluster >= (int)layer1.size()) {
-                  break;
+              for (int iPhiCount{0}; iPhiCount < phiBinsNum; iPhiCount++) {
+                int iPhiBin = (selectedBinsRect.y + iPhiCount) % mTrkParams.PhiBins;
+                const int firstBinIndex{tf->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
+                const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
+                if constexpr (debugLevel) {
+                  if (firstBinIndex < 0 || firstBinIndex > tf->getIndexTables(rof1)[iLayer].size() ||
+                      maxBinIndex < 0 || maxBinIndex > tf->getIndexTables(rof1)[iLayer].size()) {
+                    std::cout << iLayer << "\t" << iCluster << "\t" << zAtRmin << "\t" << zAtRmax << "\t" << sigmaZ * mTrkParams.NSigmaCut << "\t" << tf->getPhiCut(iLayer) << std::endl;
+                    std::cout << currentCluster.zCoordinate << "\t" << primaryVertex.getZ() << "\t" << currentCluster.radius << std::endl;
+                    std::cout << tf->getMinR(iLayer + 1) << "\t" << currentCluster.radius << "\t" << currentCluster.zCoordinate << std::endl;
+                    std::cout << "Illegal access to IndexTable " << firstBinIndex << "\t" << maxBinIndex << "\t" << selectedBinsRect.z << "\t" << selectedBinsRect.x << std::endl;
+                    exit(1);
+                  }
                 }
-                const Cluster& nextCluster{layer1[iNextCluster]};
+                const int firstRowClusterIndex = tf->getIndexTables(rof1)[iLayer][firstBinIndex];
+                const int maxRowClusterIndex = tf->getIndexTables(rof1)[iLayer][maxBinIndex];
 
-                if (tf->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
-                  continue;
-                }
+                for (int iNextCluster{firstRowClusterIndex}; iNextCluster < maxRowClusterIndex; ++iNextCluster) {
+                  if (iNextCluster >= (int)layer1.size()) {
+                    break;
+                  }
+                  const Cluster& nextCluster{layer1[iNextCluster]};
 
-                const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi)};
-                const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.radius - currentCluster.radius) +
-                                                           currentCluster.zCoordinate - nextCluster.zCoordinate)};
+                  if (tf->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
+                    continue;
+                  }
+
+                  const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi)};
+                  const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.radius - currentCluster.radius) +
+                                                             currentCluster.zCoordinate - nextCluster.zCoordinate)};
 
 #ifdef OPTIMISATION_OUTPUT
-                MCCompLabel label;
-                int currentId{currentCluster.clusterId};
-                int nextId{nextCluster.clusterId};
-                for (auto& lab1 : tf->getClusterLabels(iLayer, currentId)) {
-                  for (auto& lab2 : tf->getClusterLabels(iLayer + 1, nextId)) {
-                    if (lab1 == lab2 && lab1.isValid()) {
-                      label = lab1;
+                  MCCompLabel label;
+                  int currentId{currentCluster.clusterId};
+                  int nextId{nextCluster.clusterId};
+                  for (auto& lab1 : tf->getClusterLabels(iLayer, currentId)) {
+                    for (auto& lab2 : tf->getClusterLabels(iLayer + 1, nextId)) {
+                      if (lab1 == lab2 && lab1.isValid()) {
+                        label = lab1;
+                        break;
+                      }
+                    }
+                    if (label.isValid()) {
                       break;
                     }
                   }
-                  if (label.isValid()) {
-                    break;
-                  }
-                }
-                off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
+                  off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
 #endif
 
-                if (deltaZ / sigmaZ < mTrkParams.NSigmaCut &&
-                    (deltaPhi < tf->getPhiCut(iLayer) ||
-                     gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < tf->getPhiCut(iLayer))) {
-                  if (iLayer > 0) {
-                    tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
+                  if (deltaZ / sigmaZ < mTrkParams.NSigmaCut &&
+                      (deltaPhi < tf->getPhiCut(iLayer) ||
+                       gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < tf->getPhiCut(iLayer))) {
+                    if (iLayer > 0) {
+                      tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
+                    }
+                    const float phi{o2::gpu::GPUCommonMath::ATan2(currentCluster.yCoordinate - nextCluster.yCoordinate,
+                                                                  currentCluster.xCoordinate - nextCluster.xCoordinate)};
+                    const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
+                                     (currentCluster.radius - nextCluster.radius)};
+                    tracklets[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
                   }
-                  const float phi{o2::gpu::GPUCommonMath::ATan2(currentCluster.yCoordinate - nextCluster.yCoordinate,
-                                                                currentCluster.xCoordinate - nextCluster.xCoordinate)};
-                  const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
-                                   (currentCluster.radius - nextCluster.radius)};
-                  tf->getTracklets()[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
                 }
               }
             }
           }
         }
-      }
-      if (!tf->checkMemory(mTrkParams.MaxMemory)) {
-        return;
+        if (nChunks == 1 && !tf->checkMemory(mTrkParams.MaxMemory)) {
+          return;
+        }
       }
     }
+  });
+
+  for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
+    auto& trkl{tf->getTracklets()[iLayer]};
+    for (auto& chunk : chunkTracklets) {
+      trkl.insert(trkl.end(), chunk[iLayer].begin(), chunk[iLayer].end());
+    }
   }
+  if (!tf->checkMemory(mTrkParams.MaxMemory)) {
+    return;
+  }
+
   /// Cold code, fixups
 
   for (int iLayer{0}; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
@@ -252,11 +277,19 @@ void TrackerTraitsCPU::computeLayerCells()
 #endif
 
   TimeFrame* tf = mTimeFrame;
-  for (int iLayer{0}; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
+  /// Each layer fills its own cells and cells LUT, so the layers are processed concurrently
+  auto& pool = getThreadPool();
+  const bool sequential{pool.getNThreads() == 1};
+  bool outOfMemory{false};
+  pool.run(mTrkParams.CellsPerRoad(), [&](size_t layer) {
+    const int iLayer{static_cast<int>(layer)};
+    if (outOfMemory) {
+      return;
+    }
 
     if (tf->getTracklets()[iLayer + 1].empty() ||
         tf->getTracklets()[iLayer].empty()) {
-      continue;
+      return;
     }
 
     float resolution{std::sqrt(Sq(mTrkParams.LayerMisalignment[iLayer]) + Sq(mTrkParams.LayerMisalignment[iLayer + 1]) + Sq(mTrkParams.LayerMisalignment[iLayer + 2])) / mTrkParams.LayerResolution[iLayer]};
@@ -306,9 +339,12 @@ void TrackerTraitsCPU::computeLayerCells()
     if (iLayer > 0) {
       tf->getCellsLookupTable()[iLayer - 1].resize(currentLayerTrackletsNum + 1, tf->getCells()[iLayer].size());
     }
-    if (!tf->checkMemory(mTrkParams.MaxMemory)) {
-      return;
+    if (sequential && !tf->checkMemory(mTrkParams.MaxMemory)) {
+      outOfMemory = true;
     }
+  });
+  if (outOfMemory || !tf->checkMemory(mTrkParams.MaxMemory)) {
+    return;
   }
 
   /// Create cells labels
@@ -329,6 +365,15 @@ void TrackerTraitsCPU::computeLayerCells()
   }
 }
 
+o2::utils::ThreadPool& TrackerTraitsCPU::getThreadPool()
+{
+  const size_t nThreads = std::max(1, mTrkParams.NThreads);
+  if (!mThreadPool || mThreadPool->getNThreads() != nThreads) {
+    mThreadPool = std::make_unique<o2::utils::ThreadPool>(nThreads);
+  }
+  return *mThreadPool;
+}
+
 void TrackerTraitsCPU::refitTracks(const std::vector<std::vector<TrackingFrameInfo>>& tf, std::vector<TrackITSExt>& tracks)
 {
   std::vector<const Cell*> cells;
@@ -0,0 +1,175 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTrackerThreads.cxx
+/// \brief Tests that the tracklets, cells and tracks of the ITS CA tracker do not depend on the number of CPU threads
+
+#define BOOST_TEST_MODULE Test ITS Tracker Threads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ITStracking/ROframe.h"
+#include "ITStracking/TimeFrame.h"
+#include "ITStracking/Tracker.h"
+#include "ITStracking/TrackerTraitsCPU.h"
+#include "Field/MagneticField.h"
+#include <TGeoGlobalMagField.h>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace its
+{
+
+namespace
+{
+constexpr int NRof = 8;
+constexpr float Bz = 5.f;                                                             // kG
+constexpr float ClusterResolution = 5.e-4f;                                           // cm
+constexpr float LayerRadii[7] = {2.33f, 3.13f, 3.91f, 19.6f, 24.55f, 34.39f, 39.34f}; // cm
+
+/// RO frames with tracks from a vertex at the beam line and noise clusters, each cluster sitting on a sensor tangent to its layer
+std::vector<ROframe> createROFrames()
+{
+  std::vector<ROframe> rofs;
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI), tanLDist(-0.8f, 0.8f), ptDist(0.3f, 5.f), vtxDist(-5.f, 5.f), noiseZDist(-1.f, 1.f);
+  std::normal_distribution<float> resDist(0.f, ClusterResolution);
+  int externalIndex = 0;
+  for (int iRof = 0; iRof < NRof; iRof++) {
+    auto& rof = rofs.emplace_back(iRof, 7);
+    auto addCluster = [&](int layer, float alpha, float y, float z) {
+      const float r = LayerRadii[layer], cosA = std::cos(alpha), sinA = std::sin(alpha);
+      const float x = r * cosA - y * sinA, yGlo = r * sinA + y * cosA;
+      const int id = rof.getClustersOnLayer(layer).size();
+      rof.addTrackingFrameInfoToLayer(layer, x, yGlo, z, r, alpha, std::array<float, 2>{y, z},
+                                      std::array<float, 3>{ClusterResolution * ClusterResolution, 0.f, ClusterResolution * ClusterResolution});
+      rof.addClusterToLayer(layer, x, yGlo, z, id);
+      rof.addClusterExternalIndexToLayer(layer, externalIndex++);
+    };
+    const float zVtx = vtxDist(gen);
+    for (int iTrack = 0; iTrack < 30; iTrack++) {
+      const float phi0 = phiDist(gen), tanL = tanLDist(gen), radius = ptDist(gen) / (0.299792458e-3f * Bz); // cm
+      const float charge = iTrack % 2 ? 1.f : -1.f;
+      for (int layer = 0; layer < 7; layer++) {
+        const float halfAngle = std::asin(LayerRadii[layer] / (2.f * radius)); // helix from the origin crossing the layer
+        addCluster(layer, phi0 - charge * halfAngle, resDist(gen), zVtx + 2.f * radius * halfAngle * tanL + resDist(gen));
+      }
+    }
+    for (int layer = 0; layer < 7; layer++) {
+      for (int iNoise = 0; iNoise < 20; iNoise++) {
+        addCluster(layer, phiDist(gen), 0.f, noiseZDist(gen) * LayerRadii[layer]);
+      }
+    }
+    rof.addPrimaryVertex(0.f, 0.f, zVtx);
+  }
+  return rofs;
+}
+
+struct TrackingResult {
+  std::vector<std::vector<Tracklet>> tracklets;
+  std::vector<std::vector<Cell>> cells;
+  std::vector<std::vector<float>> tracks; // per RO frame, parameters, covariances and cluster indices of all tracks
+};
+
+TrackingResult runTracker(const std::vector<ROframe>& rofs, int nThreads)
+{
+  TimeFrame timeFrame;
+  for (const auto& rof : rofs) {
+    timeFrame.loadROFrameData(rof);
+    std::vector<Vertex> vertices(1);
+    vertices[0].setXYZ(0.f, 0.f, rof.getPrimaryVertex(0).z);
+    vertices[0].setNContributors(30);
+    timeFrame.addPrimaryVertices(vertices);
+  }
+  timeFrame.setMultiplicityCutMask(std::vector<bool>(NRof, true));
+
+  TrackerTraitsCPU traits;
+  Tracker tracker(&traits);
+  std::vector<TrackingParameters> trackParams(1);
+  std::vector<MemoryParameters> memParams(1);
+  trackParams[0].MinTrackLength = 7;
+  trackParams[0].NThreads = nThreads; // as set by ITSCATrackerParam.nThreads
+  tracker.setParameters(memParams, trackParams);
+  tracker.adoptTimeFrame(timeFrame);
+  tracker.setBz(Bz);
+  tracker.clustersToTracks([](std::string) {}, [](std::string s) { BOOST_FAIL(s); });
+
+  TrackingResult result{timeFrame.getTracklets(), timeFrame.getCells(), {}};
+  for (int iRof = 0; iRof < NRof; iRof++) {
+    auto& tracks = result.tracks.emplace_back();
+    for (const auto& track : timeFrame.getTracks(iRof)) {
+      tracks.insert(tracks.end(), {track.getX(), track.getAlpha(), track.getChi2(), float(track.getNumberOfClusters())});
+      for (int i = 0; i < 5; i++) {
+        tracks.push_back(track.getParam(i));
+      }
+      for (int i = 0; i < 15; i++) {
+        tracks.push_back(track.getCov()[i]);
+      }
+      for (int i = 0; i < 7; i++) {
+        tracks.push_back(track.getClusterIndex(i));
+      }
+    }
+  }
+  return result;
+}
+
+template <typename T>
+void checkIdentical(const std::vector<std::vector<T>>& ref, const std::vector<std::vector<T>>& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+  for (size_t i = 0; i < ref.size(); i++) {
+    BOOST_REQUIRE_EQUAL(ref[i].size(), test[i].size());
+    BOOST_CHECK(std::memcmp(ref[i].data(), test[i].data(), ref[i].size() * sizeof(T)) == 0);
+  }
+}
+} // namespace
+
+/// @brief The chunks of RO frames and the layers processed concurrently are merged in the order of the serial processing
+BOOST_AUTO_TEST_CASE(ITSTracker_threads_test)
+{
+  auto field = o2::field::MagneticField::createNominalField(5);
+  TGeoGlobalMagField::Instance()->SetField(field);
+  TGeoGlobalMagField::Instance()->Lock();
+
+  const auto rofs = createROFrames();
+  const auto serial = runTracker(rofs, 1);
+  size_t nTracklets = 0, nCells = 0, nTracks = 0;
+  for (const auto& t : serial.tracklets) {
+    nTracklets += t.size();
+  }
+  for (const auto& c : serial.cells) {
+    nCells += c.size();
+  }
+  for (const auto& t : serial.tracks) {
+    nTracks += t.size();
+  }
+  BOOST_CHECK(nTracklets > 0);
+  BOOST_CHECK(nCells > 0);
+  BOOST_CHECK(nTracks > 0);
+
+  for (int nThreads : {2, 4}) {
+    const auto parallel = runTracker(rofs, nThreads);
+    checkIdentical(serial.tracklets, parallel.tracklets);
+    checkIdentical(serial.cells, parallel.cells);
+    checkIdentical(serial.tracks, parallel.tracks);
+  }
+}
+
+} // namespace its
+} // namespace o2
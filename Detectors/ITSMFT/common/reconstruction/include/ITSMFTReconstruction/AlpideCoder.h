@@ -12,6 +12,7 @@
 #ifndef ALICEO2_ITSMFT_ALPIDE_CODER_H
 #define ALICEO2_ITSMFT_ALPIDE_CODER_H
 #include <Rtypes.h>
+#include <array>
 #include <cstdio>
 #include <cstdint>
 #include <vector>
@@ -79,6 +80,17 @@ class AlpideCoder
   static constexpr int NDColInReg = NCols / NRegions / 2;
   static constexpr int HitMapSize = 7;
 
+  /// Hits encoded by the hitmap of a DATALONG word, for a given parity of the address of its
+  /// first pixel: row offsets w.r.t. the first pixel of the extra hits in the left and in the
+  /// right column, in increasing address order
+  struct HitMapExpansion {
+    uint8_t nLeft = 0;
+    uint8_t nRight = 0;
+    uint8_t maxAddrOffset = 0; // offset of the highest address encoded in the hitmap
+    uint8_t dRowLeft[HitMapSize] = {};
+    uint8_t dRowRight[HitMapSize] = {};
+  };
+
   // masks for records components
   static constexpr uint32_t MaskEncoder = 0x3c00;                 // encoder (double column) ID takes 4 bit max (0:15)
   static constexpr uint32_t MaskPixID = 0x3ff;                    // pixel ID within encoder (double column) takes 10 bit max (0:1023)
@@ -117,6 +129,36 @@ class AlpideCoder
 
   static void setNoisyPixels(const NoiseMap* noise) { mNoisyPixels = noise; }
 
+  /// expand the DATALONG hitmaps with a lookup table instead of testing the hitmap bit by bit
+  static void setDataLongLUT(bool v) { mDataLongLUT = v; }
+  static bool isDataLongLUT() { return mDataLongLUT; }
+
+  /// table of the hitmap expansions, indexed by the 2 lowest bits of the address of the first pixel and by the hitmap
+  static const std::array<std::array<HitMapExpansion, MaskHitMap + 1>, 4>& getHitMapLUT()
+  {
+    static const auto lut = []() {
+      std::array<std::array<HitMapExpansion, MaskHitMap + 1>, 4> t{};
+      for (uint16_t addr0 = 0; addr0 < 4; addr0++) {
+        for (uint16_t hitsPattern = 0; hitsPattern <= MaskHitMap; hitsPattern++) {
+          auto& exp = t[addr0][hitsPattern];
+          for (int ip = 0; ip < HitMapSize; ip++) {
+            if (hitsPattern & (0x1 << ip)) {
+              uint16_t addr = addr0 + ip + 1, dRow = (addr >> 1) - (addr0 >> 1);
+              if ((addr >> 1) & 0x1 ? !(addr & 0x1) : (addr & 0x1)) { // right column
+                exp.dRowRight[exp.nRight++] = dRow;
+              } else {
+                exp.dRowLeft[exp.nLeft++] = dRow;
+              }
+              exp.maxAddrOffset = ip + 1;
+            }
+          }
+        }
+      }
+      return t;
+    }();
+    return lut;
+  }
+
   /// decode alpide data for the next non-empty chip from the buffer
   template <class T, typename CG>
   static int decodeChip(ChipPixelData& chipData, T& buffer, CG cidGetter)
@@ -302,21 +344,47 @@ class AlpideCoder
 #endif
               return unexpectedEOF("CHIP_DATA_LONG:Pattern"); // abandon cable data
             }
-            for (int ip = 0; ip < HitMapSize; ip++) {
-              if (hitsPattern & (0x1 << ip)) {
-                uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
-                if (addr & ~MaskPixID) {
+            if (mDataLongLUT) {
+              const auto& exp = getHitMapLUT()[pixID & 0x3][hitsPattern];
+              if ((pixID + exp.maxAddrOffset) & ~MaskPixID) {
 #ifdef ALPIDE_DECODING_STAT
-                  chipData.setError(ChipStat::WrongRow);
+                chipData.setError(ChipStat::WrongRow);
 #endif
-                  return unexpectedEOF(fmt::format("Non-existing encoder {} decoded, DataLong was {:x}", pixID, dataS)); // abandon cable data
+                return unexpectedEOF(fmt::format("Non-existing encoder {} decoded, DataLong was {:x}", pixID, dataS)); // abandon cable data
+              }
+              for (int ih = 0; ih < exp.nRight; ih++) {
+                rightColHits[nRightCHits++] = row + exp.dRowRight[ih];
+              }
+              if (mNoisyPixels) {
+                for (int ih = 0; ih < exp.nLeft; ih++) {
+                  addHit(chipData, row + exp.dRowLeft[ih], colD);
                 }
-                rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1)); // true for right column / lalse for left
-                // the real columnt is int colE = colD + rightC;
-                if (rightC) { // same as above
-                  rightColHits[nRightCHits++] = rowE;
-                } else {
-                  addHit(chipData, rowE, colD + rightC); // left column hits are added directly to the container
+              } else { // no filtering needed, append the left column hits in one go
+                auto& pixData = chipData.getData();
+                auto nPix = pixData.size();
+                pixData.resize(nPix + exp.nLeft);
+                auto* dest = &pixData[nPix];
+                for (int ih = 0; ih < exp.nLeft; ih++) {
+                  dest[ih] = PixelData(row + exp.dRowLeft[ih], colD);
+                }
+              }
+            } else {
+              for (int ip = 0; ip < HitMapSize; ip++) {
+                if (hitsPattern & (0x1 << ip)) {
+                  uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
+                  if (addr & ~MaskPixID) {
+#ifdef ALPIDE_DECODING_STAT
+                    chipData.setError(ChipStat::WrongRow);
+#endif
+                    return unexpectedEOF(fmt::format("Non-existing encoder {} decoded, DataLong was {:x}", pixID, dataS)); // abandon cable data
+                  }
+                  rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1)); // true for right column / lalse for left
+                  // the real columnt is int colE = colD + rightC;
+                  if (rightC) { // same as above
+                    rightColHits[nRightCHits++] = rowE;
+                  } else {
+                    addHit(chipData, rowE, colD + rightC); // left column hits are added directly to the container
+                  }
                 }
               }
             }
@@ -528,6 +596,7 @@ class AlpideCoder
   //
 
   static const NoiseMap* mNoisyPixels;
+  static bool mDataLongLUT; // expand DATALONG hitmaps with the lookup table
 
   // cluster map used for the ENCODING only
   std::vector<int> mFirstInRow;     //! entry of 1st pixel of each non-empty row in the mPix2Encode
@@ -17,6 +17,7 @@
 #define O2_ITSMFT_CTFCODER_H
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <string>
 #include "DataFormatsITSMFT/CTF.h"
@@ -113,8 +114,10 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofRecVec, co
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  // the blocks are encoded concurrently out of place and stored one after the other into the buffer at the end
+  CTF::encodedSlots slots;
+  std::vector<std::function<void()>> tasks;
+#define ENCODEITSMFT(part, slot, bits) tasks.emplace_back([&]() { CTF::encodeSlot(slots[int(slot)], part, bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor(), getANSNStreams()); });
   // clang-format off
   ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
   ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
@@ -128,6 +131,8 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofRecVec, co
   ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
   ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
   // clang-format on
+  runBlockTasks(tasks);
+  CTF::storeSlots(buff, slots);
   //CTF::get(buff.data())->print(getPrefix());
 }
 
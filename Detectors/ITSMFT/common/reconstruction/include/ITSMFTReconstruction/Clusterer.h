@@ -229,7 +229,18 @@ class Clusterer
 
  private:
 
+  /// contiguous range of fired chips processed as a unit by a thread
+  struct ChipBatch {
+    uint16_t firstChip = 0;
+    uint16_t nChips = 0;
+    size_t cost = 0;   ///< estimated cost: fired pixels + fixed cost per chip
+    int thread = 0;    ///< thread which processed the batch
+    uint32_t stat = 0; ///< entry of the batch in the stats of that thread
+  };
+
   void flushClusters(CompClusCont* compClus, MCTruth* labels);
+  void createChipBatches(int nThreads, size_t nPix);
+  void mergeThreads(int nThreads, CompClusCont* compClus, PatternCont* patterns, MCTruth* labelsCl);
 
   // clusterization options
   bool mContinuousReadout = true;    ///< flag continuous readout
@@ -243,6 +254,8 @@ class Clusterer
   std::vector<ChipPixelData> mChips;                      // currently processed ROF's chips data
   std::vector<ChipPixelData> mChipsOld;                   // previously processed ROF's chips data (for masking)
   std::vector<ChipPixelData*> mFiredChipsPtr;             // pointers on the fired chips data in the decoder cache
+  std::vector<ChipBatch> mBatches;                        // batches of fired chips of current ROF, in chip order
+  std::vector<uint32_t> mBatchOrder;                      // order in which the batches are dispatched to threads
 
   LookUp mPattIdConverter; //! Convert the cluster topology to the corresponding entry in the dictionary.
 
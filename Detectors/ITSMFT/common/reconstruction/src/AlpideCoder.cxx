@@ -17,6 +17,7 @@
 using namespace o2::itsmft;
 
 const NoiseMap* AlpideCoder::mNoisyPixels = nullptr;
+bool AlpideCoder::mDataLongLUT = true;
 
 //_____________________________________
 void AlpideCoder::print() const
@@ -197,7 +197,9 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec)
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   ec.print(getPrefix(), mVerbosity);
-#define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // the blocks are decoded concurrently
+  std::vector<std::function<void()>> tasks;
+#define DECODEITSMFT(part, slot) tasks.emplace_back([&]() { ec.decode(part, int(slot), mCoders[int(slot)].get()); })
   // clang-format off
   DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
   DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
@@ -211,5 +213,6 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec)
   DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
   DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
   // clang-format on
+  runBlockTasks(tasks);
   return cc;
 }
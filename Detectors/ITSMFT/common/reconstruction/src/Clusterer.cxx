@@ -12,6 +12,7 @@
 /// \file Clusterer.cxx
 /// \brief Implementation of the ITS cluster finder
 #include <algorithm>
+#include <numeric>
 #include <TTree.h>
 #include "Framework/Logger.h"
 #include "ITSMFTBase/GeometryTGeo.h"
@@ -63,89 +64,40 @@ void Clusterer::process(int nThreads, PixelReader& reader, CompClusCont* compClu
       }
       break; // just 1 ROF was asked to be processed
     }
-    if (nFired < nThreads) {
-      nThreads = nFired;
-    }
+    int nThrROF = std::min(nThreads, int(nFired));
 #ifndef WITH_OPENMP
-    nThreads = 1;
+    nThrROF = 1;
 #endif
-    uint16_t chipStep = nThreads > 1 ? (nThreads == 2 ? 20 : (nThreads < 5 ? 5 : 1)) : nFired;
-    int dynGrp = std::min(4, std::max(1, nThreads / 2));
-    if (nThreads > mThreads.size()) {
+    if (nThrROF > mThreads.size()) {
       int oldSz = mThreads.size();
-      mThreads.resize(nThreads);
-      for (int i = oldSz; i < nThreads; i++) {
+      mThreads.resize(nThrROF);
+      for (int i = oldSz; i < nThrROF; i++) {
         mThreads[i] = std::make_unique<ClustererThread>(this);
       }
     }
+    if (nThrROF < 2) { // put directly to the destination
+      mThreads[0]->process(0, nFired, compClus, patterns, labelsCl ? reader.getDigitsMCTruth() : nullptr, labelsCl, rof);
+      mThreads[0]->stats.clear();
+    } else {
 #ifdef WITH_OPENMP
-#pragma omp parallel for schedule(dynamic, dynGrp) num_threads(nThreads)
-    //>> start of MT region
-    for (uint16_t ic = 0; ic < nFired; ic += chipStep) {
-      auto ith = omp_get_thread_num();
-      if (nThreads > 1) {
-        mThreads[ith]->process(ic, std::min(chipStep, uint16_t(nFired - ic)),
-                               &mThreads[ith]->compClusters,
-                               patterns ? &mThreads[ith]->patterns : nullptr,
-                               labelsCl ? reader.getDigitsMCTruth() : nullptr,
-                               labelsCl ? &mThreads[ith]->labels : nullptr, rof);
-      } else { // put directly to the destination
-        mThreads[0]->process(0, nFired, compClus, patterns, labelsCl ? reader.getDigitsMCTruth() : nullptr, labelsCl, rof);
+      createChipBatches(nThrROF, nPix);
+      uint32_t nBatches = mBatches.size();
+      // batches are dispatched dynamically, largest first, such that a thread which is done with its
+      // batches takes over the remaining ones and a few busy chips do not leave the others idle at the end
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nThrROF)
+      //>> start of MT region
+      for (uint32_t ib = 0; ib < nBatches; ib++) {
+        auto ith = omp_get_thread_num();
+        auto& thr = *mThreads[ith];
+        auto& batch = mBatches[mBatchOrder[ib]];
+        thr.process(batch.firstChip, batch.nChips, &thr.compClusters, patterns ? &thr.patterns : nullptr,
+                    labelsCl ? reader.getDigitsMCTruth() : nullptr, labelsCl ? &thr.labels : nullptr, rof);
+        batch.thread = ith;
+        batch.stat = thr.stats.size() - 1;
       }
-    }
-    //<< end of MT region
-#else
-    mThreads[0]->process(0, nFired, compClus, patterns, labelsCl ? reader.getDigitsMCTruth() : nullptr, labelsCl, rof);
+      //<< end of MT region
+      mergeThreads(nThrROF, compClus, patterns, labelsCl);
 #endif
-    // copy data of all threads but the 1st one to final destination
-    if (nThreads > 1) {
-#ifdef _PERFORM_TIMING_
-      mTimerMerge.Start(false);
-#endif
-      size_t nClTot = 0, nPattTot = 0;
-      int chid = 0, thrStatIdx[nThreads];
-      for (int ith = 0; ith < nThreads; ith++) {
-        thrStatIdx[ith] = 0;
-        nClTot += mThreads[ith]->compClusters.size();
-        nPattTot += mThreads[ith]->patterns.size();
-      }
-      compClus->reserve(nClTot);
-      if (patterns) {
-        patterns->reserve(nPattTot);
-      }
-      while (chid < nFired) {
-        for (int ith = 0; ith < nThreads; ith++) {
-          if (thrStatIdx[ith] >= mThreads[ith]->stats.size()) {
-            continue;
-          }
-          const auto& stat = mThreads[ith]->stats[thrStatIdx[ith]];
-          if (stat.firstChip == chid) {
-            thrStatIdx[ith]++;
-            chid += stat.nChips; // next chip to look
-            const auto clbeg = mThreads[ith]->compClusters.begin() + stat.firstClus;
-            auto szold = compClus->size();
-            compClus->insert(compClus->end(), clbeg, clbeg + stat.nClus);
-            if (patterns) {
-              const auto ptbeg = mThreads[ith]->patterns.begin() + stat.firstPatt;
-              patterns->insert(patterns->end(), ptbeg, ptbeg + stat.nPatt);
-            }
-            if (labelsCl) {
-              labelsCl->mergeAtBack(mThreads[ith]->labels, stat.firstClus, stat.nClus);
-            }
-          }
-        }
-      }
-      for (int ith = 0; ith < nThreads; ith++) {
-        mThreads[ith]->patterns.clear();
-        mThreads[ith]->compClusters.clear();
-        mThreads[ith]->labels.clear();
-        mThreads[ith]->stats.clear();
-      }
-#ifdef _PERFORM_TIMING_
-      mTimerMerge.Stop();
-#endif
-    } else {
-      mThreads[0]->stats.clear();
     }
     rof.setNEntries(compClus->size() - rof.getFirstEntry()); // update
   } while (autoDecode);
@@ -155,13 +107,87 @@ void Clusterer::process(int nThreads, PixelReader& reader, CompClusCont* compClu
 #endif
 }
 
+//__________________________________________________
+void Clusterer::createChipBatches(int nThreads, size_t nPix)
+{
+  // split the fired chips in batches of contiguous chips with similar amount of fired pixels,
+  // several per thread to leave room for balancing
+  constexpr int BatchesPerThread = 8;
+  constexpr uint32_t ChipCost = 16; // fixed cost of a chip, in units of pixels
+  uint16_t nFired = mFiredChipsPtr.size();
+  size_t batchCost = std::max(size_t(1), (nPix + size_t(ChipCost) * nFired) / (nThreads * BatchesPerThread));
+  mBatches.clear();
+  for (uint16_t ic = 0; ic < nFired; ic++) {
+    if (mBatches.empty() || mBatches.back().cost >= batchCost) {
+      mBatches.emplace_back(ChipBatch{ic, 0, 0});
+    }
+    auto& batch = mBatches.back();
+    batch.nChips++;
+    batch.cost += ChipCost + mFiredChipsPtr[ic]->getData().size();
+  }
+  mBatchOrder.resize(mBatches.size());
+  std::iota(mBatchOrder.begin(), mBatchOrder.end(), 0);
+  std::stable_sort(mBatchOrder.begin(), mBatchOrder.end(), [this](uint32_t a, uint32_t b) { return mBatches[a].cost > mBatches[b].cost; });
+}
+
+//__________________________________________________
+void Clusterer::mergeThreads(int nThreads, CompClusCont* compClus, PatternCont* patterns, MCTruth* labelsCl)
+{
+#ifdef _PERFORM_TIMING_
+  mTimerMerge.Start(false);
+#endif
+  // batches are stored in chip order, so the output offsets of each batch are known upfront and
+  // every batch can be copied to its final place independently of the others
+  uint32_t nBatches = mBatches.size();
+  std::vector<size_t> clOffs(nBatches + 1), ptOffs(nBatches + 1);
+  clOffs[0] = compClus->size();
+  ptOffs[0] = patterns ? patterns->size() : 0;
+  for (uint32_t ib = 0; ib < nBatches; ib++) {
+    const auto& stat = mThreads[mBatches[ib].thread]->stats[mBatches[ib].stat];
+    clOffs[ib + 1] = clOffs[ib] + stat.nClus;
+    ptOffs[ib + 1] = ptOffs[ib] + stat.nPatt;
+  }
+  compClus->resize(clOffs[nBatches]);
+  if (patterns) {
+    patterns->resize(ptOffs[nBatches]);
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic, 4) num_threads(nThreads)
+#endif
+  for (uint32_t ib = 0; ib < nBatches; ib++) {
+    const auto& thr = *mThreads[mBatches[ib].thread];
+    const auto& stat = thr.stats[mBatches[ib].stat];
+    const auto clbeg = thr.compClusters.begin() + stat.firstClus;
+    std::copy(clbeg, clbeg + stat.nClus, compClus->begin() + clOffs[ib]);
+    if (patterns) {
+      const auto ptbeg = thr.patterns.begin() + stat.firstPatt;
+      std::copy(ptbeg, ptbeg + stat.nPatt, patterns->begin() + ptOffs[ib]);
+    }
+  }
+  if (labelsCl) {
+    for (uint32_t ib = 0; ib < nBatches; ib++) {
+      const auto& stat = mThreads[mBatches[ib].thread]->stats[mBatches[ib].stat];
+      labelsCl->mergeAtBack(mThreads[mBatches[ib].thread]->labels, stat.firstClus, stat.nClus);
+    }
+  }
+  // the thread buffers keep their capacity and are reused as arenas for the next ROF
+  for (int ith = 0; ith < nThreads; ith++) {
+    mThreads[ith]->patterns.clear();
+    mThreads[ith]->compClusters.clear();
+    mThreads[ith]->labels.clear();
+    mThreads[ith]->stats.clear();
+  }
+#ifdef _PERFORM_TIMING_
+  mTimerMerge.Stop();
+#endif
+}
+
 //__________________________________________________
 void Clusterer::ClustererThread::process(uint16_t chip, uint16_t nChips, CompClusCont* compClusPtr, PatternCont* patternsPtr,
                                          const ConstMCTruth* labelsDigPtr, MCTruth* labelsClPtr, const ROFRecord& rofPtr)
 {
-  if (stats.empty() || stats.back().firstChip + stats.back().nChips < chip) { // there is a jump, register new block
-    stats.emplace_back(ThreadStat{chip, 0, uint32_t(compClusPtr->size()), patternsPtr ? uint32_t(patternsPtr->size()) : 0, 0, 0});
-  }
+  // every call registers its own block, the merging locates it by the batch it was called for
+  stats.emplace_back(ThreadStat{chip, 0, uint32_t(compClusPtr->size()), patternsPtr ? uint32_t(patternsPtr->size()) : 0, 0, 0});
   for (int ic = 0; ic < nChips; ic++) {
     auto* curChipData = parent->mFiredChipsPtr[chip + ic];
     auto chipID = curChipData->getChipID();
@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchAlpideCoder.cxx
+/// \brief Benchmark of the ALPIDE chip data decoding
+
+#include <benchmark/benchmark.h>
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace o2::itsmft;
+
+namespace
+{
+constexpr int NChips = 64;
+
+// encoded data of NChips chips with clusters of a few pixels, as produced by particle hits
+PayLoadCont createPayload(int nClustersPerChip)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> rowDist(0, AlpideCoder::NRows - 4), colDist(0, AlpideCoder::NCols - 4), sizeDist(1, 3);
+  AlpideCoder coder;
+  PayLoadCont payload;
+  ChipPixelData chipData;
+  for (int ic = 0; ic < NChips; ic++) {
+    auto& pixels = chipData.getData();
+    pixels.clear();
+    for (int icl = 0; icl < nClustersPerChip; icl++) {
+      int row0 = rowDist(gen), col0 = colDist(gen), nr = sizeDist(gen), nc = sizeDist(gen);
+      for (int ir = 0; ir < nr; ir++) {
+        for (int icol = 0; icol < nc; icol++) {
+          pixels.emplace_back(row0 + ir, col0 + icol);
+        }
+      }
+    }
+    // the encoder expects the pixels sorted in row then column, without duplicates
+    auto rowCol = [](const PixelData& a, const PixelData& b) { return a.getRow() < b.getRow() || (a.getRow() == b.getRow() && a.getCol() < b.getCol()); };
+    std::sort(pixels.begin(), pixels.end(), rowCol);
+    pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+    payload.ensureFreeCapacity(16 * (pixels.size() + 64));
+    coder.encodeChip(payload, chipData, ic % 16, 0);
+  }
+  return payload;
+}
+
+size_t decodeAll(PayLoadCont& payload, ChipPixelData& chipData, std::vector<PixelData>* out = nullptr)
+{
+  size_t nPix = 0;
+  payload.rewind();
+  for (int ic = 0; ic < NChips; ic++) {
+    auto res = AlpideCoder::decodeChip(chipData, payload, [](uint16_t id) { return id; });
+    if (res < 0) {
+      return 0;
+    }
+    nPix += chipData.getData().size();
+    if (out) {
+      out->insert(out->end(), chipData.getData().begin(), chipData.getData().end());
+    }
+  }
+  return nPix;
+}
+} // namespace
+
+static void BM_DecodeChips(benchmark::State& state)
+{
+  auto payload = createPayload(state.range(0));
+  ChipPixelData chipData;
+
+  // the lookup table expansion must give the same pixels as the bitwise one
+  std::vector<PixelData> refPixels, lutPixels;
+  AlpideCoder::setDataLongLUT(false);
+  decodeAll(payload, chipData, &refPixels);
+  AlpideCoder::setDataLongLUT(true);
+  decodeAll(payload, chipData, &lutPixels);
+  if (refPixels.empty() || !(refPixels == lutPixels)) {
+    state.SkipWithError("decoding mismatch");
+    return;
+  }
+
+  AlpideCoder::setDataLongLUT(state.range(1));
+  size_t nPix = 0;
+  for (auto _ : state) {
+    nPix += decodeAll(payload, chipData);
+  }
+  AlpideCoder::setDataLongLUT(true);
+  state.SetItemsProcessed(nPix);
+  state.SetBytesProcessed(state.iterations() * payload.getSize());
+}
+
+BENCHMARK(BM_DecodeChips)->Args({10, 0})->Args({10, 1})->Args({100, 0})->Args({100, 1})->Args({1000, 0})->Args({1000, 1});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,176 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testAlpideCoder.cxx
+/// @brief  Test that the table-driven expansion of the DATALONG hitmaps decodes the pixels of the bitwise one
+
+#define BOOST_TEST_MODULE Test ITSMFT AlpideCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "DataFormatsITSMFT/NoiseMap.h"
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+
+using namespace o2::itsmft;
+
+namespace
+{
+constexpr int NChipIDs = 16;
+
+struct Chip {
+  int chipID = 0;
+  std::vector<PixelData> pixels;
+};
+
+bool rowCol(const PixelData& a, const PixelData& b)
+{
+  return a.getRow() < b.getRow() || (a.getRow() == b.getRow() && a.getCol() < b.getCol());
+}
+
+/// Chips with clusters of a few pixels, as produced by particle hits, plus fully fired blocks
+/// at the edges of the matrix, where the hitmaps reach the last address of the double columns
+std::vector<Chip> createChips(int nChips, int nClustersPerChip)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> rowDist(0, AlpideCoder::NRows - 4), colDist(0, AlpideCoder::NCols - 4), sizeDist(1, 4);
+  std::uniform_real_distribution<float> flat(0.f, 1.f);
+  std::vector<Chip> chips(nChips);
+  for (int ic = 0; ic < nChips; ic++) {
+    auto& pixels = chips[ic].pixels;
+    chips[ic].chipID = ic % NChipIDs;
+    for (int icl = 0; icl < nClustersPerChip; icl++) {
+      int row0 = rowDist(gen), col0 = colDist(gen), nr = sizeDist(gen), nc = sizeDist(gen);
+      for (int ir = 0; ir < nr; ir++) {
+        for (int icol = 0; icol < nc; icol++) {
+          if (flat(gen) < 0.8f) {
+            pixels.emplace_back(row0 + ir, col0 + icol);
+          }
+        }
+      }
+    }
+    for (int row : {0, AlpideCoder::NRows - 4}) {
+      for (int col : {0, 1, AlpideCoder::NCols - 2, AlpideCoder::NCols - 1}) {
+        for (int ir = 0; ir < 4; ir++) {
+          pixels.emplace_back(row + ir, col);
+        }
+      }
+    }
+    // the encoder expects the pixels sorted in row then column, without duplicates
+    std::sort(pixels.begin(), pixels.end(), rowCol);
+    pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+  }
+  return chips;
+}
+
+PayLoadCont encode(std::vector<Chip> const& chips)
+{
+  AlpideCoder coder;
+  PayLoadCont payload;
+  ChipPixelData chipData;
+  for (const auto& chip : chips) {
+    chipData.getData() = chip.pixels;
+    payload.ensureFreeCapacity(16 * (chip.pixels.size() + 64));
+    coder.encodeChip(payload, chipData, chip.chipID, 0);
+  }
+  return payload;
+}
+
+/// Pixels of every chip, sorted in row then column
+std::vector<std::vector<PixelData>> decode(PayLoadCont& payload, int nChips, bool dataLongLUT)
+{
+  AlpideCoder::setDataLongLUT(dataLongLUT);
+  std::vector<std::vector<PixelData>> pixels;
+  ChipPixelData chipData;
+  payload.rewind();
+  for (int ic = 0; ic < nChips; ic++) {
+    chipData.clear();
+    BOOST_REQUIRE(AlpideCoder::decodeChip(chipData, payload, [](uint16_t id) { return id; }) >= 0);
+    BOOST_CHECK_EQUAL(int(chipData.getChipID()), ic % NChipIDs);
+    auto& chipPixels = pixels.emplace_back(chipData.getData().begin(), chipData.getData().end());
+    std::sort(chipPixels.begin(), chipPixels.end(), rowCol);
+  }
+  AlpideCoder::setDataLongLUT(true);
+  return pixels;
+}
+} // namespace
+
+/// Every entry of the table gives the hits of the bitwise expansion, in the same order
+BOOST_AUTO_TEST_CASE(AlpideCoderHitMapLUT)
+{
+  const auto& lut = AlpideCoder::getHitMapLUT();
+  for (uint16_t pixID = 0; pixID < 4; pixID++) {
+    uint16_t row = pixID >> 1;
+    for (uint16_t hitsPattern = 0; hitsPattern <= AlpideCoder::MaskHitMap; hitsPattern++) {
+      std::vector<int> left, right;
+      int maxAddrOffset = 0;
+      for (int ip = 0; ip < AlpideCoder::HitMapSize; ip++) {
+        if (hitsPattern & (0x1 << ip)) {
+          uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
+          bool rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1));
+          (rightC ? right : left).push_back(rowE - row);
+          maxAddrOffset = ip + 1;
+        }
+      }
+      const auto& exp = lut[pixID][hitsPattern];
+      BOOST_CHECK_EQUAL(int(exp.maxAddrOffset), maxAddrOffset);
+      BOOST_REQUIRE_EQUAL(size_t(exp.nLeft), left.size());
+      BOOST_REQUIRE_EQUAL(size_t(exp.nRight), right.size());
+      for (size_t i = 0; i < left.size(); i++) {
+        BOOST_CHECK_EQUAL(int(exp.dRowLeft[i]), left[i]);
+      }
+      for (size_t i = 0; i < right.size(); i++) {
+        BOOST_CHECK_EQUAL(int(exp.dRowRight[i]), right[i]);
+      }
+    }
+  }
+}
+
+/// Both expansions decode the encoded pixels, also when the noisy pixels are masked
+BOOST_AUTO_TEST_CASE(AlpideCoderDataLong)
+{
+  for (int nClusters : {10, 1000}) {
+    const auto chips = createChips(64, nClusters);
+    auto payload = encode(chips);
+    const auto ref = decode(payload, chips.size(), false);
+    const auto lut = decode(payload, chips.size(), true);
+    BOOST_REQUIRE_EQUAL(ref.size(), chips.size());
+    for (size_t ic = 0; ic < chips.size(); ic++) {
+      BOOST_CHECK(ref[ic] == chips[ic].pixels);
+      BOOST_CHECK(lut[ic] == ref[ic]);
+    }
+
+    // every third pixel of the first chips is noisy
+    NoiseMap noise(NChipIDs);
+    for (int ic = 0; ic < NChipIDs; ic++) {
+      for (size_t ip = 0; ip < chips[ic].pixels.size(); ip += 3) {
+        noise.increaseNoiseCount(ic, chips[ic].pixels[ip].getRow(), chips[ic].pixels[ip].getCol());
+      }
+    }
+    AlpideCoder::setNoisyPixels(&noise);
+    const auto refMasked = decode(payload, chips.size(), false);
+    const auto lutMasked = decode(payload, chips.size(), true);
+    AlpideCoder::setNoisyPixels(nullptr);
+    for (size_t ic = 0; ic < chips.size(); ic++) {
+      BOOST_CHECK(lutMasked[ic] == refMasked[ic]);
+      BOOST_CHECK(refMasked[ic].size() < ref[ic].size());
+      for (const auto& pix : lutMasked[ic]) {
+        BOOST_CHECK(!noise.isNoisy(chips[ic].chipID, pix.getRow(), pix.getCol()));
+      }
+    }
+  }
+}
@@ -0,0 +1,168 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testClusterer.cxx
+/// @brief  Test that the clusters, patterns and MC labels of the Clusterer do not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test ITSMFT Clusterer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "ITSMFTBase/SegmentationAlpide.h"
+#include "ITSMFTReconstruction/ChipMappingITS.h"
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ITSMFTReconstruction/DigitPixelReader.h"
+#include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+
+using namespace o2::itsmft;
+
+namespace
+{
+using MCTruth = o2::dataformats::MCTruthContainer<o2::MCCompLabel>;
+
+struct DigitsTF {
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofs;
+  o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel> labels;
+};
+
+struct ClustersTF {
+  std::vector<CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  std::vector<ROFRecord> rofs;
+  MCTruth labels;
+};
+
+/// Blobs of pixels fired by the same particle, on a few busy chips and many quiet ones, with some pixels
+/// shared by two particles and the same pixels fired in consecutive ROFs. Digits are sorted in chip/col/row.
+DigitsTF createDigits(int nROFs, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> chipGen(0, ChipMappingITS::getNChips() - 1);
+  std::uniform_int_distribution<int> rowGen(0, SegmentationAlpide::NRows - 1);
+  std::uniform_int_distribution<int> colGen(0, SegmentationAlpide::NCols - 1);
+  std::uniform_int_distribution<int> sizeGen(1, 6);
+  std::uniform_real_distribution<float> flat(0.f, 1.f);
+
+  DigitsTF tf;
+  MCTruth labels;
+  std::map<std::tuple<int, int, int>, std::vector<o2::MCCompLabel>> previousPixels{};
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    std::map<std::tuple<int, int, int>, std::vector<o2::MCCompLabel>> pixels{};
+    int trackID = 0;
+    auto addBlob = [&](int chip, int row, int col, int rowSpan, int colSpan) {
+      o2::MCCompLabel label(trackID++, iROF, 0);
+      for (int r = row; r < std::min(row + rowSpan, int(SegmentationAlpide::NRows)); r++) {
+        for (int c = col; c < std::min(col + colSpan, int(SegmentationAlpide::NCols)); c++) {
+          if (flat(gen) < 0.7f) {
+            auto& pixLabels = pixels[{chip, c, r}];
+            if (pixLabels.size() < 2) {
+              pixLabels.push_back(label);
+            }
+          }
+        }
+      }
+    };
+    for (int iChip = 0; iChip < 5; iChip++) { // busy chips, with large and overlapping blobs
+      int chip = chipGen(gen);
+      for (int iBlob = 0; iBlob < 200; iBlob++) {
+        addBlob(chip, rowGen(gen) % 64, colGen(gen) % 64, 2 * sizeGen(gen), 2 * sizeGen(gen));
+      }
+      addBlob(chip, rowGen(gen), colGen(gen), 40, 40);
+    }
+    for (int iChip = 0; iChip < 500; iChip++) { // quiet chips
+      int chip = chipGen(gen);
+      for (int iBlob = sizeGen(gen); iBlob--;) {
+        addBlob(chip, rowGen(gen), colGen(gen), sizeGen(gen), sizeGen(gen));
+      }
+    }
+    for (const auto& pix : previousPixels) { // pixels fired again in the next ROF, to be masked
+      if (flat(gen) < 0.05f) {
+        pixels.emplace(pix.first, std::vector<o2::MCCompLabel>{o2::MCCompLabel(trackID++, iROF, 0)});
+      }
+    }
+    tf.rofs.emplace_back(o2::InteractionRecord(0, 10 + iROF), iROF, tf.digits.size(), pixels.size());
+    for (const auto& pix : pixels) {
+      for (const auto& label : pix.second) {
+        labels.addElement(tf.digits.size(), label);
+      }
+      tf.digits.emplace_back(std::get<0>(pix.first), std::get<2>(pix.first), std::get<1>(pix.first), 100);
+    }
+    previousPixels = std::move(pixels);
+  }
+  labels.flatten_to(tf.labels);
+  return tf;
+}
+
+ClustersTF findClusters(const DigitsTF& digits, int nThreads)
+{
+  o2::dataformats::ConstMCTruthContainerView<o2::MCCompLabel> labels(digits.labels);
+  DigitPixelReader reader;
+  reader.setDigits(digits.digits);
+  reader.setROFRecords(digits.rofs);
+  reader.setDigitsMCTruth(&labels);
+  reader.init();
+  Clusterer clusterer;
+  clusterer.setNChips(ChipMappingITS::getNChips());
+  ClustersTF tf;
+  clusterer.process(nThreads, reader, &tf.clusters, &tf.patterns, &tf.rofs, &tf.labels);
+  return tf;
+}
+
+template <typename T>
+void checkIdentical(const std::vector<T>& ref, const std::vector<T>& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+  BOOST_CHECK(std::memcmp(ref.data(), test.data(), ref.size() * sizeof(T)) == 0);
+}
+
+void checkIdentical(const MCTruth& ref, const MCTruth& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.getIndexedSize(), test.getIndexedSize());
+  BOOST_REQUIRE_EQUAL(ref.getNElements(), test.getNElements());
+  for (uint32_t i = 0; i < ref.getIndexedSize(); i++) {
+    auto refLabels = ref.getLabels(i), testLabels = test.getLabels(i);
+    BOOST_REQUIRE_EQUAL(refLabels.size(), testLabels.size());
+    for (size_t j = 0; j < refLabels.size(); j++) {
+      BOOST_CHECK(refLabels[j] == testLabels[j]);
+    }
+  }
+}
+} // namespace
+
+/// The chips are split in batches processed by different threads and merged afterwards: the output must
+/// be the one of the serial processing, in the same order
+BOOST_AUTO_TEST_CASE(ClustererThreads)
+{
+  const auto digits = createDigits(10, 1);
+  const auto ref = findClusters(digits, 1);
+  BOOST_CHECK(!ref.clusters.empty());
+  BOOST_CHECK_EQUAL(ref.rofs.size(), digits.rofs.size());
+  BOOST_CHECK_EQUAL(ref.labels.getIndexedSize(), ref.clusters.size());
+  for (int nThreads : {2, 3, 8}) {
+    const auto test = findClusters(digits, nThreads);
+    checkIdentical(ref.rofs, test.rofs);
+    checkIdentical(ref.clusters, test.clusters);
+    checkIdentical(ref.patterns, test.patterns);
+    checkIdentical(ref.labels, test.labels);
+  }
+}
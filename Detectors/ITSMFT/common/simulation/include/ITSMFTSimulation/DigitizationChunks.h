@@ -0,0 +1,74 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DigitizationChunks.h
+/// \brief Splitting of the collisions into time chunks which are digitized independently and concurrently
+#ifndef ALICEO2_ITSMFT_DIGITIZATIONCHUNKS_H
+#define ALICEO2_ITSMFT_DIGITIZATIONCHUNKS_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Rtypes.h"
+#include "ITSMFTSimulation/Digitizer.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+
+class TRandom;
+
+namespace o2
+{
+namespace itsmft
+{
+
+/// output flushed by the digitizer while processing a collision
+struct DigitizationChunkOutput {
+  std::vector<o2::itsmft::Digit> digits;
+  std::vector<o2::itsmft::ROFRecord> rofRecords;
+  o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+};
+
+/// collisions range [firstColl, lastColl[ which can be digitized independently of the other ones, starting from firstROF
+struct DigitizationChunk {
+  int firstColl = 0;
+  int lastColl = 0;
+  uint32_t firstROF = 0;
+  UInt_t seed = 0;                                     ///< seed of the random generator used for this chunk
+  std::vector<DigitizationChunkOutput> outputs;        ///< per collision plus the final flush
+  std::vector<o2::itsmft::MC2ROFRecord> mc2rofRecords; ///< per collision
+};
+
+class DigitizationChunks
+{
+ public:
+  static constexpr int MaxChunks = 64; ///< max number of chunks to split the collisions to
+
+  /// Split the collisions at the RO frames which cannot be reached by the signal of the preceding collisions.
+  /// In the triggered mode every collision is independent. The splitting depends on the collisions only, not on the
+  /// number of threads, and the chunk seeds are drawn from rnd in the order of the chunks.
+  /// \param collROFs RO frame of each collision, used in the continuous mode only
+  /// \param span max number of RO frames following the collision RO frame which may receive its signal
+  static std::vector<DigitizationChunk> define(const std::vector<uint32_t>& collROFs, uint32_t span, bool continuous, TRandom& rnd);
+
+  /// Digitize nChunks chunks with nThreads threads. process(iThread, iChunk) is called once for every chunk by any thread,
+  /// merge(iChunk) is called in the order of the chunks, as soon as a chunk and all preceding ones are processed,
+  /// by one thread at a time. An exception thrown by process or merge stops the processing and is rethrown.
+  static void run(int nChunks, int nThreads, const std::function<void(int, int)>& process, const std::function<void(int)>& merge);
+
+  /// Digitize the chunk ic with the digitizer, seeding rnd with the chunk seed. processCollision(collID) must pass the hits
+  /// of the collision to the digitizer, whose event time is already set. The outputs are stored in the chunk.
+  static void digitize(std::vector<DigitizationChunk>& chunks, int ic, Digitizer& digitizer, TRandom& rnd,
+                       const std::vector<o2::InteractionTimeRecord>& times, const std::function<void(int)>& processCollision);
+};
+
+} // namespace itsmft
+} // namespace o2
+
+#endif
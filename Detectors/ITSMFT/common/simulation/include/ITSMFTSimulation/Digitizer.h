@@ -32,6 +32,8 @@
 #include "CommonDataFormat/InteractionRecord.h"
 #include "SimulationDataFormat/MCCompLabel.h"
 
+class TRandom;
+
 namespace o2
 {
 
@@ -92,6 +94,21 @@ class Digitizer : public TObject
     mEventROFrameMax = 0;
   }
 
+  /// use provided random generator instead of gRandom (nullptr to reset), needed when several digitizers run concurrently
+  void setRandomGenerator(TRandom* rnd) { mRandom = rnd; }
+
+  /// RO frame to which the collision would be assigned in the continuous mode
+  uint32_t getCollisionROFrame(const o2::InteractionTimeRecord& irt) const;
+  /// max number of RO frames following the collision RO frame which may receive its signal in the continuous mode
+  uint32_t getCollisionROFrameSpan() const;
+  /// start the digitization from the given RO frame, for collisions digitized in independent time chunks:
+  /// all data of the previously processed collisions must have been flushed already
+  void setFirstROFrame(uint32_t rof)
+  {
+    mROFrameMin = rof;
+    mROFrameMax = rof;
+  }
+
  private:
   void processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID, int srcID);
   void registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
@@ -110,6 +127,7 @@ class Digitizer : public TObject
   }
 
   static constexpr float sec2ns = 1e9;
+  static constexpr float MaxHitTimeNS = 20e3; ///< hits with larger time wrt the collision are ignored
 
   o2::itsmft::DigiParams mParams; ///< digitization parameters
   o2::InteractionTimeRecord mEventTime; ///< global event time and interaction record
@@ -138,6 +156,7 @@ class Digitizer : public TObject
   o2::dataformats::MCTruthContainer<o2::MCCompLabel>* mMCLabels = nullptr; //! output labels
   const o2::itsmft::NoiseMap* mNoiseMap = nullptr;
   const o2::itsmft::NoiseMap* mDeadChanMap = nullptr;
+  TRandom* mRandom = nullptr; //! random generator to use instead of gRandom
 
   ClassDefOverride(Digitizer, 2);
 };
@@ -25,6 +25,12 @@ ClassImp(o2::itsmft::ChipDigitsContainer);
 
 //______________________________________________________________________
 void ChipDigitsContainer::addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, int maxRows, int maxCols)
+{
+  addNoise(rofMin, rofMax, params, *gRandom, maxRows, maxCols);
+}
+
+//______________________________________________________________________
+void ChipDigitsContainer::addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, TRandom& rnd, int maxRows, int maxCols)
 {
   UInt_t row = 0;
   UInt_t col = 0;
@@ -35,10 +41,10 @@ void ChipDigitsContainer::addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmf
   int nel = params->getChargeThreshold() * 1.1; // RS: TODO: need realistic spectrum of noise above the threshold
 
   for (UInt_t rof = rofMin; rof <= rofMax; rof++) {
-    nhits = gRandom->Poisson(mean);
+    nhits = rnd.Poisson(mean);
     for (Int_t i = 0; i < nhits; ++i) {
-      row = gRandom->Integer(maxRows);
-      col = gRandom->Integer(maxCols);
+      row = rnd.Integer(maxRows);
+      col = rnd.Integer(maxCols);
       if (mNoiseMap && mNoiseMap->isNoisy(mChipIndex, row, col)) {
         continue;
       }
@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DigitizationChunks.cxx
+/// \brief Implementation of the splitting of the collisions into independent time chunks
+
+#include "ITSMFTSimulation/DigitizationChunks.h"
+#include <TRandom.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace o2::itsmft;
+
+//_______________________________________________________________________
+std::vector<DigitizationChunk> DigitizationChunks::define(const std::vector<uint32_t>& collROFs, uint32_t span, bool continuous, TRandom& rnd)
+{
+  const int nColl = collROFs.size();
+  const int minChunkSize = std::max(1, nColl / MaxChunks);
+  std::vector<DigitizationChunk> chunks(1);
+  uint32_t lastReachedROF = 0;
+  for (int collID = 0; collID < nColl; collID++) {
+    uint32_t rof = continuous ? collROFs[collID] : 0;
+    if (collID - chunks.back().firstColl >= minChunkSize && (!continuous || rof > lastReachedROF)) {
+      chunks.back().lastColl = collID;
+      auto& chunk = chunks.emplace_back();
+      chunk.firstColl = collID;
+      chunk.firstROF = rof;
+    }
+    lastReachedROF = std::max(lastReachedROF, rof + span);
+  }
+  chunks.back().lastColl = nColl;
+  for (auto& chunk : chunks) {
+    chunk.seed = 1 + rnd.Integer(0x7fffffff); // 0 would request a random seed
+  }
+  return chunks;
+}
+
+//_______________________________________________________________________
+void DigitizationChunks::run(int nChunks, int nThreads, const std::function<void(int, int)>& process, const std::function<void(int)>& merge)
+{
+  nThreads = std::max(1, std::min(nThreads, nChunks));
+  std::atomic<int> nextChunk{0};
+  std::mutex mergeMutex;
+  std::vector<char> processed(nChunks, 0);
+  int nextToMerge = 0;
+  std::vector<std::exception_ptr> errors(nThreads);
+  auto worker = [&](int iThread) {
+    try {
+      int ic;
+      while ((ic = nextChunk++) < nChunks) {
+        process(iThread, ic);
+        std::lock_guard<std::mutex> guard(mergeMutex);
+        processed[ic] = 1;
+        while (nextToMerge < nChunks && processed[nextToMerge]) {
+          merge(nextToMerge++);
+        }
+      }
+    } catch (...) {
+      errors[iThread] = std::current_exception();
+      nextChunk = nChunks; // the other threads do not take new chunks
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int iThread = 1; iThread < nThreads; iThread++) {
+    threads.emplace_back(worker, iThread);
+  }
+  worker(0);
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& err : errors) {
+    if (err) {
+      std::rethrow_exception(err);
+    }
+  }
+}
+
+//_______________________________________________________________________
+void DigitizationChunks::digitize(std::vector<DigitizationChunk>& chunks, int ic, Digitizer& digitizer, TRandom& rnd,
+                                  const std::vector<o2::InteractionTimeRecord>& times, const std::function<void(int)>& processCollision)
+{
+  auto& chunk = chunks[ic];
+  auto setOutput = [&digitizer, &chunk]() {
+    auto& out = chunk.outputs.emplace_back();
+    digitizer.setDigits(&out.digits);
+    digitizer.setROFRecords(&out.rofRecords);
+    digitizer.setMCLabels(&out.labels);
+  };
+  rnd.SetSeed(chunk.seed);
+  digitizer.setRandomGenerator(&rnd);
+  chunk.outputs.reserve(chunk.lastColl - chunk.firstColl + 1);
+  digitizer.setFirstROFrame(chunk.firstROF);
+  for (int collID = chunk.firstColl; collID < chunk.lastColl; collID++) {
+    setOutput();
+    digitizer.setEventTime(times[collID]);
+    digitizer.resetEventROFrames(); // to estimate min/max ROF for this collID
+    processCollision(collID);
+    chunk.mc2rofRecords.emplace_back(collID, -1, digitizer.getEventROFrameMin(), digitizer.getEventROFrameMax());
+  }
+  setOutput();
+  if (ic + 1 < int(chunks.size()) && digitizer.isContinuous()) {
+    digitizer.setEventTime(times[chunks[ic + 1].firstColl]); // to flush also noise-only RO frames preceding the next chunk
+  }
+  digitizer.fillOutputContainer();
+  digitizer.setRandomGenerator(nullptr);
+}
@@ -159,6 +159,24 @@ void Digitizer::setEventTime(const o2::InteractionTimeRecord& irt)
   }
 }
 
+//_______________________________________________________________________
+uint32_t Digitizer::getCollisionROFrame(const o2::InteractionTimeRecord& irt) const
+{
+  // RO frame of the collision, same as assigned in the setEventTime in the continuous mode
+  auto nbc = irt.differenceInBC(mIRFirstSampledTF);
+  if (irt.timeInBCNS < 0 && nbc > 0) {
+    nbc--;
+  }
+  return nbc / mParams.getROFrameLengthInBC();
+}
+
+//_______________________________________________________________________
+uint32_t Digitizer::getCollisionROFrameSpan() const
+{
+  // the signal starts at most MaxHitTimeNS after the collision, which itself is within the 1st RO frame
+  return uint32_t((mParams.getROFrameLength() + MaxHitTimeNS + mParams.getSignalShape().getMaxDuration()) * mParams.getROFrameLengthInv()) + 1;
+}
+
 //_______________________________________________________________________
 void Digitizer::fillOutputContainer(uint32_t frameLast)
 {
@@ -173,6 +191,7 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
             << frameLast;
 
   o2::itsmft::ROFRecord rcROF;
+  auto& rnd = mRandom ? *mRandom : *gRandom;
 
   // we have to write chips in RO increasing order, therefore have to loop over the frames here
   for (; mROFrameMin <= frameLast; mROFrameMin++) {
@@ -184,7 +203,7 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
       if (chip.isDisabled()) {
         continue;
       }
-      chip.addNoise(mROFrameMin, mROFrameMin, &mParams);
+      chip.addNoise(mROFrameMin, mROFrameMin, &mParams, rnd);
       auto& buffer = chip.getPreDigits();
       if (buffer.empty()) {
         continue;
@@ -238,7 +257,7 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
     return;
   }
   float timeInROF = hit.GetTime() * sec2ns;
-  if (timeInROF > 20e3) {
+  if (timeInROF > MaxHitTimeNS) {
     const int maxWarn = 10;
     static int warnNo = 0;
     if (warnNo < maxWarn) {
@@ -377,6 +396,7 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
 
   // fire the pixels assuming Poisson(n_response_electrons)
   o2::MCCompLabel lbl(hit.GetTrackID(), evID, srcID, false);
+  auto& rnd = mRandom ? *mRandom : *gRandom;
   auto roFrameAbs = mNewROFrame + roFrameRel;
   for (int irow = rowSpan; irow--;) {
     uint16_t rowIS = irow + rowS;
@@ -385,7 +405,7 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
       if (!nEleResp) {
         continue;
       }
-      int nEle = gRandom->Poisson(nElectrons * nEleResp); // total charge in given pixel
+      int nEle = rnd.Poisson(nElectrons * nEleResp); // total charge in given pixel
       // ignore charge which have no chance to fire the pixel
       if (nEle < mParams.getMinChargeToAccount()) {
         continue;
@@ -0,0 +1,283 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test DigitizationChunks
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <TRandom3.h>
+#include <TVector3.h>
+#include "CommonConstants/LHCConstants.h"
+#include "ITSMFTSimulation/DigitizationChunks.h"
+#include "ITSMFTSimulation/Digitizer.h"
+#include "ITSMFTBase/GeometryTGeo.h"
+#include "ITSMFTBase/SegmentationAlpide.h"
+
+using namespace o2::itsmft;
+
+namespace
+{
+constexpr uint32_t Span = 3;
+
+/// RO frames of collisions in bunches separated by empty periods, as for a filling scheme with trains
+std::vector<uint32_t> createCollisionROFs()
+{
+  std::vector<uint32_t> rofs;
+  TRandom3 rnd(12345);
+  uint32_t rof = 0;
+  for (int train = 0; train < 40; train++) {
+    for (int i = 0; i < 20; i++) {
+      rof += rnd.Integer(2);
+      rofs.push_back(rof);
+    }
+    rof += Span + 1 + rnd.Integer(5);
+  }
+  return rofs;
+}
+
+using ROFSignals = std::map<uint32_t, double>; // summed signal per RO frame
+
+/// Toy digitization with the structure of the ITSMFT one: every collision adds a random signal to the RO frames it can
+/// reach, the RO frames are flushed with random noise from the first RO frame of the chunk up to the next chunk
+std::vector<std::pair<uint32_t, double>> digitize(const std::vector<uint32_t>& collROFs, int nThreads)
+{
+  TRandom3 seeds(42);
+  const auto chunks = DigitizationChunks::define(collROFs, Span, true, seeds);
+  std::vector<ROFSignals> outputs(chunks.size());
+  std::vector<std::pair<uint32_t, double>> merged;
+  std::vector<int> mergeOrder;
+  DigitizationChunks::run(
+    chunks.size(), nThreads,
+    [&](int, int ic) {
+      const auto& chunk = chunks[ic];
+      TRandom3 rnd(chunk.seed);
+      auto& signals = outputs[ic];
+      uint32_t lastROF = chunk.firstROF;
+      for (int collID = chunk.firstColl; collID < chunk.lastColl; collID++) {
+        for (uint32_t rof = collROFs[collID]; rof <= collROFs[collID] + Span; rof++) {
+          signals[rof] += rnd.Exp(10.);
+        }
+        lastROF = std::max(lastROF, collROFs[collID] + Span);
+      }
+      const uint32_t flushROF = ic + 1 < int(chunks.size()) ? chunks[ic + 1].firstROF - 1 : lastROF;
+      for (uint32_t rof = chunk.firstROF; rof <= flushROF; rof++) {
+        signals[rof] += rnd.Gaus(0., 1.);
+      }
+    },
+    [&](int ic) { // merged by the worker threads, the order is checked in the main thread
+      mergeOrder.push_back(ic);
+      for (const auto& signal : outputs[ic]) {
+        merged.push_back(signal);
+      }
+      outputs[ic].clear();
+    });
+  BOOST_REQUIRE_EQUAL(mergeOrder.size(), chunks.size());
+  for (size_t ic = 0; ic < chunks.size(); ic++) {
+    BOOST_CHECK_EQUAL(mergeOrder[ic], int(ic));
+  }
+  return merged;
+}
+
+/// Geometry of identical chips with the local frame equal to the global one
+class ChipsGeometry : public GeometryTGeo
+{
+ public:
+  explicit ChipsGeometry(int nChips) : GeometryTGeo(o2::detectors::DetID::MFT)
+  {
+    setSize(nChips);
+    getCacheL2G().setSize(nChips);
+    for (int i = 0; i < nChips; i++) {
+      getCacheL2G().setMatrix(Mat3D{}, i);
+    }
+  }
+  void Build(int) override {}
+  void fillMatrixCache(int) override {}
+};
+
+constexpr int NChips = 20;
+constexpr int ROFLengthInBC = 198;
+
+/// Collisions in trains separated by empty periods, with the hits crossing the sensors of random chips
+struct Collisions {
+  std::vector<o2::InteractionTimeRecord> times;
+  std::vector<std::vector<Hit>> hits;
+};
+
+Collisions createCollisions()
+{
+  Collisions colls;
+  TRandom3 rnd(12345);
+  const float thick = SegmentationAlpide::SensorLayerThickness;
+  o2::InteractionRecord ir(0, 1);
+  for (int train = 0; train < 30; train++) {
+    for (int i = 0; i < 8; i++) {
+      ir += 1 + rnd.Integer(ROFLengthInBC);
+      colls.times.emplace_back(ir, 0.);
+      auto& hits = colls.hits.emplace_back();
+      for (int ih = 0; ih < 50; ih++) {
+        float x = rnd.Uniform(-0.6, 0.6), z = rnd.Uniform(-1.3, 1.3);
+        TVector3 start(x, -0.49 * thick, z), end(x + rnd.Uniform(-2e-3, 2e-3), 0.49 * thick, z + rnd.Uniform(-2e-3, 2e-3));
+        hits.emplace_back(ih, rnd.Integer(NChips), start, end, TVector3(0., 1., 0.), 1., rnd.Uniform(0., 5.), rnd.Uniform(5e-6, 2e-5), 0, 0);
+      }
+    }
+    ir += 20 * ROFLengthInBC;
+  }
+  return colls;
+}
+
+struct DigitizerOutput {
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofRecords;
+  std::vector<MC2ROFRecord> mc2rofRecords;
+  o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+};
+
+/// Digitization as in the ITSMFT digitizer workflow, with a digitizer and a random generator per thread
+DigitizerOutput digitizeChunks(const Collisions& colls, const GeometryTGeo& geom, int nThreads)
+{
+  std::vector<std::unique_ptr<Digitizer>> digitizers;
+  std::vector<TRandom3> rnds(nThreads);
+  for (int i = 0; i < nThreads; i++) {
+    auto& digitizer = digitizers.emplace_back(std::make_unique<Digitizer>());
+    auto& params = digitizer->getParams();
+    params.setContinuous(true);
+    params.setROFrameLengthInBC(ROFLengthInBC);
+    params.setROFrameLength(ROFLengthInBC * o2::constants::lhc::LHCBunchSpacingNS);
+    params.setStrobeDelay(0.);
+    params.setStrobeLength(ROFLengthInBC * o2::constants::lhc::LHCBunchSpacingNS);
+    params.setNoisePerPixel(1e-7);
+    digitizer->setGeometry(&geom);
+    digitizer->init();
+  }
+  std::vector<uint32_t> collROFs;
+  for (const auto& t : colls.times) {
+    collROFs.push_back(digitizers[0]->getCollisionROFrame(t));
+  }
+  TRandom3 seeds(42);
+  auto chunks = DigitizationChunks::define(collROFs, digitizers[0]->getCollisionROFrameSpan(), true, seeds);
+  BOOST_CHECK(chunks.size() > 1);
+  DigitizerOutput res;
+  DigitizationChunks::run(
+    chunks.size(), nThreads,
+    [&](int iThread, int ic) {
+      auto& digitizer = *digitizers[iThread];
+      DigitizationChunks::digitize(chunks, ic, digitizer, rnds[iThread], colls.times,
+                                   [&](int collID) { digitizer.process(&colls.hits[collID], collID, 0); });
+    },
+    [&](int ic) {
+      auto& chunk = chunks[ic];
+      for (auto& out : chunk.outputs) {
+        for (auto rof : out.rofRecords) {
+          rof.setFirstEntry(res.digits.size() + rof.getFirstEntry());
+          res.rofRecords.push_back(rof);
+        }
+        res.digits.insert(res.digits.end(), out.digits.begin(), out.digits.end());
+        res.labels.mergeAtBack(out.labels);
+      }
+      res.mc2rofRecords.insert(res.mc2rofRecords.end(), chunk.mc2rofRecords.begin(), chunk.mc2rofRecords.end());
+      chunk = DigitizationChunk{};
+    });
+  return res;
+}
+
+template <typename T>
+void checkIdentical(const std::vector<T>& ref, const std::vector<T>& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+  BOOST_CHECK(std::memcmp(ref.data(), test.data(), ref.size() * sizeof(T)) == 0);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DigitizationChunks_define)
+{
+  const auto collROFs = createCollisionROFs();
+  TRandom3 rnd(42);
+  const auto chunks = DigitizationChunks::define(collROFs, Span, true, rnd);
+  BOOST_CHECK(chunks.size() > 1);
+  BOOST_CHECK(int(chunks.size()) <= DigitizationChunks::MaxChunks + 1);
+  BOOST_CHECK_EQUAL(chunks.front().firstColl, 0);
+  BOOST_CHECK_EQUAL(chunks.back().lastColl, int(collROFs.size()));
+  for (size_t ic = 1; ic < chunks.size(); ic++) {
+    BOOST_CHECK_EQUAL(chunks[ic].firstColl, chunks[ic - 1].lastColl);
+    BOOST_CHECK_EQUAL(chunks[ic].firstROF, collROFs[chunks[ic].firstColl]);
+    // no RO frame is shared with the preceding chunks
+    for (int collID = 0; collID < chunks[ic].firstColl; collID++) {
+      BOOST_CHECK(collROFs[collID] + Span < chunks[ic].firstROF);
+    }
+  }
+
+  // continuous collisions without any gap give a single chunk
+  std::vector<uint32_t> dense(1000);
+  for (size_t i = 0; i < dense.size(); i++) {
+    dense[i] = i / 2;
+  }
+  BOOST_CHECK_EQUAL(DigitizationChunks::define(dense, Span, true, rnd).size(), 1);
+
+  // in the triggered mode every collision is independent
+  BOOST_CHECK_EQUAL(DigitizationChunks::define(std::vector<uint32_t>(10), Span, false, rnd).size(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(DigitizationChunks_threads)
+{
+  const auto collROFs = createCollisionROFs();
+  const auto result1 = digitize(collROFs, 1);
+  const auto result2 = digitize(collROFs, 2);
+  const auto result4 = digitize(collROFs, 4);
+  BOOST_CHECK(!result1.empty());
+  BOOST_CHECK(result1 == result2);
+  BOOST_CHECK(result1 == result4);
+}
+
+BOOST_AUTO_TEST_CASE(DigitizationChunks_exception)
+{
+  int nMerged = 0;
+  BOOST_CHECK_THROW(DigitizationChunks::run(
+                      10, 4,
+                      [](int, int ic) {
+                        if (ic == 5) {
+                          throw std::runtime_error("failed chunk");
+                        }
+                      },
+                      [&nMerged](int) { nMerged++; }),
+                    std::runtime_error);
+  BOOST_CHECK(nMerged <= 5);
+}
+
+BOOST_AUTO_TEST_CASE(DigitizationChunks_digitizer)
+{
+  const auto colls = createCollisions();
+  ChipsGeometry geom(NChips);
+  const auto result1 = digitizeChunks(colls, geom, 1);
+  BOOST_CHECK(!result1.digits.empty());
+  for (int nThreads : {2, 4}) {
+    auto result = digitizeChunks(colls, geom, nThreads);
+    checkIdentical(result1.digits, result.digits);
+    checkIdentical(result1.rofRecords, result.rofRecords);
+    checkIdentical(result1.mc2rofRecords, result.mc2rofRecords);
+    BOOST_REQUIRE_EQUAL(result1.labels.getIndexedSize(), result.labels.getIndexedSize());
+    BOOST_REQUIRE_EQUAL(result1.labels.getNElements(), result.labels.getNElements());
+    for (size_t i = 0; i < result.labels.getIndexedSize(); i++) {
+      auto ref = result1.labels.getLabels(i);
+      auto test = result.labels.getLabels(i);
+      BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+      for (size_t j = 0; j < ref.size(); j++) {
+        BOOST_CHECK(ref[j] == test[j]);
+      }
+    }
+  }
+}
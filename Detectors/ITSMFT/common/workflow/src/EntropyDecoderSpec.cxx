@@ -43,6 +43,7 @@ void EntropyDecoderSpec::init(o2::framework::InitContext& ic)
   mCTFDictPath = ic.options().get<std::string>("ctf-dict");
   mMaskNoise = ic.options().get<bool>("mask-noise");
   mUseClusterDictionary = !ic.options().get<bool>("ignore-cluster-dictionary");
+  mCTFCoder.setNThreads(ic.options().get<int>("nthreads"));
 }
 
 void EntropyDecoderSpec::run(ProcessingContext& pc)
@@ -134,7 +135,8 @@ DataProcessorSpec getEntropyDecoderSpec(o2::header::DataOrigin orig, int verbosi
     Options{
       {"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}},
       {"mask-noise", VariantType::Bool, false, {"apply noise mask to digits or clusters (involves reclusterization)"}},
-      {"ignore-cluster-dictionary", VariantType::Bool, false, {"do not use cluster dictionary, always store explicit patterns"}}}};
+      {"ignore-cluster-dictionary", VariantType::Bool, false, {"do not use cluster dictionary, always store explicit patterns"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads decoding the CTF blocks concurrently"}}}};
 }
 
 } // namespace itsmft
@@ -17,6 +17,7 @@
 #define O2_MCH_CTFCODER_H
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <string>
 #include <array>
@@ -86,8 +87,10 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofData, cons
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODEMCH(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  // the blocks are encoded concurrently out of place and stored one after the other into the buffer at the end
+  CTF::encodedSlots slots;
+  std::vector<std::function<void()>> tasks;
+#define ENCODEMCH(beg, end, slot, bits) tasks.emplace_back([&]() { CTF::encodeSlot(slots[int(slot)], beg, end, bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor(), getANSNStreams()); });
   // clang-format off
   ENCODEMCH(helper.begin_bcIncROF(),    helper.end_bcIncROF(),     CTF::BLC_bcIncROF,     0);
   ENCODEMCH(helper.begin_orbitIncROF(), helper.end_orbitIncROF(),  CTF::BLC_orbitIncROF,  0);
@@ -100,6 +103,8 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofData, cons
   ENCODEMCH(helper.begin_padID(),       helper.end_padID(),        CTF::BLC_padID,        0);
   ENCODEMCH(helper.begin_ADC()  ,       helper.end_ADC(),          CTF::BLC_ADC,          0);
   // clang-format on
+  runBlockTasks(tasks);
+  CTF::storeSlots(buff, slots);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
 }
 
@@ -117,7 +122,9 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofVec, VCOL& digVec)
   std::vector<int16_t> detID, padID;
   std::vector<uint8_t> isSaturated;
 
-#define DECODEMCH(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // the blocks are decoded concurrently
+  std::vector<std::function<void()>> tasks;
+#define DECODEMCH(part, slot) tasks.emplace_back([&]() { ec.decode(part, int(slot), mCoders[int(slot)].get()); })
   // clang-format off
   DECODEMCH(bcInc,       CTF::BLC_bcIncROF);
   DECODEMCH(orbitInc,    CTF::BLC_orbitIncROF);
@@ -130,6 +137,7 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofVec, VCOL& digVec)
   DECODEMCH(padID,       CTF::BLC_padID);
   DECODEMCH(ADC,         CTF::BLC_ADC);
   // clang-format on
+  runBlockTasks(tasks);
   //
   rofVec.clear();
   digVec.clear();
@@ -51,6 +51,7 @@ EntropyDecoderSpec::EntropyDecoderSpec(int verbosity)
 void EntropyDecoderSpec::init(o2::framework::InitContext& ic)
 {
   std::string dictPath = ic.options().get<std::string>("ctf-dict");
+  mCTFCoder.setNThreads(ic.options().get<int>("nthreads"));
   if (!dictPath.empty() && dictPath != "none") {
     mCTFCoder.createCodersFromFile<CTF>(dictPath, o2::ctf::CTFCoderBase::OpType::Decoder);
   }
@@ -91,7 +92,8 @@ DataProcessorSpec getEntropyDecoderSpec(int verbosity, const char* specName, uns
     Inputs{InputSpec{"ctf", "MCH", "CTFDATA", sspec, Lifetime::Timeframe}},
     outputs,
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(verbosity)},
-    Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}}}};
+    Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}},
+            {"nthreads", VariantType::Int, 1, {"Number of threads decoding the CTF blocks concurrently"}}}};
 }
 
 } // namespace mch
@@ -28,6 +28,20 @@ namespace mch
 
 class TrackParam;
 
+/// Parameters of a batch of tracks, stored as structure of arrays, to be extrapolated together
+struct TrackParamBatch {
+  static constexpr int MaxSize = 8; ///< maximum number of tracks in the batch
+
+  void clear() { size = 0; }
+  int add(const TrackParam& trackParam);
+  void get(int i, TrackParam& trackParam) const;
+
+  int size = 0;                  ///< number of tracks in the batch
+  double z[MaxSize] = {};        ///< z position of each track (cm)
+  double param[5][MaxSize] = {}; ///< track parameters (x, slope x, y, slope y, inverse bending momentum) of each track
+  bool ok[MaxSize] = {};         ///< false if the extrapolation of the track failed
+};
+
 /// Class holding tools for track extrapolation
 class TrackExtrap
 {
@@ -57,6 +71,7 @@ class TrackExtrap
 
   static bool extrapToZ(TrackParam& trackParam, double zEnd);
   static bool extrapToZCov(TrackParam& trackParam, double zEnd, bool updatePropagator = false);
+  static void extrapToZ(TrackParamBatch& trackParams, double zEnd);
 
   static bool extrapToVertex(TrackParam& trackParam, double xVtx, double yVtx, double zVtx, double errXVtx, double errYVtx)
   {
@@ -116,6 +131,14 @@ class TrackExtrap
   static bool extrapToZRungekutta(TrackParam& trackParam, double zEnd);
   static bool extrapToZRungekuttaV2(TrackParam& trackParam, double zEnd);
   static bool extrapOneStepRungekutta(double charge, double step, const double* vect, double* vout);
+  static bool extrapOneStepHelix(double pinv, double step, const double* f, const double* xyzt, const double* vect, double* vout);
+
+  static bool extrapToZCovV2(TrackParam& trackParam, double zEnd, bool updatePropagator);
+  static void extrapToZRungekuttaV2(TrackParamBatch& trackParams, double zEnd);
+  static void extrapOneStepRungekutta(int n, const bool* active, const double* charge, const double* step,
+                                      const double (*vect)[TrackParamBatch::MaxSize], double (*vout)[TrackParamBatch::MaxSize], bool* ok);
+  static void getField(int n, const bool* active, const double* x, const double* y, const double* z,
+                       double (*f)[TrackParamBatch::MaxSize]);
 
   static constexpr double SMuMass = 0.105658;                         ///< Muon mass (GeV/c2)
   static constexpr double SAbsZBeg = -90.;                            ///< Position of the begining of the absorber (cm)
@@ -19,12 +19,14 @@
 
 #include <chrono>
 #include <unordered_map>
-#include <unordered_set>
 #include <list>
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <utility>
 
+#include <gsl/span>
+
 #include "DataFormatsMCH/Cluster.h"
 #include "MCHTracking/Track.h"
 #include "MCHTracking/TrackFitter.h"
@@ -49,6 +51,7 @@ class TrackFinder
   void init(float l3Current, float dipoleCurrent);
 
   const std::list<Track>& findTracks(const std::unordered_map<int, std::list<const Cluster*>>& clusters);
+  const std::list<Track>& findTracks(gsl::span<const Cluster> clusters);
 
   /// set the debug level defining the verbosity
   void debug(int debugLevel) { mDebugLevel = debugLevel; }
@@ -57,6 +60,65 @@ class TrackFinder
   void printTimers() const;
 
  private:
+  /// pointers to the clusters of one DE
+  using ClusterPtrs = gsl::span<const Cluster* const>;
+
+  /// position of a cluster in the bending direction and its index in mClusterPtrs
+  struct SortedCluster {
+    float y;
+    int index;
+  };
+
+  /// clusters of one DE to try to attach to a track, in their input order: either all of them,
+  /// i.e. the ones with index in mClusterPtrs in [begin, end[, or mSelectedClusters[begin, end[
+  struct ClusterRange {
+    size_t begin;
+    size_t end;
+    bool selected;
+  };
+
+  /// Clusters excluded from the search for compatible clusters of one candidate, identified by their uid
+  /// in a short list, or by their index in mClusterPtrs in a bitset with the sorted cluster search
+  class ExcludedClusters
+  {
+   public:
+    explicit ExcludedClusters(TrackFinder& finder);
+    ~ExcludedClusters();
+
+    ExcludedClusters(const ExcludedClusters&) = delete;
+    ExcludedClusters& operator=(const ExcludedClusters&) = delete;
+    ExcludedClusters(ExcludedClusters&&) = delete;
+    ExcludedClusters& operator=(ExcludedClusters&&) = delete;
+
+    /// return true if no cluster is excluded
+    bool empty() const { return mNClusters == 0; }
+    bool contains(const Cluster& cluster, int index) const;
+    void add(const Cluster& cluster, int index = -1);
+    void moveTo(ExcludedClusters& destination);
+
+   private:
+    TrackFinder& mFinder;          ///< track finder providing the bitsets
+    bool mUseBits = false;         ///< use a bitset instead of the list of uids
+    std::vector<uint32_t> mUids{}; ///< list of uids of the excluded clusters
+    uint64_t* mBits = nullptr;     ///< bitset of the excluded clusters, taken from mExcludedClusterBits
+    int mNClusters = 0;            ///< number of excluded clusters
+  };
+
+  void setDEClusters();
+  void sortDEClusters();
+  ClusterRange getClusters(int deId, const TrackParam& param);
+  /// return the index in mClusterPtrs of the i-th cluster of the range
+  int getClusterIndex(const ClusterRange& clusters, size_t i) const { return clusters.selected ? mSelectedClusters[i] : int(i); }
+  /// release the clusters selected by getClusters
+  void releaseClusters(const ClusterRange& clusters)
+  {
+    if (clusters.selected) {
+      mSelectedClusters.resize(clusters.begin);
+    }
+  }
+  int getClusterIndex(const Cluster& cluster) const;
+  const std::list<Track>& findTracks();
+
   void findTrackCandidates();
   void findTrackCandidatesInSt5();
   void findTrackCandidatesInSt4();
@@ -66,13 +128,13 @@ class TrackFinder
   std::list<Track>::iterator followTrackInOverlapDE(const std::list<Track>::iterator& itTrack, int currentDE, int plane);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int chamber, int lastChamber, bool canSkip,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ExcludedClusters& excludedClusters);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int plane1, int plane2, int lastChamber,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ExcludedClusters& excludedClusters);
   std::list<Track>::iterator addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                        const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                       std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                       ExcludedClusters& excludedClusters);
 
   void improveTracks();
 
@@ -93,9 +155,8 @@ class TrackFinder
 
   bool areUsed(const Cluster& cl1, const Cluster& cl2, const std::vector<std::array<uint32_t, 4>>& usedClusters);
   void excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                          std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                          ExcludedClusters& excludedClusters,
                                           const std::list<Track>::iterator& itEndTrack);
-  void moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination);
 
   bool isCompatible(const TrackParam& param, const Cluster& cluster, TrackParam& paramAtCluster);
   bool tryOneClusterFast(const TrackParam& param, const Cluster& cluster);
@@ -113,6 +174,9 @@ class TrackFinder
   /// return the chamber to which this plane belong to
   int getChamberId(int plane) { return (plane < 8) ? plane / 2 : 4 + (plane - 8) / 4; }
 
+  /// return the internal index of the DE or -1 if it is not a valid DE
+  int getDEIndex(int deId) const { return (deId >= 0 && deId < SNDEIds) ? mDEIndices[deId] : -1; }
+
   ///< maximum distance to the track to search for compatible cluster(s) in non bending direction
   static constexpr double SMaxNonBendingDistanceToTrack = 1.;
   ///< maximum distance to the track to search for compatible cluster(s) in bending direction
@@ -125,11 +189,24 @@ class TrackFinder
   static constexpr double SChamberThicknessInX0[10] = {0.065, 0.065, 0.075, 0.075, 0.035,
                                                        0.035, 0.035, 0.035, 0.035, 0.035};
   static constexpr int SNDE[10] = {4, 4, 4, 4, 18, 18, 26, 26, 26, 26}; ///< number of DE per chamber
+  static constexpr int SNDEIds = 1100;                                  ///< upper limit of the DE Ids
 
   TrackFitter mTrackFitter{}; /// track fitter
 
-  /// array of pointers to the lists of clusters per DE
-  std::array<std::vector<std::pair<const int, const std::list<const Cluster*>*>>, 32> mClusters{};
+  /// array of clusters per DE, grouped in z-planes, pointing to mClusterPtrs
+  std::array<std::vector<std::pair<const int, ClusterPtrs>>, 32> mClusters{};
+  std::vector<const Cluster*> mClusterPtrs{}; ///< pointers to the clusters of the current event, contiguous per DE
+  std::array<int, SNDEIds> mDEIndices{};      ///< internal index of the DEs, ordered as in mClusters
+  std::vector<size_t> mDEOffsets{};           ///< offsets of the clusters of each DE in mClusterPtrs
+  std::vector<size_t> mDEFillIndices{};       ///< working array to group the clusters per DE
+
+  bool mSortedClusterSearch = false;                         ///< search the clusters around the tracks in the sorted arrays
+  std::vector<SortedCluster> mSortedClusters{};              ///< clusters sorted in y per DE, with the same offsets as mClusterPtrs
+  std::vector<std::pair<float, float>> mDEZRanges{};         ///< z range of the clusters of each DE
+  std::vector<int> mSelectedClusters{};                      ///< stack of clusters selected by getClusters
+  std::vector<std::vector<uint64_t>> mExcludedClusterBits{}; ///< stack of bitsets of excluded clusters
+  size_t mNExcludedClusterBitsInUse = 0;                     ///< number of bitsets of excluded clusters in use
+  size_t mNExcludedClusterWords = 0;                         ///< size of the bitsets of excluded clusters
 
   std::list<Track> mTracks{}; ///< list of reconstructed tracks
 
@@ -42,6 +42,10 @@ struct TrackerParam : public o2::conf::ConfigurableParamHelper<TrackerParam> {
   bool moreCandidates = false; ///< find more track candidates starting from 1 cluster in each of station (1..) 4 and 5
   bool refineTracks = true;    ///< refine the tracks in the end using cluster resolution
 
+  /// if true, only the clusters around the track are tested, searched in the DEs sorted in y, and the excluded
+  /// clusters are kept in bitsets, otherwise all the clusters of the DEs are tested (same tracks, slower)
+  bool sortedClusterSearch = true;
+
   O2ParamDef(TrackerParam, "MCHTracking");
 };
 
@@ -38,6 +38,34 @@ bool TrackExtrap::sFieldON = false;
 std::size_t TrackExtrap::sNCallExtrapToZCov = 0;
 std::size_t TrackExtrap::sNCallField = 0;
 
+//__________________________________________________________________________
+int TrackParamBatch::add(const TrackParam& trackParam)
+{
+  /// Add the track parameters at the end of the batch and return their index
+  /// Return -1 if the batch is full
+  if (size == MaxSize) {
+    return -1;
+  }
+  z[size] = trackParam.getZ();
+  for (int j = 0; j < 5; ++j) {
+    param[j][size] = trackParam.getParameters()(j, 0);
+  }
+  ok[size] = true;
+  return size++;
+}
+
+//__________________________________________________________________________
+void TrackParamBatch::get(int i, TrackParam& trackParam) const
+{
+  /// Set the parameters of the track at index i in trackParam
+  trackParam.setZ(z[i]);
+  trackParam.setNonBendingCoor(param[0][i]);
+  trackParam.setNonBendingSlope(param[1][i]);
+  trackParam.setBendingCoor(param[2][i]);
+  trackParam.setBendingSlope(param[3][i]);
+  trackParam.setInverseBendingMomentum(param[4][i]);
+}
+
 //__________________________________________________________________________
 void TrackExtrap::setField()
 {
@@ -180,6 +208,11 @@ bool TrackExtrap::extrapToZCov(TrackParam& trackParam, double zEnd, bool updateP
     return extrapToZ(trackParam, zEnd);
   }
 
+  // Extrapolate the track parameters and the ones used to compute the jacobian together
+  if (sExtrapV2) {
+    return extrapToZCovV2(trackParam, zEnd, updatePropagator);
+  }
+
   // Save the actual track parameters
   TrackParam trackParamSave(trackParam);
   TMatrixD paramSave(trackParamSave.getParameters());
@@ -248,6 +281,106 @@ bool TrackExtrap::extrapToZCov(TrackParam& trackParam, double zEnd, bool updateP
   return true;
 }
 
+//__________________________________________________________________________
+void TrackExtrap::extrapToZ(TrackParamBatch& trackParams, double zEnd)
+{
+  /// Extrapolate the parameters of every tracks in the batch to the plane at "zEnd" in one go.
+  /// The result is the same as extrapolating them one by one with extrapToZ(TrackParam&, double).
+  /// On return, trackParams.ok[i] is false if the extrapolation of track i failed,
+  /// in which case its parameters are left as they were when that happened
+  if (!sFieldON) {
+    for (int i = 0; i < trackParams.size; ++i) {
+      if (trackParams.z[i] != zEnd) {
+        double dZ = zEnd - trackParams.z[i];
+        trackParams.param[0][i] = trackParams.param[0][i] + trackParams.param[1][i] * dZ;
+        trackParams.param[2][i] = trackParams.param[2][i] + trackParams.param[3][i] * dZ;
+        trackParams.z[i] = zEnd;
+      }
+      trackParams.ok[i] = true;
+    }
+  } else if (sExtrapV2) {
+    extrapToZRungekuttaV2(trackParams, zEnd);
+  } else {
+    TrackParam trackParam{};
+    for (int i = 0; i < trackParams.size; ++i) {
+      trackParams.get(i, trackParam);
+      trackParams.ok[i] = extrapToZRungekutta(trackParam, zEnd);
+      trackParams.z[i] = trackParam.getZ();
+      for (int j = 0; j < 5; ++j) {
+        trackParams.param[j][i] = trackParam.getParameters()(j, 0);
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+bool TrackExtrap::extrapToZCovV2(TrackParam& trackParam, double zEnd, bool updatePropagator)
+{
+  /// Same as extrapToZCov(...) with the Runge-Kutta extrapolation v2, but extrapolating
+  /// the track parameters and the ones varied to compute the jacobian together in one batch
+
+  const TMatrixD& kParamCov = trackParam.getCovariances();
+  const TMatrixD& param = trackParam.getParameters();
+  double zBegin = trackParam.getZ();
+
+  // the nominal track parameters go first, followed by the ones with a small variation of parameter i only
+  TrackParamBatch trackParams{};
+  trackParams.add(trackParam);
+  int variedParam[5] = {0};
+  double dParam[5] = {0.};
+  double direction[5] = {-1., -1., 1., 1., -1.};
+  for (int i = 0; i < 5; i++) {
+    // Skip jacobian calculation for parameters with no associated error
+    if (kParamCov(i, i) <= 0.) {
+      continue;
+    }
+    // variation always in the same direction
+    dParam[i] = TMath::Sqrt(kParamCov(i, i));
+    dParam[i] *= TMath::Sign(1., direction[i] * param(i, 0));
+    int iTrack = trackParams.size++;
+    variedParam[iTrack - 1] = i;
+    trackParams.z[iTrack] = zBegin;
+    for (int j = 0; j < 5; j++) {
+      trackParams.param[j][iTrack] = param(j, 0) + ((j == i) ? dParam[i] : 0.);
+    }
+  }
+
+  // Extrapolate all the track parameters to "zEnd"
+  extrapToZRungekuttaV2(trackParams, zEnd);
+
+  // Do not update the covariance matrix if the extrapolation failed
+  if (!trackParams.ok[0]) {
+    return false;
+  }
+  trackParams.get(0, trackParam);
+
+  // Calculate the jacobian related to the track parameters extrapolation to "zEnd"
+  TMatrixD jacob(5, 5);
+  jacob.Zero();
+  for (int iTrack = 1; iTrack < trackParams.size; ++iTrack) {
+    if (!trackParams.ok[iTrack]) {
+      LOG(warning) << "Bad covariance matrix";
+      return false;
+    }
+    int i = variedParam[iTrack - 1];
+    for (int j = 0; j < 5; j++) {
+      jacob(j, i) = (trackParams.param[j][iTrack] - trackParams.param[j][0]) * (1. / dParam[i]);
+    }
+  }
+
+  // Extrapolate track parameter covariances to "zEnd"
+  TMatrixD tmp(kParamCov, TMatrixD::kMultTranspose, jacob);
+  TMatrixD tmp2(jacob, TMatrixD::kMult, tmp);
+  trackParam.setCovariances(tmp2);
+
+  // Update the propagator if required
+  if (updatePropagator) {
+    trackParam.updatePropagator(jacob);
+  }
+
+  return true;
+}
+
 //__________________________________________________________________________
 bool TrackExtrap::extrapToMID(TrackParam& trackParam)
 {
@@ -985,6 +1118,118 @@ bool TrackExtrap::extrapToZRungekuttaV2(TrackParam& trackParam, double zEnd)
   return true;
 }
 
+//__________________________________________________________________________
+void TrackExtrap::extrapToZRungekuttaV2(TrackParamBatch& trackParams, double zEnd)
+{
+  /// Extrapolation of a batch of track parameters to the plane at "Z" using Rungekutta algorithm v2.
+  /// The tracks are propagated step by step in lockstep, each of them following exactly
+  /// the same sequence of operations as in extrapToZRungekuttaV2(TrackParam&, double).
+  /// On return, trackParams.ok[i] is false in case of failure for track i and its parameters are
+  /// left as they were when that happened
+
+  constexpr int N = TrackParamBatch::MaxSize;
+  const int n = trackParams.size;
+
+  double v3[7][N] = {{0.}}, v3New[7][N] = {{0.}};
+  double residue[N] = {0.}, forwardBackward[N] = {0.}, charge[N] = {0.}, stepCharge[N] = {0.}, step[N] = {0.};
+  int stepNumber[N] = {0};
+  bool active[N] = {false}, stepOK[N] = {false};
+  int nActive(0);
+
+  for (int i = 0; i < n; ++i) {
+    trackParams.ok[i] = true;
+    if (trackParams.z[i] == zEnd) {
+      continue; // nothing to be done if same Z
+    }
+    residue[i] = zEnd - trackParams.z[i];
+    forwardBackward[i] = (residue[i] < 0) ? 1. : -1.; // +1 if forward, -1 if backward
+    // convert the track parameters to Geant3 parameters, as in convertTrackParamForExtrap(...)
+    double pYZ = TMath::Abs(1.0 / trackParams.param[4][i]);
+    double pZ = pYZ / TMath::Sqrt(1.0 + trackParams.param[3][i] * trackParams.param[3][i]);
+    v3[0][i] = trackParams.param[0][i];
+    v3[1][i] = trackParams.param[2][i];
+    v3[2][i] = trackParams.z[i];
+    v3[6][i] = TMath::Sqrt(pYZ * pYZ + pZ * pZ * trackParams.param[1][i] * trackParams.param[1][i]);
+    v3[5][i] = -forwardBackward[i] * pZ / v3[6][i];
+    v3[3][i] = trackParams.param[1][i] * v3[5][i];
+    v3[4][i] = trackParams.param[3][i] * v3[5][i];
+    charge[i] = TMath::Sign(double(1.), trackParams.param[4][i]);
+    active[i] = true;
+    ++nActive;
+  }
+
+  // Extrapolation loop (until within tolerance or the track turn around)
+  while (nActive > 0) {
+
+    for (int i = 0; i < n; ++i) {
+      if (!active[i]) {
+        continue;
+      }
+      if (++stepNumber[i] > SMaxStepNumber) {
+        LOG(warning) << "Too many trials";
+        trackParams.ok[i] = active[i] = false;
+        --nActive;
+        continue;
+      }
+      // step length assuming linear trajectory
+      double slopeX = v3[3][i] / v3[5][i];
+      double slopeY = v3[4][i] / v3[5][i];
+      step[i] = TMath::Abs(residue[i]) * TMath::Sqrt(1.0 + slopeX * slopeX + slopeY * slopeY);
+      stepCharge[i] = forwardBackward[i] * charge[i];
+    }
+
+    extrapOneStepRungekutta(n, active, stepCharge, step, v3, v3New, stepOK);
+
+    for (int i = 0; i < n; ++i) {
+      if (!active[i]) {
+        continue;
+      }
+
+      if (!stepOK[i]) {
+        trackParams.ok[i] = active[i] = false;
+        --nActive;
+        continue;
+      }
+
+      if (v3New[5][i] * v3[5][i] < 0) {
+        LOG(warning) << "The track turned around";
+        trackParams.ok[i] = active[i] = false;
+        --nActive;
+        continue;
+      }
+
+      residue[i] = zEnd - v3New[2][i];
+      if (TMath::Abs(residue[i]) < SRungeKuttaMaxResidueV2) {
+
+        // recover the track parameters, as in recoverTrackParam(...), and terminate
+        // the extrapolation with a straight line up to the exact "zEnd" value
+        double pYZ = v3New[6][i] * TMath::Sqrt((1. - v3New[3][i]) * (1. + v3New[3][i]));
+        trackParams.param[4][i] = charge[i] / pYZ;
+        trackParams.param[3][i] = v3New[4][i] / v3New[5][i];
+        trackParams.param[1][i] = v3New[3][i] / v3New[5][i];
+        trackParams.param[0][i] = v3New[0][i] + residue[i] * trackParams.param[1][i];
+        trackParams.param[2][i] = v3New[1][i] + residue[i] * trackParams.param[3][i];
+        trackParams.z[i] = zEnd;
+        active[i] = false;
+        --nActive;
+        continue;
+      }
+
+      for (int j = 0; j < 7; ++j) {
+        v3[j][i] = v3New[j][i];
+      }
+
+      // invert the sens of propagation if the track went too far
+      if (forwardBackward[i] * residue[i] > 0) {
+        forwardBackward[i] = -forwardBackward[i];
+        v3[3][i] = -v3[3][i];
+        v3[4][i] = -v3[4][i];
+        v3[5][i] = -v3[5][i];
+      }
+    }
+  }
+}
+
 //__________________________________________________________________________
 bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const double* vect, double* vout)
 {
@@ -1014,10 +1259,9 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
   double h2(0.), h4(0.), f[4] = {0.};
   double xyzt[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
   double a(0.), b(0.), c(0.), ph(0.), ph2(0.);
-  double secxs[4] = {0.}, secys[4] = {0.}, seczs[4] = {0.}, hxp[3] = {0.};
-  double g1(0.), g2(0.), g3(0.), g4(0.), g5(0.), g6(0.), ang2(0.), dxt(0.), dyt(0.), dzt(0.);
+  double secxs[4] = {0.}, secys[4] = {0.}, seczs[4] = {0.};
+  double ang2(0.), dxt(0.), dyt(0.), dzt(0.);
   double est(0.), at(0.), bt(0.), ct(0.), cba(0.);
-  double f1(0.), f2(0.), f3(0.), f4(0.), rho(0.), tet(0.), hnorm(0.), hp(0.), rho1(0.), sint(0.), cost(0.);
 
   double x(0.);
   double y(0.);
@@ -1037,12 +1281,6 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
   const double kec = 2.9979251e-4;
 
   const double kpisqua = 9.86960440109;
-  const int kix = 0;
-  const int kiy = 1;
-  const int kiz = 2;
-  const int kipx = 3;
-  const int kipy = 4;
-  const int kipz = 5;
 
   // *.
   // *.    ------------------------------------------------------------------
@@ -1211,6 +1449,27 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
   // angle too big, use helix
   LOG(warning) << "Ruge-Kutta failed: switch to helix";
 
+  return extrapOneStepHelix(pinv, step, f, xyzt, vect, vout);
+}
+
+//__________________________________________________________________________
+bool TrackExtrap::extrapOneStepHelix(double pinv, double step, const double* f, const double* xyzt, const double* vect, double* vout)
+{
+  /// Helix extrapolation of one step in the field f, used when the Runge-Kutta extrapolation fails
+  /// xyzt is the last position where the field has been evaluated
+
+  double hxp[3] = {0.};
+  double g1(0.), g2(0.), g3(0.), g4(0.), g5(0.), g6(0.);
+  double f1(0.), f2(0.), f3(0.), f4(0.), rho(0.), tet(0.), hnorm(0.), hp(0.), rho1(0.), sint(0.), cost(0.);
+
+  const double khalf = 0.5;
+  const int kix = 0;
+  const int kiy = 1;
+  const int kiz = 2;
+  const int kipx = 3;
+  const int kipy = 4;
+  const int kipz = 5;
+
   f1 = f[0];
   f2 = f[1];
   f3 = f[2];
@@ -1255,6 +1514,260 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
   return true;
 }
 
+//__________________________________________________________________________
+void TrackExtrap::extrapOneStepRungekutta(int n, const bool* active, const double* charge, const double* step,
+                                          const double (*vect)[TrackParamBatch::MaxSize],
+                                          double (*vout)[TrackParamBatch::MaxSize], bool* ok)
+{
+  /// Runge-Kutta step of every active tracks of a batch, with the same algorithm as
+  /// extrapOneStepRungekutta(double, double, const double*, double*) run for each of them.
+  /// The tracks are processed in lockstep: the arithmetic runs over all the tracks at once and
+  /// the field is evaluated for all the tracks still in the step before going to the next stage.
+  /// The parameters are in Geant3 format, one array per component: vect[component][track]
+
+  constexpr int N = TrackParamBatch::MaxSize;
+  enum Status { Idle,
+                Running,
+                Done,
+                Helix };
+
+  double f[3][N] = {{0.}};
+  double xyzt[3][N];
+  double x[N] = {0.}, y[N] = {0.}, z[N] = {0.}, a[N] = {0.}, b[N] = {0.}, c[N] = {0.};
+  double xt[N] = {0.}, yt[N] = {0.}, zt[N] = {0.}, at[N] = {0.}, bt[N] = {0.}, ct[N] = {0.};
+  double secxs[4][N] = {{0.}}, secys[4][N] = {{0.}}, seczs[4][N] = {{0.}};
+  double h[N] = {0.}, ph2[N] = {0.}, est[N] = {0.}, ang2[N] = {0.}, pinv[N] = {0.}, tl[N] = {0.};
+  int iter[N] = {0}, ncut[N] = {0};
+  Status status[N] = {Idle};
+  bool inStep[N] = {false};
+  int nRunning(0);
+
+  const double maxit = 1992;
+  const double maxcut = 11;
+
+  const double kdlt = 1e-4;
+  const double kdlt32 = kdlt / 32.;
+  const double kthird = 1. / 3.;
+  const double khalf = 0.5;
+  const double kec = 2.9979251e-4;
+
+  const double kpisqua = 9.86960440109;
+
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < 7; j++) {
+      vout[j][i] = vect[j][i];
+    }
+    xyzt[0][i] = xyzt[1][i] = xyzt[2][i] = FLT_MAX;
+    if (active[i]) {
+      status[i] = Running;
+      pinv[i] = kec * charge[i] / vect[6][i];
+      h[i] = step[i];
+      ++nRunning;
+    }
+  }
+
+  // stop the current step of track i, either to retry with a smaller one or to switch to helix
+  auto cutStep = [&](int i) {
+    inStep[i] = false;
+    if (ncut[i]++ > maxcut) {
+      status[i] = Helix;
+      --nRunning;
+    } else {
+      h[i] *= khalf;
+    }
+  };
+
+  while (nRunning > 0) {
+
+    for (int i = 0; i < n; ++i) {
+      inStep[i] = (status[i] == Running);
+      if (inStep[i]) {
+        double rest = step[i] - tl[i];
+        if (TMath::Abs(h[i]) > TMath::Abs(rest)) {
+          h[i] = rest;
+        }
+      }
+    }
+
+    getField(n, inStep, vout[0], vout[1], vout[2], f);
+
+    // start of integration
+    for (int i = 0; i < n; ++i) {
+      x[i] = vout[0][i];
+      y[i] = vout[1][i];
+      z[i] = vout[2][i];
+      a[i] = vout[3][i];
+      b[i] = vout[4][i];
+      c[i] = vout[5][i];
+      double h2 = khalf * h[i];
+      double h4 = khalf * h2;
+      double ph = pinv[i] * h[i];
+      ph2[i] = khalf * ph;
+      secxs[0][i] = (b[i] * f[2][i] - c[i] * f[1][i]) * ph2[i];
+      secys[0][i] = (c[i] * f[0][i] - a[i] * f[2][i]) * ph2[i];
+      seczs[0][i] = (a[i] * f[1][i] - b[i] * f[0][i]) * ph2[i];
+      ang2[i] = (secxs[0][i] * secxs[0][i] + secys[0][i] * secys[0][i] + seczs[0][i] * seczs[0][i]);
+      double dxt = h2 * a[i] + h4 * secxs[0][i];
+      double dyt = h2 * b[i] + h4 * secys[0][i];
+      double dzt = h2 * c[i] + h4 * seczs[0][i];
+      xt[i] = x[i] + dxt;
+      yt[i] = y[i] + dyt;
+      zt[i] = z[i] + dzt;
+      est[i] = TMath::Abs(dxt) + TMath::Abs(dyt) + TMath::Abs(dzt);
+    }
+
+    // second intermediate point
+    for (int i = 0; i < n; ++i) {
+      if (!inStep[i]) {
+        continue;
+      }
+      if (ang2[i] > kpisqua) {
+        inStep[i] = false;
+        status[i] = Helix;
+        --nRunning;
+      } else if (est[i] > h[i]) {
+        cutStep(i);
+      } else {
+        xyzt[0][i] = xt[i];
+        xyzt[1][i] = yt[i];
+        xyzt[2][i] = zt[i];
+      }
+    }
+
+    getField(n, inStep, xyzt[0], xyzt[1], xyzt[2], f);
+
+    for (int i = 0; i < n; ++i) {
+      at[i] = a[i] + secxs[0][i];
+      bt[i] = b[i] + secys[0][i];
+      ct[i] = c[i] + seczs[0][i];
+      secxs[1][i] = (bt[i] * f[2][i] - ct[i] * f[1][i]) * ph2[i];
+      secys[1][i] = (ct[i] * f[0][i] - at[i] * f[2][i]) * ph2[i];
+      seczs[1][i] = (at[i] * f[1][i] - bt[i] * f[0][i]) * ph2[i];
+      at[i] = a[i] + secxs[1][i];
+      bt[i] = b[i] + secys[1][i];
+      ct[i] = c[i] + seczs[1][i];
+      secxs[2][i] = (bt[i] * f[2][i] - ct[i] * f[1][i]) * ph2[i];
+      secys[2][i] = (ct[i] * f[0][i] - at[i] * f[2][i]) * ph2[i];
+      seczs[2][i] = (at[i] * f[1][i] - bt[i] * f[0][i]) * ph2[i];
+      double dxt = h[i] * (a[i] + secxs[2][i]);
+      double dyt = h[i] * (b[i] + secys[2][i]);
+      double dzt = h[i] * (c[i] + seczs[2][i]);
+      xt[i] = x[i] + dxt;
+      yt[i] = y[i] + dyt;
+      zt[i] = z[i] + dzt;
+      at[i] = a[i] + 2. * secxs[2][i];
+      bt[i] = b[i] + 2. * secys[2][i];
+      ct[i] = c[i] + 2. * seczs[2][i];
+      est[i] = TMath::Abs(dxt) + TMath::Abs(dyt) + TMath::Abs(dzt);
+    }
+
+    for (int i = 0; i < n; ++i) {
+      if (!inStep[i]) {
+        continue;
+      }
+      if (est[i] > 2. * TMath::Abs(h[i])) {
+        cutStep(i);
+      } else {
+        xyzt[0][i] = xt[i];
+        xyzt[1][i] = yt[i];
+        xyzt[2][i] = zt[i];
+      }
+    }
+
+    getField(n, inStep, xyzt[0], xyzt[1], xyzt[2], f);
+
+    for (int i = 0; i < n; ++i) {
+      z[i] = z[i] + (c[i] + (seczs[0][i] + seczs[1][i] + seczs[2][i]) * kthird) * h[i];
+      y[i] = y[i] + (b[i] + (secys[0][i] + secys[1][i] + secys[2][i]) * kthird) * h[i];
+      x[i] = x[i] + (a[i] + (secxs[0][i] + secxs[1][i] + secxs[2][i]) * kthird) * h[i];
+      secxs[3][i] = (bt[i] * f[2][i] - ct[i] * f[1][i]) * ph2[i];
+      secys[3][i] = (ct[i] * f[0][i] - at[i] * f[2][i]) * ph2[i];
+      seczs[3][i] = (at[i] * f[1][i] - bt[i] * f[0][i]) * ph2[i];
+      a[i] = a[i] + (secxs[0][i] + secxs[3][i] + 2. * (secxs[1][i] + secxs[2][i])) * kthird;
+      b[i] = b[i] + (secys[0][i] + secys[3][i] + 2. * (secys[1][i] + secys[2][i])) * kthird;
+      c[i] = c[i] + (seczs[0][i] + seczs[3][i] + 2. * (seczs[1][i] + seczs[2][i])) * kthird;
+      est[i] = TMath::Abs(secxs[0][i] + secxs[3][i] - (secxs[1][i] + secxs[2][i])) +
+               TMath::Abs(secys[0][i] + secys[3][i] - (secys[1][i] + secys[2][i])) +
+               TMath::Abs(seczs[0][i] + seczs[3][i] - (seczs[1][i] + seczs[2][i]));
+    }
+
+    for (int i = 0; i < n; ++i) {
+      if (!inStep[i]) {
+        continue;
+      }
+      if (est[i] > kdlt && TMath::Abs(h[i]) > 1.e-4) {
+        cutStep(i);
+        continue;
+      }
+      ncut[i] = 0;
+      // if too many iterations, go to helix
+      if (iter[i]++ > maxit) {
+        status[i] = Helix;
+        --nRunning;
+        continue;
+      }
+      tl[i] += h[i];
+      if (est[i] < kdlt32) {
+        h[i] *= 2.;
+      }
+      double cba = 1. / TMath::Sqrt(a[i] * a[i] + b[i] * b[i] + c[i] * c[i]);
+      vout[0][i] = x[i];
+      vout[1][i] = y[i];
+      vout[2][i] = z[i];
+      vout[3][i] = cba * a[i];
+      vout[4][i] = cba * b[i];
+      vout[5][i] = cba * c[i];
+      double rest = step[i] - tl[i];
+      if (step[i] < 0.) {
+        rest = -rest;
+      }
+      if (rest < 1.e-5 * TMath::Abs(step[i])) {
+        status[i] = Done;
+        --nRunning;
+      }
+    }
+  }
+
+  for (int i = 0; i < n; ++i) {
+    ok[i] = (status[i] == Done);
+    if (status[i] == Helix) {
+      // angle too big, use helix
+      LOG(warning) << "Ruge-Kutta failed: switch to helix";
+      double vectI[7], voutI[7], fI[3] = {f[0][i], f[1][i], f[2][i]}, xyztI[3] = {xyzt[0][i], xyzt[1][i], xyzt[2][i]};
+      for (int j = 0; j < 7; j++) {
+        vectI[j] = vect[j][i];
+        voutI[j] = vout[j][i];
+      }
+      ok[i] = extrapOneStepHelix(pinv[i], step[i], fI, xyztI, vectI, voutI);
+      for (int j = 0; j < 7; j++) {
+        vout[j][i] = voutI[j];
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+void TrackExtrap::getField(int n, const bool* active, const double* x, const double* y, const double* z,
+                           double (*f)[TrackParamBatch::MaxSize])
+{
+  /// Evaluate the magnetic field at the position of every active tracks of a batch
+  /// The field of the other tracks is left unchanged
+  double xyz[3] = {0.}, b[3] = {0.};
+  for (int i = 0; i < n; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    xyz[0] = x[i];
+    xyz[1] = y[i];
+    xyz[2] = z[i];
+    TGeoGlobalMagField::Instance()->Field(xyz, b);
+    ++sNCallField;
+    f[0][i] = b[0];
+    f[1][i] = b[1];
+    f[2][i] = b[2];
+  }
+}
+
 //__________________________________________________________________________
 void TrackExtrap::printNCalls()
 {
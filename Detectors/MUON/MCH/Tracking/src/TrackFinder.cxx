@@ -16,8 +16,12 @@
 
 #include "MCHTracking/TrackFinder.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
 
 #include <TGeoGlobalMagField.h>
@@ -75,88 +79,256 @@ void TrackFinder::init(float l3Current, float dipoleCurrent)
   // grouping DEs in z-planes (2 for chambers 1-4 and 4 for chambers 5-10)
   for (int iCh = 0; iCh < 4; ++iCh) {
     mClusters[2 * iCh].reserve(2);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, nullptr);
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, ClusterPtrs{});
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, ClusterPtrs{});
     mClusters[2 * iCh + 1].reserve(2);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, nullptr);
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), ClusterPtrs{});
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, ClusterPtrs{});
   }
   for (int iCh = 4; iCh < 6; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(5);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(5);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, ClusterPtrs{});
   }
   for (int iCh = 6; iCh < 10; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(7);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, ClusterPtrs{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(7);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, ClusterPtrs{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, ClusterPtrs{});
+  }
+
+  // index the DEs in the order of the z-planes to group their clusters in a contiguous array
+  mDEIndices.fill(-1);
+  int nDEs(0);
+  for (const auto& plane : mClusters) {
+    for (const auto& de : plane) {
+      mDEIndices[de.first] = nDEs++;
+    }
   }
+  mDEOffsets.assign(nDEs + 1, 0);
+  mDEZRanges.resize(nDEs);
 }
 
 //_________________________________________________________________________________________________
 const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, std::list<const Cluster*>>& clusters)
 {
-  /// Run the track finder algorithm
+  /// Run the track finder algorithm on the lists of clusters per DE
+
+  // copy the pointers to the clusters in a contiguous array, grouped per DE
+  mClusterPtrs.clear();
+  int iDE(0);
+  for (const auto& plane : mClusters) {
+    for (const auto& de : plane) {
+      mDEOffsets[iDE++] = mClusterPtrs.size();
+      auto itDE = clusters.find(de.first);
+      if (itDE != clusters.end()) {
+        mClusterPtrs.insert(mClusterPtrs.end(), itDE->second.begin(), itDE->second.end());
+      }
+    }
+  }
+  mDEOffsets[iDE] = mClusterPtrs.size();
 
-  mTracks.clear();
+  setDEClusters();
+
+  return findTracks();
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks(gsl::span<const Cluster> clusters)
+{
+  /// Run the track finder algorithm on the clusters of one event
+
+  // group the pointers to the clusters per DE in a contiguous array, keeping their relative order
+  std::fill(mDEOffsets.begin(), mDEOffsets.end(), 0);
+  for (const auto& cluster : clusters) {
+    int iDE = getDEIndex(cluster.getDEId());
+    if (iDE >= 0) {
+      ++mDEOffsets[iDE + 1];
+    }
+  }
+  std::partial_sum(mDEOffsets.begin(), mDEOffsets.end(), mDEOffsets.begin());
+  mClusterPtrs.resize(mDEOffsets.back());
+  mDEFillIndices.assign(mDEOffsets.begin(), std::prev(mDEOffsets.end()));
+  for (const auto& cluster : clusters) {
+    int iDE = getDEIndex(cluster.getDEId());
+    if (iDE >= 0) {
+      mClusterPtrs[mDEFillIndices[iDE]++] = &cluster;
+    }
+  }
+
+  setDEClusters();
 
-  // fill the internal array of pointers to the list of clusters per DE
+  return findTracks();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::setDEClusters()
+{
+  /// make the internal array of clusters per DE point to the contiguous array of clusters
   for (auto& plane : mClusters) {
     for (auto& de : plane) {
-      auto itDE = clusters.find(de.first);
-      if (itDE == clusters.end()) {
-        de.second = nullptr;
-      } else {
-        de.second = &(itDE->second);
-      }
+      int iDE = mDEIndices[de.first];
+      de.second = ClusterPtrs(mClusterPtrs.data() + mDEOffsets[iDE], mDEOffsets[iDE + 1] - mDEOffsets[iDE]);
     }
   }
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::sortDEClusters()
+{
+  /// sort the clusters of each DE in y and compute their z range, to search the clusters around the tracks,
+  /// and prepare the bitsets of excluded clusters for the number of clusters of this event
+  mSortedClusters.resize(mClusterPtrs.size());
+  for (size_t iDE = 0; iDE + 1 < mDEOffsets.size(); ++iDE) {
+    float zMin = std::numeric_limits<float>::max();
+    float zMax = std::numeric_limits<float>::lowest();
+    bool sortable = true;
+    for (auto i = mDEOffsets[iDE]; i < mDEOffsets[iDE + 1]; ++i) {
+      const Cluster* cluster = mClusterPtrs[i];
+      mSortedClusters[i] = {cluster->y, static_cast<int>(i)};
+      zMin = std::min(zMin, cluster->z);
+      zMax = std::max(zMax, cluster->z);
+      sortable &= (std::isfinite(cluster->y) && std::isfinite(cluster->z));
+    }
+    if (sortable) {
+      mDEZRanges[iDE] = {zMin, zMax};
+      std::sort(mSortedClusters.begin() + mDEOffsets[iDE], mSortedClusters.begin() + mDEOffsets[iDE + 1],
+                [](const SortedCluster& cl1, const SortedCluster& cl2) { return cl1.y < cl2.y || (cl1.y == cl2.y && cl1.index < cl2.index); });
+    } else {
+      // the clusters of this DE will all be tested
+      mDEZRanges[iDE] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN()};
+    }
+  }
+  mSelectedClusters.clear();
+  mNExcludedClusterWords = (mClusterPtrs.size() + 63) / 64;
+  for (auto& bits : mExcludedClusterBits) {
+    bits.assign(mNExcludedClusterWords, 0);
+  }
+  mNExcludedClusterBitsInUse = 0;
+}
+
+//_________________________________________________________________________________________________
+TrackFinder::ClusterRange TrackFinder::getClusters(int deId, const TrackParam& param)
+{
+  /// Return the clusters of the DE to try to attach to the track, in their input order
+  /// With the sorted cluster search, only the clusters within the window in y outside of which
+  /// tryOneClusterFast(param, cluster) fails are returned, in mSelectedClusters
+  /// The selected clusters must be released with releaseClusters once tested, in the reverse order of selection
+
+  int iDE = mDEIndices[deId];
+  if (!mSortedClusterSearch) {
+    return {mDEOffsets[iDE], mDEOffsets[iDE + 1], false};
+  }
+
+  ClusterRange clusters{mSelectedClusters.size(), 0, true};
+
+  // window in y outside of which tryOneClusterFast fails for any z in the range of the clusters of this DE,
+  // the uncertainty on the track position being quadratic in z, hence extremal at the ends of the range or at its vertex
+  const TMatrixD& paramCov = param.getCovariances();
+  auto errY2At = [&](double dZ) {
+    return paramCov(2, 2) + dZ * dZ * paramCov(3, 3) + 2. * dZ * paramCov(2, 3) + mChamberResolutionY2;
+  };
+  double dZ1 = mDEZRanges[iDE].first - param.getZ();
+  double dZ2 = mDEZRanges[iDE].second - param.getZ();
+  double dZ0 = (paramCov(3, 3) != 0.) ? std::clamp(-paramCov(2, 3) / paramCov(3, 3), dZ1, dZ2) : dZ1;
+  double sigmaCut = TrackerParam::Instance().sigmaCutForTracking;
+  bool validWindow = (sigmaCut >= 0.);
+  double errY2Max = 0.;
+  for (double errY2 : {errY2At(dZ1), errY2At(dZ2), errY2At(dZ0)}) {
+    validWindow &= (errY2 >= 0.);
+    errY2Max = std::max(errY2Max, errY2);
+  }
+  double dYmax = sigmaCut * TMath::Sqrt(2. * errY2Max) + SMaxBendingDistanceToTrack;
+  double y1 = param.getBendingCoor() + param.getBendingSlope() * dZ1;
+  double y2 = param.getBendingCoor() + param.getBendingSlope() * dZ2;
+  // margin to cover the rounding errors in tryOneClusterFast
+  double yMin = std::min(y1, y2) - dYmax - 1.e-3;
+  double yMax = std::max(y1, y2) + dYmax + 1.e-3;
+
+  // select the clusters in the window, or all of them if it is undefined, and put them back in their input order
+  auto itBegin = mSortedClusters.begin() + mDEOffsets[iDE];
+  auto itEnd = mSortedClusters.begin() + mDEOffsets[iDE + 1];
+  if (validWindow && yMin <= yMax) {
+    itBegin = std::lower_bound(itBegin, itEnd, yMin, [](const SortedCluster& cl, double y) { return cl.y < y; });
+    itEnd = std::upper_bound(itBegin, itEnd, yMax, [](double y, const SortedCluster& cl) { return y < cl.y; });
+  }
+  for (auto it = itBegin; it != itEnd; ++it) {
+    mSelectedClusters.push_back(it->index);
+  }
+  std::sort(mSelectedClusters.begin() + clusters.begin, mSelectedClusters.end());
+  clusters.end = mSelectedClusters.size();
+
+  return clusters;
+}
+
+//_________________________________________________________________________________________________
+int TrackFinder::getClusterIndex(const Cluster& cluster) const
+{
+  /// Return the index of the cluster in mClusterPtrs
+  int iDE = getDEIndex(cluster.getDEId());
+  auto itBegin = mClusterPtrs.begin() + mDEOffsets[iDE];
+  auto itCluster = std::find(itBegin, mClusterPtrs.begin() + mDEOffsets[iDE + 1], &cluster);
+  assert(itCluster != mClusterPtrs.begin() + mDEOffsets[iDE + 1]);
+  return static_cast<int>(std::distance(mClusterPtrs.begin(), itCluster));
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks()
+{
+  /// Run the track finder algorithm on the clusters already grouped per DE
+
+  mTracks.clear();
+
+  // prepare the search of the clusters around the tracks if requested
+  mSortedClusterSearch = TrackerParam::Instance().sortedClusterSearch;
+  if (mSortedClusterSearch) {
+    sortDEClusters();
+  }
 
   // use the chamber resolution when fitting the tracks during the tracking
   mTrackFitter.useChamberResolution();
@@ -179,7 +351,7 @@ const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, st
   // track each candidate down to chamber 1 and remove it
   tStart = std::chrono::high_resolution_clock::now();
   for (auto itTrack = mTracks.begin(); itTrack != mTracks.end();) {
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ExcludedClusters excludedClusters(*this);
     followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
     print("findTracks: removing candidate at position #", getTrackIndex(itTrack));
     itTrack = mTracks.erase(itTrack);
@@ -233,7 +405,7 @@ void TrackFinder::findTrackCandidates()
     }
 
     // look for compatible clusters on station 4
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ExcludedClusters excludedClusters(*this);
     auto itNewTrack = followTrackInChamber(itTrack, 7, 6, false, excludedClusters);
 
     // keep the current candidate only if no compatible cluster is found and the station is not requested
@@ -271,7 +443,7 @@ void TrackFinder::findTrackCandidates()
     // look for compatible clusters on each chamber of station 5 separately,
     // exluding those already attached to an identical candidate on station 4
     // (cases where both chambers of station 5 are fired should have been found in the first step)
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ExcludedClusters excludedClusters(*this);
     if (itLastCandidateFromSt5 != mTracks.end()) {
       excludeClustersFromIdenticalTracks(itTrack, excludedClusters, std::next(itLastCandidateFromSt5));
     }
@@ -640,22 +812,22 @@ std::list<Track>::iterator TrackFinder::findTrackCandidates(int plane1, int plan
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    for (const auto cluster1 : *de1.second) {
+    for (const auto cluster1 : de1.second) {
 
       double z1 = cluster1->getZ();
 
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
-        for (const auto cluster2 : *de2.second) {
+        for (const auto cluster2 : de2.second) {
 
           // skip combinations of clusters already part of a track if requested
           if (skipUsedPairs && areUsed(*cluster1, *cluster2, usedClusters)) {
@@ -728,7 +900,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
   for (auto& de : mClusters[plane]) {
 
     // skip DE without cluster
-    if (de.second == nullptr) {
+    if (de.second.empty()) {
       continue;
     }
 
@@ -738,7 +910,9 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
     }
 
     // look for cluster candidate in this DE
-    for (const auto cluster : *de.second) {
+    auto clusters = getClusters(de.first, currentParam);
+    for (auto i = clusters.begin; i < clusters.end; ++i) {
+      const Cluster* cluster = mClusterPtrs[getClusterIndex(clusters, i)];
 
       // try to add the current cluster
       if (!isCompatible(currentParam, *cluster, paramAtCluster)) {
@@ -755,6 +929,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
         itNewTrack->removable();
       }
     }
+    releaseClusters(clusters);
   }
 
   return (itNewTrack == itTrack) ? mTracks.end() : itNewTrack;
@@ -763,7 +938,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int chamber, int lastChamber, bool canSkip,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ExcludedClusters& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the given "chamber"
   /// The tracking starts from the current parameters, which must have already been set
@@ -858,7 +1033,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int plane1, int plane2, int lastChamber,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ExcludedClusters& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the (half)chamber formed by "plane1" and "plane2"
   /// The tracking starts from the current parameters, which must have already been set
@@ -909,23 +1084,22 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
   TrackParam paramAtCluster1{};
   TrackParam currentParamAtCluster1{};
   TrackParam paramAtCluster2{};
-  std::unordered_map<int, std::unordered_set<uint32_t>> newExcludedClusters{};
+  ExcludedClusters newExcludedClusters(*this);
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de1.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto cluster1 : *de1.second) {
+    auto clusters1 = getClusters(de1.first, paramAtChamber);
+    for (auto i1 = clusters1.begin; i1 < clusters1.end; ++i1) {
+      int index1 = getClusterIndex(clusters1, i1);
+      const Cluster* cluster1 = mClusterPtrs[index1];
 
       // skip excluded clusters
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster1->uid) > 0) {
+      if (excludedClusters.contains(*cluster1, index1)) {
         continue;
       }
 
@@ -935,7 +1109,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de1.first].emplace(cluster1->uid);
+      excludedClusters.add(*cluster1, index1);
 
       // skip tracks out of limits, but after checking for overlaps
       bool isAcceptableAtCluster1 = isAcceptable(paramAtCluster1);
@@ -950,7 +1124,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
@@ -960,7 +1134,10 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
         }
 
         // look for cluster candidate in this DE
-        for (const auto cluster2 : *de2.second) {
+        auto clusters2 = getClusters(de2.first, currentParamAtCluster1);
+        for (auto i2 = clusters2.begin; i2 < clusters2.end; ++i2) {
+          int index2 = getClusterIndex(clusters2, i2);
+          const Cluster* cluster2 = mClusterPtrs[index2];
 
           // try to add the current cluster
           if (!isCompatible(currentParamAtCluster1, *cluster2, paramAtCluster2)) {
@@ -970,7 +1147,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
           cluster2Found = true;
 
           // add it to the list of excluded clusters for this candidate
-          excludedClusters[de2.first].emplace(cluster2->uid);
+          excludedClusters.add(*cluster2, index2);
 
           // skip tracks out of limits
           if (!isAcceptableAtCluster1 || !isAcceptable(paramAtCluster2)) {
@@ -984,8 +1161,9 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
           }
 
           // transfert the list of new excluded clusters to the full list for the initial candidate
-          moveClusters(newExcludedClusters, excludedClusters);
+          newExcludedClusters.moveTo(excludedClusters);
         }
+        releaseClusters(clusters2);
       }
 
       if (!cluster2Found && isAcceptableAtCluster1) {
@@ -997,28 +1175,28 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
         }
 
         // transfert the list of new excluded clusters to the full list for the initial candidate
-        moveClusters(newExcludedClusters, excludedClusters);
+        newExcludedClusters.moveTo(excludedClusters);
       }
     }
+    releaseClusters(clusters1);
   }
 
   // loop over all DEs of plane2
   for (auto& de2 : mClusters[plane2]) {
 
     // skip DE without cluster
-    if (de2.second == nullptr) {
+    if (de2.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de2.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto cluster2 : *de2.second) {
+    auto clusters2 = getClusters(de2.first, paramAtChamber);
+    for (auto i2 = clusters2.begin; i2 < clusters2.end; ++i2) {
+      int index2 = getClusterIndex(clusters2, i2);
+      const Cluster* cluster2 = mClusterPtrs[index2];
 
       // skip excluded clusters (in particular the ones already attached together with a cluster on plane1)
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster2->uid) > 0) {
+      if (excludedClusters.contains(*cluster2, index2)) {
         continue;
       }
 
@@ -1028,7 +1206,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de2.first].emplace(cluster2->uid);
+      excludedClusters.add(*cluster2, index2);
 
       // skip tracks out of limits
       if (!isAcceptable(paramAtCluster2)) {
@@ -1042,8 +1220,9 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // transfert the list of new excluded clusters to the full list for the initial candidate
-      moveClusters(newExcludedClusters, excludedClusters);
+      newExcludedClusters.moveTo(excludedClusters);
     }
+    releaseClusters(clusters2);
   }
 
   // reset the current parameters to the ones at that chamber if needed, not adding MCS effects yet
@@ -1057,7 +1236,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                                   const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                                  ExcludedClusters& excludedClusters)
 {
   /// If "nextChamber" >= 0: continue the tracking of "itTrack" up to "lastChamber", attach the two clusters
   /// to every new tracks found and return an iterator to the first of them (or mTracks.end() if none is found)
@@ -1461,7 +1640,7 @@ bool TrackFinder::areUsed(const Cluster& cl1, const Cluster& cl2, const std::vec
 
 //_________________________________________________________________________________________________
 void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                                     std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                                     ExcludedClusters& excludedClusters,
                                                      const std::list<Track>::iterator& itEndTrack)
 {
   /// Find tracks in the range [mTracks.begin(), itEndTrack[ that contain all the clusters of itTrack
@@ -1471,7 +1650,7 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
       for (auto itParam = itTrack2->rbegin(); itParam != itTrack2->rend(); ++itParam) {
         const Cluster* cluster = itParam->getClusterPtr();
         if (cluster->getChamberId() > 7) {
-          excludedClusters[cluster->getDEId()].emplace(cluster->uid);
+          excludedClusters.add(*cluster);
         } else {
           break;
         }
@@ -1481,13 +1660,84 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
 }
 
 //_________________________________________________________________________________________________
-void TrackFinder::moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination)
+TrackFinder::ExcludedClusters::ExcludedClusters(TrackFinder& finder) : mFinder(finder), mUseBits(finder.mSortedClusterSearch)
+{
+  /// Take a bitset from the track finder if needed
+  if (mUseBits) {
+    if (mFinder.mNExcludedClusterBitsInUse == mFinder.mExcludedClusterBits.size()) {
+      mFinder.mExcludedClusterBits.emplace_back(mFinder.mNExcludedClusterWords, 0);
+    }
+    mBits = mFinder.mExcludedClusterBits[mFinder.mNExcludedClusterBitsInUse++].data();
+  }
+}
+
+//_________________________________________________________________________________________________
+TrackFinder::ExcludedClusters::~ExcludedClusters()
+{
+  /// Give the bitset back cleared to the track finder
+  /// The bitsets must be given back in the reverse order they were taken
+  if (mUseBits) {
+    if (mNClusters > 0) {
+      std::fill(mBits, mBits + mFinder.mNExcludedClusterWords, 0);
+    }
+    --mFinder.mNExcludedClusterBitsInUse;
+  }
+}
+
+//_________________________________________________________________________________________________
+bool TrackFinder::ExcludedClusters::contains(const Cluster& cluster, int index) const
 {
-  /// Move cluster Ids listed in source into destination then clear source
-  for (auto& sourceDE : source) {
-    destination[sourceDE.first].insert(sourceDE.second.begin(), sourceDE.second.end());
+  /// Return true if the cluster, located at this index in mClusterPtrs, is excluded
+  if (mUseBits) {
+    return (mBits[index / 64] >> (index % 64)) & 1;
+  }
+  return std::find(mUids.begin(), mUids.end(), cluster.uid) != mUids.end();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::ExcludedClusters::add(const Cluster& cluster, int index)
+{
+  /// Exclude the cluster, located at this index in mClusterPtrs if known, if not already excluded
+  if (mUseBits) {
+    if (index < 0) {
+      index = mFinder.getClusterIndex(cluster);
+    }
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (!(mBits[index / 64] & bit)) {
+      mBits[index / 64] |= bit;
+      ++mNClusters;
+    }
+  } else if (!contains(cluster, index)) {
+    mUids.push_back(cluster.uid);
+    ++mNClusters;
+  }
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::ExcludedClusters::moveTo(ExcludedClusters& destination)
+{
+  /// Exclude the clusters of this set in the destination then clear this set
+  if (mNClusters == 0) {
+    return;
+  }
+  if (mUseBits) {
+    for (size_t i = 0; i < mFinder.mNExcludedClusterWords; ++i) {
+      if (mBits[i] != 0) {
+        destination.mNClusters += __builtin_popcountll(mBits[i] & ~destination.mBits[i]);
+        destination.mBits[i] |= mBits[i];
+        mBits[i] = 0;
+      }
+    }
+  } else {
+    for (auto uid : mUids) {
+      if (std::find(destination.mUids.begin(), destination.mUids.end(), uid) == destination.mUids.end()) {
+        destination.mUids.push_back(uid);
+        ++destination.mNClusters;
+      }
+    }
+    mUids.clear();
   }
-  source.clear();
+  mNClusters = 0;
 }
 
 //_________________________________________________________________________________________________
@@ -0,0 +1,121 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   benchTrackExtrap.cxx
+/// @brief  Track extrapolation through the dipole, one track at a time or in batches
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <TGeoGlobalMagField.h>
+#include <TVirtualMagField.h>
+
+#include "MCHTracking/TrackExtrap.h"
+#include "MCHTracking/TrackParam.h"
+
+using namespace o2::mch;
+
+namespace
+{
+constexpr double ZStart = -526.; // first chamber of station 4
+constexpr double ZEnd = -967.5;  // last chamber
+
+// uniform field filling the dipole region, enough to exercise the Runge-Kutta stepping
+void setField()
+{
+  static bool initialized = false;
+  if (!initialized) {
+    TGeoGlobalMagField::Instance()->SetField(new TGeoUniformMagField(-5., 0., 0.));
+    TGeoGlobalMagField::Instance()->Lock();
+    TrackExtrap::setField();
+    initialized = true;
+  }
+}
+
+const std::vector<TrackParam>& getTracks()
+{
+  static std::vector<TrackParam> tracks{};
+  if (tracks.empty()) {
+    std::mt19937 mt(0);
+    std::uniform_real_distribution<double> pos(-100., 100.);
+    std::uniform_real_distribution<double> slope(-0.15, 0.15);
+    std::uniform_real_distribution<double> invP(0.05, 0.5);
+    const double variances[15] = {0.01, 0., 1.e-5, 0., 0., 0.01, 0., 0., 0., 1.e-5, 0., 0., 0., 0., 1.e-3};
+    for (int i = 0; i < 1024; ++i) {
+      double param[5] = {pos(mt), slope(mt), pos(mt), slope(mt), (i % 2 ? 1. : -1.) * invP(mt)};
+      tracks.emplace_back(ZStart, param);
+      tracks.back().setVariances(variances);
+    }
+  }
+  return tracks;
+}
+} // namespace
+
+static void BM_ExtrapToZ(benchmark::State& state)
+{
+  setField();
+  TrackExtrap::useExtrapV2();
+  const auto& tracks = getTracks();
+  TrackParam trackParam{};
+  for (auto _ : state) {
+    for (const auto& track : tracks) {
+      trackParam.setZ(track.getZ());
+      trackParam.setParameters(track.getParameters());
+      benchmark::DoNotOptimize(TrackExtrap::extrapToZ(trackParam, ZEnd));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+static void BM_ExtrapToZBatch(benchmark::State& state)
+{
+  setField();
+  TrackExtrap::useExtrapV2();
+  const auto& tracks = getTracks();
+  TrackParamBatch batch{};
+  for (auto _ : state) {
+    batch.clear();
+    for (const auto& track : tracks) {
+      if (batch.add(track) < 0) {
+        TrackExtrap::extrapToZ(batch, ZEnd);
+        batch.clear();
+        batch.add(track);
+      }
+    }
+    TrackExtrap::extrapToZ(batch, ZEnd);
+    benchmark::DoNotOptimize(batch.param);
+  }
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+// Arg(0): v1 extrapolation, track parameters varied one by one to compute the jacobian
+// Arg(1): v2 extrapolation, track parameters varied in one batch
+static void BM_ExtrapToZCov(benchmark::State& state)
+{
+  setField();
+  TrackExtrap::useExtrapV2(state.range(0) != 0);
+  const auto& tracks = getTracks();
+  for (auto _ : state) {
+    for (const auto& track : tracks) {
+      TrackParam trackParam(track);
+      benchmark::DoNotOptimize(TrackExtrap::extrapToZCov(trackParam, ZEnd));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+BENCHMARK(BM_ExtrapToZ)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExtrapToZBatch)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExtrapToZCov)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,228 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testTrackExtrapBatch.cxx
+/// @brief  Test the extrapolation of track batches against the extrapolation of the tracks one by one
+
+#define BOOST_TEST_MODULE Test MCH TrackExtrapBatch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <TGeoGlobalMagField.h>
+#include <TVirtualMagField.h>
+#include <TMath.h>
+#include <TMatrixD.h>
+
+#include "MCHTracking/TrackExtrap.h"
+#include "MCHTracking/TrackParam.h"
+
+using namespace o2::mch;
+
+namespace
+{
+constexpr double ZStart = -526.; // first chamber of station 4
+constexpr double ZEnd = -967.5;  // last chamber
+
+// uniform field filling the dipole region, enough to exercise the Runge-Kutta stepping
+void setField()
+{
+  static bool initialized = false;
+  if (!initialized) {
+    TGeoGlobalMagField::Instance()->SetField(new TGeoUniformMagField(-5., 0., 0.));
+    TGeoGlobalMagField::Instance()->Lock();
+    TrackExtrap::setField();
+    initialized = true;
+  }
+}
+
+/// Tracks going through the dipole, mixed with tracks that stop early or fail within the same batches:
+/// a track already at ZEnd, tracks starting close to ZEnd and low momentum tracks turning around in the field
+std::vector<TrackParam> createTracks()
+{
+  std::vector<TrackParam> tracks{};
+  std::mt19937 mt(0);
+  std::uniform_real_distribution<double> pos(-100., 100.);
+  std::uniform_real_distribution<double> slope(-0.15, 0.15);
+  std::uniform_real_distribution<double> invP(0.05, 0.5);
+  std::uniform_real_distribution<double> lowInvP(3., 5.);
+  std::uniform_real_distribution<double> zNearEnd(ZEnd + 0.5, ZEnd + 10.);
+  const double variances[15] = {0.01, 0., 1.e-5, 0., 0., 0.01, 0., 0., 0., 1.e-5, 0., 0., 0., 0., 1.e-3};
+  for (int i = 0; i < 100; ++i) {
+    double z = ZStart;
+    double param[5] = {pos(mt), slope(mt), pos(mt), slope(mt), (i % 2 ? 1. : -1.) * invP(mt)};
+    if (i % 7 == 3) {
+      param[4] = (i % 2 ? 1. : -1.) * lowInvP(mt);
+    } else if (i % 11 == 5) {
+      z = ZEnd;
+    } else if (i % 5 == 2) {
+      z = zNearEnd(mt);
+    }
+    tracks.emplace_back(z, param);
+    tracks.back().setVariances(variances);
+  }
+  return tracks;
+}
+
+/// Check that a and b agree within tolerance, relative to scale
+void checkClose(double a, double b, double tolerance, double scale = 1.)
+{
+  BOOST_CHECK_MESSAGE(std::abs(a - b) <= tolerance * std::max({scale, std::abs(a), std::abs(b)}),
+                      a << " != " << b << " within " << tolerance);
+}
+
+void checkParams(const TrackParam& ref, const TrackParam& test, double tolerance)
+{
+  checkClose(ref.getZ(), test.getZ(), tolerance);
+  for (int j = 0; j < 5; ++j) {
+    checkClose(ref.getParameters()(j, 0), test.getParameters()(j, 0), tolerance);
+  }
+}
+
+/// Extrapolation of the covariances with the jacobian computed from the tracks extrapolated one by one
+bool extrapToZCovOneByOne(TrackParam& trackParam, double zEnd)
+{
+  const TMatrixD paramCov(trackParam.getCovariances());
+  const TMatrixD param(trackParam.getParameters());
+  const double zBegin = trackParam.getZ();
+  if (!TrackExtrap::extrapToZ(trackParam, zEnd)) {
+    return false;
+  }
+  TMatrixD jacob(5, 5);
+  jacob.Zero();
+  double direction[5] = {-1., -1., 1., 1., -1.};
+  for (int i = 0; i < 5; i++) {
+    if (paramCov(i, i) <= 0.) {
+      continue;
+    }
+    double dParam = TMath::Sqrt(paramCov(i, i)) * TMath::Sign(1., direction[i] * param(i, 0));
+    TMatrixD variedParam(param);
+    variedParam(i, 0) += dParam;
+    TrackParam trackParamVaried(zBegin, variedParam.GetMatrixArray());
+    if (!TrackExtrap::extrapToZ(trackParamVaried, zEnd)) {
+      return false;
+    }
+    for (int j = 0; j < 5; j++) {
+      jacob(j, i) = (trackParamVaried.getParameters()(j, 0) - trackParam.getParameters()(j, 0)) * (1. / dParam);
+    }
+  }
+  TMatrixD tmp(paramCov, TMatrixD::kMultTranspose, jacob);
+  TMatrixD tmp2(jacob, TMatrixD::kMult, tmp);
+  trackParam.setCovariances(tmp2);
+  return true;
+}
+
+void checkCovariances(const TrackParam& ref, const TrackParam& test, double tolerance)
+{
+  const TMatrixD& refCov = ref.getCovariances();
+  const TMatrixD& testCov = test.getCovariances();
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      checkClose(refCov(i, j), testCov(i, j), tolerance, TMath::Sqrt(refCov(i, i) * refCov(j, j)));
+    }
+  }
+}
+} // namespace
+
+/// The batched v2 extrapolation gives the result of the v2 extrapolation track by track, and the one of
+/// the original Runge-Kutta extrapolation within the tolerance of the stepping, including the failures
+BOOST_AUTO_TEST_CASE(ExtrapToZBatch)
+{
+  setField();
+  const auto tracks = createTracks();
+
+  // reference: the tracks extrapolated one by one, with v2 and with the original extrapolation
+  std::vector<TrackParam> refV1(tracks), refV2(tracks);
+  std::vector<bool> okV1(tracks.size()), okV2(tracks.size());
+  TrackExtrap::useExtrapV2(false);
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    okV1[i] = TrackExtrap::extrapToZ(refV1[i], ZEnd);
+  }
+  TrackExtrap::useExtrapV2(true);
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    okV2[i] = TrackExtrap::extrapToZ(refV2[i], ZEnd);
+  }
+
+  int nOK(0), nFailed(0);
+  TrackParamBatch batch{};
+  TrackParam trackParam{};
+  for (size_t first = 0; first < tracks.size(); first += TrackParamBatch::MaxSize) {
+    batch.clear();
+    for (size_t i = first; i < std::min(first + TrackParamBatch::MaxSize, tracks.size()); ++i) {
+      BOOST_REQUIRE_EQUAL(batch.add(tracks[i]), int(i - first));
+    }
+    if (batch.size == TrackParamBatch::MaxSize) {
+      BOOST_CHECK_EQUAL(batch.add(tracks[first]), -1);
+    }
+    TrackExtrap::extrapToZ(batch, ZEnd);
+    for (int k = 0; k < batch.size; ++k) {
+      size_t i = first + k;
+      batch.get(k, trackParam);
+      BOOST_CHECK_EQUAL(batch.ok[k], okV2[i]);
+      BOOST_CHECK_EQUAL(batch.ok[k], okV1[i]);
+      if (batch.ok[k]) {
+        ++nOK;
+        BOOST_CHECK_EQUAL(trackParam.getZ(), ZEnd);
+        checkParams(refV2[i], trackParam, 1.e-12);
+        checkClose(refV1[i].getNonBendingCoor(), trackParam.getNonBendingCoor(), 1.e-4, 100.);
+        checkClose(refV1[i].getBendingCoor(), trackParam.getBendingCoor(), 1.e-4, 100.);
+        checkClose(refV1[i].getNonBendingSlope(), trackParam.getNonBendingSlope(), 1.e-4);
+        checkClose(refV1[i].getBendingSlope(), trackParam.getBendingSlope(), 1.e-4);
+        checkClose(refV1[i].getInverseBendingMomentum(), trackParam.getInverseBendingMomentum(), 1.e-4, 0.);
+      } else {
+        ++nFailed;
+        // the parameters of a failed track are left untouched
+        checkParams(tracks[i], trackParam, 0.);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(nOK + nFailed, int(tracks.size()));
+  BOOST_CHECK(nOK > 0);
+  BOOST_CHECK(nFailed > 0);
+}
+
+/// The extrapolation of the covariances with the jacobian computed in one batch gives the result
+/// of the jacobian computed track by track, with the v2 and with the original extrapolation
+BOOST_AUTO_TEST_CASE(ExtrapToZCovBatch)
+{
+  setField();
+  const auto tracks = createTracks();
+
+  int nOK(0), nFailed(0);
+  for (const auto& track : tracks) {
+    TrackParam batchV2(track), refV2(track), refV1(track);
+
+    TrackExtrap::useExtrapV2(true);
+    bool ok = TrackExtrap::extrapToZCov(batchV2, ZEnd);
+    bool okV2 = extrapToZCovOneByOne(refV2, ZEnd);
+    TrackExtrap::useExtrapV2(false);
+    bool okV1 = TrackExtrap::extrapToZCov(refV1, ZEnd);
+
+    BOOST_CHECK_EQUAL(ok, okV2);
+    BOOST_CHECK_EQUAL(ok, okV1);
+    if (!ok) {
+      ++nFailed;
+      continue;
+    }
+    ++nOK;
+    checkParams(refV2, batchV2, 1.e-12);
+    checkCovariances(refV2, batchV2, 1.e-10);
+    checkParams(refV1, batchV2, 1.e-4);
+    checkCovariances(refV1, batchV2, 1.e-2);
+  }
+  BOOST_CHECK(nOK > 0);
+  BOOST_CHECK(nFailed > 0);
+}
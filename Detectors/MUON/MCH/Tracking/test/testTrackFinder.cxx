@@ -0,0 +1,198 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testTrackFinder.cxx
+/// @brief  Test that the sorted cluster search of the track finder gives the tracks of the search through all the clusters
+
+#define BOOST_TEST_MODULE Test MCH TrackFinder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <TMatrixD.h>
+
+#include "CommonUtils/ConfigurableParam.h"
+#include "DataFormatsMCH/Cluster.h"
+#include "MCHTracking/Track.h"
+#include "MCHTracking/TrackExtrap.h"
+#include "MCHTracking/TrackFinder.h"
+#include "MCHTracking/TrackFinderOriginal.h"
+#include "MCHTracking/TrackParam.h"
+#include "MCHTracking/TrackerParam.h"
+
+using namespace o2::mch;
+
+namespace
+{
+constexpr double ChamberZ[10] = {-526.16, -545.24, -676.4, -695.4, -967.5, -998.5, -1276.5, -1307.5, -1406.6, -1437.6};
+constexpr int NDE[10] = {4, 4, 4, 4, 18, 18, 26, 26, 26, 26};
+
+/// DE crossed at this position, numbered in azimuth, with the odd and even DEs at different z
+int getDEId(int chamber, double x, double y)
+{
+  double phi = std::atan2(y, x) + M_PI;
+  return 100 * (chamber + 1) + int(phi / (2. * M_PI) * NDE[chamber]) % NDE[chamber];
+}
+
+double getDEZ(int deId)
+{
+  return ChamberZ[deId / 100 - 1] + ((deId % 2) ? 1. : -1.);
+}
+
+/// Clusters of muons from the vertex crossing every chamber, plus noise clusters in every chamber, in random order
+std::vector<Cluster> createClusters(int nTracks, int nNoisePerChamber, unsigned int seed)
+{
+  std::vector<Cluster> clusters{};
+  std::map<int, int> nClustersPerDE{};
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> tanTheta(std::tan(3. * M_PI / 180.), std::tan(8. * M_PI / 180.));
+  std::uniform_real_distribution<double> phi(0., 2. * M_PI);
+  std::uniform_real_distribution<double> p(8., 60.);
+  std::uniform_real_distribution<double> dZ(-0.1, 0.1);
+  std::normal_distribution<double> resolution(0., 0.05);
+
+  auto addCluster = [&](int chamber, double x, double y, double z) {
+    int deId = getDEId(chamber, x, y);
+    clusters.push_back({float(x + resolution(gen)), float(y + resolution(gen)), float(z), 0.2f, 0.2f,
+                        Cluster::buildUniqueId(chamber, deId, nClustersPerDE[deId]++), 0, 0});
+  };
+
+  for (int iTrack = 0; iTrack < nTracks;) {
+    double slope = tanTheta(gen), angle = phi(gen);
+    double param[5] = {0., slope * std::cos(angle), 0., slope * std::sin(angle), ((iTrack % 2) ? 1. : -1.) / p(gen)};
+    TrackParam trackParam(0., param);
+    std::array<TrackParam, 10> paramAtDE{};
+    bool ok = true;
+    for (int iCh = 0; iCh < 10 && ok; ++iCh) {
+      ok = TrackExtrap::extrapToZ(trackParam, ChamberZ[iCh]);
+      paramAtDE[iCh] = trackParam;
+      int deId = getDEId(iCh, trackParam.getNonBendingCoor(), trackParam.getBendingCoor());
+      ok = ok && TrackExtrap::extrapToZ(paramAtDE[iCh], getDEZ(deId) + dZ(gen));
+    }
+    if (!ok) {
+      continue;
+    }
+    for (int iCh = 0; iCh < 10; ++iCh) {
+      addCluster(iCh, paramAtDE[iCh].getNonBendingCoor(), paramAtDE[iCh].getBendingCoor(), paramAtDE[iCh].getZ());
+    }
+    ++iTrack;
+  }
+
+  for (int iCh = 0; iCh < 10; ++iCh) {
+    std::uniform_real_distribution<double> radius(-0.05 * ChamberZ[iCh], -0.15 * ChamberZ[iCh]);
+    for (int i = 0; i < nNoisePerChamber; ++i) {
+      double r = radius(gen), angle = phi(gen);
+      double x = r * std::cos(angle), y = r * std::sin(angle);
+      addCluster(iCh, x, y, getDEZ(getDEId(iCh, x, y)) + dZ(gen));
+    }
+  }
+
+  std::shuffle(clusters.begin(), clusters.end(), gen);
+  return clusters;
+}
+
+std::list<Track> findTracks(gsl::span<const Cluster> clusters, bool sortedClusterSearch)
+{
+  o2::conf::ConfigurableParam::updateFromString(std::string("MCHTracking.sortedClusterSearch=") + (sortedClusterSearch ? "true" : "false"));
+  TrackFinder trackFinder{};
+  trackFinder.init(30000., 6000.);
+  return trackFinder.findTracks(clusters);
+}
+
+/// Check that the tracks are the same, in the same order, with the same parameters at the same clusters
+void checkIdentical(const std::list<Track>& ref, const std::list<Track>& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+  for (auto itRef = ref.begin(), itTest = test.begin(); itRef != ref.end(); ++itRef, ++itTest) {
+    BOOST_REQUIRE_EQUAL(itRef->getNClusters(), itTest->getNClusters());
+    for (auto itRefParam = itRef->begin(), itTestParam = itTest->begin(); itRefParam != itRef->end(); ++itRefParam, ++itTestParam) {
+      BOOST_CHECK(itRefParam->getClusterPtr() == itTestParam->getClusterPtr());
+      BOOST_CHECK_EQUAL(itRefParam->getZ(), itTestParam->getZ());
+      BOOST_CHECK_EQUAL(itRefParam->getTrackChi2(), itTestParam->getTrackChi2());
+      for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(itRefParam->getParameters()(i, 0), itTestParam->getParameters()(i, 0));
+        for (int j = 0; j < 5; ++j) {
+          BOOST_CHECK_EQUAL(itRefParam->getCovariances()(i, j), itTestParam->getCovariances()(i, j));
+        }
+      }
+    }
+  }
+}
+
+/// Unique IDs of the clusters of every track
+std::set<std::vector<uint32_t>> getClusterIds(const std::list<Track>& tracks)
+{
+  std::set<std::vector<uint32_t>> clusterIds{};
+  for (const auto& track : tracks) {
+    std::vector<uint32_t> ids{};
+    for (const auto& param : track) {
+      ids.push_back(param.getClusterPtr()->uid);
+    }
+    std::sort(ids.begin(), ids.end());
+    clusterIds.insert(ids);
+  }
+  return clusterIds;
+}
+} // namespace
+
+/// On clean events, the two searches give the same tracks as the original track finder
+BOOST_AUTO_TEST_CASE(TrackFinderCleanEvent)
+{
+  TrackFinder trackFinder{};
+  trackFinder.init(30000., 6000.); // create the field map
+  const auto clusters = createClusters(10, 0, 1);
+
+  const auto tracks = findTracks(clusters, false);
+  const auto tracksSorted = findTracks(clusters, true);
+  BOOST_CHECK_EQUAL(tracks.size(), 10u);
+  checkIdentical(tracks, tracksSorted);
+
+  std::array<std::list<const Cluster*>, 10> clustersPerChamber{};
+  for (const auto& cluster : clusters) {
+    clustersPerChamber[cluster.getChamberId()].emplace_back(&cluster);
+  }
+  TrackExtrap::useExtrapV2(false);
+  TrackFinderOriginal trackFinderOriginal{};
+  trackFinderOriginal.init(30000., 6000.);
+  const auto& tracksOriginal = trackFinderOriginal.findTracks(clustersPerChamber);
+  BOOST_CHECK(getClusterIds(tracks) == getClusterIds(tracksOriginal));
+  TrackExtrap::useExtrapV2(true);
+}
+
+/// On busy events, with many clusters per DE, the sorted search gives the same tracks in the same order,
+/// also when more candidates are searched and when the stations can be skipped
+BOOST_AUTO_TEST_CASE(TrackFinderBusyEvent)
+{
+  TrackFinder trackFinder{};
+  trackFinder.init(30000., 6000.); // create the field map
+  const auto clusters = createClusters(40, 100, 2);
+
+  const std::string defaultConfig = "MCHTracking.moreCandidates=false;MCHTracking.requestStation[0]=true;MCHTracking.requestStation[4]=true";
+  const std::string looseConfig = "MCHTracking.moreCandidates=true;MCHTracking.requestStation[0]=false;MCHTracking.requestStation[4]=false";
+  for (const auto& config : {defaultConfig, looseConfig}) {
+    o2::conf::ConfigurableParam::updateFromString(config);
+    const auto tracks = findTracks(clusters, false);
+    const auto tracksSorted = findTracks(clusters, true);
+    BOOST_CHECK(!tracks.empty());
+    checkIdentical(tracks, tracksSorted);
+  }
+  o2::conf::ConfigurableParam::updateFromString(defaultConfig);
+}
@@ -125,15 +125,9 @@ class TrackFinderTask
     trackROFs.reserve(clusterROFs.size());
     for (const auto& clusterROF : clusterROFs) {
 
-      // sort the input clusters of the current event per DE
-      std::unordered_map<int, std::list<const Cluster*>> clusters{};
-      for (const auto& cluster : clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries())) {
-        clusters[cluster.getDEId()].emplace_back(&cluster);
-      }
-
-      // run the track finder
+      // run the track finder on the clusters of the current event
       auto tStart = std::chrono::high_resolution_clock::now();
-      const auto& tracks = mTrackFinder.findTracks(clusters);
+      const auto& tracks = mTrackFinder.findTracks(clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries()));
       auto tEnd = std::chrono::high_resolution_clock::now();
       mElapsedTime += tEnd - tStart;
 
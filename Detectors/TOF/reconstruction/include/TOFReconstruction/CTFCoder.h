@@ -17,6 +17,7 @@
 #define O2_TOF_CTFCODER_H
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <string>
 #include "DataFormatsTOF/CTF.h"
@@ -93,8 +94,10 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ReadoutWindowData>& rofRe
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODETOF(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  // the blocks are encoded concurrently out of place and stored one after the other into the buffer at the end
+  CTF::encodedSlots slots;
+  std::vector<std::function<void()>> tasks;
+#define ENCODETOF(part, slot, bits) tasks.emplace_back([&]() { CTF::encodeSlot(slots[int(slot)], part, bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor(), getANSNStreams()); });
   // clang-format off
   ENCODETOF(cc.bcIncROF,     CTF::BLCbcIncROF,     0);
   ENCODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF,  0);
@@ -108,6 +111,8 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ReadoutWindowData>& rofRe
   ENCODETOF(cc.tot,          CTF::BLCtot,          0);
   ENCODETOF(cc.pattMap,      CTF::BLCpattMap,      0);
   // clang-format on
+  runBlockTasks(tasks);
+  CTF::storeSlots(buff, slots);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
 }
 
@@ -120,7 +125,9 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG& cdigVec, VPAT&
   ec.print(getPrefix(), mVerbosity);
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
-#define DECODETOF(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // the blocks are decoded concurrently
+  std::vector<std::function<void()>> tasks;
+#define DECODETOF(part, slot) tasks.emplace_back([&]() { ec.decode(part, int(slot), mCoders[int(slot)].get()); })
   // clang-format off
   DECODETOF(cc.bcIncROF,     CTF::BLCbcIncROF);
   DECODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF);
@@ -135,6 +142,7 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG& cdigVec, VPAT&
   DECODETOF(cc.tot,          CTF::BLCtot);
   DECODETOF(cc.pattMap,      CTF::BLCpattMap);
   // clang-format on
+  runBlockTasks(tasks);
   //
   decompress(cc, rofRecVec, cdigVec, pattVec);
 }
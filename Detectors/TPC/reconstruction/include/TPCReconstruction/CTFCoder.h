@@ -20,6 +20,7 @@
 #include <iterator>
 #include <string>
 #include <cassert>
+#include <functional>
 #include <tuple>
 #include <type_traits>
 #include <typeinfo>
@@ -206,10 +207,14 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
 
-  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor()](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
-    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  // the columns are encoded concurrently out of place and stored one after the other into the buffer at the end
+  CTF::encodedSlots slots;
+  std::vector<std::function<void()>> tasks;
+  auto encodeTPC = [&slots, &tasks, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), nStreams = this->getANSNStreams()](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
     const auto slotVal = static_cast<int>(slot);
-    CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get(), mfc);
+    tasks.emplace_back([&slots, &optField, &coders, begin, end, slotVal, probabilityBits, mfc, nStreams]() {
+      CTF::encodeSlot(slots[slotVal], begin, end, probabilityBits, optField[slotVal], coders[slotVal].get(), mfc, nStreams);
+    });
   };
 
   if (mCombineColumns) {
@@ -274,6 +279,8 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 
   encodeTPC(ccl.nTrackClusters, ccl.nTrackClusters + ccl.nTracks, CTF::BLCnTrackClusters, 0);
   encodeTPC(ccl.nSliceRowClusters, ccl.nSliceRowClusters + ccl.nSliceRows, CTF::BLCnSliceRowClusters, 0);
+  runBlockTasks(tasks);
+  CTF::storeSlots(buff, slots);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
 }
 
@@ -300,10 +307,11 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   ccFlat->set(sz, cc); // set offsets
   ec.print(getPrefix(), mVerbosity);
 
-  // decode encoded data directly to destination buff
-  auto decodeTPC = [&ec, &coders = mCoders](auto begin, CTF::Slots slot) {
+  // decode encoded data directly to destination buff, the columns are decoded concurrently
+  std::vector<std::function<void()>> tasks;
+  auto decodeTPC = [&ec, &tasks, &coders = mCoders](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    ec.decode(begin, slotVal, coders[slotVal].get());
+    tasks.emplace_back([&ec, &coders, begin, slotVal]() { ec.decode(begin, slotVal, coders[slotVal].get()); });
   };
 
   if (mCombineColumns) {
@@ -358,6 +366,7 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
   decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
+  runBlockTasks(tasks);
 }
 
 } // namespace tpc
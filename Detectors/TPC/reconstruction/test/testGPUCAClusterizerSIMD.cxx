@@ -0,0 +1,142 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testGPUCAClusterizerSIMD.cxx
+/// \brief Tests that the explicit-SIMD CPU kernels of the GPU TPC cluster finder give the clusters of the scalar kernels
+
+#define BOOST_TEST_MODULE Test TPC CA Clusterizer SIMD
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DataFormatsTPC/Constants.h"
+#include "DataFormatsTPC/Digit.h"
+#include "DataFormatsTPC/ClusterNative.h"
+#include "TPCReconstruction/TPCFastTransformHelperO2.h"
+
+#include "TPCFastTransform.h"
+#include "GPUO2Interface.h"
+#include "GPUO2InterfaceConfiguration.h"
+#include "TPCPadGainCalib.h"
+#include "CalibdEdxContainer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace o2::gpu;
+
+namespace o2
+{
+namespace tpc
+{
+
+using RowClusters = std::vector<std::vector<ClusterNative>>; // per sector and row
+
+/// Synthetic charge map of the first sectors: 3x3 clusters, overlapping clusters and single-digit noise peaks, sorted in time
+std::vector<std::vector<Digit>> createDigits(int nSectors)
+{
+  std::vector<std::vector<Digit>> digits(nSectors);
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> padDist(2, 60), timeDist(2, 500), peakDist(20, 800);
+  for (int sector = 0; sector < nSectors; sector++) {
+    std::map<std::tuple<int, int, int>, float> charges; // time, row, pad
+    for (int row = 0; row < constants::MAXGLOBALPADROW; row++) {
+      for (int i = 0; i < 20; i++) {
+        const int pad = padDist(gen), time = timeDist(gen);
+        const float q = peakDist(gen);
+        for (int dp = -1; dp <= 1; dp++) {
+          for (int dt = -1; dt <= 1; dt++) {
+            charges[{time + dt, row, pad + dp}] += q / (1 + 2 * std::abs(dp) + 3 * std::abs(dt));
+          }
+        }
+        if (i % 4 == 0) { // a smaller close-by peak, for the noise suppression
+          charges[{time + 2, row, pad + 1}] += 0.5f * q;
+        }
+        if (i % 5 == 0) { // isolated single digit
+          charges[{timeDist(gen), row, padDist(gen)}] += 10.f;
+        }
+      }
+    }
+    for (const auto& [key, q] : charges) {
+      const auto [time, row, pad] = key;
+      digits[sector].emplace_back(sector * 10, std::min(q, 1023.f), row, pad, time);
+    }
+  }
+  return digits;
+}
+
+RowClusters runClusterizer(const std::vector<std::vector<Digit>>& digits, bool simd)
+{
+  GPUO2InterfaceConfiguration config;
+  config.configDeviceBackend.deviceType = GPUDataTypes::DeviceType::CPU;
+  config.configDeviceBackend.forceDeviceType = true;
+  config.configProcessing.ompThreads = 4;
+  config.configProcessing.cpuSIMDKernels = simd;
+  config.configGRP.solenoidBz = -5.00668;
+  config.configGRP.continuousMaxTimeBin = 1000;
+  config.configWorkflow.steps.set(GPUDataTypes::RecoStep::TPCClusterFinding);
+  config.configWorkflow.inputs.set(GPUDataTypes::InOutType::TPCRaw);
+  config.configWorkflow.outputs.set(GPUDataTypes::InOutType::TPCClusters);
+
+  std::unique_ptr<TPCFastTransform> fastTransform(TPCFastTransformHelperO2::instance()->create(0));
+  config.configCalib.fastTransform = fastTransform.get();
+  auto dEdxCalibContainer = GPUO2Interface::getCalibdEdxContainerDefault();
+  config.configCalib.dEdxCalibContainer = dEdxCalibContainer.get();
+  std::unique_ptr<TPCPadGainCalib> gainCalib = GPUO2Interface::getPadGainCalibDefault();
+  config.configCalib.tpcPadGain = gainCalib.get();
+
+  GPUO2Interface clusterizer;
+  BOOST_REQUIRE_EQUAL(clusterizer.Initialize(config), 0);
+
+  GPUTrackingInOutDigits digitsInput;
+  for (unsigned int i = 0; i < digits.size(); i++) {
+    digitsInput.tpcDigits[i] = digits[i].data();
+    digitsInput.nTPCDigits[i] = digits[i].size();
+  }
+  GPUTrackingInOutPointers ptrs;
+  ptrs.tpcPackedDigits = &digitsInput;
+  BOOST_REQUIRE_EQUAL(clusterizer.RunTracking(&ptrs), 0);
+  BOOST_REQUIRE(ptrs.clustersNative);
+
+  // the order of the clusters within a row is not part of the result
+  RowClusters clusters(constants::MAXSECTOR * constants::MAXGLOBALPADROW);
+  for (int sector = 0; sector < constants::MAXSECTOR; sector++) {
+    for (int row = 0; row < constants::MAXGLOBALPADROW; row++) {
+      auto& rowClusters = clusters[sector * constants::MAXGLOBALPADROW + row];
+      rowClusters.assign(ptrs.clustersNative->clusters[sector][row], ptrs.clustersNative->clusters[sector][row] + ptrs.clustersNative->nClusters[sector][row]);
+      std::sort(rowClusters.begin(), rowClusters.end(), [](const auto& a, const auto& b) { return std::memcmp(&a, &b, sizeof(a)) < 0; });
+    }
+  }
+  clusterizer.Deinitialize();
+  return clusters;
+}
+
+/// @brief The SIMD peak finding and noise suppression give bit-identical clusters
+BOOST_AUTO_TEST_CASE(CAClusterizer_SIMD_test)
+{
+  const auto digits = createDigits(2);
+  const auto scalar = runClusterizer(digits, false);
+  const auto simd = runClusterizer(digits, true);
+
+  size_t nClusters = 0;
+  for (size_t i = 0; i < scalar.size(); i++) {
+    BOOST_REQUIRE_EQUAL(scalar[i].size(), simd[i].size());
+    BOOST_CHECK(std::memcmp(scalar[i].data(), simd[i].data(), scalar[i].size() * sizeof(ClusterNative)) == 0);
+    nClusters += scalar[i].size();
+  }
+  BOOST_CHECK(nClusters > 0);
+}
+} // namespace tpc
+} // namespace o2
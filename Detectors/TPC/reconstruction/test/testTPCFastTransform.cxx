@@ -29,6 +29,8 @@
 #include "Riostream.h"
 #include "FairLogger.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <iostream>
 #include <iomanip>
@@ -198,5 +200,48 @@ BOOST_AUTO_TEST_CASE(FastTransform_test_setSpaceChargeCorrection)
   BOOST_CHECK_MESSAGE(fabs(maxDeviation) < 1.e-2, "test of inverse correction map failed, max difference " << maxDeviation << " cm is too large");
 }
 
+/// @brief The batch transformation of the clusters of one row gives the result of the point-by-point transformation
+BOOST_AUTO_TEST_CASE(FastTransform_test_batch)
+{
+  auto correctionGlobal = [&](int roc, const double XYZ[3], double dXdYdZ[3]) {
+    dXdYdZ[0] = 0.5 + 0.001 * XYZ[0];
+    dXdYdZ[1] = -0.3 + 0.002 * XYZ[2];
+    dXdYdZ[2] = 1. + 0.001 * XYZ[1] * XYZ[1] / 100.;
+  };
+  TPCFastTransformHelperO2::instance()->setSpaceChargeCorrection(correctionGlobal);
+  std::unique_ptr<TPCFastTransform> fastTransform(TPCFastTransformHelperO2::instance()->create(0));
+  const TPCFastTransformGeo& geo = fastTransform->getGeometry();
+  const float maxTimeBin = 2000.f;
+
+  double maxDiff = 0., maxDiffTF = 0.;
+  for (int slice = 0; slice < geo.getNumberOfSlices(); slice += 7) {
+    float lastTimeBin = fastTransform->getMaxDriftTime(slice, 0.f);
+    for (int row = 0; row < geo.getNumberOfRows(); row += 5) {
+      std::vector<float> pad, time;
+      for (int p = 0; p <= geo.getRowInfo(row).maxPad; p += 3) {
+        for (float t = 0; t < lastTimeBin; t += 17.3f) {
+          pad.push_back(p + 0.25f);
+          time.push_back(t);
+        }
+      }
+      const int n = pad.size();
+      std::vector<float> x(n), y(n), z(n);
+      fastTransform->TransformBatch(slice, row, n, pad.data(), time.data(), x.data(), y.data(), z.data());
+      for (int i = 0; i < n; i++) {
+        float x0, y0, z0;
+        fastTransform->Transform(slice, row, pad[i], time[i], x0, y0, z0);
+        maxDiff = std::max<double>(maxDiff, std::max({std::fabs(x[i] - x0), std::fabs(y[i] - y0), std::fabs(z[i] - z0)}));
+      }
+      fastTransform->TransformInTimeFrameBatch(slice, row, n, pad.data(), time.data(), x.data(), y.data(), z.data(), maxTimeBin);
+      for (int i = 0; i < n; i++) {
+        float x0, y0, z0;
+        fastTransform->TransformInTimeFrame(slice, row, pad[i], time[i], x0, y0, z0, maxTimeBin);
+        maxDiffTF = std::max<double>(maxDiffTF, std::max({std::fabs(x[i] - x0), std::fabs(y[i] - y0), std::fabs(z[i] - z0)}));
+      }
+    }
+  }
+  BOOST_CHECK_MESSAGE(maxDiff < 1.e-4, "batch transformation differs from Transform() by " << maxDiff << " cm");
+  BOOST_CHECK_MESSAGE(maxDiffTF < 1.e-4, "batch transformation differs from TransformInTimeFrame() by " << maxDiffTF << " cm");
+}
 } // namespace tpc
 } // namespace o2
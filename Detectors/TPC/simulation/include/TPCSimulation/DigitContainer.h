@@ -58,6 +58,7 @@ class DigitContainer
   void setStartTime(TimeBin time) { mFirstTimeBin = time; }
 
   /// Add digit to the container
+  /// Digits of different time bins can be added concurrently, once the space is reserved
   /// \param eventID MC Event ID
   /// \param trackID MC Track ID
   /// \param cru CRU of the digit
@@ -79,9 +80,11 @@ class DigitContainer
   /// Get the size of the container for one event
   size_t size() const { return mTimeBins.size(); }
 
+  /// Get the memory allocated for the time bins, in bytes
+  size_t getAllocatedSize() const;
+
  private:
   TimeBin mFirstTimeBin = 0;       ///< First time bin to consider
-  TimeBin mEffectiveTimeBin = 0;   ///< Effective time bin of that digit
   TimeBin mTmaxTriggered = 0;      ///< Maximum time bin in case of triggered mode (hard cut at average drift speed with additional margin)
   TimeBin mOffset;                 ///< Size of the container for one event
   std::deque<DigitTime> mTimeBins; ///< Time bin Container for the ADC value
@@ -102,7 +105,6 @@ inline DigitContainer::DigitContainer()
 inline void DigitContainer::reset()
 {
   mFirstTimeBin = 0;
-  mEffectiveTimeBin = 0;
   for (auto& time : mTimeBins) {
     time.reset();
   }
@@ -115,11 +117,19 @@ inline void DigitContainer::reserve(TimeBin eventTimeBin)
   }
 }
 
+inline size_t DigitContainer::getAllocatedSize() const
+{
+  size_t allocated = 0;
+  for (const auto& time : mTimeBins) {
+    allocated += sizeof(DigitTime) + time.getAllocatedSize();
+  }
+  return allocated;
+}
+
 inline void DigitContainer::addDigit(const MCCompLabel& label, const CRU& cru, TimeBin timeBin, GlobalPadNumber globalPad,
                                      float signal)
 {
-  mEffectiveTimeBin = timeBin - mFirstTimeBin;
-  mTimeBins[mEffectiveTimeBin].addDigit(label, cru, globalPad, signal);
+  mTimeBins[timeBin - mFirstTimeBin].addDigit(label, cru, globalPad, signal);
 }
 
 } // namespace tpc
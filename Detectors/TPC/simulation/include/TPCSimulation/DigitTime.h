@@ -20,6 +20,9 @@
 #include "TPCSimulation/DigitGlobalPad.h"
 #include "SimulationDataFormat/LabelContainer.h"
 #include "TPCSimulation/CommonMode.h"
+#include <algorithm>
+#include <array>
+#include <vector>
 
 namespace o2
 {
@@ -33,6 +36,8 @@ class Digit;
 /// sorted into after amplification
 /// The structure assures proper sorting of the Digits when later on written out for further processing.
 /// This class holds the individual Pad Row containers and is contained within the CRU Container.
+/// Only the pads with signal are stored, in order of arrival, and are found with an open addressing hash table,
+/// such that the memory and the time needed to write out the digits scale with the occupancy.
 
 class DigitTime
 {
@@ -75,38 +80,75 @@ class DigitTime
   void fillOutputContainer(std::vector<Digit>& output, dataformats::MCTruthContainer<MCCompLabel>& mcTruth,
                            std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin, float commonMode = 0.f);
 
+  /// Get the number of pads with signal
+  size_t getNPads() const { return mGlobalPads.size(); }
+
+  /// Get the memory allocated for the pads and labels, in bytes
+  size_t getAllocatedSize() const;
+
  private:
-  std::array<float, GEMSTACKSPERSECTOR> mCommonMode;                 ///< Common mode container - 4 GEM ROCs per sector
-  std::array<DigitGlobalPad, Mapper::getPadsInSector()> mGlobalPads; ///< Pad Container for the ADC value
-  int mDigitCounter = 0;                                             ///< counts the number of digits in this timebin
+  static constexpr uint32_t EmptySlot = 0xffffffff;
+
+  /// Find the pad container of the global pad, creating it if needed
+  DigitGlobalPad& getPad(GlobalPadNumber globalPad);
+
+  /// Hash table index of the global pad
+  uint32_t getSlot(GlobalPadNumber globalPad) const { return (globalPad * 2654435761u) & (mPadIndex.size() - 1); }
+
+  std::array<float, GEMSTACKSPERSECTOR> mCommonMode; ///< Common mode container - 4 GEM ROCs per sector
+  std::vector<DigitGlobalPad> mGlobalPads;           ///< Pad Container for the ADC value, pads with signal in order of arrival
+  std::vector<uint32_t> mPadIndex;                   ///< Hash table of (global pad number << 16 | index in mGlobalPads)
 
   o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false> mLabels;
-  // std::deque<int> mOccupiedPads; // iterable container of occupied pads
 };
 
-inline DigitTime::DigitTime() : mCommonMode(), mGlobalPads()
+inline DigitTime::DigitTime() : mCommonMode()
 {
   mCommonMode.fill(0.f);
-  mLabels.reserve(Mapper::getPadsInSector() / 3);
 }
 
-inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+inline DigitGlobalPad& DigitTime::getPad(GlobalPadNumber globalPad)
 {
-  auto& paddigit = mGlobalPads[globalPad];
-  if (paddigit.getID() == -1) {
-    // this means we have a new digit
-    paddigit.setID(mDigitCounter++);
-    // could also register this pad in a vector of digits
+  if (2 * (mGlobalPads.size() + 1) > mPadIndex.size()) {
+    // keep the load factor below 1/2, rehash all the pads
+    std::vector<uint32_t> padIndex(std::max(size_t(64), 2 * mPadIndex.size()), EmptySlot);
+    mPadIndex.swap(padIndex);
+    for (const auto padKey : padIndex) {
+      if (padKey != EmptySlot) {
+        auto slot = getSlot(padKey >> 16);
+        while (mPadIndex[slot] != EmptySlot) {
+          slot = (slot + 1) & (mPadIndex.size() - 1);
+        }
+        mPadIndex[slot] = padKey;
+      }
+    }
   }
-  paddigit.addDigit(label, signal, mLabels);
+  auto slot = getSlot(globalPad);
+  while (mPadIndex[slot] != EmptySlot) {
+    if ((mPadIndex[slot] >> 16) == globalPad) {
+      return mGlobalPads[mPadIndex[slot] & 0xffff];
+    }
+    slot = (slot + 1) & (mPadIndex.size() - 1);
+  }
+  // this means we have a new digit
+  const uint32_t id = mGlobalPads.size();
+  mPadIndex[slot] = (uint32_t(globalPad) << 16) | id;
+  auto& paddigit = mGlobalPads.emplace_back();
+  paddigit.setID(id);
+  return paddigit;
+}
+
+inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+{
+  getPad(globalPad).addDigit(label, signal, mLabels);
   mCommonMode[cru.gemStack()] += signal;
 }
 
 inline void DigitTime::reset()
 {
-  for (auto& pad : mGlobalPads) {
-    pad.reset();
-  }
+  mGlobalPads.clear();
+  mPadIndex.clear();
+  mLabels.clear();
   mCommonMode.fill(0.f);
 }
 
@@ -118,25 +160,39 @@ inline float DigitTime::getCommonMode(const GEMstack& gemstack) const
   return mCommonMode[gemstack] / static_cast<float>(nPads);
 }
 
+inline size_t DigitTime::getAllocatedSize() const
+{
+  return mGlobalPads.capacity() * sizeof(DigitGlobalPad) + mPadIndex.capacity() * sizeof(uint32_t) + mLabels.getAllocatedSize();
+}
+
 template <DigitzationMode MODE>
 inline void DigitTime::fillOutputContainer(std::vector<Digit>& output, dataformats::MCTruthContainer<MCCompLabel>& mcTruth,
                                            std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin,
                                            float commonMode)
 {
   Mapper& mapper = Mapper::instance();
-  GlobalPadNumber globalPad = 0;
   for (size_t i = 0; i < mCommonMode.size(); ++i) {
     const float cm = getCommonMode(GEMstack(i));
     if (cm > 0.) {
       commonModeOutput.push_back({cm, timeBin, static_cast<unsigned char>(i)});
     }
   }
-  for (auto& pad : mGlobalPads) {
+  /// the digits are written out in the order of the global pad number
+  static thread_local std::vector<uint32_t> sortedPads; // workspace container for sorting
+  sortedPads.clear();
+  for (const auto padKey : mPadIndex) {
+    if (padKey != EmptySlot) {
+      sortedPads.push_back(padKey);
+    }
+  }
+  std::sort(sortedPads.begin(), sortedPads.end());
+  for (const auto padKey : sortedPads) {
+    auto& pad = mGlobalPads[padKey & 0xffff];
     if (pad.getChargePad() > 0.) {
+      const GlobalPadNumber globalPad = padKey >> 16;
       const CRU cru = mapper.getCRU(sector, globalPad);
       pad.fillOutputContainer<MODE>(output, mcTruth, cru, timeBin, globalPad, mLabels, getCommonMode(cru));
     }
-    ++globalPad;
   }
 }
 } // namespace tpc
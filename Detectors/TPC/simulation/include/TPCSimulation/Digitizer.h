@@ -22,7 +22,10 @@
 
 #include "TPCBase/Mapper.h"
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 using std::vector;
 
@@ -35,6 +38,8 @@ namespace tpc
 {
 
 class DigitContainer;
+class ElectronTransport;
+class GEMAmplification;
 
 /// \class Digitizer
 /// This is the digitizer for the ALICE GEM TPC.
@@ -58,7 +63,7 @@ class Digitizer
   Digitizer() = default;
 
   /// Destructor
-  ~Digitizer() = default;
+  ~Digitizer();
 
   Digitizer(const Digitizer&) = delete;
   Digitizer& operator=(const Digitizer&) = delete;
@@ -67,6 +72,9 @@ class Digitizer
   void init();
 
   /// Process a single hit group
+  /// With more than one thread the hit groups are distributed to the threads, each hit group with its own random
+  /// stream drawn from gRandom, and the signals are accumulated in the digit container by the threads in disjoint
+  /// time bin ranges. The result is reproducible for a given seed and does not depend on the number of threads.
   /// \param hits Container with TPC hit groups
   /// \param eventID ID of the event to be processed
   /// \param sourceID ID of the source to be processed
@@ -109,6 +117,19 @@ class Digitizer
   /// \return true for continuous readout
   bool isContinuousReadout() { return mIsContinuous; }
 
+  /// Set the number of threads for the drift, amplification and signal induction of the electrons
+  /// \param nThreads Number of threads, with 1 the hits are processed serially
+  void setNThreads(int nThreads) { mNThreads = std::max(1, nThreads); }
+
+  /// Get the number of threads for the drift, amplification and signal induction of the electrons
+  int getNThreads() const { return mNThreads; }
+
+  /// Position the random rings with a seed per hit group also in the serial processing, as in the multi-threaded one,
+  /// such that the output does not depend on the number of threads. By default the serial processing continues the
+  /// random streams from the previous hit group, giving the output of the single-threaded digitization.
+  void setSeedHitGroups(bool seed) { mSeedHitGroups = seed; }
+  bool getSeedHitGroups() const { return mSeedHitGroups; }
+
   /// Enable the use of space-charge distortions and provide space-charge density histogram as input
   /// \param distortionType select the type of space-charge distortions (constant or realistic)
   /// \param hisInitialSCDensity optional space-charge density histogram to use at the beginning of the simulation
@@ -126,13 +147,38 @@ class Digitizer
   void setUseSCDistortions(TFile& finp);
 
  private:
-  DigitContainer mDigitContainer;    ///< Container for the Digits
-  std::unique_ptr<SC> mSpaceCharge;  ///< Handler of space-charge distortions
-  Sector mSector = -1;               ///< ID of the currently processed sector
-  double mEventTime = 0.f;           ///< Time of the currently processed event
-  double mOutputDigitTimeOffset = 0; ///< Time of the first IR sampled in the digitizer
-  bool mIsContinuous;                ///< Switch for continuous readout
-  bool mUseSCDistortions = false; ///< Flag to switch on the use of space-charge distortions
+  /// Signal of an electron after the amplification, kept until it is accumulated in the digit container
+  struct ElectronSignal {
+    float time;                ///< Arrival time of the electron
+    float ADCsignal;           ///< Signal of the electron in ADC counts
+    GlobalPadNumber globalPad; ///< Global pad number
+    CRU cru;                   ///< CRU of the pad
+  };
+
+  /// Random streams and scratch buffers of a thread
+  struct ThreadContext;
+
+  /// Drift, attachment and amplification of the electrons of a hit group
+  /// \param accumulate Callable taking the CRU, global pad, ADC signal and arrival time of each amplified electron
+  template <typename Accumulate>
+  void processHitGroup(const HitGroup& hitGroup, ElectronTransport& electronTransport, GEMAmplification& gemAmplification,
+                       float maxEleTime, Accumulate&& accumulate) const;
+
+  /// Multi-threaded processing of the hit groups
+  void processParallel(const std::vector<o2::tpc::HitGroup>& hits, const int eventID, const int sourceID, float maxEleTime);
+
+  DigitContainer mDigitContainer;                              ///< Container for the Digits
+  std::unique_ptr<SC> mSpaceCharge;                            ///< Handler of space-charge distortions
+  Sector mSector = -1;                                         ///< ID of the currently processed sector
+  double mEventTime = 0.f;                                     ///< Time of the currently processed event
+  double mOutputDigitTimeOffset = 0;                           ///< Time of the first IR sampled in the digitizer
+  bool mIsContinuous;                                          ///< Switch for continuous readout
+  bool mUseSCDistortions = false;                              ///< Flag to switch on the use of space-charge distortions
+  int mNThreads = 1;                                           //!< Number of threads for the processing of the hits
+  bool mSeedHitGroups = false;                                 //!< Seed the random rings per hit group in the serial processing
+  std::vector<float> mSignalArray;                             //!< Shaped signal of an electron, serial processing
+  std::vector<std::unique_ptr<ThreadContext>> mThreadContexts; //!< Random streams and scratch buffers per thread
+  std::vector<std::vector<ElectronSignal>> mHitGroupSignals;   //!< Amplified electrons per hit group, parallel processing
   ClassDefNV(Digitizer, 1);
 };
 } // namespace tpc
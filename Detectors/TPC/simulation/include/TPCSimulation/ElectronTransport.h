@@ -71,6 +71,10 @@ class ElectronTransport
   /// \return Time of the charge
   float getDriftTime(float zPos, float signChange = 1.f) const;
 
+  /// Move the random streams to positions given by the seed. To be used in thread-local copies of the instance
+  /// \param seed Seed of the positions in the circular random buffers
+  void setRandomRingPositions(unsigned int seed);
+
  private:
   ElectronTransport();
 
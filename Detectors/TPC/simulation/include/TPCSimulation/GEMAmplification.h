@@ -89,6 +89,10 @@ class GEMAmplification
   /// \return Number of electrons after amplification in the GEM
   int getGEMMultiplication(int nElectrons, int GEM);
 
+  /// Move the random streams to positions given by the seed. To be used in thread-local copies of the instance
+  /// \param seed Seed of the positions in the circular random buffers
+  void setRandomRingPositions(unsigned int seed);
+
  private:
   GEMAmplification();
 
@@ -30,10 +30,40 @@
 
 #include "FairLogger.h"
 
+#include "TRandom.h"
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+
 ClassImp(o2::tpc::Digitizer);
 
 using namespace o2::tpc;
 
+namespace
+{
+/// One random stream per hit group, drawn in the order of the hit groups, such that the result does not depend on the
+/// number of threads nor on the scheduling
+std::vector<unsigned int> drawHitGroupSeeds(size_t nHitGroups)
+{
+  std::vector<unsigned int> seeds(nHitGroups);
+  for (auto& seed : seeds) {
+    seed = gRandom->Integer(0x7fffffff);
+  }
+  return seeds;
+}
+} // namespace
+
+/// Thread-local copies of the random rings, such that each thread has its own streams of random values
+struct Digitizer::ThreadContext {
+  ElectronTransport electronTransport;
+  GEMAmplification gemAmplification;
+  std::vector<float> signalArray;
+};
+
+Digitizer::~Digitizer() = default;
+
 void Digitizer::init()
 {
   // Calculate distortion lookup tables if initial space-charge density is provided
@@ -46,24 +76,24 @@ void Digitizer::init()
   electronTransport.updateParameters();
   auto& sampaProcessing = SAMPAProcessing::instance();
   sampaProcessing.updateParameters();
+  for (auto& context : mThreadContexts) {
+    if (context) {
+      context->gemAmplification.updateParameters();
+      context->electronTransport.updateParameters();
+    }
+  }
 }
 
 void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
                         const int eventID, const int sourceID)
 {
-  const Mapper& mapper = Mapper::instance();
-  auto& detParam = ParameterDetector::Instance();
   auto& eleParam = ParameterElectronics::Instance();
-  auto& gemParam = ParameterGEM::Instance();
-
   auto& gemAmplification = GEMAmplification::instance();
   auto& electronTransport = ElectronTransport::instance();
   auto& sampaProcessing = SAMPAProcessing::instance();
 
   const int nShapedPoints = eleParam.NShapedPoints;
-  const auto amplificationMode = gemParam.AmplMode;
-  static std::vector<float> signalArray;
-  signalArray.resize(nShapedPoints);
+  mSignalArray.resize(nShapedPoints);
 
   /// Reserve space in the digit container for the current event
   mDigitContainer.reserve(sampaProcessing.getTimeBinFromTime(mEventTime - mOutputDigitTimeOffset));
@@ -71,89 +101,201 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
   /// obtain max drift_time + hitTime which can be processed
   float maxEleTime = (int(mDigitContainer.size()) - nShapedPoints) * eleParam.ZbinWidth;
 
-  for (auto& hitGroup : hits) {
-    const int MCTrackID = hitGroup.GetTrackID();
-    for (size_t hitindex = 0; hitindex < hitGroup.getSize(); ++hitindex) {
-      const auto& eh = hitGroup.getHit(hitindex);
+  if (mNThreads > 1) {
+    processParallel(hits, eventID, sourceID, maxEleTime);
+    return;
+  }
 
-      GlobalPosition3D posEle(eh.GetX(), eh.GetY(), eh.GetZ());
+  const auto seeds = mSeedHitGroups ? drawHitGroupSeeds(hits.size()) : std::vector<unsigned int>{};
+  for (size_t iHitGroup = 0; iHitGroup < hits.size(); ++iHitGroup) {
+    const auto& hitGroup = hits[iHitGroup];
+    const MCCompLabel label(hitGroup.GetTrackID(), eventID, sourceID, false);
+    if (mSeedHitGroups) {
+      electronTransport.setRandomRingPositions(seeds[iHitGroup]);
+      gemAmplification.setRandomRingPositions(seeds[iHitGroup]);
+    }
+    processHitGroup(hitGroup, electronTransport, gemAmplification, maxEleTime,
+                    [&](const CRU& cru, GlobalPadNumber globalPad, float ADCsignal, float absoluteTime) {
+                      sampaProcessing.getShapedSignal(ADCsignal, absoluteTime, mSignalArray);
+                      for (float i = 0; i < nShapedPoints; ++i) {
+                        const float time = absoluteTime + i * eleParam.ZbinWidth;
+                        mDigitContainer.addDigit(label, cru, sampaProcessing.getTimeBinFromTime(time), globalPad,
+                                                 mSignalArray[i]);
+                      }
+                    });
+  }
+}
 
-      // Distort the electron position in case space-charge distortions are used
-      if (mUseSCDistortions) {
-        mSpaceCharge->distortElectron(posEle);
+template <typename Accumulate>
+void Digitizer::processHitGroup(const HitGroup& hitGroup, ElectronTransport& electronTransport, GEMAmplification& gemAmplification,
+                                float maxEleTime, Accumulate&& accumulate) const
+{
+  const Mapper& mapper = Mapper::instance();
+  auto& detParam = ParameterDetector::Instance();
+  auto& gemParam = ParameterGEM::Instance();
+  auto& sampaProcessing = SAMPAProcessing::instance();
+  const auto amplificationMode = gemParam.AmplMode;
+
+  for (size_t hitindex = 0; hitindex < hitGroup.getSize(); ++hitindex) {
+    const auto& eh = hitGroup.getHit(hitindex);
+
+    GlobalPosition3D posEle(eh.GetX(), eh.GetY(), eh.GetZ());
+
+    // Distort the electron position in case space-charge distortions are used
+    if (mUseSCDistortions) {
+      mSpaceCharge->distortElectron(posEle);
+    }
+
+    /// Remove electrons that end up more than three sigma of the hit's average diffusion away from the current sector
+    /// boundary
+    if (electronTransport.isCompletelyOutOfSectorCoarseElectronDrift(posEle, mSector)) {
+      continue;
+    }
+
+    /// The energy loss stored corresponds to nElectrons
+    const int nPrimaryElectrons = static_cast<int>(eh.GetEnergyLoss());
+    const float hitTime = eh.GetTime() * 0.001; /// in us
+    float driftTime = 0.f;
+
+    /// TODO: add primary ions to space-charge density
+
+    /// Loop over electrons
+    for (int iEle = 0; iEle < nPrimaryElectrons; ++iEle) {
+
+      /// Drift and Diffusion
+      const GlobalPosition3D posEleDiff = electronTransport.getElectronDrift(posEle, driftTime);
+      const float eleTime = driftTime + hitTime; /// in us
+      if (eleTime > maxEleTime) {
+        LOG(warning) << "Skipping electron with driftTime " << driftTime << " from hit at time " << hitTime;
+        continue;
       }
+      const float absoluteTime = eleTime + (mEventTime - mOutputDigitTimeOffset); /// in us
 
-      /// Remove electrons that end up more than three sigma of the hit's average diffusion away from the current sector
-      /// boundary
-      if (electronTransport.isCompletelyOutOfSectorCoarseElectronDrift(posEle, mSector)) {
+      /// Attachment
+      if (electronTransport.isElectronAttachment(driftTime)) {
         continue;
       }
 
-      /// The energy loss stored corresponds to nElectrons
-      const int nPrimaryElectrons = static_cast<int>(eh.GetEnergyLoss());
-      const float hitTime = eh.GetTime() * 0.001; /// in us
-      float driftTime = 0.f;
+      /// Remove electrons that end up outside the active volume
+      if (std::abs(posEleDiff.Z()) > detParam.TPClength) {
+        continue;
+      }
 
-      /// TODO: add primary ions to space-charge density
+      /// When the electron is not in the sector we're processing, abandon
+      if (mapper.isOutOfSector(posEleDiff, mSector)) {
+        continue;
+      }
 
-      /// Loop over electrons
-      for (int iEle = 0; iEle < nPrimaryElectrons; ++iEle) {
+      /// Compute digit position and check for validity
+      const DigitPos digiPadPos = mapper.findDigitPosFromGlobalPosition(posEleDiff, mSector);
+      if (!digiPadPos.isValid()) {
+        continue;
+      }
 
-        /// Drift and Diffusion
-        const GlobalPosition3D posEleDiff = electronTransport.getElectronDrift(posEle, driftTime);
-        const float eleTime = driftTime + hitTime; /// in us
-        if (eleTime > maxEleTime) {
-          LOG(warning) << "Skipping electron with driftTime " << driftTime << " from hit at time " << hitTime;
-          continue;
-        }
-        const float absoluteTime = eleTime + (mEventTime - mOutputDigitTimeOffset); /// in us
+      /// Remove digits the end up outside the currently produced sector
+      if (digiPadPos.getCRU().sector() != mSector) {
+        continue;
+      }
 
-        /// Attachment
-        if (electronTransport.isElectronAttachment(driftTime)) {
-          continue;
-        }
+      /// Electron amplification
+      const int nElectronsGEM = gemAmplification.getStackAmplification(digiPadPos.getCRU(), digiPadPos.getPadPos(), amplificationMode);
+      if (nElectronsGEM == 0) {
+        continue;
+      }
 
-        /// Remove electrons that end up outside the active volume
-        if (std::abs(posEleDiff.Z()) > detParam.TPClength) {
-          continue;
-        }
+      const GlobalPadNumber globalPad = mapper.globalPadNumber(digiPadPos.getGlobalPadPos());
+      const float ADCsignal = sampaProcessing.getADCvalue(static_cast<float>(nElectronsGEM));
+      accumulate(digiPadPos.getCRU(), globalPad, ADCsignal, absoluteTime);
+      /// TODO: add ion backflow to space-charge density
+    }
+    /// end of loop over electrons
+  }
+}
 
-        /// When the electron is not in the sector we're processing, abandon
-        if (mapper.isOutOfSector(posEleDiff, mSector)) {
-          continue;
-        }
+void Digitizer::processParallel(const std::vector<o2::tpc::HitGroup>& hits, const int eventID, const int sourceID, float maxEleTime)
+{
+  auto& eleParam = ParameterElectronics::Instance();
+  auto& sampaProcessing = SAMPAProcessing::instance();
+  const int nShapedPoints = eleParam.NShapedPoints;
+  const float shapingTime = (nShapedPoints - 1) * eleParam.ZbinWidth;
 
-        /// Compute digit position and check for validity
-        const DigitPos digiPadPos = mapper.findDigitPosFromGlobalPosition(posEleDiff, mSector);
-        if (!digiPadPos.isValid()) {
-          continue;
-        }
+  const auto seeds = drawHitGroupSeeds(hits.size());
+  if (mHitGroupSignals.size() < hits.size()) {
+    mHitGroupSignals.resize(hits.size());
+  }
+  if (mThreadContexts.size() < size_t(mNThreads)) {
+    mThreadContexts.resize(mNThreads);
+  }
 
-        /// Remove digits the end up outside the currently produced sector
-        if (digiPadPos.getCRU().sector() != mSector) {
-          continue;
-        }
+  auto runThreads = [this](const std::function<void(int)>& work) {
+    std::vector<std::thread> threads;
+    for (int iThread = 1; iThread < mNThreads; ++iThread) {
+      threads.emplace_back(work, iThread);
+    }
+    work(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  /// Drift and amplification: the hit groups are taken in turn by the threads, the amplified electrons are kept per
+  /// hit group
+  std::atomic<size_t> nextHitGroup{0};
+  runThreads([&](int iThread) {
+    auto& context = mThreadContexts[iThread];
+    if (!context) {
+      /// the copies of the random rings are made by the thread which uses them
+      context.reset(new ThreadContext{ElectronTransport::instance(), GEMAmplification::instance(), {}});
+    }
+    for (size_t iHitGroup = nextHitGroup++; iHitGroup < hits.size(); iHitGroup = nextHitGroup++) {
+      auto& signals = mHitGroupSignals[iHitGroup];
+      signals.clear();
+      context->electronTransport.setRandomRingPositions(seeds[iHitGroup]);
+      context->gemAmplification.setRandomRingPositions(seeds[iHitGroup]);
+      processHitGroup(hits[iHitGroup], context->electronTransport, context->gemAmplification, maxEleTime,
+                      [&signals](const CRU& cru, GlobalPadNumber globalPad, float ADCsignal, float absoluteTime) {
+                        signals.push_back({absoluteTime, ADCsignal, globalPad, cru});
+                      });
+    }
+  });
+
+  TimeBin firstTimeBin = std::numeric_limits<TimeBin>::max();
+  TimeBin lastTimeBin = 0;
+  for (size_t iHitGroup = 0; iHitGroup < hits.size(); ++iHitGroup) {
+    for (const auto& signal : mHitGroupSignals[iHitGroup]) {
+      firstTimeBin = std::min(firstTimeBin, sampaProcessing.getTimeBinFromTime(signal.time));
+      lastTimeBin = std::max(lastTimeBin, sampaProcessing.getTimeBinFromTime(signal.time + shapingTime));
+    }
+  }
+  if (firstTimeBin > lastTimeBin) {
+    return;
+  }
 
-        /// Electron amplification
-        const int nElectronsGEM = gemAmplification.getStackAmplification(digiPadPos.getCRU(), digiPadPos.getPadPos(), amplificationMode);
-        if (nElectronsGEM == 0) {
+  /// Signal induction: each thread adds the shaped signals to its own range of time bins, without locks. Within a time
+  /// bin the signals are added in the same order as in the serial processing
+  const TimeBin timeBinsPerThread = (lastTimeBin - firstTimeBin) / mNThreads + 1;
+  runThreads([&](int iThread) {
+    const TimeBin minTimeBin = firstTimeBin + iThread * timeBinsPerThread;
+    const TimeBin maxTimeBin = minTimeBin + timeBinsPerThread;
+    auto& signalArray = mThreadContexts[iThread]->signalArray;
+    signalArray.resize(nShapedPoints);
+    for (size_t iHitGroup = 0; iHitGroup < hits.size(); ++iHitGroup) {
+      const MCCompLabel label(hits[iHitGroup].GetTrackID(), eventID, sourceID, false);
+      for (const auto& signal : mHitGroupSignals[iHitGroup]) {
+        if (sampaProcessing.getTimeBinFromTime(signal.time) >= maxTimeBin ||
+            sampaProcessing.getTimeBinFromTime(signal.time + shapingTime) < minTimeBin) {
           continue;
         }
-
-        const GlobalPadNumber globalPad = mapper.globalPadNumber(digiPadPos.getGlobalPadPos());
-        const float ADCsignal = sampaProcessing.getADCvalue(static_cast<float>(nElectronsGEM));
-        const MCCompLabel label(MCTrackID, eventID, sourceID, false);
-        sampaProcessing.getShapedSignal(ADCsignal, absoluteTime, signalArray);
+        sampaProcessing.getShapedSignal(signal.ADCsignal, signal.time, signalArray);
         for (float i = 0; i < nShapedPoints; ++i) {
-          const float time = absoluteTime + i * eleParam.ZbinWidth;
-          mDigitContainer.addDigit(label, digiPadPos.getCRU(), sampaProcessing.getTimeBinFromTime(time), globalPad,
-                                   signalArray[i]);
+          const TimeBin timeBin = sampaProcessing.getTimeBinFromTime(signal.time + i * eleParam.ZbinWidth);
+          if (timeBin >= minTimeBin && timeBin < maxTimeBin) {
+            mDigitContainer.addDigit(label, signal.cru, timeBin, signal.globalPad, signalArray[i]);
+          }
         }
-        /// TODO: add ion backflow to space-charge density
       }
-      /// end of loop over electrons
     }
-  }
+  });
 }
 
 void Digitizer::flush(std::vector<o2::tpc::Digit>& digits,
@@ -17,6 +17,7 @@
 #include "TPCBase/CDBInterface.h"
 
 #include <cmath>
+#include <random>
 
 using namespace o2::tpc;
 using namespace o2::math_utils;
@@ -79,3 +80,10 @@ bool ElectronTransport::isCompletelyOutOfSectorCoarseElectronDrift(GlobalPositio
   auto& mapper = Mapper::instance();
   return mapper.isOutOfSector(posEle, sector, threeSigmaT);
 }
+
+void ElectronTransport::setRandomRingPositions(unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  mRandomGaus.setRingPosition(generator());
+  mRandomFlat.setRingPosition(generator());
+}
@@ -21,6 +21,7 @@
 #include <fstream>
 #include "Framework/Logger.h"
 #include <filesystem>
+#include <random>
 
 using namespace o2::tpc;
 using namespace o2::math_utils;
@@ -204,3 +205,14 @@ int GEMAmplification::getElectronLosses(int nElectrons, float probability)
     return nElectronsOut;
   }
 }
+
+void GEMAmplification::setRandomRingPositions(unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  mRandomGaus.setRingPosition(generator());
+  mRandomFlat.setRingPosition(generator());
+  for (auto& gain : mGain) {
+    gain.setRingPosition(generator());
+  }
+  mGainFullStack.setRingPosition(generator());
+}
@@ -0,0 +1,81 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchTPCDigitContainer.cxx
+/// \brief Benchmark of the accumulation of the signals in the DigitContainer and of the digits writing
+///
+/// The pads of one sector are filled randomly in the time bins of one drift time with the given occupancy
+/// in per mille: ~1 for pp, ~10 for Pb-Pb at low rate and ~300 for Pb-Pb with 50 kHz pile-up.
+/// The "allocatedMB" counter gives the memory held by the container before the digits are written out,
+/// the "denseMB" counter the memory of a container with all the pads of the sector allocated in each time bin.
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <random>
+#include <vector>
+#include "DataFormatsTPC/Digit.h"
+#include "TPCSimulation/DigitContainer.h"
+#include "TPCBase/CDBInterface.h"
+
+using namespace o2::tpc;
+
+namespace
+{
+constexpr int NTimeBins = 500;
+constexpr int NSignalsPerPad = 3;
+
+void initialize()
+{
+  static bool initialized = false;
+  if (!initialized) {
+    CDBInterface::instance().setUseDefaults();
+    o2::conf::ConfigurableParam::updateFromString(fmt::format("TPCEleParam.DigiMode={}", (int)DigitzationMode::PropagateADC));
+    initialized = true;
+  }
+}
+} // namespace
+
+static void BM_DigitContainer(benchmark::State& state)
+{
+  initialize();
+  const Mapper& mapper = Mapper::instance();
+  const int nPadsPerTimeBin = Mapper::getPadsInSector() * state.range(0) / 1000;
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> padDist(0, Mapper::getPadsInSector() - 1), trackDist(0, 1000);
+  size_t allocated = 0, nDigits = 0;
+  for (auto _ : state) {
+    DigitContainer digitContainer;
+    digitContainer.reset();
+    for (int timeBin = 0; timeBin < NTimeBins; ++timeBin) {
+      for (int i = 0; i < nPadsPerTimeBin; ++i) {
+        const GlobalPadNumber globalPad = padDist(gen);
+        const CRU cru = mapper.getCRU(Sector(0), globalPad);
+        for (int j = 0; j < NSignalsPerPad; ++j) {
+          digitContainer.addDigit(o2::MCCompLabel(trackDist(gen), 0, 0, false), cru, timeBin, globalPad, 10.f);
+        }
+      }
+    }
+    allocated = digitContainer.getAllocatedSize();
+    std::vector<Digit> digits;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+    std::vector<CommonMode> commonMode;
+    digitContainer.fillOutputContainer(digits, labels, commonMode, Sector(0), 0, true, true);
+    nDigits = digits.size();
+  }
+  state.counters["allocatedMB"] = allocated / 1024. / 1024.;
+  state.counters["denseMB"] = double(NTimeBins) * Mapper::getPadsInSector() * sizeof(DigitGlobalPad) / 1024. / 1024.;
+  state.counters["digits"] = nDigits;
+  state.SetItemsProcessed(state.iterations() * NTimeBins * nPadsPerTimeBin * NSignalsPerPad);
+}
+
+BENCHMARK(BM_DigitContainer)->Arg(1)->Arg(10)->Arg(300)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
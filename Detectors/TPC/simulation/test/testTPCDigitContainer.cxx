@@ -17,7 +17,9 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
+#include <map>
 #include <memory>
+#include <random>
 #include <vector>
 #include <fmt/format.h>
 #include "DataFormatsTPC/Digit.h"
@@ -167,5 +169,45 @@ BOOST_AUTO_TEST_CASE(DigitContainer_test2)
     BOOST_CHECK_CLOSE(commonMode[i].getCommonMode(), chargeSum[i] / nPads, 1E-6);
   }
 }
+
+/// \brief Test of the DigitContainer
+/// Many pads are filled in random order in one time bin and we check that the digits are written out once per pad,
+/// ordered by global pad number and with the accumulated charge
+BOOST_AUTO_TEST_CASE(DigitContainer_test3)
+{
+  auto& cdb = CDBInterface::instance();
+  cdb.setUseDefaults();
+  o2::conf::ConfigurableParam::updateFromString(fmt::format("TPCEleParam.DigiMode={}", (int)o2::tpc::DigitzationMode::PropagateADC)); // propagate the ADC values, otherwise the computation get complicated
+  const Mapper& mapper = Mapper::instance();
+  DigitContainer digitContainer;
+  digitContainer.reset();
+  dataformats::MCTruthContainer<MCCompLabel> mMCTruthArray;
+
+  const TimeBin timeBin = 100;
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> padDist(0, Mapper::getPadsInSector() - 1);
+  std::map<GlobalPadNumber, float> charges;
+  for (int i = 0; i < 5000; ++i) {
+    const GlobalPadNumber globalPad = padDist(gen);
+    const float signal = 1 + i % 7;
+    digitContainer.addDigit(MCCompLabel(i, 0, 0, false), mapper.getCRU(Sector(0), globalPad), timeBin, globalPad, signal);
+    charges[globalPad] += signal;
+  }
+
+  std::vector<Digit> mDigitsArray;
+  std::vector<o2::tpc::CommonMode> commonMode;
+  digitContainer.fillOutputContainer(mDigitsArray, mMCTruthArray, commonMode, 0, 0, true, true);
+
+  BOOST_REQUIRE(mDigitsArray.size() == charges.size());
+  auto padCharge = charges.begin();
+  for (const auto& digit : mDigitsArray) {
+    const GlobalPadNumber globalPad = mapper.globalPadNumber(PadPos(digit.getRow(), digit.getPad()));
+    BOOST_CHECK(globalPad == padCharge->first);
+    BOOST_CHECK(digit.getTimeStamp() == timeBin);
+    BOOST_CHECK_CLOSE(digit.getChargeFloat(), padCharge->second, 1E-4);
+    ++padCharge;
+  }
+  BOOST_CHECK(mMCTruthArray.getNElements() == 5000);
+}
 } // namespace tpc
 } // namespace o2
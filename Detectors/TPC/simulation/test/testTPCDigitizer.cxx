@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCDigitizer.cxx
+/// \brief This task tests the multi-threaded processing of the hits in the TPC Digitizer
+
+#define BOOST_TEST_MODULE Test TPC Digitizer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+#include <fmt/format.h>
+#include "TRandom.h"
+#include "DataFormatsTPC/Digit.h"
+#include "TPCSimulation/Digitizer.h"
+#include "TPCBase/CDBInterface.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// Tracks crossing sector 0 on the A side
+std::vector<HitGroup> createHits()
+{
+  std::vector<HitGroup> hits;
+  for (int track = 0; track < 20; ++track) {
+    auto& hitGroup = hits.emplace_back(track);
+    const float phi = (1.f + 0.9f * track) * M_PI / 180.f;
+    const float z = 10.f + 10.f * track;
+    for (float r = 90.f; r < 240.f; r += 2.f) {
+      hitGroup.addHit(r * std::cos(phi), r * std::sin(phi), z, 0.f, 40);
+    }
+  }
+  return hits;
+}
+
+void digitize(int nThreads, std::vector<Digit>& digits, dataformats::MCTruthContainer<MCCompLabel>& labels)
+{
+  std::vector<CommonMode> commonMode;
+  Digitizer digitizer;
+  digitizer.setNThreads(nThreads);
+  digitizer.setSeedHitGroups(true);
+  digitizer.setContinuousReadout(true);
+  digitizer.setSector(Sector(0));
+  digitizer.init();
+  digitizer.setOutputDigitTimeOffset(0);
+  digitizer.setStartTime(0);
+  digitizer.setEventTime(0);
+  gRandom->SetSeed(12345);
+  digitizer.process(createHits(), 0);
+  digitizer.flush(digits, labels, commonMode, true);
+}
+
+void compare(const std::vector<Digit>& digitsA, const dataformats::MCTruthContainer<MCCompLabel>& labelsA,
+             const std::vector<Digit>& digitsB, const dataformats::MCTruthContainer<MCCompLabel>& labelsB)
+{
+  BOOST_CHECK_EQUAL(digitsA.size(), digitsB.size());
+  BOOST_CHECK_EQUAL(labelsA.getIndexedSize(), labelsB.getIndexedSize());
+  BOOST_CHECK_EQUAL(labelsA.getNElements(), labelsB.getNElements());
+  for (size_t i = 0; i < std::min(digitsA.size(), digitsB.size()); ++i) {
+    BOOST_CHECK_EQUAL(digitsA[i].getCRU(), digitsB[i].getCRU());
+    BOOST_CHECK_EQUAL(digitsA[i].getRow(), digitsB[i].getRow());
+    BOOST_CHECK_EQUAL(digitsA[i].getPad(), digitsB[i].getPad());
+    BOOST_CHECK_EQUAL(digitsA[i].getTimeStamp(), digitsB[i].getTimeStamp());
+    BOOST_CHECK_EQUAL(digitsA[i].getChargeFloat(), digitsB[i].getChargeFloat());
+    const auto labelsOfA = labelsA.getLabels(i);
+    const auto labelsOfB = labelsB.getLabels(i);
+    BOOST_REQUIRE_EQUAL(labelsOfA.size(), labelsOfB.size());
+    for (size_t j = 0; j < labelsOfA.size(); ++j) {
+      BOOST_CHECK(labelsOfA[j] == labelsOfB[j]);
+    }
+  }
+}
+
+/// \brief The digits and labels do not depend on the number of threads, the serial processing with seeded hit groups included
+BOOST_AUTO_TEST_CASE(Digitizer_threads_test)
+{
+  CDBInterface::instance().setUseDefaults();
+  // no noise, which is added serially at the flush
+  o2::conf::ConfigurableParam::updateFromString(fmt::format("TPCEleParam.DigiMode={}", (int)o2::tpc::DigitzationMode::PropagateADC));
+
+  std::vector<Digit> digits1, digits2, digits4;
+  dataformats::MCTruthContainer<MCCompLabel> labels1, labels2, labels4;
+  digitize(1, digits1, labels1);
+  digitize(2, digits2, labels2);
+  digitize(4, digits4, labels4);
+
+  BOOST_CHECK(digits1.size() > 0);
+  compare(digits1, labels1, digits2, labels2);
+  compare(digits1, labels1, digits4, labels4);
+}
+
+} // namespace tpc
+} // namespace o2
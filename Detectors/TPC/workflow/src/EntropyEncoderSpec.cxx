@@ -31,6 +31,8 @@ void EntropyEncoderSpec::init(o2::framework::InitContext& ic)
 {
   mCTFCoder.setCombineColumns(!ic.options().get<bool>("no-ctf-columns-combining"));
   mCTFCoder.setMemMarginFactor(ic.options().get<float>("mem-factor"));
+  mCTFCoder.setANSNStreams(ic.options().get<int>("ans-streams"));
+  mCTFCoder.setNThreads(ic.options().get<int>("nthreads"));
   std::string dictPath = ic.options().get<std::string>("ctf-dict");
   if (!dictPath.empty() && dictPath != "none") {
     mCTFCoder.createCodersFromFile<CTF>(dictPath, o2::ctf::CTFCoderBase::OpType::Encoder);
@@ -86,7 +88,9 @@ DataProcessorSpec getEntropyEncoderSpec(bool inputFromFile)
     AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>(inputFromFile)},
     Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF encoding dictionary"}},
             {"no-ctf-columns-combining", VariantType::Bool, false, {"Do not combine correlated columns in CTF"}},
-            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}}}};
+            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+            {"ans-streams", VariantType::Int, 2, {"Number of interleaved rANS streams of the entropy encoder (2, 4, 8, 16, 32)"}},
+            {"nthreads", VariantType::Int, 1, {"Number of threads encoding the CTF blocks concurrently"}}}};
 }
 
 } // namespace tpc
@@ -79,6 +79,8 @@ class PVertexer
   void setBunchFilling(const o2::BunchFilling& bf);
 
   void setBz(float bz) { mBz = bz; }
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
   void setValidateWithIR(bool v) { mValidateWithIR = v; }
   bool getValidateWithIR() const { return mValidateWithIR; }
 
@@ -106,6 +108,19 @@ class PVertexer
  private:
   static constexpr int DBS_UNDEF = -2, DBS_NOISE = -1, DBS_INCHECK = -10;
 
+  ///< vertices found by a single thread in the time-Z clusters it processed
+  struct VerticesWorkspace {
+    std::vector<PVertex> vertices;
+    std::vector<uint32_t> trackIDs;
+    std::vector<V2TRef> v2tRefs;
+    void clear()
+    {
+      vertices.clear();
+      trackIDs.clear();
+      v2tRefs.clear();
+    }
+  };
+
   SeedHistoTZ buildHistoTZ(const VertexingInput& input);
   int runVertexing(gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
                    std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs,
@@ -135,6 +150,7 @@ class PVertexer
 
   int dbscan_RangeQuery(int idxs, std::vector<int>& cand, std::vector<int>& status);
   void dbscan_clusterize();
+  void dbscan_buildGrid();
   void doDBScanDump(const VertexingInput& input, gsl::span<const o2::MCCompLabel> lblTracks);
   void doVtxDump(std::vector<PVertex>& vertices, std::vector<uint32_t> trackIDsLoc, std::vector<V2TRef>& v2tRefsLoc, gsl::span<const o2::MCCompLabel> lblTracks);
 
@@ -149,6 +165,17 @@ class PVertexer
   float mITSROFrameLengthMUS = 0;           ///< ITS readout time span in \mus
   float mBz = 0.;                          ///< mag.field at beam line
   bool mValidateWithIR = false;            ///< require vertex validation with InteractionRecords (if available)
+  int mNThreads = 1;                       ///< number of threads for the vertex finding in time-Z clusters
+  std::vector<VerticesWorkspace> mWorkspaces; ///< per-thread output of the vertex finding
+
+  // time-Z grid for the dbscan neighbours search: the pool tracks are sorted in time, so each time bin
+  // is a contiguous range of the pool, whose track indices are stored sorted in Z
+  float mDBSGridTMin = 0.;            ///< lower edge of the 1st time bin
+  float mDBSGridBinTI = 0.;           ///< inverse time bin size
+  std::vector<int> mDBSGridBinStart;  ///< 1st entry of each time bin (+ end of the last one)
+  std::vector<int> mDBSGridIDs;       ///< pool track indices, sorted in Z within each time bin
+  std::vector<float> mDBSGridZ;       ///< Z of the tracks in mDBSGridIDs
+  std::vector<float> mDBSGridZRange;  ///< max Z distance of a neighbour in each time bin
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
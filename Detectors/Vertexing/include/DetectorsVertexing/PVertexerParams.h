@@ -27,9 +27,12 @@ struct PVertexerParams : public o2::conf::ConfigurableParamHelper<PVertexerParam
   static constexpr float kDefTukey = 5.0f; ///< def.value for tukey constant
 
   // DBSCAN clustering settings
-  float dbscanMaxDist2 = 9.;   ///< distance^2 cut (eps^2).
-  float dbscanDeltaT = 10.;    ///< abs. time difference cut, should be >= ITS ROF duration if ITS SA tracks used
-  float dbscanAdaptCoef = 0.1; ///< adapt dbscan minPts for each cluster as minPts=max(minPts, currentSize*dbscanAdaptCoef).
+  float dbscanMaxDist2 = 9.;    ///< distance^2 cut (eps^2).
+  float dbscanDeltaT = 10.;     ///< abs. time difference cut, should be >= ITS ROF duration if ITS SA tracks used
+  float dbscanAdaptCoef = 0.1;  ///< adapt dbscan minPts for each cluster as minPts=max(minPts, currentSize*dbscanAdaptCoef).
+  bool dbscanGridSearch = true; ///< look for the dbscan neighbours in the time-Z grid rather than by a linear scan in time
+
+  int nThreads = 1; ///< number of threads processing the time-z clusters
 
   int maxVerticesPerCluster = 10; ///< max vertices per time-z cluster to look for
   int maxTrialsPerCluster = 100;  ///< max unsucessful trials for vertex search per vertex
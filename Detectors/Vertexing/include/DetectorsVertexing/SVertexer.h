@@ -24,6 +24,7 @@
 #include "ReconstructionDataFormats/VtxTrackRef.h"
 #include "CommonDataFormat/RangeReference.h"
 #include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/HelixHelper.h"
 #include "DetectorsVertexing/SVertexerParams.h"
 #include "DetectorsVertexing/SVertexHypothesis.h"
 #include "DataFormatsTPC/TrackTPC.h"
@@ -74,6 +75,7 @@ class SVertexer
   void setEnableCascades(bool v) { mEnableCascades = v; }
   void init();
   void process(const o2::globaltracking::RecoContainer& recoTracks); // accessor to various tracks
+  void process(gsl::span<const PVertex> vertices, std::array<std::vector<TrackCand>, 2>&& seeds);
   auto& getMeanVertex() const { return mMeanVertex; }
   void setMeanVertex(const o2d::VertexBase& v) { mMeanVertex = v; }
   void setNThreads(int n);
@@ -89,9 +91,16 @@ class SVertexer
 
  private:
   bool checkV0(const TrackCand& seed0, const TrackCand& seed1, int iP, int iN, int ithread);
+  bool checkSeedsCrossing(const DCAFitterN<2>& fitter, const o2::track::TrackAuxPar& aux0, const o2::track::TrackParCov& tr0,
+                          const o2::track::TrackAuxPar& aux1, const o2::track::TrackParCov& tr1) const;
+  int preselectPartners(int itp, int firstN, int lastN, int ithread);
+  void processSeeds();
+  void buildSeedsAux();
+  void reportPreselection() const;
   int checkCascades(float rv0, std::array<float, 3> pV0, float p2v0, int avoidTrackID, int posneg, int ithread);
   void setupThreads();
   void buildT2V(const o2::globaltracking::RecoContainer& recoTracks);
+  void setVtxFirstTrack(int nv);
   void updateTimeDependentParams();
   bool acceptTrack(GIndex gid, const o2::track::TrackParCov& trc) const;
   bool processTPCTrack(const o2::tpc::TrackTPC& trTPC, GIndex gid, int vtxid);
@@ -102,11 +111,36 @@ class SVertexer
     return (uint64_t(id1) << 32) | id2;
   }
 
+  // circles of the seeds in the structure of arrays, for the batched distance check
+  struct SeedCircles {
+    std::vector<float> xC, yC, rC;
+    void clear()
+    {
+      xC.clear();
+      yC.clear();
+      rC.clear();
+    }
+  };
+
+  // counters of the candidates rejected before the DCAFitterN call
+  struct PreselStats {
+    size_t nPairs = 0;        // V0 pairs of seeds with compatible vertices
+    size_t nRejCircles = 0;   // rejected on the distance between the circles of the seeds
+    size_t nRejSeeds = 0;     // rejected since no crossing passes the seeding cuts of the fitter
+    size_t nCascPairs = 0;    // V0-bachelor pairs
+    size_t nCascRejSeeds = 0; // V0-bachelor pairs rejected since no crossing passes the seeding cuts
+    void clear() { *this = PreselStats{}; }
+  };
+
   gsl::span<const PVertex> mPVertices;
   std::vector<std::vector<V0>> mV0sTmp;
   std::vector<std::vector<Cascade>> mCascadesTmp;
-  std::array<std::vector<TrackCand>, 2> mTracksPool{}; // pools of positive and negative seeds sorted in min VtxID
-  std::array<std::vector<int>, 2> mVtxFirstTrack{};    // 1st pos. and neg. track of the pools for each vertex
+  std::array<std::vector<TrackCand>, 2> mTracksPool{};             // pools of positive and negative seeds sorted in min VtxID
+  std::array<std::vector<int>, 2> mVtxFirstTrack{};                // 1st pos. and neg. track of the pools for each vertex
+  std::array<std::vector<o2::track::TrackAuxPar>, 2> mTracksAux{}; // helix parameters of the seeds from the pools
+  std::array<SeedCircles, 2> mSeedCircles{};                       // same circles as arrays
+  std::vector<std::vector<uint8_t>> mPreselMask;                   // per thread mask of accepted partners
+  std::vector<PreselStats> mPreselStats;                           // per thread pre-selection counters
   o2d::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
   const SVertexerParams* mSVParams = nullptr;
   std::array<SVertexHypothesis, NHypV0> mV0Hyps;
@@ -36,6 +36,7 @@ struct SVertexerParams : public o2::conf::ConfigurableParamHelper<SVertexerParam
   float minRelChi2Change = 0.9; ///< stop when chi2 changes by less than this value
   float maxDZIni = 5.;          ///< don't consider as a seed (circles intersection) if Z distance exceeds this
   float maxRIni = 150;          ///< don't consider as a seed (circles intersection) if its R exceeds this
+  bool preselectPairs = true;   ///< reject w/o fitting the candidates whose seeds fail the fitter seeding cuts
   //
   // propagation options
   int matCorr = int(o2::base::Propagator::MatCorrType::USEMatCorrNONE); ///< material correction to use
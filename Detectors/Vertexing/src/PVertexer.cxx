@@ -22,6 +22,10 @@
 #include "CommonUtils/StringUtils.h" // RS REM
 #include <TH2F.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::vertexing;
 
 constexpr float PVertexer::kAlmost0F;
@@ -39,7 +43,29 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<V2TRef> v2tRefsLoc;
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
-  for (auto tc : mTimeZClusters) {
+
+  // The time-Z clusters have no tracks in common, so they are processed in parallel, each thread storing the
+  // found vertices in its own workspace. These are then concatenated in the order of clusters, so that the
+  // result does not depend on the number of threads.
+  int nClus = mTimeZClusters.size(), nThreads = mNThreads;
+#ifdef _PV_DEBUG_TREE_
+  nThreads = 1; // debug output is not thread safe
+#endif
+  mWorkspaces.resize(nThreads);
+  for (auto& ws : mWorkspaces) {
+    ws.clear();
+  }
+  std::vector<std::array<int, 3>> clusVertices(nClus); // workspace ID, first vertex and N vertices found for each cluster
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int ic = 0; ic < nClus; ic++) {
+    auto& tc = mTimeZClusters[ic];
+    int iThread = 0;
+#ifdef WITH_OPENMP
+    iThread = omp_get_thread_num();
+#endif
+    auto& ws = mWorkspaces[iThread];
     VertexingInput inp;
     inp.idRange = gsl::span<int>(tc.trackIDs);
     inp.scaleSigma2 = mPVParams->iniScale2;
@@ -47,7 +73,21 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 #ifdef _PV_DEBUG_TREE_
     doDBScanDump(inp, lblTracks);
 #endif
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+    int nvIni = ws.vertices.size();
+    clusVertices[ic] = {iThread, nvIni, findVertices(inp, ws.vertices, ws.trackIDs, ws.v2tRefs)};
+  }
+  for (const auto& cv : clusVertices) {
+    const auto& ws = mWorkspaces[cv[0]];
+    for (int iv = cv[1]; iv < cv[1] + cv[2]; iv++) {
+      int vtxID = verticesLoc.size();
+      verticesLoc.push_back(ws.vertices[iv]);
+      const auto& ref = ws.v2tRefs[iv];
+      v2tRefsLoc.emplace_back(trackIDs.size(), ref.getEntries());
+      for (int it = ref.getFirstEntry(); it < ref.getFirstEntry() + ref.getEntries(); it++) {
+        trackIDs.push_back(ws.trackIDs[it]);
+        mTracksPool[ws.trackIDs[it]].vtxID = vtxID; // vertex ID in the workspace -> global one
+      }
+    }
   }
 
   // sort in time
@@ -626,6 +666,7 @@ void PVertexer::init()
 {
   mPVParams = &PVertexerParams::Instance();
   setTukey(mPVParams->tukey);
+  setNThreads(mPVParams->nThreads);
   initMeanVertexConstraint();
 
   auto* prop = o2::base::Propagator::Instance();
@@ -804,18 +845,15 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
 {
   // find neighbours for dbscan cluster core point candidate
   // Since we use asymmetric distance definition, is it bit more complex than simple search within chi2 proximity
-  int nFound = 0;
+  int nFound = 0, nCandIni = cand.size();
   const auto& tI = mTracksPool[id];
-  int ntr = mTracksPool.size();
+  float tI0 = tI.timeEst.getTimeStamp();
 
   auto procPnt = [this, &tI, &status, &cand, &nFound, id](int idN) {
     const auto& tL = this->mTracksPool[idN];
-    if (std::abs(tI.timeEst.getTimeStamp() - tL.timeEst.getTimeStamp()) > this->mPVParams->dbscanDeltaT) {
-      return -1;
-    }
     auto statN = status[idN], stat = status[id];
     if (statN >= 0 && (stat < 0 || (stat >= 0 && statN != stat))) { // do not consider as a neighbour if already added to other cluster
-      return 0;
+      return;
     }
     auto dist2 = tL.getDist2(tI);
     if (dist2 < this->mPVParams->dbscanMaxDist2) {
@@ -825,23 +863,91 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
         status[idN] += DBS_INCHECK; // flag that the track is in the candidates list (i.e. DBS_UDEF-10 = -12 or DPB_NOISE-10 = -11).
       }
     }
-    return 1;
   };
-  int idL = id;
-  while (--idL >= 0) { // index in time decreasing direction
-    if (procPnt(idL) < 0) {
-      break;
+
+  if (!mPVParams->dbscanGridSearch) { // scan all tracks within dbscanDeltaT, in decreasing time from id, then in increasing time
+    for (int idL = id; --idL >= 0 && tI0 - mTracksPool[idL].timeEst.getTimeStamp() <= mPVParams->dbscanDeltaT;) {
+      procPnt(idL);
+    }
+    for (int idU = id, ntr = mTracksPool.size(); ++idU < ntr && mTracksPool[idU].timeEst.getTimeStamp() - tI0 <= mPVParams->dbscanDeltaT;) {
+      procPnt(idU);
     }
+    return nFound;
   }
-  int idU = id;
-  while (++idU < ntr) { // index in time increasing direction
-    if (procPnt(idU) < 0) {
-      break;
+
+  // the distance of the neighbour tL is dtnorm2 + (tL.z-tI.z)^2*tL.sig2ZI, so in every time bin only the tracks within
+  // the Z range defined by the smallest sig2ZI of the bin may pass the cut (the range is slightly enlarged to be immune
+  // to rounding, the exact check being done in procPnt)
+  int binMin = std::max(0, int((tI0 - mPVParams->dbscanDeltaT - mDBSGridTMin) * mDBSGridBinTI));
+  int binMax = std::min(int(mDBSGridBinStart.size()) - 2, int((tI0 + mPVParams->dbscanDeltaT - mDBSGridTMin) * mDBSGridBinTI));
+  for (int ib = binMin; ib <= binMax; ib++) {
+    int first = mDBSGridBinStart[ib], last = mDBSGridBinStart[ib + 1];
+    if (first == last) {
+      continue;
+    }
+    float dzMax = mDBSGridZRange[ib] < kHugeF ? mDBSGridZRange[ib] * 1.001f + 1e-6f : kHugeF;
+    auto zBeg = mDBSGridZ.begin() + first, zEnd = mDBSGridZ.begin() + last;
+    auto itMin = dzMax < kHugeF ? std::lower_bound(zBeg, zEnd, tI.z - dzMax) : zBeg;
+    auto itMax = dzMax < kHugeF ? std::upper_bound(itMin, zEnd, tI.z + dzMax) : zEnd;
+    for (auto it = itMin; it != itMax; ++it) {
+      int idN = mDBSGridIDs[it - mDBSGridZ.begin()];
+      if (idN == id || std::abs(tI0 - mTracksPool[idN].timeEst.getTimeStamp()) > mPVParams->dbscanDeltaT) {
+        continue;
+      }
+      procPnt(idN);
     }
   }
+  // restore the order of the linear scan (neighbours in decreasing time from id, then in increasing time), the
+  // clusterization depends on the order of the candidates
+  std::sort(cand.begin() + nCandIni, cand.end(), [id](int a, int b) {
+    return (a < id) == (b < id) ? (a < id ? a > b : a < b) : a < id;
+  });
   return nFound;
 }
 
+//_____________________________________________________
+void PVertexer::dbscan_buildGrid()
+{
+  // Index the tracks pool (sorted in time) in time bins of the dbscanDeltaT size, with tracks of each bin sorted in Z
+  int ntr = mTracksPool.size();
+  mDBSGridBinStart.clear();
+  mDBSGridIDs.resize(ntr);
+  mDBSGridZ.resize(ntr);
+  mDBSGridZRange.clear();
+  if (!ntr) {
+    mDBSGridBinStart.push_back(0);
+    return;
+  }
+  mDBSGridTMin = mTracksPool.front().timeEst.getTimeStamp();
+  float tRange = mTracksPool.back().timeEst.getTimeStamp() - mDBSGridTMin;
+  float binT = std::max(mPVParams->dbscanDeltaT, tRange / ntr); // don't create more bins than tracks
+  mDBSGridBinTI = binT > 0.f ? 1.f / binT : 0.f;
+  int nBins = 1 + int(tRange * mDBSGridBinTI);
+  mDBSGridBinStart.resize(nBins + 1, ntr);
+  mDBSGridZRange.resize(nBins, 0.f);
+  for (int it = ntr, ib = nBins; it--;) {
+    int bin = std::min(nBins - 1, int((mTracksPool[it].timeEst.getTimeStamp() - mDBSGridTMin) * mDBSGridBinTI));
+    while (ib > bin) {
+      mDBSGridBinStart[ib--] = it + 1;
+    }
+  }
+  mDBSGridBinStart[0] = 0;
+  std::iota(mDBSGridIDs.begin(), mDBSGridIDs.end(), 0);
+  for (int ib = 0; ib < nBins; ib++) {
+    int first = mDBSGridBinStart[ib], last = mDBSGridBinStart[ib + 1];
+    std::sort(mDBSGridIDs.begin() + first, mDBSGridIDs.begin() + last, [this](int a, int b) {
+      return mTracksPool[a].z < mTracksPool[b].z;
+    });
+    float sig2ZIMin = kHugeF;
+    for (int i = first; i < last; i++) {
+      const auto& trc = mTracksPool[mDBSGridIDs[i]];
+      mDBSGridZ[i] = trc.z;
+      sig2ZIMin = std::min(sig2ZIMin, trc.sig2ZI);
+    }
+    mDBSGridZRange[ib] = sig2ZIMin > kAlmost0F ? std::sqrt(mPVParams->dbscanMaxDist2 / sig2ZIMin) : kHugeF;
+  }
+}
+
 //_____________________________________________________
 void PVertexer::dbscan_clusterize()
 {
@@ -849,6 +955,9 @@ void PVertexer::dbscan_clusterize()
   int ntr = mTracksPool.size();
   std::vector<int> status(ntr, DBS_UNDEF);
   TStopwatch timer;
+  if (mPVParams->dbscanGridSearch) {
+    dbscan_buildGrid();
+  }
   int clID = -1;
 
   std::vector<int> nbVec;
@@ -915,6 +1024,19 @@ void PVertexer::dbscan_clusterize()
   LOG(info) << "Found " << mTimeZClusters.size() << " seeding clusters from DBSCAN in " << timer.CpuTime() << " CPU s";
 }
 
+//___________________________________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  if (n > 1) {
+    LOG(warning) << "Multithreading is not supported, imposing single thread";
+  }
+  mNThreads = 1;
+#endif
+}
+
 //___________________________________________________________________
 std::pair<int, int> PVertexer::getBestIR(const PVertex& vtx, const gsl::span<o2::InteractionRecord> bcData, int& currEntry) const
 {
@@ -34,9 +34,31 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData) // ac
   updateTimeDependentParams(); // TODO RS: strictly speaking, one should do this only in case of the CCDB objects update
   mPVertices = recoData.getPrimaryVertices();
   buildT2V(recoData); // build track->vertex refs from vertex->track (if other workflow will need this, consider producing a message in the VertexTrackMatcher)
-  int ntrP = mTracksPool[POS].size(), ntrN = mTracksPool[NEG].size(), iThread = 0;
+  processSeeds();
+}
+
+//__________________________________________________________________
+void SVertexer::process(gsl::span<const PVertex> vertices, std::array<std::vector<TrackCand>, 2>&& seeds)
+{
+  // process the positive and negative seeds already attached to the vertices, each pool sorted in min vertex ID
+  updateTimeDependentParams();
+  mPVertices = vertices;
+  mTracksPool = std::move(seeds);
+  setVtxFirstTrack(mPVertices.size());
+  processSeeds();
+}
+
+//__________________________________________________________________
+void SVertexer::processSeeds()
+{
+  // find the V0s and cascades from the pools of seeds
+  buildSeedsAux();
+  int ntrP = mTracksPool[POS].size(), ntrN = mTracksPool[NEG].size();
   mV0sTmp[0].clear();
   mCascadesTmp[0].clear();
+  for (auto& stat : mPreselStats) {
+    stat.clear();
+  }
 #ifdef WITH_OPENMP
   int dynGrp = std::min(4, std::max(1, mNThreads / 2));
 #pragma omp parallel for schedule(dynamic, dynGrp) num_threads(mNThreads)
@@ -48,21 +70,35 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData) // ac
       LOG(debug) << "No partner is found for pos.track " << itp << " out of " << ntrP;
       continue;
     }
-    for (int itn = firstN; itn < ntrN; itn++) { // start from the 1st negative track of lowest-ID vertex of positive
-      auto& seedN = mTracksPool[NEG][itn];
-      if (seedN.vBracket > seedP.vBracket) { // all vertices compatible with seedN are in future wrt that of seedP
-        LOG(debug) << "Brackets do not match";
-        break;
-      }
+    int iThread = 0;
 #ifdef WITH_OPENMP
-      iThread = omp_get_thread_num();
+    iThread = omp_get_thread_num();
 #endif
+    // start from the 1st negative track of lowest-ID vertex of positive, stop at the 1st one whose compatible vertices
+    // are all in future wrt that of seedP
+    int lastN = firstN;
+    while (lastN < ntrN && !(mTracksPool[NEG][lastN].vBracket > seedP.vBracket)) {
+      lastN++;
+    }
+    preselectPartners(itp, firstN, lastN, iThread);
+    const auto& mask = mPreselMask[iThread];
+    auto& stat = mPreselStats[iThread];
+    for (int itn = firstN; itn < lastN; itn++) {
+      if (!mask[itn - firstN]) {
+        continue;
+      }
+      auto& seedN = mTracksPool[NEG][itn];
       if (mSVParams->maxPVContributors < 2 && seedP.gid.isPVContributor() + seedN.gid.isPVContributor() > mSVParams->maxPVContributors) {
         continue;
       }
+      if (mSVParams->preselectPairs && !checkSeedsCrossing(mFitterV0[iThread], mTracksAux[POS][itp], seedP, mTracksAux[NEG][itn], seedN)) {
+        stat.nRejSeeds++;
+        continue;
+      }
       checkV0(seedP, seedN, itp, itn, iThread);
     }
   }
+  reportPreselection();
   // sort V0s and Cascades in vertex id
   struct vid {
     int thrID;
@@ -172,6 +208,8 @@ void SVertexer::setupThreads()
   }
   mV0sTmp.resize(mNThreads);
   mCascadesTmp.resize(mNThreads);
+  mPreselMask.resize(mNThreads);
+  mPreselStats.resize(mNThreads);
   mFitterV0.resize(mNThreads);
   auto bz = o2::base::Propagator::Instance()->getNominalBz();
   for (auto& fitter : mFitterV0) {
@@ -251,8 +289,6 @@ void SVertexer::buildT2V(const o2::globaltracking::RecoContainer& recoData) // a
   int nv = vtxRefs.size() - 1; // The last entry is for unassigned tracks, ignore them
   for (int i = 0; i < 2; i++) {
     mTracksPool[i].clear();
-    mVtxFirstTrack[i].clear();
-    mVtxFirstTrack[i].resize(nv, -1);
   }
   for (int iv = 0; iv < nv; iv++) {
     const auto& vtref = vtxRefs[iv];
@@ -294,11 +330,20 @@ void SVertexer::buildT2V(const o2::globaltracking::RecoContainer& recoData) // a
       }
     }
   }
-  // register 1st track of each charge for each vertex
+  setVtxFirstTrack(nv);
+
+  LOG(info) << "Collected " << mTracksPool[POS].size() << " positive and " << mTracksPool[NEG].size() << " negative seeds";
+}
 
+//__________________________________________________________________
+void SVertexer::setVtxFirstTrack(int nv)
+{
+  // register 1st track of each charge for each vertex
   for (int pn = 0; pn < 2; pn++) {
     auto& vtxFirstT = mVtxFirstTrack[pn];
     const auto& tracksPool = mTracksPool[pn];
+    vtxFirstT.clear();
+    vtxFirstT.resize(nv, -1);
     for (unsigned i = 0; i < tracksPool.size(); i++) {
       const auto& t = tracksPool[i];
       if (vtxFirstT[t.vBracket.getMin()] == -1) {
@@ -306,8 +351,126 @@ void SVertexer::buildT2V(const o2::globaltracking::RecoContainer& recoData) // a
       }
     }
   }
+}
 
-  LOG(info) << "Collected " << mTracksPool[POS].size() << " positive and " << mTracksPool[NEG].size() << " negative seeds";
+//__________________________________________________________________
+void SVertexer::buildSeedsAux()
+{
+  // precalculate the helix parameters of the seeds once, instead of doing this for every pair in the fitter
+  float bz = mFitterV0[0].getBz();
+  for (int pn = 0; pn < 2; pn++) {
+    const auto& tracksPool = mTracksPool[pn];
+    auto& aux = mTracksAux[pn];
+    auto& circles = mSeedCircles[pn];
+    aux.resize(tracksPool.size());
+    circles.clear();
+    circles.xC.resize(tracksPool.size());
+    circles.yC.resize(tracksPool.size());
+    circles.rC.resize(tracksPool.size());
+    for (size_t i = 0; i < tracksPool.size(); i++) {
+      aux[i].set(tracksPool[i], bz);
+      circles.xC[i] = aux[i].xC;
+      circles.yC[i] = aux[i].yC;
+      circles.rC[i] = aux[i].rC;
+    }
+  }
+}
+
+//__________________________________________________________________
+int SVertexer::preselectPartners(int itp, int firstN, int lastN, int ithread)
+{
+  // Flag the negative seeds from [firstN : lastN) which may form a V0 with the positive seed itp.
+  // The loop over the batch of partners is branch-free to be vectorized: DCAFitterN rejects the pairs of
+  // circles whose distance exceeds the max initial DXY, the straight lines are left to the full check.
+  int n = lastN - firstN;
+  auto& mask = mPreselMask[ithread];
+  mask.resize(n);
+  auto& stat = mPreselStats[ithread];
+  stat.nPairs += n;
+  const auto& auxP = mTracksAux[POS][itp];
+  if (!mSVParams->preselectPairs || auxP.rC < o2::constants::math::Almost0) {
+    std::fill(mask.begin(), mask.end(), 1);
+    return n;
+  }
+  const float* xC = mSeedCircles[NEG].xC.data() + firstN;
+  const float* yC = mSeedCircles[NEG].yC.data() + firstN;
+  const float* rC = mSeedCircles[NEG].rC.data() + firstN;
+  const float xCP = auxP.xC, yCP = auxP.yC, rCP = auxP.rC + mFitterV0[ithread].getMaxDXYIni();
+  uint8_t* maskPtr = mask.data();
+  int nAcc = 0;
+  for (int i = 0; i < n; i++) {
+    float dx = xC[i] - xCP, dy = yC[i] - yCP, rs = rC[i] + rCP;
+    uint8_t acc = (dx * dx + dy * dy <= rs * rs) | (rC[i] < o2::constants::math::Almost0);
+    maskPtr[i] = acc;
+    nAcc += acc;
+  }
+  stat.nRejCircles += n - nAcc;
+  return nAcc;
+}
+
+//__________________________________________________________________
+bool SVertexer::checkSeedsCrossing(const DCAFitterN<2>& fitter, const o2::track::TrackAuxPar& aux0, const o2::track::TrackParCov& tr0,
+                                   const o2::track::TrackAuxPar& aux1, const o2::track::TrackParCov& tr1) const
+{
+  // Reproduce the seeding of DCAFitterN::process: if none of the crossing points of the tracks passes the
+  // seed cuts of the fitter (max R, min X, max DZ of the tracks), the fit would fail anyway.
+  // The DZ is checked only for the internal helix propagation, which is reproduced exactly here: with the
+  // propagator or with material corrections the fitter propagates the seeds differently, so they are kept.
+  o2::track::CrossInfo crossings;
+  if (!crossings.set(aux0, tr0, aux1, tr1, fitter.getMaxDXYIni())) {
+    return false;
+  }
+  if (crossings.nDCA == 2) { // close candidates are merged by the fitter
+    float dx = crossings.xDCA[0] - crossings.xDCA[1], dy = crossings.yDCA[0] - crossings.yDCA[1];
+    if (dx * dx + dy * dy < fitter.getMaxDistance2ToMerge()) {
+      crossings.nDCA = 1;
+      crossings.xDCA[0] = 0.5 * (crossings.xDCA[0] + crossings.xDCA[1]);
+      crossings.yDCA[0] = 0.5 * (crossings.yDCA[0] + crossings.yDCA[1]);
+    }
+  }
+  float maxR = fitter.getMaxR(), maxR2 = maxR * maxR, bz = fitter.getBz();
+  for (int ic = 0; ic < crossings.nDCA; ic++) {
+    float xc = crossings.xDCA[ic], yc = crossings.yDCA[ic];
+    if (xc * xc + yc * yc > maxR2) {
+      continue;
+    }
+    float x0 = aux0.c * xc + aux0.s * yc, x1 = aux1.c * xc + aux1.s * yc; // X of the crossing in the tracks frames
+    if (x0 < fitter.getMinXSeed() || x1 < fitter.getMinXSeed()) {
+      continue;
+    }
+    if (fitter.getUsePropagator() || fitter.getMatCorrType() != o2::base::Propagator::MatCorrType::USEMatCorrNONE || fitter.getMaxDZIni() <= 0) {
+      return true;
+    }
+    float y0, z0, y1, z1;
+    if (!tr0.getYZAt(x0, bz, y0, z0) || !tr1.getYZAt(x1, bz, y1, z1)) {
+      continue;
+    }
+    if (std::abs(z0 - z1) <= fitter.getMaxDZIni()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//__________________________________________________________________
+void SVertexer::reportPreselection() const
+{
+  if (!mSVParams->preselectPairs) {
+    return;
+  }
+  PreselStats tot;
+  for (const auto& stat : mPreselStats) {
+    tot.nPairs += stat.nPairs;
+    tot.nRejCircles += stat.nRejCircles;
+    tot.nRejSeeds += stat.nRejSeeds;
+    tot.nCascPairs += stat.nCascPairs;
+    tot.nCascRejSeeds += stat.nCascRejSeeds;
+  }
+  auto frac = [](size_t n, size_t tot) { return tot ? float(n) / tot : 0.f; };
+  LOG(debug) << "V0 pre-selection rejected " << tot.nRejCircles + tot.nRejSeeds << " of " << tot.nPairs << " pairs ("
+             << frac(tot.nRejCircles + tot.nRejSeeds, tot.nPairs) * 100.f << "%: " << tot.nRejCircles << " on circles distance, "
+             << tot.nRejSeeds << " on seed cuts), cascade pre-selection rejected " << tot.nCascRejSeeds << " of " << tot.nCascPairs
+             << " (" << frac(tot.nCascRejSeeds, tot.nCascPairs) * 100.f << "%)";
 }
 
 //__________________________________________________________________
@@ -450,6 +613,8 @@ int SVertexer::checkCascades(float rv0, std::array<float, 3> pV0, float p2V0, in
   if (firstTr < 0) {
     firstTr = nTr;
   }
+  o2::track::TrackAuxPar v0Aux(v0, fitterCasc.getBz());
+  auto& stat = mPreselStats[ithread];
   for (int it = firstTr; it < nTr; it++) {
     if (it == avoidTrackID) {
       continue; // skip the track used by V0
@@ -464,6 +629,11 @@ int SVertexer::checkCascades(float rv0, std::array<float, 3> pV0, float p2V0, in
     if (bach.minR > rv0 + mSVParams->causalityRTolerance) {
       continue;
     }
+    stat.nCascPairs++;
+    if (mSVParams->preselectPairs && !checkSeedsCrossing(fitterCasc, v0Aux, v0, mTracksAux[posneg][it], bach)) {
+      stat.nCascRejSeeds++;
+      continue;
+    }
     int nCandC = fitterCasc.process(v0, bach);
     if (nCandC == 0) { // discard this pair
       continue;
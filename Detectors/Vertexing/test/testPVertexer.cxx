@@ -0,0 +1,170 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testPVertexer.cxx
+/// @brief  Test that the primary vertices do not depend on the dbscan neighbours search nor on the number of threads
+
+#define BOOST_TEST_MODULE Test PVertexer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TRandom.h>
+
+#include "CommonConstants/LHCConstants.h"
+#include "CommonDataFormat/BunchFilling.h"
+#include "CommonUtils/ConfigurableParam.h"
+#include "DetectorsVertexing/PVertexer.h"
+#include "Field/MagneticField.h"
+
+using namespace o2::vertexing;
+
+namespace
+{
+using GTrackID = o2::dataformats::GlobalTrackID;
+
+struct PVertices {
+  std::vector<PVertex> vertices;
+  std::vector<o2::dataformats::VtxTrackIndex> vertexTrackIDs;
+  std::vector<V2TRef> v2tRefs;
+};
+
+/// World volume filled with air, for the material corrections of the propagation to the mean vertex
+void createGeometry()
+{
+  auto geom = new TGeoManager("PVertexer", "Air world");
+  auto air = new TGeoMedium("Air", 1, new TGeoMaterial("Air", 14.61, 7.3, 1.205e-3));
+  geom->SetTopVolume(geom->MakeBox("World", air, 1000., 1000., 1000.));
+  geom->CloseGeometry();
+}
+
+/// Tracks of collisions at random times, close enough in time for several collisions to end up in the same time-Z cluster,
+/// in random order, plus some tracks of no collision
+std::vector<TrackWithTimeStamp> createTracks(int nCollisions, int nNoise)
+{
+  gRandom->SetSeed(1);
+  const float errYZ = 3e-3, errSlp = 1e-3, errQPT = 2e-2, errT = 0.5;
+  std::vector<TrackWithTimeStamp> tracks;
+  auto addTrack = [&](const std::array<float, 3>& xyz, float t) {
+    double pt = 0.3 + gRandom->Exp(1.), phi = gRandom->Rndm() * 2. * M_PI, tgl = 1.6 * (gRandom->Rndm() - 0.5);
+    o2::track::TrackPar par(xyz, {float(pt * std::cos(phi)), float(pt * std::sin(phi)), float(pt * tgl)}, gRandom->Rndm() < 0.5 ? -1 : 1, false);
+    std::array<float, 5> params;
+    std::memcpy(params.data(), par.getParams(), sizeof(params));
+    params[0] += gRandom->Gaus(0., errYZ);
+    params[1] += gRandom->Gaus(0., errYZ);
+    params[2] += gRandom->Gaus(0., errSlp);
+    params[3] += gRandom->Gaus(0., errSlp);
+    params[4] *= gRandom->Gaus(1., errQPT);
+    std::array<float, 15> covm = {
+      errYZ * errYZ,
+      0., errYZ * errYZ,
+      0, 0., errSlp * errSlp,
+      0., 0., 0., errSlp * errSlp,
+      0., 0., 0., 0., errQPT * errQPT * params[4] * params[4]};
+    auto& trk = tracks.emplace_back();
+    static_cast<o2::track::TrackParCov&>(trk) = o2::track::TrackParCov(par.getX(), par.getAlpha(), params, covm, par.getCharge());
+    trk.timeEst = TimeEst{float(t + gRandom->Gaus(0., errT)), errT};
+  };
+  for (int i = 0; i < nCollisions; i++) {
+    std::array<float, 3> xyz = {float(gRandom->Gaus(0., 5e-3)), float(gRandom->Gaus(0., 5e-3)), float(gRandom->Gaus(0., 6.))};
+    float t = 2. + gRandom->Rndm() * 1000.;
+    for (int j = 2 + gRandom->Integer(40); j--;) {
+      addTrack(xyz, t);
+    }
+  }
+  for (int i = 0; i < nNoise; i++) {
+    addTrack({float(gRandom->Gaus(0., 5e-2)), float(gRandom->Gaus(0., 5e-2)), float(gRandom->Gaus(0., 6.))}, 2. + gRandom->Rndm() * 1000.);
+  }
+  for (int i = tracks.size(); i > 1; i--) {
+    std::swap(tracks[i - 1], tracks[gRandom->Integer(i)]);
+  }
+  return tracks;
+}
+
+PVertices findVertices(const std::vector<TrackWithTimeStamp>& tracks, const std::string& config)
+{
+  o2::conf::ConfigurableParam::updateFromString(config);
+  o2::BunchFilling bunchFilling;
+  for (int bc = 0; bc < o2::constants::lhc::LHCMaxBunches; bc++) {
+    bunchFilling.setBC(bc);
+  }
+  PVertexer vertexer;
+  vertexer.setBunchFilling(bunchFilling);
+  vertexer.init();
+  std::vector<GTrackID> gids;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    gids.emplace_back(i, GTrackID::ITSTPC);
+  }
+  PVertices res;
+  std::vector<o2::MCEventLabel> lblVtx;
+  vertexer.process(tracks, gids, gsl::span<o2::InteractionRecord>{}, res.vertices, res.vertexTrackIDs, res.v2tRefs, gsl::span<const o2::MCCompLabel>{}, lblVtx);
+  return res;
+}
+
+/// Check that the vertices are the same, in the same order, with the same contributors
+void checkIdentical(const PVertices& ref, const PVertices& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.vertices.size(), test.vertices.size());
+  for (size_t i = 0; i < ref.vertices.size(); i++) {
+    const auto &vRef = ref.vertices[i], &vTest = test.vertices[i];
+    BOOST_CHECK_EQUAL(vRef.getX(), vTest.getX());
+    BOOST_CHECK_EQUAL(vRef.getY(), vTest.getY());
+    BOOST_CHECK_EQUAL(vRef.getZ(), vTest.getZ());
+    for (int j = 0; j < 6; j++) {
+      BOOST_CHECK_EQUAL(vRef.getCov()[j], vTest.getCov()[j]);
+    }
+    BOOST_CHECK_EQUAL(vRef.getChi2(), vTest.getChi2());
+    BOOST_CHECK_EQUAL(vRef.getNContributors(), vTest.getNContributors());
+    BOOST_CHECK_EQUAL(vRef.getFlags(), vTest.getFlags());
+    BOOST_CHECK_EQUAL(vRef.getTimeStamp().getTimeStamp(), vTest.getTimeStamp().getTimeStamp());
+    BOOST_CHECK_EQUAL(vRef.getTimeStamp().getTimeStampError(), vTest.getTimeStamp().getTimeStampError());
+    BOOST_CHECK(vRef.getIRMin() == vTest.getIRMin());
+    BOOST_CHECK(vRef.getIRMax() == vTest.getIRMax());
+  }
+  BOOST_REQUIRE_EQUAL(ref.v2tRefs.size(), test.v2tRefs.size());
+  BOOST_CHECK(std::memcmp(ref.v2tRefs.data(), test.v2tRefs.data(), ref.v2tRefs.size() * sizeof(V2TRef)) == 0);
+  BOOST_REQUIRE_EQUAL(ref.vertexTrackIDs.size(), test.vertexTrackIDs.size());
+  for (size_t i = 0; i < ref.vertexTrackIDs.size(); i++) {
+    BOOST_CHECK(ref.vertexTrackIDs[i] == test.vertexTrackIDs[i]);
+  }
+}
+} // namespace
+
+/// The grid search of the dbscan neighbours gives the time-Z clusters of the linear scan, and the time-Z clusters
+/// processed concurrently give the vertices of the serial processing
+BOOST_AUTO_TEST_CASE(PVertexerThreads)
+{
+  auto field = o2::field::MagneticField::createNominalField(5);
+  TGeoGlobalMagField::Instance()->SetField(field);
+  TGeoGlobalMagField::Instance()->Lock();
+  createGeometry();
+
+  const auto tracks = createTracks(300, 500);
+  const auto ref = findVertices(tracks, "pvertexer.dbscanGridSearch=false;pvertexer.nThreads=1");
+  BOOST_CHECK(ref.vertices.size() > 100);
+  for (const std::string nThreads : {"1", "4"}) {
+    for (const std::string gridSearch : {"false", "true"}) {
+      const auto test = findVertices(tracks, "pvertexer.dbscanGridSearch=" + gridSearch + ";pvertexer.nThreads=" + nThreads);
+      checkIdentical(ref, test);
+    }
+  }
+  o2::conf::ConfigurableParam::updateFromString("pvertexer.dbscanGridSearch=true;pvertexer.nThreads=1");
+}
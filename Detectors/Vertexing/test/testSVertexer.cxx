@@ -0,0 +1,173 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testSVertexer.cxx
+/// @brief  Test that the pre-selection of the pairs of seeds does not change the V0s and cascades found by the SVertexer
+
+#define BOOST_TEST_MODULE Test SVertexer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <TGenPhaseSpace.h>
+#include <TGeoGlobalMagField.h>
+#include <TLorentzVector.h>
+#include <TRandom.h>
+
+#include "CommonUtils/ConfigurableParam.h"
+#include "DetectorsVertexing/SVertexer.h"
+#include "Field/MagneticField.h"
+
+using namespace o2::vertexing;
+
+namespace
+{
+constexpr double MassPion = 0.13957, MassProton = 0.93827, MassK0 = 0.49761, MassLambda = 1.11568, MassXi = 1.32171;
+
+struct SVertices {
+  std::vector<o2::dataformats::V0> v0s;
+  std::vector<SVertexer::RRef> v0Refs;
+  std::vector<o2::dataformats::Cascade> cascades;
+  std::vector<SVertexer::RRef> cascadeRefs;
+};
+
+/// Seed created at its decay point, attached to the single primary vertex
+void addSeed(std::array<std::vector<SVertexer::TrackCand>, 2>& seeds, const TLorentzVector& mom, const std::array<float, 3>& xyz, int sign)
+{
+  const float errYZ = 1e-2, errSlp = 1e-3, errQPT = 2e-2;
+  o2::track::TrackPar par(xyz, {float(mom.Px()), float(mom.Py()), float(mom.Pz())}, sign, false);
+  std::array<float, 5> params;
+  std::memcpy(params.data(), par.getParams(), sizeof(params));
+  float r1, r2;
+  gRandom->Rannor(r1, r2);
+  params[0] += r1 * errYZ;
+  params[1] += r2 * errYZ;
+  gRandom->Rannor(r1, r2);
+  params[2] += r1 * errSlp;
+  params[3] += r2 * errSlp;
+  params[4] *= gRandom->Gaus(1., errQPT);
+  std::array<float, 15> covm = {
+    errYZ * errYZ,
+    0., errYZ * errYZ,
+    0, 0., errSlp * errSlp,
+    0., 0., 0., errSlp * errSlp,
+    0., 0., 0., 0., errQPT * errQPT * params[4] * params[4]};
+  float r = std::sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+  auto& seed = seeds[sign > 0 ? SVertexer::POS : SVertexer::NEG].emplace_back();
+  static_cast<o2::track::TrackParCov&>(seed) = o2::track::TrackParCov(par.getX(), par.getAlpha(), params, covm, sign);
+  seed.gid = o2::dataformats::GlobalTrackID(seeds[0].size() + seeds[1].size(), o2::dataformats::GlobalTrackID::ITS);
+  seed.vBracket = {0, 0};
+  seed.minR = r;
+}
+
+/// Decay of the particle moving from the origin, at the decay radius rDecay
+std::array<float, 3> decay(TGenPhaseSpace& genPHS, TLorentzVector parent, float rDecay, std::vector<double> masses)
+{
+  genPHS.SetDecay(parent, masses.size(), masses.data());
+  genPHS.Generate();
+  return {float(rDecay * parent.Px() / parent.Pt()), float(rDecay * parent.Py() / parent.Pt()), float(rDecay * parent.Pz() / parent.Pt())};
+}
+
+TLorentzVector generateParent(double mass)
+{
+  double pt = 0.5 + gRandom->Rndm() * 3., phi = gRandom->Rndm() * 2. * M_PI, y = gRandom->Rndm() - 0.5;
+  TLorentzVector parent;
+  parent.SetPtEtaPhiM(pt, y, phi, mass);
+  return parent;
+}
+
+/// K0 and Xi- decays, with the Lambda decays of the latter, plus the tracks of the combinatorial background,
+/// all the seeds attached to the same primary vertex at the origin
+std::array<std::vector<SVertexer::TrackCand>, 2> createSeeds(int nK0, int nXi, int nBackground)
+{
+  gRandom->SetSeed(1);
+  TGenPhaseSpace genPHS;
+  std::array<std::vector<SVertexer::TrackCand>, 2> seeds{};
+  for (int i = 0; i < nK0; i++) {
+    auto k0 = generateParent(MassK0);
+    auto xyz = decay(genPHS, k0, 1. + gRandom->Rndm() * 30., {MassPion, MassPion});
+    addSeed(seeds, *genPHS.GetDecay(0), xyz, 1);
+    addSeed(seeds, *genPHS.GetDecay(1), xyz, -1);
+  }
+  for (int i = 0; i < nXi; i++) {
+    auto xi = generateParent(MassXi);
+    float rXi = 1. + gRandom->Rndm() * 10.;
+    auto xyzXi = decay(genPHS, xi, rXi, {MassLambda, MassPion});
+    TLorentzVector lambda = *genPHS.GetDecay(0);
+    addSeed(seeds, *genPHS.GetDecay(1), xyzXi, -1);
+    float dR = 2. + gRandom->Rndm() * 20.;
+    auto xyzLambda = decay(genPHS, lambda, 1., {MassProton, MassPion});
+    for (int j = 0; j < 3; j++) {
+      xyzLambda[j] = xyzXi[j] + dR * xyzLambda[j];
+    }
+    addSeed(seeds, *genPHS.GetDecay(0), xyzLambda, 1);
+    addSeed(seeds, *genPHS.GetDecay(1), xyzLambda, -1);
+  }
+  for (int i = 0; i < nBackground; i++) {
+    auto pion = generateParent(MassPion);
+    float r = 3.;
+    addSeed(seeds, pion, {float(r * pion.Px() / pion.Pt()), float(r * pion.Py() / pion.Pt()), float(r * pion.Pz() / pion.Pt())}, i % 2 ? -1 : 1);
+  }
+  return seeds;
+}
+
+SVertices findSVertices(const std::vector<o2::dataformats::PrimaryVertex>& vertices, std::array<std::vector<SVertexer::TrackCand>, 2> seeds,
+                        const std::string& config)
+{
+  o2::conf::ConfigurableParam::updateFromString(config);
+  SVertexer svertexer{};
+  svertexer.init();
+  svertexer.process(vertices, std::move(seeds));
+  SVertices res;
+  svertexer.extractSecondaryVertices(res.v0s, res.v0Refs, res.cascades, res.cascadeRefs);
+  return res;
+}
+
+template <typename T>
+void checkIdentical(const std::vector<T>& ref, const std::vector<T>& test)
+{
+  BOOST_REQUIRE_EQUAL(ref.size(), test.size());
+  BOOST_CHECK(std::memcmp(ref.data(), test.data(), ref.size() * sizeof(T)) == 0);
+}
+} // namespace
+
+/// The pairs rejected by the pre-selection are the ones which the fitter would reject, with the internal propagation
+/// and with the propagator
+BOOST_AUTO_TEST_CASE(SVertexerPreselection)
+{
+  auto field = o2::field::MagneticField::createNominalField(5);
+  TGeoGlobalMagField::Instance()->SetField(field);
+  TGeoGlobalMagField::Instance()->Lock();
+
+  std::vector<o2::dataformats::PrimaryVertex> vertices(1);
+  vertices[0].setXYZ(0., 0., 0.);
+  vertices[0].setCov(1e-4, 0., 1e-4, 0., 0., 1e-4);
+  vertices[0].setNContributors(50);
+  const auto seeds = createSeeds(100, 100, 400);
+
+  for (const std::string propagator : {"false", "true"}) {
+    const std::string config = "svertexer.usePropagator=" + propagator + ";svertexer.preselectPairs=";
+    const auto ref = findSVertices(vertices, seeds, config + "false");
+    const auto test = findSVertices(vertices, seeds, config + "true");
+    BOOST_CHECK(!ref.v0s.empty());
+    checkIdentical(ref.v0s, test.v0s);
+    checkIdentical(ref.v0Refs, test.v0Refs);
+    checkIdentical(ref.cascades, test.cascades);
+    checkIdentical(ref.cascadeRefs, test.cascadeRefs);
+  }
+  o2::conf::ConfigurableParam::updateFromString("svertexer.usePropagator=false;svertexer.preselectPairs=true");
+}
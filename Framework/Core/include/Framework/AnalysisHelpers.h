@@ -20,6 +20,7 @@
 #include "Framework/OutputObjHeader.h"
 #include "Framework/StringHelpers.h"
 #include "Framework/Output.h"
+#include "Framework/FilterKernels.h"
 #include <string>
 namespace o2::framework
 {
@@ -545,8 +546,11 @@ struct Partition {
         throw std::runtime_error("Partition filter does not match declared table type");
       }
     }
-    if (gfilter == nullptr) {
-      gfilter = framework::expressions::createFilter(schema, framework::expressions::makeCondition(tree));
+    if (gfilter == nullptr && kfilter == nullptr) {
+      kfilter = framework::expressions::createKernelFilter(tree);
+      if (kfilter == nullptr) {
+        gfilter = framework::expressions::createFilter(schema, framework::expressions::makeCondition(tree));
+      }
     }
   }
 
@@ -559,7 +563,9 @@ struct Partition {
   {
     intializeCaches(table.asArrowTable()->schema());
     if (dataframeChanged) {
-      mFiltered = getTableFromFilter(table, soa::selectionToVector(framework::expressions::createSelection(table.asArrowTable(), gfilter)));
+      auto selection = kfilter != nullptr ? framework::expressions::createSelection(table.asArrowTable(), kfilter)
+                                          : framework::expressions::createSelection(table.asArrowTable(), gfilter);
+      mFiltered = getTableFromFilter(table, soa::selectionToVector(selection));
       dataframeChanged = false;
     }
   }
@@ -601,6 +607,7 @@ struct Partition {
   std::unique_ptr<o2::soa::Filtered<T>> mFiltered = nullptr;
   gandiva::NodePtr tree = nullptr;
   gandiva::FilterPtr gfilter = nullptr;
+  std::shared_ptr<framework::expressions::KernelFilter> kfilter = nullptr;
   bool dataframeChanged = true;
 
   using iterator = typename o2::soa::Filtered<T>::iterator;
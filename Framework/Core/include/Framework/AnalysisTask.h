@@ -21,6 +21,7 @@
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/Expressions.h"
 #include "Framework/ExpressionHelpers.h"
+#include "Framework/FilterKernels.h"
 #include "Framework/EndOfStreamContext.h"
 #include "Framework/GroupSlicer.h"
 #include "Framework/Logger.h"
@@ -188,11 +189,19 @@ struct AnalysisDataProcessorBuilder {
   static auto extractFilteredFromRecord(InputRecord& record, ExpressionInfo& info, pack<Os...> const&)
   {
     auto table = o2::soa::ArrowHelpers::joinTables(std::vector<std::shared_ptr<arrow::Table>>{extractTableFromRecord<Os>(record)...});
-    if (info.tree != nullptr && info.filter == nullptr) {
-      info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
+    if (info.tree != nullptr && info.filter == nullptr && info.kernelFilter == nullptr) {
+      // simple conditions are evaluated without gandiva
+      info.kernelFilter = framework::expressions::createKernelFilter(info.tree);
+      if (info.kernelFilter == nullptr) {
+        info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
+      }
     }
-    if (info.tree != nullptr && info.filter != nullptr && info.resetSelection == true) {
-      info.selection = framework::expressions::createSelection(table, info.filter);
+    if (info.tree != nullptr && info.resetSelection == true) {
+      if (info.kernelFilter != nullptr) {
+        info.selection = framework::expressions::createSelection(table, info.kernelFilter);
+      } else {
+        info.selection = framework::expressions::createSelection(table, info.filter);
+      }
       info.resetSelection = false;
     }
     if constexpr (!framework::is_base_of_template<soa::SmallGroups, std::decay_t<T>>::value) {
@@ -19,9 +19,11 @@
 #include "Framework/MessageSet.h"
 #include "Framework/TimesliceIndex.h"
 #include "Framework/Tracing.h"
+#include "Headers/DataHeader.h"
 
 #include <cstddef>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <fairmq/FwdDecls.h>
@@ -49,6 +51,38 @@ enum struct CacheEntryStatus : int {
   DONE
 };
 
+/// Precompiled dispatch from the origin / description / subspecification of an
+/// incoming header to the distinct routes which can possibly match it, so that
+/// relaying a message does not evaluate the matchers of all the inputs.
+struct RouteDispatchTable {
+  /// Candidate routes, sorted, for the headers matching a concrete route.
+  /// Keyed on a hash of origin / description / subspec, collisions only add candidates.
+  std::unordered_map<uint64_t, std::vector<int>> concrete;
+  /// Routes with a non concrete matcher, candidates for any header.
+  std::vector<int> generic;
+  /// All the routes, for messages without a DataHeader.
+  std::vector<int> all;
+  /// Whether the route was built from a ConcreteDataMatcher, i.e. it binds the
+  /// start time to the variable 0 of the context and matches nothing else.
+  std::vector<bool> isConcrete;
+
+  static uint64_t key(header::DataOrigin const& origin, header::DataDescription const& description, header::DataHeader::SubSpecificationType subSpec)
+  {
+    uint64_t h = description.itg[0] ^ (description.itg[1] * 0x9e3779b97f4a7c15ULL);
+    return h ^ ((uint64_t(origin.itg[0]) << 32 | subSpec) * 0xc2b2ae3d27d4eb4fULL);
+  }
+
+  /// @return the routes which can match the header, in route order
+  std::vector<int> const& candidates(header::DataHeader const* dh) const
+  {
+    if (dh == nullptr) {
+      return all;
+    }
+    auto it = concrete.find(key(dh->dataOrigin, dh->dataDescription, dh->subSpecification));
+    return it == concrete.end() ? generic : it->second;
+  }
+};
+
 class DataRelayer
 {
  public:
@@ -163,6 +197,7 @@ class DataRelayer
   std::vector<size_t> mDistinctRoutesIndex;
   std::vector<InputSpec> mInputs;
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
+  RouteDispatchTable mRouteDispatch;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<CacheEntryStatus> mCachedStateMetrics;
   size_t mMaxLanes;
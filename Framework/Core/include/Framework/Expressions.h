@@ -49,6 +49,11 @@ using Selection = std::shared_ptr<gandiva::SelectionVector>;
 using FilterPtr = std::shared_ptr<gandiva::Filter>;
 } // namespace gandiva
 
+namespace o2::framework::expressions
+{
+class KernelFilter;
+}
+
 using atype = arrow::Type;
 struct ExpressionInfo {
   int argumentIndex;
@@ -57,6 +62,7 @@ struct ExpressionInfo {
   gandiva::SchemaPtr schema;
   gandiva::NodePtr tree;
   gandiva::FilterPtr filter;
+  std::shared_ptr<o2::framework::expressions::KernelFilter> kernelFilter;
   gandiva::Selection selection;
   bool resetSelection = false;
 };
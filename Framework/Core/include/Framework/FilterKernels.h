@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_FILTERKERNELS_H_
+#define O2_FRAMEWORK_FILTERKERNELS_H_
+
+#include "Framework/Expressions.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::framework::expressions
+{
+/// Filter for the conditions made of comparisons of a numeric column with a literal,
+/// combined with logical 'and' / 'or'. The column can be upcast and taken in absolute
+/// value, as for nabs(aod::track::eta) < 0.8f. Such conditions are evaluated without
+/// gandiva: every comparison fills a byte mask of the rows in a loop over the contiguous
+/// column values which the compiler vectorizes, the masks are combined and converted
+/// to the selection vector at the end. This avoids the JIT compilation of the filter.
+class KernelFilter
+{
+ public:
+  enum struct Comparison : uint8_t {
+    LessThan,
+    LessThanOrEqual,
+    GreaterThan,
+    GreaterThanOrEqual,
+    Equal,
+    NotEqual
+  };
+
+  /// node of the parsed condition
+  struct Term {
+    enum struct Kind : uint8_t {
+      And,
+      Or,
+      Compare
+    };
+    Kind kind = Kind::Compare;
+    std::vector<Term> children;                ///< operands of And / Or
+    std::string column;                        ///< column name for Compare
+    atype::type columnType = atype::NA;        ///< type of the column
+    atype::type valueType = atype::NA;         ///< type after the upcast, if any, and of the literal
+    bool abs = false;                          ///< absolute value of the (upcast) column is compared
+    Comparison comparison = Comparison::Equal; ///< column is on the left side of the comparison
+    LiteralNode::var_t literal;                ///< literal, of valueType
+  };
+
+  /// Parse a gandiva condition, return nullptr if it cannot be evaluated by the kernels
+  static std::shared_ptr<KernelFilter> make(gandiva::NodePtr const& condition);
+
+  /// Fill the mask of the selected rows of the table, 1 byte per row
+  void evaluate(arrow::Table const& table, std::vector<uint8_t>& mask) const;
+
+  Term const& getTerm() const { return mTerm; }
+
+ private:
+  Term mTerm;
+};
+
+/// Function to create the kernel filter for a gandiva condition, nullptr if the condition is
+/// not supported by the kernels or if the gandiva filters are requested with O2_DPL_GANDIVA_FILTERS=1
+std::shared_ptr<KernelFilter> createKernelFilter(gandiva::NodePtr const& condition);
+/// Function for creating the selection with the kernel filter
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<KernelFilter> const& kfilter);
+} // namespace o2::framework::expressions
+
+#endif // O2_FRAMEWORK_FILTERKERNELS_H_
@@ -64,6 +64,7 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mCompletionPolicy{policy},
     mDistinctRoutesIndex{DataRelayerHelpers::createDistinctRouteIndex(routes)},
     mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
+    mRouteDispatch{DataRelayerHelpers::createRouteDispatchTable(routes, mDistinctRoutesIndex)},
     mMaxLanes{InputRouteHelpers::maxLanes(routes)}
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
@@ -212,26 +213,6 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
   return activity;
 }
 
-/// This does the mapping between a route and a InputSpec. The
-/// reason why these might diffent is that when you have timepipelining
-/// you have one route per timeslice, even if the type is the same.
-size_t matchToContext(void const* data,
-                      std::vector<DataDescriptorMatcher> const& matchers,
-                      std::vector<size_t> const& index,
-                      VariableContext& context)
-{
-  for (size_t ri = 0, re = index.size(); ri < re; ++ri) {
-    auto& matcher = matchers[index[ri]];
-
-    if (matcher.match(reinterpret_cast<char const*>(data), context)) {
-      context.commit();
-      return ri;
-    }
-    context.discard();
-  }
-  return INVALID_INPUT;
-}
-
 /// Send the contents of a context as metrics, so that we can examine them in
 /// the GUI.
 void sendVariableContextMetrics(VariableContext& context, TimesliceSlot slot,
@@ -282,14 +263,20 @@ DataRelayer::RelayChoice
   // This returns the identifier for the given input. We use a separate
   // function because while it's trivial now, the actual matchmaking will
   // become more complicated when we will start supporting ranges.
+  // The routes which can match this header do not depend on the slot, so
+  // they are looked up only once.
+  auto& candidates = mRouteDispatch.candidates(o2::header::get<DataHeader*>(rawHeader));
   auto getInputTimeslice = [&matchers = mInputMatchers,
                             &distinctRoutes = mDistinctRoutesIndex,
+                            &candidates,
+                            &isConcrete = mRouteDispatch.isConcrete,
+                            startTime = dph->startTime,
                             &rawHeader,
                             &index](VariableContext& context)
     -> std::tuple<int, TimesliceId> {
     /// FIXME: for the moment we only use the first context and reset
     /// between one invokation and the other.
-    auto input = matchToContext(rawHeader, matchers, distinctRoutes, context);
+    auto input = DataRelayerHelpers::matchCandidatesToContext(rawHeader, matchers, distinctRoutes, candidates, isConcrete, startTime, context);
 
     if (input == INVALID_INPUT) {
       return {
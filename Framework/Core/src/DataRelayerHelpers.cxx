@@ -70,4 +70,61 @@ std::vector<DataDescriptorMatcher>
   return result;
 }
 
+RouteDispatchTable
+  DataRelayerHelpers::createRouteDispatchTable(std::vector<InputRoute> const& routes, std::vector<size_t> const& distinctRoutes)
+{
+  RouteDispatchTable table;
+  std::vector<uint64_t> keys(distinctRoutes.size());
+  for (size_t ri = 0; ri < distinctRoutes.size(); ++ri) {
+    table.all.push_back(ri);
+    auto concrete = std::get_if<ConcreteDataMatcher>(&routes[distinctRoutes[ri]].matcher.matcher);
+    table.isConcrete.push_back(concrete != nullptr);
+    if (concrete) {
+      keys[ri] = RouteDispatchTable::key(concrete->origin, concrete->description, concrete->subSpec);
+    } else {
+      table.generic.push_back(ri);
+    }
+  }
+  // a header of a concrete route can match all the routes with the same key and the generic ones,
+  // they must be tried in route order as the first matching route wins
+  for (size_t ri = 0; ri < distinctRoutes.size(); ++ri) {
+    if (!table.isConcrete[ri] || table.concrete.count(keys[ri])) {
+      continue;
+    }
+    auto& candidates = table.concrete[keys[ri]];
+    for (size_t rj = 0; rj < distinctRoutes.size(); ++rj) {
+      if (!table.isConcrete[rj] || keys[rj] == keys[ri]) {
+        candidates.push_back(rj);
+      }
+    }
+  }
+  return table;
+}
+
+size_t
+  DataRelayerHelpers::matchCandidatesToContext(void const* data,
+                                               std::vector<DataDescriptorMatcher> const& matchers,
+                                               std::vector<size_t> const& index,
+                                               std::vector<int> const& candidates,
+                                               std::vector<bool> const& isConcrete,
+                                               uint64_t startTime,
+                                               VariableContext& context)
+{
+  auto boundStartTime = std::get_if<uint64_t>(&context.get(0));
+  bool otherTimeslice = boundStartTime && *boundStartTime != startTime;
+  for (auto ri : candidates) {
+    if (otherTimeslice && isConcrete[ri]) {
+      continue;
+    }
+    auto& matcher = matchers[index[ri]];
+
+    if (matcher.match(reinterpret_cast<char const*>(data), context)) {
+      context.commit();
+      return ri;
+    }
+    context.discard();
+  }
+  return -1;
+}
+
 } // namespace o2::framework
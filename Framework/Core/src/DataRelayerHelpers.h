@@ -12,6 +12,7 @@
 #define O2_FRAMEWORK_DATARELAYERHELPERS_H_
 
 #include "Framework/InputRoute.h"
+#include "Framework/DataRelayer.h"
 #include <vector>
 
 namespace o2::framework
@@ -23,6 +24,22 @@ struct DataRelayerHelpers {
   static std::vector<size_t> createDistinctRouteIndex(std::vector<InputRoute> const&);
   /// This converts from InputRoute to the associated DataDescriptorMatcher.
   static std::vector<data_matcher::DataDescriptorMatcher> createInputMatchers(std::vector<InputRoute> const&);
+  /// Build the table dispatching a header to the distinct routes which can match it.
+  static RouteDispatchTable createRouteDispatchTable(std::vector<InputRoute> const&, std::vector<size_t> const& distinctRoutes);
+  /// This does the mapping between a route and a InputSpec. The
+  /// reason why these might diffent is that when you have timepipelining
+  /// you have one route per timeslice, even if the type is the same.
+  /// Only the @a candidates routes, as selected by the RouteDispatchTable,
+  /// are tried. If the start time bound to the context is not the one of the
+  /// data, the concrete routes cannot match and only the generic ones are tried.
+  /// @return the first matching distinct route, -1 if none matches
+  static size_t matchCandidatesToContext(void const* data,
+                                         std::vector<data_matcher::DataDescriptorMatcher> const& matchers,
+                                         std::vector<size_t> const& index,
+                                         std::vector<int> const& candidates,
+                                         std::vector<bool> const& isConcrete,
+                                         uint64_t startTime,
+                                         data_matcher::VariableContext& context);
 };
 
 } // namespace o2::framework
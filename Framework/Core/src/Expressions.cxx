@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/ExpressionHelpers.h"
+#include "Framework/FilterKernels.h"
 #include "Framework/VariantHelpers.h"
 #include "Framework/Logger.h"
 #include "Framework/RuntimeError.h"
@@ -455,7 +456,11 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, s
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table,
                                    Filter const& expression)
 {
-  return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
+  auto tree = createExpressionTree(createOperations(expression), table->schema());
+  if (auto kfilter = createKernelFilter(tree); kfilter != nullptr) {
+    return createSelection(table, kfilter);
+  }
+  return createSelection(table, createFilter(table->schema(), makeCondition(tree)));
 }
 
 auto createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector)
@@ -0,0 +1,374 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/FilterKernels.h"
+#include "Framework/RuntimeError.h"
+#include <arrow/table.h>
+#include <gandiva/func_descriptor.h>
+#include <gandiva/node.h>
+#include <gandiva/selection_vector.h>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace o2::framework::expressions
+{
+namespace
+{
+using Comparison = KernelFilter::Comparison;
+using Term = KernelFilter::Term;
+
+bool isNumeric(atype::type t)
+{
+  switch (t) {
+    case atype::UINT8:
+    case atype::INT8:
+    case atype::UINT16:
+    case atype::INT16:
+    case atype::UINT32:
+    case atype::INT32:
+    case atype::UINT64:
+    case atype::INT64:
+    case atype::FLOAT:
+    case atype::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool parseComparison(std::string const& name, Comparison& comparison)
+{
+  if (name == "less_than") {
+    comparison = Comparison::LessThan;
+  } else if (name == "less_than_or_equal_to") {
+    comparison = Comparison::LessThanOrEqual;
+  } else if (name == "greater_than") {
+    comparison = Comparison::GreaterThan;
+  } else if (name == "greater_than_or_equal_to") {
+    comparison = Comparison::GreaterThanOrEqual;
+  } else if (name == "equal") {
+    comparison = Comparison::Equal;
+  } else if (name == "not_equal") {
+    comparison = Comparison::NotEqual;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/// comparison with swapped operands
+Comparison mirror(Comparison comparison)
+{
+  switch (comparison) {
+    case Comparison::LessThan:
+      return Comparison::GreaterThan;
+    case Comparison::LessThanOrEqual:
+      return Comparison::GreaterThanOrEqual;
+    case Comparison::GreaterThan:
+      return Comparison::LessThan;
+    case Comparison::GreaterThanOrEqual:
+      return Comparison::LessThanOrEqual;
+    default:
+      return comparison;
+  }
+}
+
+gandiva::FunctionNode const* asFunction(gandiva::NodePtr const& node, size_t nArgs)
+{
+  auto function = dynamic_cast<gandiva::FunctionNode const*>(node.get());
+  return (function != nullptr && function->children().size() == nArgs) ? function : nullptr;
+}
+
+/// operand is [absf]([castXXX](field)), as created by createExpressionTree
+bool parseOperand(gandiva::NodePtr const& node, Term& term)
+{
+  term.valueType = node->return_type()->id();
+  auto inner = node;
+  auto function = asFunction(inner, 1);
+  if (function != nullptr && function->descriptor()->name() == "absf") {
+    term.abs = true;
+    inner = function->children()[0];
+    if (inner->return_type()->id() != term.valueType || (term.valueType != atype::FLOAT && term.valueType != atype::DOUBLE)) {
+      return false;
+    }
+    function = asFunction(inner, 1);
+  }
+  if (function != nullptr) {
+    auto const& name = function->descriptor()->name();
+    if (name != "castFLOAT4" && name != "castFLOAT8" && name != "castINT" && name != "castBIGINT") {
+      return false;
+    }
+    inner = function->children()[0];
+  }
+  auto field = dynamic_cast<gandiva::FieldNode const*>(inner.get());
+  if (field == nullptr) {
+    return false;
+  }
+  term.column = field->field()->name();
+  term.columnType = field->return_type()->id();
+  return isNumeric(term.columnType) && isNumeric(term.valueType);
+}
+
+/// the literal must be of the type of the operand, as gandiva does not have mixed comparisons
+bool parseLiteral(gandiva::NodePtr const& node, Term& term)
+{
+  auto literal = dynamic_cast<gandiva::LiteralNode const*>(node.get());
+  if (literal == nullptr || literal->is_null() || literal->return_type()->id() != term.valueType) {
+    return false;
+  }
+  auto assign = [&term](auto&& value) {
+    using T = std::decay_t<decltype(value)>;
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      term.literal = value;
+      return true;
+    } else {
+      return false;
+    }
+  };
+  return std::visit(assign, literal->holder());
+}
+
+bool parseTerm(gandiva::NodePtr const& node, Term& term)
+{
+  if (auto boolean = dynamic_cast<gandiva::BooleanNode const*>(node.get()); boolean != nullptr) {
+    term.kind = boolean->expr_type() == gandiva::BooleanNode::AND ? Term::Kind::And : Term::Kind::Or;
+    for (auto const& child : boolean->children()) {
+      if (!parseTerm(child, term.children.emplace_back())) {
+        return false;
+      }
+    }
+    return !term.children.empty();
+  }
+  auto function = asFunction(node, 2);
+  Comparison comparison;
+  if (function == nullptr || !parseComparison(function->descriptor()->name(), comparison)) {
+    return false;
+  }
+  auto const& left = function->children()[0];
+  auto const& right = function->children()[1];
+  term.kind = Term::Kind::Compare;
+  if (parseOperand(left, term) && parseLiteral(right, term)) {
+    term.comparison = comparison;
+    return true;
+  }
+  term = Term{};
+  if (parseOperand(right, term) && parseLiteral(left, term)) {
+    term.comparison = mirror(comparison);
+    return true;
+  }
+  return false;
+}
+
+template <typename F>
+void dispatchColumnType(atype::type type, F&& f)
+{
+  switch (type) {
+    case atype::UINT8:
+      return f(uint8_t{});
+    case atype::INT8:
+      return f(int8_t{});
+    case atype::UINT16:
+      return f(uint16_t{});
+    case atype::INT16:
+      return f(int16_t{});
+    case atype::UINT32:
+      return f(uint32_t{});
+    case atype::INT32:
+      return f(int32_t{});
+    case atype::UINT64:
+      return f(uint64_t{});
+    case atype::INT64:
+      return f(int64_t{});
+    case atype::FLOAT:
+      return f(float{});
+    case atype::DOUBLE:
+      return f(double{});
+    default:
+      throw runtime_error_f("Unsupported column type %d in filter kernel", type);
+  }
+}
+
+/// the upcasts are done only to the types of upcastTo
+template <typename C, typename F>
+void dispatchValueType(atype::type columnType, atype::type valueType, F&& f)
+{
+  if (valueType == columnType) {
+    return f(C{});
+  }
+  switch (valueType) {
+    case atype::INT32:
+      return f(int32_t{});
+    case atype::INT64:
+      return f(int64_t{});
+    case atype::FLOAT:
+      return f(float{});
+    case atype::DOUBLE:
+      return f(double{});
+    default:
+      throw runtime_error_f("Unsupported upcast to %d in filter kernel", valueType);
+  }
+}
+
+/// the loop body is branchless, such that the loop is vectorized
+template <Comparison CMP, bool ABS, typename C, typename V>
+void compareKernel(C const* __restrict__ values, int64_t n, V literal, uint8_t* __restrict__ mask)
+{
+  for (int64_t i = 0; i < n; i++) {
+    V v = static_cast<V>(values[i]);
+    if constexpr (ABS) {
+      v = v < V(0) ? -v : v;
+    }
+    if constexpr (CMP == Comparison::LessThan) {
+      mask[i] = v < literal;
+    } else if constexpr (CMP == Comparison::LessThanOrEqual) {
+      mask[i] = v <= literal;
+    } else if constexpr (CMP == Comparison::GreaterThan) {
+      mask[i] = v > literal;
+    } else if constexpr (CMP == Comparison::GreaterThanOrEqual) {
+      mask[i] = v >= literal;
+    } else if constexpr (CMP == Comparison::Equal) {
+      mask[i] = v == literal;
+    } else {
+      mask[i] = v != literal;
+    }
+  }
+}
+
+template <bool ABS, typename C, typename V>
+void compare(Comparison comparison, C const* values, int64_t n, V literal, uint8_t* mask)
+{
+  switch (comparison) {
+    case Comparison::LessThan:
+      return compareKernel<Comparison::LessThan, ABS>(values, n, literal, mask);
+    case Comparison::LessThanOrEqual:
+      return compareKernel<Comparison::LessThanOrEqual, ABS>(values, n, literal, mask);
+    case Comparison::GreaterThan:
+      return compareKernel<Comparison::GreaterThan, ABS>(values, n, literal, mask);
+    case Comparison::GreaterThanOrEqual:
+      return compareKernel<Comparison::GreaterThanOrEqual, ABS>(values, n, literal, mask);
+    case Comparison::Equal:
+      return compareKernel<Comparison::Equal, ABS>(values, n, literal, mask);
+    case Comparison::NotEqual:
+      return compareKernel<Comparison::NotEqual, ABS>(values, n, literal, mask);
+  }
+}
+
+void evaluateCompare(Term const& term, arrow::Table const& table, uint8_t* mask)
+{
+  auto column = table.GetColumnByName(term.column);
+  if (column == nullptr) {
+    throw runtime_error_f("Cannot find field \"%s\"", term.column.c_str());
+  }
+  if (column->type()->id() != term.columnType) {
+    throw runtime_error_f("Field \"%s\" has type %d instead of %d", term.column.c_str(), column->type()->id(), term.columnType);
+  }
+  dispatchColumnType(term.columnType, [&](auto c) {
+    using C = decltype(c);
+    dispatchValueType<C>(term.columnType, term.valueType, [&](auto v) {
+      using V = decltype(v);
+      auto literal = std::get<V>(term.literal);
+      int64_t offset = 0;
+      for (auto const& chunk : column->chunks()) {
+        auto values = chunk->data()->GetValues<C>(1);
+        auto out = mask + offset;
+        if constexpr (std::is_floating_point_v<V>) {
+          if (term.abs) {
+            compare<true>(term.comparison, values, chunk->length(), literal, out);
+          } else {
+            compare<false>(term.comparison, values, chunk->length(), literal, out);
+          }
+        } else {
+          compare<false>(term.comparison, values, chunk->length(), literal, out);
+        }
+        if (chunk->null_count() > 0) { // nulls are not selected, as by gandiva
+          for (int64_t i = 0; i < chunk->length(); i++) {
+            out[i] &= chunk->IsValid(i);
+          }
+        }
+        offset += chunk->length();
+      }
+    });
+  });
+}
+
+void evaluateTerm(Term const& term, arrow::Table const& table, uint8_t* mask)
+{
+  if (term.kind == Term::Kind::Compare) {
+    evaluateCompare(term, table, mask);
+    return;
+  }
+  auto n = table.num_rows();
+  evaluateTerm(term.children[0], table, mask);
+  std::vector<uint8_t> other(n);
+  for (size_t ic = 1; ic < term.children.size(); ic++) {
+    evaluateTerm(term.children[ic], table, other.data());
+    if (term.kind == Term::Kind::And) {
+      for (int64_t i = 0; i < n; i++) {
+        mask[i] &= other[i];
+      }
+    } else {
+      for (int64_t i = 0; i < n; i++) {
+        mask[i] |= other[i];
+      }
+    }
+  }
+}
+} // namespace
+
+std::shared_ptr<KernelFilter> KernelFilter::make(gandiva::NodePtr const& condition)
+{
+  auto filter = std::make_shared<KernelFilter>();
+  if (condition == nullptr || !parseTerm(condition, filter->mTerm)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+void KernelFilter::evaluate(arrow::Table const& table, std::vector<uint8_t>& mask) const
+{
+  mask.resize(table.num_rows());
+  if (table.num_rows() == 0) {
+    return;
+  }
+  evaluateTerm(mTerm, table, mask.data());
+}
+
+std::shared_ptr<KernelFilter> createKernelFilter(gandiva::NodePtr const& condition)
+{
+  static bool useGandiva = getenv("O2_DPL_GANDIVA_FILTERS") && strcmp(getenv("O2_DPL_GANDIVA_FILTERS"), "0");
+  if (useGandiva) {
+    return nullptr;
+  }
+  return KernelFilter::make(condition);
+}
+
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<KernelFilter> const& kfilter)
+{
+  gandiva::Selection selection;
+  auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(),
+                                               arrow::default_memory_pool(),
+                                               &selection);
+  if (!s.ok()) {
+    throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
+  }
+  std::vector<uint8_t> mask;
+  kfilter->evaluate(*table, mask);
+  int64_t nSelected = 0;
+  for (int64_t i = 0; i < table->num_rows(); i++) {
+    if (mask[i]) {
+      selection->SetIndex(nSelected++, i);
+    }
+  }
+  selection->SetNumSlots(nSelected);
+  return selection;
+}
+} // namespace o2::framework::expressions
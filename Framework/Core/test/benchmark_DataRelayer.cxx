@@ -18,6 +18,7 @@
 #include <Monitoring/Monitoring.h>
 #include <fairmq/FairMQTransportFactory.h>
 #include <cstring>
+#include <string>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -339,4 +340,63 @@ static void BM_RelayMultiplePayloads(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultiplePayloads)->Arg(10)->Arg(100)->Arg(1000);
 
+/// A record with many inputs, to check that the cost of relaying a message
+/// does not grow with the number of routes.
+static void BM_RelayManyInputs(benchmark::State& state)
+{
+  Monitoring metrics;
+  size_t nInputs = state.range(0);
+
+  std::vector<InputRoute> inputs;
+  for (size_t i = 0; i < nInputs; ++i) {
+    InputSpec spec{"in" + std::to_string(i), "TST", "DATA", static_cast<DataHeader::SubSpecificationType>(i)};
+    inputs.emplace_back(InputRoute{spec, i, "Fake" + std::to_string(i), 0});
+  }
+
+  std::vector<ForwardRoute> forwards;
+  TimesliceIndex index{1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t timeslice = 0;
+
+  // One header / payload pair per input
+  std::vector<FairMQMessagePtr> inflightMessages;
+  for (size_t i = 0; i < nInputs; ++i) {
+    DataHeader dh;
+    dh.dataDescription = "DATA";
+    dh.dataOrigin = "TST";
+    dh.subSpecification = i;
+    DataProcessingHeader dph{timeslice, 1};
+    Stack stack{dh, dph};
+    inflightMessages.emplace_back(transport->CreateMessage(stack.size()));
+    inflightMessages.emplace_back(transport->CreateMessage(1000));
+    memcpy(inflightMessages[2 * i]->GetData(), stack.data(), stack.size());
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < nInputs; ++i) {
+      relayer.relay(inflightMessages[2 * i]->GetData(), &inflightMessages[2 * i], 2);
+    }
+    std::vector<RecordAction> ready;
+    relayer.getReadyToProcess(ready);
+    assert(ready.size() == 1);
+    assert(ready[0].op == CompletionPolicy::CompletionOp::Consume);
+    auto result = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+    assert(result.size() == nInputs);
+    inflightMessages.clear();
+    for (auto& part : result) {
+      assert(part.size() == 1);
+      inflightMessages.emplace_back(std::move(part.messages[0]));
+      inflightMessages.emplace_back(std::move(part.messages[1]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nInputs);
+}
+
+BENCHMARK(BM_RelayManyInputs)->Arg(1)->Arg(16)->Arg(128);
+
 BENCHMARK_MAIN();
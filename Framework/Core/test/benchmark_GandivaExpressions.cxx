@@ -11,63 +11,87 @@
 
 #include "Framework/Expressions.h"
 #include "Framework/ExpressionHelpers.h"
-
-#include "Framework/HistogramRegistry.h"
-#include "Framework/Logger.h"
+#include "Framework/FilterKernels.h"
+#include "Framework/TableBuilder.h"
 
 #include <benchmark/benchmark.h>
 #include <random>
 
 using namespace o2::framework;
-using namespace arrow;
-using namespace o2::soa;
+using namespace o2::framework::expressions;
 
 namespace test
 {
-DECLARE_SOA_COLUMN(X, x, float, "x");
-DECLARE_SOA_COLUMN(Y, y, float, "y");
-DECLARE_SOA_COLUMN(Z, z, float, "z");
-DECLARE_SOA_COLUMN(cD, cd, float, "cd");
-DECLARE_SOA_DYNAMIC_COLUMN(D, d, [](float x, float y, float z) { return std::sqrt(x * x + y * y + z * z); });
+static BindingNode pt{"fPt", 1, atype::FLOAT};
+static BindingNode eta{"fEta", 2, atype::FLOAT};
+static BindingNode dcaXY{"fDcaXY", 3, atype::FLOAT};
 } // namespace test
 
-using TT = o2::soa::Table<test::X, test::Y, test::Z, test::D<test::X, test::Y, test::Z>>;
-using RT = o2::soa::Table<test::X, test::Y, test::Z, test::cD, test::D<test::X, test::Y, test::Z>>;
-
-const static size_t maxrows = 100;
-
 static std::default_random_engine e(1234567890);
 static std::normal_distribution<float> G;
 
-auto createTable = [](size_t nrows) {
-  static TableBuilder builder;
-  auto static rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
-
+auto createTable(size_t nrows)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float>({"fPt", "fEta", "fDcaXY"});
   for (auto i = 0u; i < nrows; ++i) {
-    rowWriter(0, G(e), G(e), G(e));
+    rowWriter(0, std::abs(G(e)), G(e), 0.1f * G(e));
+  }
+  return builder.finalize();
+}
+
+/// typical track selection
+Filter trackSelection()
+{
+  return (test::pt > 0.15f) && (nabs(test::eta) < 0.8f) && (nabs(test::dcaXY) < 0.2f);
+}
+
+/// time to the first selection: creation of the filter (JIT compilation for gandiva) and evaluation
+static void BM_GandivaFirstSelection(benchmark::State& state)
+{
+  auto table = createTable(state.range(0));
+  for (auto _ : state) {
+    auto tree = createExpressionTree(createOperations(trackSelection()), table->schema());
+    auto gfilter = createFilter(table->schema(), makeCondition(tree));
+    benchmark::DoNotOptimize(createSelection(table, gfilter));
   }
-  auto table = builder.finalize();
+}
 
-  return TT{table};
-};
+static void BM_KernelFirstSelection(benchmark::State& state)
+{
+  auto table = createTable(state.range(0));
+  for (auto _ : state) {
+    auto tree = createExpressionTree(createOperations(trackSelection()), table->schema());
+    auto kfilter = KernelFilter::make(tree);
+    benchmark::DoNotOptimize(createSelection(table, kfilter));
+  }
+}
 
-static void BM_DirectCalculation(benchmark::State& state)
+/// selection of the following dataframes, with the filter already created
+static void BM_GandivaSelection(benchmark::State& state)
 {
-  state.PauseTiming();
-  auto tt = createTable(state.range(0));
-  state.ResumeTiming();
-  benchmark::DoNotOptimize(tt);
+  auto table = createTable(state.range(0));
+  auto gfilter = createFilter(table->schema(), makeCondition(createExpressionTree(createOperations(trackSelection()), table->schema())));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(createSelection(table, gfilter));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
 }
 
-static void BM_GandivaExpression(benchmark::State& state)
+static void BM_KernelSelection(benchmark::State& state)
 {
-  state.PauseTiming();
-  auto tt = createTable(state.range(0));
-  state.ResumeTiming();
-  benchmark::DoNotOptimize(tt);
+  auto table = createTable(state.range(0));
+  auto kfilter = KernelFilter::make(createExpressionTree(createOperations(trackSelection()), table->schema()));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(createSelection(table, kfilter));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
 }
 
-BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
-BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+// gandiva caches the compiled filters, only the first iteration gives the JIT start-up
+BENCHMARK(BM_GandivaFirstSelection)->Arg(100000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KernelFirstSelection)->Arg(100000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GandivaSelection)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_KernelSelection)->RangeMultiplier(10)->Range(1000, 1000000);
 
 BENCHMARK_MAIN();
@@ -24,7 +24,11 @@
 #include "Framework/WorkflowSpec.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/FairMQTransportFactory.h>
+#include <algorithm>
 #include <array>
+#include <tuple>
+#include <utility>
+#include <variant>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -731,3 +735,148 @@ BOOST_AUTO_TEST_CASE(SplitPayloadSequence)
     }
   }
 }
+
+namespace
+{
+/// The matching of a header to a route as done before the RouteDispatchTable:
+/// all the distinct routes are tried in order.
+size_t matchAllRoutesToContext(void const* data,
+                               std::vector<o2::framework::data_matcher::DataDescriptorMatcher> const& matchers,
+                               std::vector<size_t> const& index,
+                               o2::framework::data_matcher::VariableContext& context)
+{
+  for (size_t ri = 0, re = index.size(); ri < re; ++ri) {
+    auto& matcher = matchers[index[ri]];
+    if (matcher.match(reinterpret_cast<char const*>(data), context)) {
+      context.commit();
+      return ri;
+    }
+    context.discard();
+  }
+  return -1;
+}
+
+/// Concrete and wildcard routes interleaved, so that wildcard routes shadow some
+/// of the concrete ones, plus a pipelined copy of a concrete route.
+std::vector<InputRoute> createMixedRoutes()
+{
+  return {
+    InputRoute{InputSpec{"c0", "TPC", "CLUSTERS", 0}, 0, "Fake", 0},
+    InputRoute{o2::framework::select("w0:TPC/CLUSTERS")[0], 1, "Fake", 0},
+    InputRoute{InputSpec{"c1", "TPC", "CLUSTERS", 1}, 2, "Fake", 0},
+    InputRoute{InputSpec{"c2", "ITS", "TRACKS", 2}, 3, "Fake", 0},
+    InputRoute{InputSpec{"c0", "TPC", "CLUSTERS", 0}, 0, "Fake", 1},
+    InputRoute{o2::framework::select("w1:ITS")[0], 4, "Fake", 0},
+    InputRoute{InputSpec{"c3", "TPC", "DIGITS", 0}, 5, "Fake", 0},
+  };
+}
+
+DataHeader createHeader(char const* origin, char const* description, uint32_t subSpec)
+{
+  DataHeader dh;
+  dh.dataOrigin.runtimeInit(origin);
+  dh.dataDescription.runtimeInit(description);
+  dh.subSpecification = subSpec;
+  dh.splitPayloadIndex = 0;
+  dh.splitPayloadParts = 1;
+  return dh;
+}
+} // namespace
+
+// The routes found through the dispatch table, with concrete routes skipped
+// for another timeslice, are the ones found trying all the routes in order.
+BOOST_AUTO_TEST_CASE(TestRouteDispatchTable)
+{
+  using namespace o2::framework::data_matcher;
+  auto routes = createMixedRoutes();
+  auto index = DataRelayerHelpers::createDistinctRouteIndex(routes);
+  auto matchers = DataRelayerHelpers::createInputMatchers(routes);
+  auto table = DataRelayerHelpers::createRouteDispatchTable(routes, index);
+  BOOST_REQUIRE_EQUAL(index.size(), 6);
+  BOOST_REQUIRE_EQUAL(table.all.size(), index.size());
+  BOOST_CHECK_EQUAL(table.generic.size(), 2);
+  BOOST_CHECK(&table.candidates(nullptr) == &table.all);
+
+  size_t nMatched = 0, nUnmatched = 0, nSkippedTimeslice = 0;
+  for (auto origin : {"TPC", "ITS", "MFT"}) {
+    for (auto description : {"CLUSTERS", "TRACKS", "DIGITS"}) {
+      for (uint32_t subSpec : {0, 1, 2}) {
+        for (uint64_t startTime : {0, 1}) {
+          Stack stack{createHeader(origin, description, subSpec), DataProcessingHeader{startTime, 1}};
+          auto& candidates = table.candidates(reinterpret_cast<DataHeader const*>(stack.data()));
+          BOOST_CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+          // a fresh slot and a slot already bound to the timeslice with start time 1
+          for (bool bound : {false, true}) {
+            VariableContext linearContext;
+            if (bound) {
+              linearContext.put({0, uint64_t{1}});
+              linearContext.commit();
+            }
+            VariableContext dispatchContext = linearContext;
+            auto expected = matchAllRoutesToContext(stack.data(), matchers, index, linearContext);
+            auto result = DataRelayerHelpers::matchCandidatesToContext(stack.data(), matchers, index, candidates, table.isConcrete,
+                                                                       startTime, dispatchContext);
+            BOOST_CHECK_EQUAL(result, expected);
+            auto expectedStartTime = std::get_if<uint64_t>(&linearContext.get(0));
+            auto resultStartTime = std::get_if<uint64_t>(&dispatchContext.get(0));
+            BOOST_REQUIRE_EQUAL(resultStartTime != nullptr, expectedStartTime != nullptr);
+            if (expectedStartTime) {
+              BOOST_CHECK_EQUAL(*resultStartTime, *expectedStartTime);
+            }
+            if (expected == size_t(-1)) {
+              nUnmatched++;
+              nSkippedTimeslice += bound && startTime != 1;
+            } else {
+              nMatched++;
+            }
+          }
+        }
+      }
+    }
+  }
+  BOOST_CHECK(nMatched > 0);
+  BOOST_CHECK(nUnmatched > 0);
+  BOOST_CHECK(nSkippedTimeslice > 0);
+}
+
+// Relaying a sequence of headers over a few slots, as the DataRelayer does, gives
+// the same slots and routes with the dispatch table as trying all the routes.
+BOOST_AUTO_TEST_CASE(TestRouteDispatchSlots)
+{
+  using namespace o2::framework::data_matcher;
+  auto routes = createMixedRoutes();
+  auto index = DataRelayerHelpers::createDistinctRouteIndex(routes);
+  auto matchers = DataRelayerHelpers::createInputMatchers(routes);
+  auto table = DataRelayerHelpers::createRouteDispatchTable(routes, index);
+
+  constexpr size_t nSlots = 3;
+  std::vector<VariableContext> linearSlots(nSlots), dispatchSlots(nSlots);
+  std::vector<std::tuple<char const*, char const*, uint32_t>> types = {
+    {"TPC", "CLUSTERS", 0}, {"TPC", "CLUSTERS", 1}, {"TPC", "CLUSTERS", 7}, {"ITS", "TRACKS", 2}, {"ITS", "CLUSTERS", 0}, {"TPC", "DIGITS", 0}, {"MFT", "TRACKS", 0}};
+  size_t nMatched = 0;
+  for (uint64_t startTime : {0, 1, 2, 1, 3, 0, 4, 2, 5, 5, 3}) {
+    for (auto& [origin, description, subSpec] : types) {
+      Stack stack{createHeader(origin, description, subSpec), DataProcessingHeader{startTime, 1}};
+      auto& candidates = table.candidates(reinterpret_cast<DataHeader const*>(stack.data()));
+      // the first slot whose context accepts the header, otherwise the slot of
+      // the timeslice is recycled
+      auto relay = [&](auto match, std::vector<VariableContext>& slots) -> std::pair<size_t, size_t> {
+        for (size_t si = 0; si < nSlots; ++si) {
+          auto ri = match(slots[si]);
+          if (ri != size_t(-1)) {
+            return {si, ri};
+          }
+        }
+        auto si = startTime % nSlots;
+        slots[si].reset();
+        return {si, match(slots[si])};
+      };
+      auto expected = relay([&](VariableContext& context) { return matchAllRoutesToContext(stack.data(), matchers, index, context); }, linearSlots);
+      auto result = relay([&](VariableContext& context) { return DataRelayerHelpers::matchCandidatesToContext(stack.data(), matchers, index, candidates, table.isConcrete, startTime, context); }, dispatchSlots);
+      BOOST_CHECK_EQUAL(result.first, expected.first);
+      BOOST_CHECK_EQUAL(result.second, expected.second);
+      nMatched += expected.second != size_t(-1);
+    }
+  }
+  BOOST_CHECK(nMatched > 0);
+}
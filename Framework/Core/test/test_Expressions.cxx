@@ -17,8 +17,11 @@
 #include "Framework/ExpressionHelpers.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
+#include "Framework/FilterKernels.h"
+#include "Framework/TableBuilder.h"
 #include <boost/test/unit_test.hpp>
 #include <arrow/util/config.h>
+#include <random>
 
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -258,3 +261,45 @@ BOOST_AUTO_TEST_CASE(TestConditionalExpressions)
   BOOST_REQUIRE_EQUAL(gandiva_tree2->ToString(),
                       "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+BOOST_AUTO_TEST_CASE(TestFilterKernels)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, double, int32_t, uint32_t>({"fX", "fY", "fI", "fU"});
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> dist(-2.f, 2.f);
+  std::uniform_int_distribution<int32_t> idist(-20, 20);
+  for (auto i = 0; i < 1000; ++i) {
+    rowWriter(0, dist(gen), dist(gen), idist(gen), std::abs(idist(gen)));
+  }
+  auto table = builder.finalize();
+
+  BindingNode x{"fX", 1, atype::FLOAT};
+  BindingNode y{"fY", 2, atype::DOUBLE};
+  BindingNode i{"fI", 3, atype::INT32};
+  BindingNode u{"fU", 4, atype::UINT32};
+
+  // the kernels must select the same rows as gandiva
+  auto check = [&table](Filter&& f, bool supported) {
+    auto tree = createExpressionTree(createOperations(f), table->schema());
+    auto kfilter = KernelFilter::make(tree);
+    BOOST_REQUIRE_EQUAL(kfilter != nullptr, supported);
+    if (kfilter == nullptr) {
+      return;
+    }
+    auto expected = createSelection(table, createFilter(table->schema(), makeCondition(tree)));
+    auto selection = createSelection(table, kfilter);
+    BOOST_REQUIRE_EQUAL(selection->GetNumSlots(), expected->GetNumSlots());
+    BOOST_CHECK(selection->GetNumSlots() > 0 && selection->GetNumSlots() < table->num_rows());
+    for (auto slot = 0; slot < expected->GetNumSlots(); ++slot) {
+      BOOST_CHECK_EQUAL(selection->GetIndex(slot), expected->GetIndex(slot));
+    }
+  };
+
+  check((x > 0.5f) && (y < 1.), true);
+  check(nabs(x) < 1.f, true);
+  check((1.f < x) || (nabs(i) <= 5.f), true);
+  check((i >= 10) || ((u != 3u) && (x < 0.f)), true);
+  check((x * 2.f) > 1.f, false);
+  check(ifnode(x > 0.f, y > 0., y < 0.), false);
+}
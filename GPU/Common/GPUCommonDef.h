@@ -50,6 +50,11 @@
   #endif
 #endif
 
+//Explicit-SIMD implementation of kernels in the CPU backend, consecutive blocks (of one thread each on the CPU) are processed as the lanes of Vc vectors
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_NO_VC) && !defined(GPUCA_NO_CPU_SIMD) && !(defined(__CINT__) || defined(__ROOTCINT__) || defined(__CLING__) || defined(__ROOTCLING__)) && defined(__cplusplus) && __cplusplus >= 201703L
+  #define GPUCA_CPU_SIMD
+#endif
+
 //Definitions for C++11 features not supported by CINT / OpenCL
 #ifdef GPUCA_NOCOMPAT
   #define CON_DELETE = delete
@@ -272,7 +272,9 @@ int GPUReconstruction::InitPhaseBeforeDevice()
   }
   if (!IsGPU()) {
     mProcessingSettings.nDeviceHelperThreads = 0;
-    mProcessingSettings.nTPCClustererLanes = 1;
+    if (!mProcessingSettings.cpuSectorPipeline) {
+      mProcessingSettings.nTPCClustererLanes = 1;
+    }
   }
 
   if (param().rec.nonConsecutiveIDs) {
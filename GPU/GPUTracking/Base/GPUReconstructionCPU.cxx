@@ -60,6 +60,19 @@ GPUReconstructionCPU::~GPUReconstructionCPU()
   Exit(); // Needs to be identical to GPU backend bahavior in order to avoid calling abstract methods later in the destructor
 }
 
+#ifdef GPUCA_CPU_SIMD
+namespace
+{
+// Kernels with an explicit-SIMD CPU implementation provide ThreadSIMD and a HasSIMD<I>() returning true for the respective kernel
+template <class T, int I, typename = void>
+struct kernelHasSIMD : std::false_type {
+};
+template <class T, int I>
+struct kernelHasSIMD<T, I, std::enable_if_t<T::template HasSIMD<I>()>> : std::true_type {
+};
+} // namespace
+#endif
+
 template <class T, int I, typename... Args>
 int GPUReconstructionCPUBackend::runKernelBackend(krnlSetup& _xyz, const Args&... args)
 {
@@ -74,6 +87,20 @@ int GPUReconstructionCPUBackend::runKernelBackend(krnlSetup& _xyz, const Args&..
   unsigned int num = y.num == 0 || y.num == -1 ? 1 : y.num;
   for (unsigned int k = 0; k < num; k++) {
     int ompThreads = mProcessingSettings.ompKernels ? (mProcessingSettings.ompKernels == 2 ? ((mProcessingSettings.ompThreads + mNestedLoopOmpFactor - 1) / mNestedLoopOmpFactor) : mProcessingSettings.ompThreads) : 1;
+#ifdef GPUCA_CPU_SIMD
+    if constexpr (kernelHasSIMD<T, I>::value) {
+      if (mProcessingSettings.cpuSIMDKernels) {
+        // Chunks of consecutive blocks, processed as the lanes of SIMD vectors by the kernel, at least one chunk per thread
+        const unsigned int blocksPerChunk = std::max(1u, std::min(1024u, (x.nBlocks + (unsigned int)ompThreads - 1) / (unsigned int)ompThreads));
+        const unsigned int nChunks = (x.nBlocks + blocksPerChunk - 1) / blocksPerChunk;
+        GPUCA_OPENMP(parallel for num_threads(ompThreads))
+        for (unsigned int iC = 0; iC < nChunks; iC++) {
+          T::template ThreadSIMD<I>(x.nBlocks, iC * blocksPerChunk, std::min(x.nBlocks, (iC + 1) * blocksPerChunk), T::Processor(*mHostConstantMem)[y.start + k], args...);
+        }
+        continue;
+      }
+    }
+#endif
     if (ompThreads > 1) {
       if (mProcessingSettings.debugLevel >= 5) {
         printf("Running %d ompThreads\n", ompThreads);
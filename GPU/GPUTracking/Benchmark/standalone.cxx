@@ -29,6 +29,7 @@
 #include <chrono>
 #include <tuple>
 #include <algorithm>
+#include <string>
 #include <thread>
 #include <future>
 #include <atomic>
@@ -50,6 +51,7 @@
 
 #include "TPCFastTransform.h"
 #include "GPUTPCGMMergedTrack.h"
+#include "GPUTPCGMMergedTrackHit.h"
 #include "GPUSettings.h"
 #include <vector>
 #include <xmmintrin.h>
@@ -68,8 +70,8 @@ namespace GPUCA_NAMESPACE::gpu
 extern GPUSettingsStandalone configStandalone;
 }
 
-GPUReconstruction *rec, *recAsync, *recPipeline;
-GPUChainTracking *chainTracking, *chainTrackingAsync, *chainTrackingPipeline;
+GPUReconstruction *rec, *recAsync, *recPipeline, *recCompare;
+GPUChainTracking *chainTracking, *chainTrackingAsync, *chainTrackingPipeline, *chainTrackingCompare;
 #ifdef GPUCA_HAVE_O2HEADERS
 GPUChainITS *chainITS, *chainITSAsync, *chainITSPipeline;
 #endif
@@ -162,7 +164,7 @@ int ReadConfiguration(int argc, char** argv)
   }
 #endif
 #ifndef GPUCA_HAVE_O2HEADERS
-  configStandalone.runTRD = configStandalone.rundEdx = configStandalone.runCompression = configStandalone.runTransformation = configStandalone.testSyncAsync = configStandalone.testSync = 0;
+  configStandalone.runTRD = configStandalone.rundEdx = configStandalone.runCompression = configStandalone.runTransformation = configStandalone.testSyncAsync = configStandalone.testSync = configStandalone.compareCPUSIMD = configStandalone.compareCPUSectorPipeline = 0;
   configStandalone.rec.ForceEarlyTPCTransform = 1;
   configStandalone.runRefit = false;
 #endif
@@ -190,6 +192,18 @@ int ReadConfiguration(int argc, char** argv)
     printf("Cannot run asynchronous processing with double pipeline\n");
     return 1;
   }
+  if ((configStandalone.compareCPUSIMD || configStandalone.compareCPUSectorPipeline) && (configStandalone.runGPU || configStandalone.proc.doublePipeline || configStandalone.testSyncAsync)) {
+    printf("Comparison of the CPU processing modes needs CPU processing without double pipeline and asynchronous phase\n");
+    return 1;
+  }
+  if (configStandalone.compareCPUSIMD && configStandalone.compareCPUSectorPipeline) {
+    printf("Only one CPU processing mode can be compared at a time\n");
+    return 1;
+  }
+  if (configStandalone.compareCPUSectorPipeline && configStandalone.proc.debugLevel >= 1) {
+    printf("The CPU sector pipeline is not used with debug level >= 1, nothing to compare\n");
+    return 1;
+  }
   if (configStandalone.proc.doublePipeline && (configStandalone.runs < 4 || !configStandalone.outputcontrolmem)) {
     printf("Double pipeline mode needs at least 3 runs per event and external output\n");
     return 1;
@@ -283,6 +297,9 @@ int SetupReconstruction()
     if (configStandalone.testSyncAsync) {
       recAsync->ReadSettings(filename);
     }
+    if (recCompare) {
+      recCompare->ReadSettings(filename);
+    }
     if (configStandalone.proc.doublePipeline) {
       recPipeline->ReadSettings(filename);
     }
@@ -421,6 +438,17 @@ int SetupReconstruction()
   if (configStandalone.proc.doublePipeline) {
     recPipeline->SetSettings(&grp, &recSet, &procSet, &steps);
   }
+  if (recCompare) {
+    GPUSettingsProcessing procSetCompare = procSet;
+    if (configStandalone.compareCPUSIMD) {
+      procSetCompare.cpuSIMDKernels = !procSet.cpuSIMDKernels;
+    } else {
+      procSetCompare.cpuSectorPipeline = !procSet.cpuSectorPipeline;
+    }
+    procSetCompare.runQA = false;
+    procSetCompare.eventDisplay = nullptr;
+    recCompare->SetSettings(&grp, &recSet, &procSetCompare, &steps);
+  }
   if (configStandalone.testSyncAsync) {
     // Set settings for asynchronous
     steps.steps.setBits(GPUDataTypes::RecoStep::TPCDecompression, true);
@@ -581,6 +609,107 @@ void OutputStat(GPUChainTracking* t, long long int* nTracksTotal = nullptr, long
   }
 }
 
+#ifdef GPUCA_HAVE_O2HEADERS
+// Copy of the clusters, sorted in each row since their order is not deterministic with several threads
+std::vector<o2::tpc::ClusterNative> SortedClusters(const o2::tpc::ClusterNativeAccess& access)
+{
+  std::vector<o2::tpc::ClusterNative> retVal(access.clustersLinear, access.clustersLinear + access.nClustersTotal);
+  for (unsigned int i = 0; i < o2::tpc::constants::MAXSECTOR; i++) {
+    for (unsigned int j = 0; j < o2::tpc::constants::MAXGLOBALPADROW; j++) {
+      auto* begin = retVal.data() + access.clusterOffset[i][j];
+      std::sort(begin, begin + access.nClusters[i][j], [](const auto& a, const auto& b) { return memcmp(&a, &b, sizeof(a)) < 0; });
+    }
+  }
+  return retVal;
+}
+
+// Merged tracks as byte strings of their parameters and of their clusters, sorted since neither the order of the tracks nor the cluster indices are deterministic
+std::vector<std::string> SortedTracks(const GPUTrackingInOutPointers& io)
+{
+  std::vector<std::string> retVal(io.nMergedTracks);
+  for (unsigned int i = 0; i < io.nMergedTracks; i++) {
+    const GPUTPCGMMergedTrack& trk = io.mergedTracks[i];
+    std::string& track = retVal[i];
+    const float alpha = trk.GetAlpha();
+    const unsigned int nClusters = trk.NClusters();
+    const bool ok = trk.OK();
+    track.append((const char*)&trk.GetParam(), sizeof(trk.GetParam()));
+    track.append((const char*)&alpha, sizeof(alpha));
+    track.append((const char*)&nClusters, sizeof(nClusters));
+    track.append((const char*)&ok, sizeof(ok));
+    for (unsigned int j = 0; j < nClusters; j++) {
+      const GPUTPCGMMergedTrackHit& hit = io.mergedTrackHits[trk.FirstClusterRef() + j];
+      const unsigned char hitInfo[4] = {hit.slice, hit.row, hit.leg, hit.state};
+      track.append((const char*)hitInfo, sizeof(hitInfo));
+      if (io.clustersNative) {
+        track.append((const char*)&io.clustersNative->clustersLinear[hit.num], sizeof(o2::tpc::ClusterNative));
+      } else {
+        track.append((const char*)&hit.num, sizeof(hit.num));
+      }
+    }
+  }
+  std::sort(retVal.begin(), retVal.end());
+  return retVal;
+}
+
+// Runs the event again with the CPU processing mode under comparison toggled, the TPC clusters (and with the sector pipeline the TPC tracks) must be identical
+int RunCompareCPU(const GPUTrackingInOutPointers& ioPtrs, int iRun)
+{
+  const bool compareTracks = configStandalone.compareCPUSectorPipeline;
+  const bool enabled = compareTracks ? rec->GetProcessingSettings().cpuSectorPipeline : rec->GetProcessingSettings().cpuSIMDKernels;
+  const char* name[2] = {compareTracks ? "no sector pipeline" : "scalar", compareTracks ? "sector pipeline" : "SIMD"};
+  const o2::tpc::ClusterNativeAccess* clusters = chainTracking->mIOPtrs.clustersNative;
+  const bool compareClusters = clusters && chainTracking->GetRecoSteps().isSet(GPUDataTypes::RecoStep::TPCClusterFinding);
+  if (!compareClusters && !compareTracks) {
+    printf("Comparison of the CPU kernel backends needs the TPC cluster finding\n");
+    return 1;
+  }
+  // The memory of the first instance is reused by the second instance, copy what is compared
+  std::vector<o2::tpc::ClusterNative> clustersRef;
+  std::vector<unsigned int> nClustersRef;
+  if (compareClusters) {
+    clustersRef = SortedClusters(*clusters);
+    nClustersRef.assign(&clusters->nClusters[0][0], &clusters->nClusters[0][0] + o2::tpc::constants::MAXSECTOR * o2::tpc::constants::MAXGLOBALPADROW);
+  }
+  std::vector<std::string> tracksRef;
+  if (compareTracks) {
+    tracksRef = SortedTracks(chainTracking->mIOPtrs);
+  }
+  const double wallTimeRef = rec->GetStatWallTime(), kernelTimeRef = rec->GetStatKernelTime();
+
+  chainTrackingCompare->mIOPtrs = ioPtrs;
+  recCompare->SetResetTimers(iRun < configStandalone.runsInit);
+  int retVal = recCompare->RunChains();
+  if (retVal == 0) {
+    bool identical = true;
+    if (compareClusters) {
+      const o2::tpc::ClusterNativeAccess* clustersCompare = chainTrackingCompare->mIOPtrs.clustersNative;
+      bool identicalClusters = clustersCompare && std::equal(nClustersRef.begin(), nClustersRef.end(), &clustersCompare->nClusters[0][0]);
+      if (identicalClusters) {
+        const std::vector<o2::tpc::ClusterNative> clustersTest = SortedClusters(*clustersCompare);
+        identicalClusters = memcmp(clustersRef.data(), clustersTest.data(), clustersRef.size() * sizeof(clustersRef[0])) == 0;
+      }
+      printf("CPU %s / %s: %s TPC clusters (%u)\n", name[0], name[1], identicalClusters ? "identical" : "DIFFERENT", (unsigned int)clustersRef.size());
+      identical &= identicalClusters;
+    }
+    if (compareTracks) {
+      const bool identicalTracks = SortedTracks(chainTrackingCompare->mIOPtrs) == tracksRef;
+      printf("CPU %s / %s: %s TPC tracks (%u)\n", name[0], name[1], identicalTracks ? "identical" : "DIFFERENT", (unsigned int)tracksRef.size());
+      identical &= identicalTracks;
+    }
+    printf("Wall time: %'d us (%s) - %'d us (%s)\n", (int)wallTimeRef, name[enabled], (int)recCompare->GetStatWallTime(), name[!enabled]);
+    if (configStandalone.proc.debugLevel >= 1) {
+      printf("Kernel time: %'d us (%s) - %'d us (%s)\n", (int)kernelTimeRef, name[enabled], (int)recCompare->GetStatKernelTime(), name[!enabled]);
+    }
+    if (!identical) {
+      retVal = 1;
+    }
+  }
+  recCompare->ClearAllocatedMemory();
+  return retVal;
+}
+#endif
+
 int RunBenchmark(GPUReconstruction* recUse, GPUChainTracking* chainTrackingUse, int runs, int iEvent, long long int* nTracksTotal, long long int* nClustersTotal, int threadId = 0, HighResTimer* timerPipeline = nullptr)
 {
   int iRun = 0, iteration = 0;
@@ -627,6 +756,9 @@ int RunBenchmark(GPUReconstruction* recUse, GPUChainTracking* chainTrackingUse,
     }
 
 #ifdef GPUCA_HAVE_O2HEADERS
+    if (tmpRetVal == 0 && recCompare) {
+      tmpRetVal = RunCompareCPU(ioPtrs, iRun);
+    }
     if (tmpRetVal == 0 && configStandalone.testSyncAsync) {
       if (configStandalone.testSyncAsync) {
         printf("Running asynchronous phase\n");
@@ -690,7 +822,7 @@ int RunBenchmark(GPUReconstruction* recUse, GPUChainTracking* chainTrackingUse,
 
 int main(int argc, char** argv)
 {
-  std::unique_ptr<GPUReconstruction> recUnique, recUniqueAsync, recUniquePipeline;
+  std::unique_ptr<GPUReconstruction> recUnique, recUniqueAsync, recUniquePipeline, recUniqueCompare;
 
   SetCPUAndOSSettings();
 
@@ -708,7 +840,11 @@ int main(int argc, char** argv)
     recUniquePipeline.reset(GPUReconstruction::CreateInstance(configStandalone.runGPU ? configStandalone.gpuType.c_str() : GPUDataTypes::DEVICE_TYPE_NAMES[GPUDataTypes::DeviceType::CPU], configStandalone.runGPUforce, rec));
     recPipeline = recUniquePipeline.get();
   }
-  if (rec == nullptr || (configStandalone.testSyncAsync && recAsync == nullptr)) {
+  if (configStandalone.compareCPUSIMD || configStandalone.compareCPUSectorPipeline) {
+    recUniqueCompare.reset(GPUReconstruction::CreateInstance(GPUDataTypes::DEVICE_TYPE_NAMES[GPUDataTypes::DeviceType::CPU], true, rec));
+    recCompare = recUniqueCompare.get();
+  }
+  if (rec == nullptr || (configStandalone.testSyncAsync && recAsync == nullptr) || ((configStandalone.compareCPUSIMD || configStandalone.compareCPUSectorPipeline) && recCompare == nullptr)) {
     printf("Error initializing GPUReconstruction\n");
     return 1;
   }
@@ -726,6 +862,12 @@ int main(int argc, char** argv)
     }
     chainTrackingPipeline = recPipeline->AddChain<GPUChainTracking>();
   }
+  if (recCompare) {
+    if (configStandalone.proc.debugLevel >= 3) {
+      recCompare->SetDebugLevelTmp(configStandalone.proc.debugLevel);
+    }
+    chainTrackingCompare = recCompare->AddChain<GPUChainTracking>();
+  }
 #ifdef GPUCA_HAVE_O2HEADERS
   if (!configStandalone.proc.doublePipeline) {
     chainITS = rec->AddChain<GPUChainITS>(0);
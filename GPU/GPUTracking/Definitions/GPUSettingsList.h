@@ -148,9 +148,11 @@ AddOption(registerStandaloneInputMemory, bool, false, "registerInputMemory", 0,
 AddOption(ompThreads, int, -1, "omp", 't', "Number of OMP threads to run (-1: all)", min(-1), message("Using %s OMP threads"))
 AddOption(ompKernels, unsigned char, 2, "", 0, "Parallelize with OMP inside kernels instead of over slices, 2 for nested parallelization over TPC sectors and inside kernels")
 AddOption(ompAutoNThreads, bool, true, "", 0, "Auto-adjust number of OMP threads, decreasing the number for small input data")
+AddOption(cpuSectorPipeline, bool, false, "", 0, "CPU processing: run the nTPCClustererLanes clusterizer lanes concurrently, and perform global tracking and output of a sector while the other sectors are still tracked (not with debugLevel >= 1)")
+AddOption(cpuSIMDKernels, bool, false, "", 0, "Run the kernels with an explicit-SIMD CPU implementation (TPC cluster finder peak finding and noise suppression, TPC cluster transformation: correction splines of triggered data only) on SIMD lanes instead of one GPU thread per block")
 AddOption(nDeviceHelperThreads, int, 1, "", 0, "Number of CPU helper threads for CPU processing")
 AddOption(nStreams, char, 8, "", 0, "Number of GPU streams / command queues")
-AddOption(nTPCClustererLanes, char, 3, "", 0, "Number of TPC clusterers that can run in parallel")
+AddOption(nTPCClustererLanes, char, 3, "", 0, "Number of TPC clusterers that can run in parallel (on CPU: forced to 1 unless cpuSectorPipeline, each lane allocates its own clusterer scratch memory, which is thus multiplied by the number of lanes)")
 AddOption(trackletSelectorSlices, char, -1, "", 0, "Number of slices to processes in parallel at max")
 AddOption(trackletConstructorInPipeline, char, -1, "", 0, "Run tracklet constructor in the pipeline")
 AddOption(trackletSelectorInPipeline, char, -1, "", 0, "Run tracklet selector in the pipeline")
@@ -375,6 +377,8 @@ AddOption(printSettings, int, 0, "", 0, "Print all settings", def(1))
 AddOption(memoryStat, bool, false, "", 0, "Print memory statistics")
 AddOption(testSyncAsync, bool, false, "syncAsync", 0, "Test first synchronous and then asynchronous processing")
 AddOption(testSync, bool, false, "sync", 0, "Test settings for synchronous phase")
+AddOption(compareCPUSIMD, bool, false, "", 0, "Repeat the CPU processing with --PROCcpuSIMDKernels toggled, compare the TPC clusters and the timing of both CPU kernel backends")
+AddOption(compareCPUSectorPipeline, bool, false, "", 0, "Repeat the CPU processing with --PROCcpuSectorPipeline toggled, compare the TPC clusters, the TPC tracks and the timing with and without sector pipeline")
 AddOption(timeFrameTime, bool, false, "tfTime", 0, "Print some debug information about time frame processing time")
 AddOption(controlProfiler, bool, false, "", 0, "Issues GPU profiler stop and start commands to profile only the relevant processing part")
 AddOption(preloadEvents, bool, false, "", 0, "Preload events into host memory before start processing")
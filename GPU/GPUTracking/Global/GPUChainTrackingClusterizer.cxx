@@ -447,12 +447,13 @@ int GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
   unsigned int outputQueueStart = mOutputQueue.size();
 
   for (unsigned int iSliceBase = 0; iSliceBase < NSLICES; iSliceBase += GetProcessingSettings().nTPCClustererLanes) {
-    std::vector<bool> laneHasData(GetProcessingSettings().nTPCClustererLanes, false);
-    for (CfFragment fragment = mCFContext->fragmentFirst; !fragment.isEnd(); fragment = fragment.next()) {
+    std::vector<char> laneHasData(GetProcessingSettings().nTPCClustererLanes, false); // not vector<bool>, the lanes may set their entry concurrently
+    const int nLanes = std::min<int>(GetProcessingSettings().nTPCClustererLanes, NSLICES - iSliceBase);
+    auto runFragment = [&](const CfFragment& fragment, int laneBegin, int laneEnd) {
       if (GetProcessingSettings().debugLevel >= 3) {
-        GPUInfo("Processing time bins [%d, %d) for sectors %d to %d", fragment.start, fragment.last(), iSliceBase, iSliceBase + GetProcessingSettings().nTPCClustererLanes - 1);
+        GPUInfo("Processing time bins [%d, %d) for sectors %d to %d", fragment.start, fragment.last(), iSliceBase + laneBegin, iSliceBase + laneEnd - 1);
       }
-      for (int lane = 0; lane < GetProcessingSettings().nTPCClustererLanes && iSliceBase + lane < NSLICES; lane++) {
+      for (int lane = laneBegin; lane < laneEnd; lane++) {
         if (fragment.index != 0) {
           SynchronizeStream(lane); // Don't overwrite charge map from previous iteration until cluster computation is finished
         }
@@ -533,7 +534,7 @@ int GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
           TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
         }
       }
-      for (int lane = 0; lane < GetProcessingSettings().nTPCClustererLanes && iSliceBase + lane < NSLICES; lane++) {
+      for (int lane = laneBegin; lane < laneEnd; lane++) {
         unsigned int iSlice = iSliceBase + lane;
         SynchronizeStream(lane);
         if (mIOPtrs.tpcZS) {
@@ -579,7 +580,7 @@ int GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
         TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
         DoDebugAndDump(RecoStep::TPCClusterFinding, 0, clusterer, &GPUTPCClusterFinder::DumpPeaksCompacted, *mDebugFile);
       }
-      for (int lane = 0; lane < GetProcessingSettings().nTPCClustererLanes && iSliceBase + lane < NSLICES; lane++) {
+      for (int lane = laneBegin; lane < laneEnd; lane++) {
         unsigned int iSlice = iSliceBase + lane;
         GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
         GPUTPCClusterFinder& clustererShadow = doGPU ? processorsShadow()->tpcClusterer[iSlice] : clusterer;
@@ -595,7 +596,7 @@ int GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
         TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
         DoDebugAndDump(RecoStep::TPCClusterFinding, 0, clusterer, &GPUTPCClusterFinder::DumpSuppressedPeaksCompacted, *mDebugFile);
       }
-      for (int lane = 0; lane < GetProcessingSettings().nTPCClustererLanes && iSliceBase + lane < NSLICES; lane++) {
+      for (int lane = laneBegin; lane < laneEnd; lane++) {
         unsigned int iSlice = iSliceBase + lane;
         GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
         GPUTPCClusterFinder& clustererShadow = doGPU ? processorsShadow()->tpcClusterer[iSlice] : clusterer;
@@ -629,10 +630,26 @@ int GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
           clusterer.DumpClusters(*mDebugFile);
         }
       }
+    };
+    // The lanes run concurrently only on the CPU with the sector pipeline, and not with debug output: DoDebugAndDump writes to the shared debug file
+    const bool runLanesInParallel = !(doGPU || GetProcessingSettings().debugLevel >= 1) && GetProcessingSettings().cpuSectorPipeline;
+    if (!runLanesInParallel) {
+      for (CfFragment fragment = mCFContext->fragmentFirst; !fragment.isEnd(); fragment = fragment.next()) {
+        runFragment(fragment, 0, nLanes);
+      }
+    } else {
+      // The sectors of the lanes are independent, each lane runs all its fragments with its share of the OMP threads without waiting for the kernels of the other lanes
+      GPUCA_OPENMP(parallel for if(GetProcessingSettings().ompKernels != 1) num_threads(mRec->SetAndGetNestedLoopOmpFactor(true, nLanes)))
+      for (int lane = 0; lane < nLanes; lane++) {
+        for (CfFragment fragment = mCFContext->fragmentFirst; !fragment.isEnd(); fragment = fragment.next()) {
+          runFragment(fragment, lane, lane + 1);
+        }
+      }
+      mRec->SetNestedLoopOmpFactor(1);
     }
     size_t nClsFirst = nClsTotal;
     bool anyLaneHasData = false;
-    for (int lane = 0; lane < GetProcessingSettings().nTPCClustererLanes && iSliceBase + lane < NSLICES; lane++) {
+    for (int lane = 0; lane < nLanes; lane++) {
       unsigned int iSlice = iSliceBase + lane;
       std::fill(&tmpNative->nClusters[iSlice][0], &tmpNative->nClusters[iSlice][0] + MAXGLOBALPADROW, 0);
       SynchronizeStream(lane);
@@ -145,6 +145,28 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
 
   int streamMap[NSLICES];
 
+  // CPU sector pipeline: global tracking and output of a sector run as soon as the sector and its neighbours are tracked, overlapping with the tracking of the other sectors
+  const bool finalizeSlicesInPipeline = !(doGPU || GetProcessingSettings().debugLevel >= 1) && GetProcessingSettings().cpuSectorPipeline;
+  std::vector<std::atomic<bool>> sliceTracked(finalizeSlicesInPipeline ? NSLICES : 0), sliceFinalized(finalizeSlicesInPipeline ? NSLICES : 0);
+  auto sliceTrackingDone = [&](unsigned int iSlice) {
+    sliceTracked[iSlice] = true;
+    unsigned int sliceLeft, sliceRight;
+    GPUTPCGlobalTracking::GlobalTrackingSliceLeftRight(iSlice, sliceLeft, sliceRight);
+    for (unsigned int tmpSlice : {sliceLeft, iSlice, sliceRight}) {
+      unsigned int tmpLeft, tmpRight;
+      GPUTPCGlobalTracking::GlobalTrackingSliceLeftRight(tmpSlice, tmpLeft, tmpRight);
+      bool ready = sliceTracked[tmpSlice] && (!param().rec.tpc.globalTracking || (sliceTracked[tmpLeft] && sliceTracked[tmpRight]));
+      if (ready && !sliceFinalized[tmpSlice].exchange(true)) { // Whoever completes the last of the 3 sectors finalizes
+        if (param().rec.tpc.globalTracking) {
+          GlobalTracking(tmpSlice, 0);
+        }
+        if (GetRecoStepsOutputs() & GPUDataTypes::InOutType::TPCSectorTracks) {
+          WriteOutput(tmpSlice, 0);
+        }
+      }
+    }
+  };
+
   bool error = false;
   GPUCA_OPENMP(parallel for if(!doGPU && GetProcessingSettings().ompKernels != 1) num_threads(mRec->SetAndGetNestedLoopOmpFactor(!doGPU, NSLICES)))
   for (unsigned int iSlice = 0; iSlice < NSLICES; iSlice++) {
@@ -178,6 +200,9 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
       }
     }
     if (!doGPU && trk.CheckEmptySlice() && GetProcessingSettings().debugLevel == 0) {
+      if (finalizeSlicesInPipeline) {
+        sliceTrackingDone(iSlice);
+      }
       continue;
     }
 
@@ -255,6 +280,9 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
       }
       DoDebugAndDump(RecoStep::TPCSliceTracking, 512, trk, &GPUTPCTracker::DumpTrackHits, *mDebugFile);
     }
+    if (finalizeSlicesInPipeline) {
+      sliceTrackingDone(iSlice);
+    }
   }
   mRec->SetNestedLoopOmpFactor(1);
   if (error) {
@@ -420,16 +448,18 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
     }
   } else {
     mSliceSelectorReady = NSLICES;
-    GPUCA_OPENMP(parallel for if(!doGPU && GetProcessingSettings().ompKernels != 1) num_threads(mRec->SetAndGetNestedLoopOmpFactor(!doGPU, NSLICES)))
-    for (unsigned int iSlice = 0; iSlice < NSLICES; iSlice++) {
-      if (param().rec.tpc.globalTracking) {
-        GlobalTracking(iSlice, 0);
-      }
-      if (GetRecoStepsOutputs() & GPUDataTypes::InOutType::TPCSectorTracks) {
-        WriteOutput(iSlice, 0);
+    if (!finalizeSlicesInPipeline) {
+      GPUCA_OPENMP(parallel for if(!doGPU && GetProcessingSettings().ompKernels != 1) num_threads(mRec->SetAndGetNestedLoopOmpFactor(!doGPU, NSLICES)))
+      for (unsigned int iSlice = 0; iSlice < NSLICES; iSlice++) {
+        if (param().rec.tpc.globalTracking) {
+          GlobalTracking(iSlice, 0);
+        }
+        if (GetRecoStepsOutputs() & GPUDataTypes::InOutType::TPCSectorTracks) {
+          WriteOutput(iSlice, 0);
+        }
       }
+      mRec->SetNestedLoopOmpFactor(1);
     }
-    mRec->SetNestedLoopOmpFactor(1);
   }
 
   if (param().rec.tpc.globalTracking && GetProcessingSettings().debugLevel >= 3) {
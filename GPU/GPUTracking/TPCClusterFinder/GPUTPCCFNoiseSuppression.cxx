@@ -18,6 +18,10 @@
 #include "CfUtils.h"
 #include "ChargePos.h"
 
+#ifdef GPUCA_CPU_SIMD
+#include <Vc/Vc>
+#endif
+
 using namespace GPUCA_NAMESPACE::gpu;
 using namespace GPUCA_NAMESPACE::gpu::tpccf;
 
@@ -348,3 +352,69 @@ GPUd() void GPUTPCCFNoiseSuppression::findMinimaAndPeaks(
     18,
     peaks);
 }
+
+#ifdef GPUCA_CPU_SIMD
+template <>
+void GPUTPCCFNoiseSuppression::ThreadSIMD<GPUTPCCFNoiseSuppression::noiseSuppression>(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& clusterer)
+{
+  // Same result as noiseSuppressionImpl, the peaks of consecutive blocks are the lanes of the vectors.
+  // The minima, bigger and peak flags of each neighbor are kept as bitmasks over the lanes,
+  // such that keepPeak is evaluated for all lanes at once.
+  using float_v = Vc::float_v;
+  constexpr int nLanes = float_v::size();
+  static_assert(nLanes <= 32);
+
+  Array2D<PackedCharge> chargeMap(reinterpret_cast<PackedCharge*>(clusterer.mPchargeMap));
+  Array2D<uchar> peakMap(clusterer.mPpeakMap);
+  const ChargePos* peakPositions = clusterer.mPpeakPositions;
+  const uint peaknum = clusterer.mPmemory->counters.nPeaks;
+  const float_v epsilon(float(clusterer.Param().rec.tpc.cfNoiseSuppressionEpsilon));
+
+  alignas(float_v::MemoryAlignment) float q[nLanes];
+  alignas(float_v::MemoryAlignment) float other[nLanes];
+  ChargePos pos[nLanes];
+  uint minimas[NOISE_SUPPRESSION_NEIGHBOR_NUM];
+
+  for (int iBlock = iBlockBegin; iBlock < iBlockEnd; iBlock += nLanes) {
+    for (int l = 0; l < nLanes; l++) {
+      // lanes beyond the last block repeat it, their result is discarded
+      const SizeT idx = CAMath::Min(iBlock + l, iBlockEnd - 1);
+      pos[l] = peakPositions[CAMath::Min(idx, (SizeT)(peaknum - 1))];
+      q[l] = chargeMap[pos[l]].unpack();
+    }
+    const float_v qV(q, Vc::Aligned);
+
+    uint peaksAround[NOISE_SUPPRESSION_NEIGHBOR_NUM];
+    for (int i = 0; i < NOISE_SUPPRESSION_NEIGHBOR_NUM; i++) {
+      const tpccf::Delta2 d = cfconsts::NoiseSuppressionNeighbors[i];
+      uint peaks = 0;
+      for (int l = 0; l < nLanes; l++) {
+        const ChargePos p = pos[l].delta(d);
+        other[l] = chargeMap[p].unpack();
+        // the neighbors 16 and 17 are not checked for peaks
+        peaks |= uint(i != 16 && i != 17 && CfUtils::isPeak(peakMap[p])) << l;
+      }
+      const float_v otherV(other, Vc::Aligned);
+      minimas[i] = ((qV - otherV) > epsilon).toInt();
+      peaksAround[i] = peaks & (otherV > qV).toInt();
+    }
+
+    uint keepMe = ~0u;
+    for (int i = 0; i < NOISE_SUPPRESSION_NEIGHBOR_NUM; i++) {
+      uint minimaBetween = 0;
+      for (int j = 0; j < NOISE_SUPPRESSION_NEIGHBOR_NUM; j++) {
+        minimaBetween |= (cfconsts::NoiseSuppressionMinima[i] & (ulong(1) << j)) ? minimas[j] : 0u;
+      }
+      keepMe &= ~peaksAround[i] | minimaBetween;
+    }
+
+    for (int l = 0; l < nLanes; l++) {
+      const SizeT idx = iBlock + l;
+      if (idx >= (SizeT)iBlockEnd || idx >= peaknum) {
+        break;
+      }
+      clusterer.mPisPeak[idx] = (keepMe >> l) & 1;
+    }
+  }
+}
+#endif
@@ -56,6 +56,17 @@ class GPUTPCCFNoiseSuppression : public GPUKernelTemplate
   template <int iKernel = defaultKernel, typename... Args>
   GPUd() static void Thread(int nBlocks, int nThreads, int iBlock, int iThread, GPUSharedMemory& smem, processorType& clusterer, Args... args);
 
+#ifdef GPUCA_CPU_SIMD
+  template <int iKernel>
+  static constexpr bool HasSIMD()
+  {
+    return iKernel == noiseSuppression;
+  }
+  // Processes the blocks [iBlockBegin, iBlockEnd) of the CPU backend, i.e. one peak each, in SIMD vectors
+  template <int iKernel = defaultKernel, typename... Args>
+  static void ThreadSIMD(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& clusterer, Args... args);
+#endif
+
  private:
   static GPUd() void noiseSuppressionImpl(int, int, int, int, GPUSharedMemory&, const GPUSettingsRec&, const Array2D<PackedCharge>&, const Array2D<uchar>&, const ChargePos*, const uint, uchar*);
 
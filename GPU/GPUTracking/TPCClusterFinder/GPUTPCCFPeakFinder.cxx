@@ -19,6 +19,10 @@
 #include "PackedCharge.h"
 #include "TPCPadGainCalib.h"
 
+#ifdef GPUCA_CPU_SIMD
+#include <Vc/Vc>
+#endif
+
 using namespace GPUCA_NAMESPACE::gpu;
 using namespace GPUCA_NAMESPACE::gpu::tpccf;
 
@@ -123,3 +127,62 @@ GPUd() void GPUTPCCFPeakFinder::findPeaksImpl(int nBlocks, int nThreads, int iBl
 
   peakMap[pos] = (uchar(charge > calib.tpc.cfInnerThreshold) << 1) | peak;
 }
+
+#ifdef GPUCA_CPU_SIMD
+template <>
+void GPUTPCCFPeakFinder::ThreadSIMD<0>(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& clusterer)
+{
+  // Same result as findPeaksImpl, the digits of consecutive blocks are the lanes of the vectors.
+  // The charges are gathered lane by lane, the comparisons are done on full vectors.
+  using float_v = Vc::float_v;
+  constexpr int nLanes = float_v::size();
+
+  Array2D<PackedCharge> chargeMap(reinterpret_cast<PackedCharge*>(clusterer.mPchargeMap));
+  Array2D<uchar> peakMap(clusterer.mPpeakMap);
+  const ChargePos* positions = clusterer.mPpositions;
+  const SizeT digitnum = clusterer.mPmemory->counters.nPositions;
+  const GPUSettingsRec& calib = clusterer.Param().rec;
+  const TPCPadGainCalib& gainCorrection = *clusterer.GetConstantMem()->calibObjects.tpcPadGain;
+
+  alignas(float_v::MemoryAlignment) float charge[nLanes];
+  alignas(float_v::MemoryAlignment) float q[nLanes];
+  alignas(float_v::MemoryAlignment) float neighbors[SCRATCH_PAD_SEARCH_N][nLanes];
+  ChargePos pos[nLanes];
+
+  for (int iBlock = iBlockBegin; iBlock < iBlockEnd; iBlock += nLanes) {
+    for (int l = 0; l < nLanes; l++) {
+      // lanes beyond the last block repeat it, their result is discarded
+      const SizeT idx = CAMath::Min(iBlock + l, iBlockEnd - 1);
+      pos[l] = positions[CAMath::Min(idx, (SizeT)(digitnum - 1))];
+      Charge c = pos[l].valid() ? chargeMap[pos[l]].unpack() : Charge(0);
+      c = clusterer.mPpadIsNoisy[gainCorrection.globalPad(pos[l].row(), pos[l].pad())] ? 0.f : c;
+      charge[l] = c;
+      q[l] = PackedCharge(c).unpack();
+      const bool belowThreshold = (c <= calib.tpc.cfQMaxCutoff);
+      for (int i = 0; i < SCRATCH_PAD_SEARCH_N; i++) {
+        neighbors[i][l] = belowThreshold ? 0.f : chargeMap[pos[l].delta(cfconsts::InnerNeighbors[i])].unpack();
+      }
+    }
+
+    const float_v chargeV(charge, Vc::Aligned);
+    const float_v qV(q, Vc::Aligned);
+    auto peak = chargeV > float_v(float(calib.tpc.cfQMaxCutoff));
+    for (int i = 0; i < 4; i++) {
+      peak &= float_v(neighbors[i], Vc::Aligned) <= qV;
+    }
+    for (int i = 4; i < SCRATCH_PAD_SEARCH_N; i++) {
+      peak &= float_v(neighbors[i], Vc::Aligned) < qV;
+    }
+    const auto aboveInnerThreshold = chargeV > float_v(float(calib.tpc.cfInnerThreshold));
+
+    for (int l = 0; l < nLanes; l++) {
+      const SizeT idx = iBlock + l;
+      if (idx >= (SizeT)iBlockEnd || idx >= digitnum) {
+        break;
+      }
+      clusterer.mPisPeak[idx] = peak[l];
+      peakMap[pos[l]] = (uchar(aboveInnerThreshold[l]) << 1) | uchar(peak[l]);
+    }
+  }
+}
+#endif
@@ -52,6 +52,17 @@ class GPUTPCCFPeakFinder : public GPUKernelTemplate
   template <int iKernel = defaultKernel, typename... Args>
   GPUd() static void Thread(int nBlocks, int nThreads, int iBlock, int iThread, GPUSharedMemory& smem, processorType& clusterer, Args... args);
 
+#ifdef GPUCA_CPU_SIMD
+  template <int iKernel>
+  static constexpr bool HasSIMD()
+  {
+    return iKernel == 0;
+  }
+  // Processes the blocks [iBlockBegin, iBlockEnd) of the CPU backend, i.e. one digit each, in SIMD vectors
+  template <int iKernel = defaultKernel, typename... Args>
+  static void ThreadSIMD(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& clusterer, Args... args);
+#endif
+
  private:
   static GPUd() void findPeaksImpl(int, int, int, int, GPUSharedMemory&, const Array2D<PackedCharge>&, const uchar*, const ChargePos*, tpccf::SizeT, const GPUSettingsRec&, const TPCPadGainCalib&, uchar*, Array2D<uchar>&);
 
@@ -43,6 +43,17 @@ class GPUTPCConvertImpl
       transform.Transform(slice, row, pad, time, x, y, z);
     }
   }
+#if !defined(GPUCA_GPUCODE)
+  // The correction splines are evaluated in SIMD vectors only for triggered data, the time frame transformation has no correction
+  static void convertBatch(const GPUConstantMem& GPUrestrict() cm, int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z)
+  {
+    if (cm.param.par.continuousTracking) {
+      cm.calibObjects.fastTransform->TransformInTimeFrameBatch(slice, row, n, pad, time, x, y, z, cm.param.par.continuousMaxTimeBin);
+    } else {
+      cm.calibObjects.fastTransform->TransformBatch(slice, row, n, pad, time, x, y, z);
+    }
+  }
+#endif
 };
 
 } // namespace gpu
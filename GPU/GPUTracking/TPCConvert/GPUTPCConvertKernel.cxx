@@ -50,3 +50,46 @@ GPUdii() void GPUTPCConvertKernel::Thread<0>(int nBlocks, int nThreads, int iBlo
 #endif
   }
 }
+
+#ifdef GPUCA_CPU_SIMD
+template <>
+void GPUTPCConvertKernel::ThreadSIMD<0>(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& processors)
+{
+  constexpr int kBatch = 256;
+  float pad[kBatch], time[kBatch], x[kBatch], y[kBatch], z[kBatch];
+  for (int iBlock = iBlockBegin; iBlock < iBlockEnd; iBlock++) {
+    const int iSlice = iBlock / GPUCA_ROW_COUNT;
+    const int iRow = iBlock % GPUCA_ROW_COUNT;
+    GPUTPCConvert& convert = processors.tpcConverter;
+    const o2::tpc::ClusterNativeAccess* native = processors.ioPtrs.clustersNative;
+    GPUTPCClusterData* clusters = convert.mMemory->clusters[iSlice];
+    const int idOffset = native->clusterOffset[iSlice][iRow];
+    const int indexOffset = native->clusterOffset[iSlice][iRow] - native->clusterOffset[iSlice][0];
+    const int nClusters = native->nClusters[iSlice][iRow];
+
+    for (int kStart = 0; kStart < nClusters; kStart += kBatch) {
+      const int nb = CAMath::Min(kBatch, nClusters - kStart);
+      for (int k = 0; k < nb; k++) {
+        pad[k] = native->clusters[iSlice][iRow][kStart + k].getPad();
+        time[k] = native->clusters[iSlice][iRow][kStart + k].getTime();
+      }
+      GPUTPCConvertImpl::convertBatch(processors, iSlice, iRow, nb, pad, time, x, y, z);
+      for (int k = 0; k < nb; k++) {
+        const auto& clin = native->clusters[iSlice][iRow][kStart + k];
+        auto& clout = clusters[indexOffset + kStart + k];
+        clout.x = x[k];
+        clout.y = y[k];
+        clout.z = z[k];
+        clout.row = iRow;
+        clout.amp = clin.qTot;
+        clout.flags = clin.getFlags();
+        clout.id = idOffset + kStart + k;
+#ifdef GPUCA_TPC_RAW_PROPAGATE_PAD_ROW_TIME
+        clout.pad = clin.getPad();
+        clout.time = clin.getTime();
+#endif
+      }
+    }
+  }
+}
+#endif
@@ -27,6 +27,16 @@ class GPUTPCConvertKernel : public GPUKernelTemplate
   GPUhdi() CONSTEXPR static GPUDataTypes::RecoStep GetRecoStep() { return GPUDataTypes::RecoStep::TPCConversion; }
   template <int iKernel = defaultKernel>
   GPUd() static void Thread(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() GPUSharedMemory& smem, processorType& processors);
+#ifdef GPUCA_CPU_SIMD
+  template <int iKernel>
+  static constexpr bool HasSIMD()
+  {
+    return true;
+  }
+  // Processes the blocks [iBlockBegin, iBlockEnd) of the CPU backend, i.e. one TPC row each, with the batch transformation
+  template <int iKernel = defaultKernel>
+  static void ThreadSIMD(int nBlocks, int iBlockBegin, int iBlockEnd, processorType& processors);
+#endif
 };
 } // namespace gpu
 } // namespace GPUCA_NAMESPACE
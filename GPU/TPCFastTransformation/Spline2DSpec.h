@@ -362,6 +362,85 @@ class Spline2DSpec<DataT, YdimT, 0>
     }
   }
 
+#if !defined(GPUCA_GPUCODE)
+  /// Get interpolated values for n points {u1[i], u2[i]} using spline parameters Parameters.
+  /// The output is in SoA layout: S[dim * n + i]. With Vc the points are processed in SIMD vectors,
+  /// the result is the one of interpolateU() up to rounding.
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  void interpolateUbatch(int inpYdim, const DataT Parameters[], int n,
+                         const DataT u1[/*n*/], const DataT u2[/*n*/], DataT S[/*inpYdim * n*/]) const
+  {
+    const auto nYdimTmp = SplineUtil::getNdim<YdimT>(inpYdim);
+    const int nYdim = nYdimTmp.get();
+    const auto maxYdim = SplineUtil::getMaxNdim<YdimT>(inpYdim);
+    const int maxYdim1 = maxYdim.get();
+
+    int i = 0;
+#ifdef GPUCA_CPU_SIMD
+    using vec = Vc::Vector<DataT>;
+    constexpr int nLanes = vec::size();
+    const int nYdim4 = nYdim * 4;
+    const int nu = mGridX1.getNumberOfKnots();
+
+    alignas(vec::MemoryAlignment) DataT knotU[nLanes], knotLiU[nLanes], knotV[nLanes], knotLiV[nLanes];
+    alignas(vec::MemoryAlignment) DataT parA[nLanes], parB[nLanes];
+    const DataT* A[nLanes]; // parameters of the lanes at {u0, v0}, the ones at {u0, v1} are at A + nYdim4 * nu
+
+    // same as Spline1DSpec::getUderivatives() on vectors
+    auto getUderivatives = [](vec uu, vec li, vec& dS0, vec& dD0, vec& dS1, vec& dD1) {
+      const vec t = uu * li;
+      const vec tm1 = t - vec(DataT(1));
+      const vec a = uu * tm1;
+      dS1 = t * t * (vec(DataT(3)) - vec(DataT(2)) * t);
+      dS0 = vec(DataT(1)) - dS1;
+      dD0 = tm1 * a;
+      dD1 = t * a;
+    };
+
+    for (; i + nLanes <= n; i += nLanes) {
+      for (int l = 0; l < nLanes; l++) {
+        const int iu = mGridX1.template getLeftKnotIndexForU<SafeT>(u1[i + l]);
+        const int iv = mGridX2.template getLeftKnotIndexForU<SafeT>(u2[i + l]);
+        const Knot& kU = mGridX1.template getKnot<SafetyLevel::kNotSafe>(iu);
+        const Knot& kV = mGridX2.template getKnot<SafetyLevel::kNotSafe>(iv);
+        knotU[l] = kU.u;
+        knotLiU[l] = kU.Li;
+        knotV[l] = kV.u;
+        knotLiV[l] = kV.Li;
+        A[l] = Parameters + (nu * iv + iu) * nYdim4;
+      }
+      vec dSl, dDl, dSr, dDr, dSd, dDd, dSu, dDu;
+      getUderivatives(vec(u1 + i, Vc::Unaligned) - vec(knotU, Vc::Aligned), vec(knotLiU, Vc::Aligned), dSl, dDl, dSr, dDr);
+      getUderivatives(vec(u2 + i, Vc::Unaligned) - vec(knotV, Vc::Aligned), vec(knotLiV, Vc::Aligned), dSd, dDd, dSu, dDu);
+
+      const vec a[8] = {dSl * dSd, dSl * dDd, dDl * dSd, dDl * dDd,
+                        dSr * dSd, dSr * dDd, dDr * dSd, dDr * dDd};
+      const vec b[8] = {dSl * dSu, dSl * dDu, dDl * dSu, dDl * dDu,
+                        dSr * dSu, dSr * dDu, dDr * dSu, dDr * dDu};
+
+      for (int dim = 0; dim < nYdim; dim++) {
+        vec Sv = vec::Zero();
+        for (int k = 0; k < 8; k++) {
+          for (int l = 0; l < nLanes; l++) {
+            parA[l] = A[l][nYdim * k + dim];
+            parB[l] = A[l][nYdim4 * nu + nYdim * k + dim];
+          }
+          Sv += a[k] * vec(parA, Vc::Aligned) + b[k] * vec(parB, Vc::Aligned);
+        }
+        Sv.store(S + dim * n + i, Vc::Unaligned);
+      }
+    }
+#endif
+    for (; i < n; i++) {
+      DataT Si[maxYdim1];
+      interpolateU<SafeT>(inpYdim, Parameters, u1[i], u2[i], Si);
+      for (int dim = 0; dim < nYdim; dim++) {
+        S[dim * n + i] = Si[dim];
+      }
+    }
+  }
+#endif
+
  protected:
   using TBase::mGridX1;
   using TBase::mGridX2;
@@ -446,12 +525,22 @@ class Spline2DSpec<DataT, YdimT, 1>
     TBase::template interpolateUold<SafeT>(YdimT, Parameters, u1, u2, S);
   }
 
+#if !defined(GPUCA_GPUCODE)
+  /// Get interpolated values for n points, the output is in SoA layout: S[dim * n + i]
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  void interpolateUbatch(const DataT Parameters[], int n, const DataT u1[/*n*/], const DataT u2[/*n*/], DataT S[/*YdimT * n*/]) const
+  {
+    TBase::template interpolateUbatch<SafeT>(YdimT, Parameters, n, u1, u2, S);
+  }
+#endif
+
   using TBase::getNumberOfKnots;
 
   /// _______________  Suppress some parent class methods   ________________________
  private:
 #if !defined(GPUCA_GPUCODE)
   using TBase::recreate;
+  using TBase::interpolateUbatch;
 #endif
   using TBase::interpolateU;
 };
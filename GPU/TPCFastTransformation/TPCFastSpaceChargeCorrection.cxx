@@ -20,6 +20,7 @@
 #if !defined(GPUCA_GPUCODE)
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include "ChebyshevFit1D.h"
 #include "Spline2DHelper.h"
 #endif
@@ -778,3 +779,28 @@ double TPCFastSpaceChargeCorrection::testInverse(bool prn)
 }
 
 #endif // GPUCA_GPUCODE
+
+#if !defined(GPUCA_GPUCODE)
+void TPCFastSpaceChargeCorrection::getCorrectionBatch(int slice, int row, int n, const float u[], const float v[], float dx[], float du[], float dv[]) const
+{
+  /// Same as getCorrection() for n points of one row
+  constexpr int kBatch = 256;
+  const SplineType& spline = getSpline(slice, row);
+  const float* splineData = getSplineData(slice, row);
+  float su[kBatch], sv[kBatch], dxuv[3 * kBatch];
+  for (int iStart = 0; iStart < n; iStart += kBatch) {
+    const int nb = std::min(kBatch, n - iStart);
+    for (int i = 0; i < nb; i++) {
+      mGeo.convUVtoScaledUV(slice, row, u[iStart + i], v[iStart + i], su[i], sv[i]);
+      su[i] *= spline.getGridX1().getUmax();
+      sv[i] *= spline.getGridX2().getUmax();
+    }
+    spline.interpolateUbatch(splineData, nb, su, sv, dxuv);
+    for (int i = 0; i < nb; i++) {
+      dx[iStart + i] = dxuv[i];
+      du[iStart + i] = dxuv[nb + i];
+      dv[iStart + i] = dxuv[2 * nb + i];
+    }
+  }
+}
+#endif
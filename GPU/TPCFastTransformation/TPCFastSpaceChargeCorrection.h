@@ -147,6 +147,11 @@ class TPCFastSpaceChargeCorrection : public FlatObject
   ///
   GPUd() int getCorrection(int slice, int row, float u, float v, float& dx, float& du, float& dv) const;
 
+#if !defined(GPUCA_GPUCODE)
+  /// Correction of n points of one row at once, the spline is evaluated in SIMD vectors (see Spline2D::interpolateUbatch)
+  void getCorrectionBatch(int slice, int row, int n, const float u[/*n*/], const float v[/*n*/], float dx[/*n*/], float du[/*n*/], float dv[/*n*/]) const;
+#endif
+
   /// inverse correction: Corrected U and V -> coorrected X
   GPUd() void getCorrectionInvCorrectedX(int slice, int row, float corrU, float corrV, float& corrX) const;
 
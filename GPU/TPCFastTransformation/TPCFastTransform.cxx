@@ -23,6 +23,7 @@
 
 #if !defined(GPUCA_GPUCODE)
 #include <iostream>
+#include <algorithm>
 #endif
 
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
@@ -153,6 +154,53 @@ void TPCFastTransform::print() const
 #endif
 }
 
+#if !defined(GPUCA_GPUCODE)
+void TPCFastTransform::TransformBatch(int slice, int row, int n, const float pad[], const float time[], float x[], float y[], float z[], float vertexTime) const
+{
+  /// Same as Transform() for n clusters of one row, the correction is evaluated for all clusters at once
+
+  constexpr int kBatch = 256;
+  const TPCFastTransformGeo::RowInfo& rowInfo = getGeometry().getRowInfo(row);
+  float u[kBatch], v[kBatch], dx[kBatch], du[kBatch], dv[kBatch];
+  for (int iStart = 0; iStart < n; iStart += kBatch) {
+    const int nb = std::min(kBatch, n - iStart);
+    for (int i = 0; i < nb; i++) {
+      convPadTimeToUV(slice, row, pad[iStart + i], time[iStart + i], u[i], v[i], vertexTime);
+    }
+    if (mApplyCorrection) {
+      mCorrection.getCorrectionBatch(slice, row, nb, u, v, dx, du, dv);
+    } else {
+      std::fill(dx, dx + nb, 0.f);
+      std::fill(du, du + nb, 0.f);
+      std::fill(dv, dv + nb, 0.f);
+    }
+    for (int i = 0; i < nb; i++) {
+      float& xi = x[iStart + i];
+      float& yi = y[iStart + i];
+      float& zi = z[iStart + i];
+      xi = rowInfo.x + dx[i];
+      getGeometry().convUVtoLocal(slice, u[i] + du[i], v[i] + dv[i], yi, zi);
+      float dzTOF = 0;
+      getTOFcorrection(slice, row, xi, yi, zi, dzTOF);
+      zi += dzTOF;
+    }
+  }
+}
+
+void TPCFastTransform::TransformInTimeFrameBatch(int slice, int row, int n, const float pad[], const float time[], float x[], float y[], float z[], float maxTimeBin) const
+{
+  /// Same as TransformInTimeFrame() for n clusters of one row
+
+  const float rowX = getGeometry().getRowInfo(row).x;
+  for (int i = 0; i < n; i++) {
+    float u = 0, v = 0;
+    convPadTimeToUVinTimeFrame(slice, row, pad[i], time[i], u, v, maxTimeBin);
+    x[i] = rowX;
+    getGeometry().convUVtoLocal(slice, u, v, y[i], z[i]);
+  }
+}
+#endif
+
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE) && !defined(GPUCA_ALIROOT_LIB)
 
 int TPCFastTransform::writeToFile(std::string outFName, std::string name)
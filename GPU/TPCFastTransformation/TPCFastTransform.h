@@ -134,6 +134,16 @@ class TPCFastTransform : public FlatObject
   /// Transformation in the time frame
   GPUd() void TransformInTimeFrame(int slice, int row, float pad, float time, float& x, float& y, float& z, float maxTimeBin) const;
 
+#if !defined(GPUCA_GPUCODE)
+  /// Transforms n clusters of one row at once, the input and output arrays are in SoA layout.
+  /// Same result as Transform() for each cluster, but the correction splines are evaluated in SIMD vectors.
+  void TransformBatch(int slice, int row, int n, const float pad[/*n*/], const float time[/*n*/], float x[/*n*/], float y[/*n*/], float z[/*n*/], float vertexTime = 0) const;
+
+  /// TransformInTimeFrame() for n clusters of one row at once.
+  /// No correction is applied in the time frame, so there is no spline evaluation to vectorize: this is a plain loop.
+  void TransformInTimeFrameBatch(int slice, int row, int n, const float pad[/*n*/], const float time[/*n*/], float x[/*n*/], float y[/*n*/], float z[/*n*/], float maxTimeBin) const;
+#endif
+
   /// Inverse transformation
   GPUd() void InverseTransformInTimeFrame(int slice, int row, float /*x*/, float y, float z, float& pad, float& time, float maxTimeBin) const;
 
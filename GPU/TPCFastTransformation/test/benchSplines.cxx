@@ -0,0 +1,78 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchSplines.cxx
+/// \brief Benchmark of the point-by-point and of the batch evaluation of a 2D spline
+///
+/// The spline has the size of a TPC space-charge correction spline of one row (3 dimensions, 10x20 knots),
+/// the points are random in the spline range like the clusters of one row.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "Spline2D.h"
+
+using namespace o2::gpu;
+
+namespace
+{
+struct SplineData {
+  SplineData(int nPoints) : spline(10, 20), u1(nPoints), u2(nPoints), S(3 * nPoints)
+  {
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> par(-1.f, 1.f);
+    parameters.resize(spline.getNumberOfParameters());
+    for (auto& p : parameters) {
+      p = par(gen);
+    }
+    std::uniform_real_distribution<float> distU1(0.f, spline.getGridX1().getUmax()), distU2(0.f, spline.getGridX2().getUmax());
+    for (int i = 0; i < nPoints; i++) {
+      u1[i] = distU1(gen);
+      u2[i] = distU2(gen);
+    }
+  }
+  Spline2D<float, 3> spline;
+  std::vector<float> parameters, u1, u2, S;
+};
+} // namespace
+
+static void BM_Spline2DScalar(benchmark::State& state)
+{
+  const int n = state.range(0);
+  SplineData d(n);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++) {
+      float S[3];
+      d.spline.interpolateU(d.parameters.data(), d.u1[i], d.u2[i], S);
+      d.S[i] = S[0];
+      d.S[n + i] = S[1];
+      d.S[2 * n + i] = S[2];
+    }
+    benchmark::DoNotOptimize(d.S.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_Spline2DBatch(benchmark::State& state)
+{
+  const int n = state.range(0);
+  SplineData d(n);
+  for (auto _ : state) {
+    d.spline.interpolateUbatch(d.parameters.data(), n, d.u1.data(), d.u2.data(), d.S.data());
+    benchmark::DoNotOptimize(d.S.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_Spline2DScalar)->RangeMultiplier(16)->Range(16, 65536);
+BENCHMARK(BM_Spline2DBatch)->RangeMultiplier(16)->Range(16, 65536);
+
+BENCHMARK_MAIN();
@@ -19,6 +19,8 @@
 #include <boost/test/unit_test.hpp>
 #include "Spline1D.h"
 #include "Spline2D.h"
+#include <cmath>
+#include <vector>
 
 namespace o2::gpu
 {
@@ -33,4 +35,28 @@ BOOST_AUTO_TEST_CASE(Spline_test1)
   int err2 = o2::gpu::Spline2D<float>::test(0);
   BOOST_CHECK_MESSAGE(err2 == 0, "test of GPU/TPCFastTransform/Spline2D failed with the error code " << err2);
 }
+
+/// @brief The batch evaluation of a 2D spline gives the point-by-point result
+BOOST_AUTO_TEST_CASE(Spline_batch_test)
+{
+  constexpr int n = 1000;
+  Spline2D<float, 3> spline(10, 20);
+  std::vector<float> parameters(spline.getNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.size(); i++) {
+    parameters[i] = std::sin(0.1f * i);
+  }
+  std::vector<float> u1(n), u2(n), S(3 * n);
+  for (int i = 0; i < n; i++) {
+    u1[i] = spline.getGridX1().getUmax() * (i % 37) / 36.f;
+    u2[i] = spline.getGridX2().getUmax() * (i % 101) / 100.f;
+  }
+  spline.interpolateUbatch(parameters.data(), n, u1.data(), u2.data(), S.data());
+  for (int i = 0; i < n; i++) {
+    float Sref[3];
+    spline.interpolateU(parameters.data(), u1[i], u2[i], Sref);
+    for (int dim = 0; dim < 3; dim++) {
+      BOOST_CHECK_SMALL(S[dim * n + i] - Sref[dim], 1.e-4f);
+    }
+  }
+}
 } // namespace o2::gpu
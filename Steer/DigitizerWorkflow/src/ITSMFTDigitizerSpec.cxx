@@ -21,6 +21,7 @@
 #include "DataFormatsITSMFT/Digit.h"
 #include "DataFormatsITSMFT/NoiseMap.h"
 #include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/FlatMCTruthContainer.h"
 #include "DetectorsBase/BaseDPLDigitizer.h"
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "DetectorsCommonDataFormats/SimTraits.h"
@@ -28,11 +29,14 @@
 #include "DataFormatsParameters/GRPObject.h"
 #include "DataFormatsITSMFT/ROFRecord.h"
 #include "ITSMFTSimulation/Digitizer.h"
+#include "ITSMFTSimulation/DigitizationChunks.h"
 #include "ITSMFTSimulation/DPLDigitizerParam.h"
 #include "ITSMFTBase/DPLAlpideParam.h"
 #include "ITSBase/GeometryTGeo.h"
 #include "MFTBase/GeometryTGeo.h"
 #include <TChain.h>
+#include <TRandom3.h>
+#include <TROOT.h>
 #include <TStopwatch.h>
 #include <string>
 
@@ -73,6 +77,25 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
 
     // init digitizer
     mDigitizer.init();
+
+    // extra digitizers for the concurrent processing of independent time chunks
+    mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+    for (int i = 1; i < mNThreads; i++) {
+      auto& digitizer = mWorkerDigitizers.emplace_back(std::make_unique<o2::itsmft::Digitizer>());
+      digitizer->setDigiParams(digipar);
+      digitizer->setGeometry(geom);
+      digitizer->init();
+    }
+    mWorkerSimChains.resize(mNThreads - 1);
+    mRandom.resize(mNThreads);
+    if (mNThreads > 1) {
+      ROOT::EnableThreadSafety(); // hits are read concurrently from the per-thread chains
+    }
+    // the time chunks have their own random seeds, their output differs from the serial one drawing from gRandom
+    mUseTimeChunks = mNThreads > 1 || ic.options().get<bool>("time-chunks");
+    if (mUseTimeChunks) {
+      LOG(info) << mID.getName() << " collisions will be digitized in independent time chunks by " << mNThreads << " thread(s)";
+    }
   }
 
   virtual void setDigitizationOptions() = 0;
@@ -100,28 +123,28 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
     timer.Start();
     LOG(info) << " CALLING ITS DIGITIZATION ";
 
-    mDigitizer.setDigits(&mDigits);
-    mDigitizer.setROFRecords(&mROFRecords);
-    mDigitizer.setMCLabels(&mLabels);
-
     // digits are directly put into DPL owned resource
     auto& digitsAccum = pc.outputs().make<std::vector<itsmft::Digit>>(Output{mOrigin, "DIGITS", 0, Lifetime::Timeframe});
+    // and so are the labels, in their final flat layout
+    o2::dataformats::FlatMCTruthContainer<o2::MCCompLabel> labelsAccum(
+      mWithMCTruth ? &pc.outputs().make<o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel>>(Output{mOrigin, "DIGITSMCTR", 0, Lifetime::Timeframe}) : nullptr);
 
-    auto accumulate = [this, &digitsAccum]() {
+    auto accumulate = [this, &digitsAccum, &labelsAccum](std::vector<itsmft::Digit>& digits, std::vector<itsmft::ROFRecord>& rofRecords,
+                                                         o2::dataformats::MCTruthContainer<o2::MCCompLabel>& labels) {
       // accumulate result of single event processing, called after processing every event supplied
       // AND after the final flushing via digitizer::fillOutputContainer
-      if (!mDigits.size()) {
+      if (!digits.size()) {
         return; // no digits were flushed, nothing to accumulate
       }
       static int fixMC2ROF = 0; // 1st entry in mc2rofRecordsAccum to be fixed for ROFRecordID
       auto ndigAcc = digitsAccum.size();
-      std::copy(mDigits.begin(), mDigits.end(), std::back_inserter(digitsAccum));
+      std::copy(digits.begin(), digits.end(), std::back_inserter(digitsAccum));
 
       // fix ROFrecords references on ROF entries
       auto nROFRecsOld = mROFRecordsAccum.size();
 
-      for (int i = 0; i < mROFRecords.size(); i++) {
-        auto& rof = mROFRecords[i];
+      for (int i = 0; i < rofRecords.size(); i++) {
+        auto& rof = rofRecords[i];
         rof.setFirstEntry(ndigAcc + rof.getFirstEntry());
         rof.print();
 
@@ -138,54 +161,67 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
         }
       }
 
-      std::copy(mROFRecords.begin(), mROFRecords.end(), std::back_inserter(mROFRecordsAccum));
+      std::copy(rofRecords.begin(), rofRecords.end(), std::back_inserter(mROFRecordsAccum));
       if (mWithMCTruth) {
-        mLabelsAccum.mergeAtBack(mLabels);
+        labelsAccum.mergeAtBack(labels);
       }
-      LOG(info) << "Added " << mDigits.size() << " digits ";
+      LOG(info) << "Added " << digits.size() << " digits ";
       // clean containers from already accumulated stuff
-      mLabels.clear();
-      mDigits.clear();
-      mROFRecords.clear();
+      labels.clear();
+      digits.clear();
+      rofRecords.clear();
     }; // and accumulate lambda
 
-    auto& eventParts = context->getEventParts(withQED);
-    // loop over all composite collisions given from context (aka loop over all the interaction records)
-    for (int collID = 0; collID < timesview.size(); ++collID) {
-      const auto& irt = timesview[collID];
-
-      mDigitizer.setEventTime(irt);
-      mDigitizer.resetEventROFrames(); // to estimate min/max ROF for this collID
-      // for each collision, loop over the constituents event and source IDs
-      // (background signal merging is basically taking place here)
-      for (auto& part : eventParts[collID]) {
-
-        // get the hits for this event and this source
-        mHits.clear();
-        context->retrieveHits(mSimChains, o2::detectors::SimTraits::DETECTORBRANCHNAMES[mID][0].c_str(), part.sourceID, part.entryID, &mHits);
-
-        if (mHits.size() > 0) {
-          LOG(debug) << "For collision " << collID << " eventID " << part.entryID
-                     << " found " << mHits.size() << " hits ";
-          mDigitizer.process(&mHits, part.entryID, part.sourceID); // call actual digitization procedure
-        }
+    if (mUseTimeChunks) {
+      // The collisions are digitized in independent time chunks, each one with its own random seed, even by a single thread:
+      // the result does not depend on the number of threads. The chunks are merged in the order of collisions as soon as
+      // they are ready, releasing their memory.
+      auto chunks = defineChunks(timesview);
+      LOG(info) << "Digitizing " << timesview.size() << " collisions in " << chunks.size() << " independent time chunks";
+      DigitizationChunks::run(
+        chunks.size(), mNThreads,
+        [&](int iThread, int ic) { digitizeChunk(chunks, ic, iThread, *context, withQED); },
+        [&](int ic) {
+          auto& chunk = chunks[ic];
+          for (int i = 0; i < int(chunk.outputs.size()); i++) {
+            auto& out = chunk.outputs[i];
+            for (auto rof : out.rofRecords) {
+              rof.setFirstEntry(mDigits.size() + rof.getFirstEntry());
+              mROFRecords.push_back(rof);
+            }
+            std::copy(out.digits.begin(), out.digits.end(), std::back_inserter(mDigits));
+            mLabels.mergeAtBack(out.labels);
+            if (i < int(chunk.mc2rofRecords.size())) {
+              mMC2ROFRecordsAccum.push_back(chunk.mc2rofRecords[i]);
+            }
+            accumulate(mDigits, mROFRecords, mLabels);
+          }
+          chunk = DigitizationChunk{}; // release memory
+        });
+    } else {
+      mDigitizer.setDigits(&mDigits);
+      mDigitizer.setROFRecords(&mROFRecords);
+      mDigitizer.setMCLabels(&mLabels);
+      // loop over all composite collisions given from context (aka loop over all the interaction records)
+      for (int collID = 0; collID < timesview.size(); ++collID) {
+        mDigitizer.setEventTime(timesview[collID]);
+        mDigitizer.resetEventROFrames(); // to estimate min/max ROF for this collID
+        digitizeCollision(mDigitizer, mSimChains, mHits, *context, collID, withQED);
+        mMC2ROFRecordsAccum.emplace_back(collID, -1, mDigitizer.getEventROFrameMin(), mDigitizer.getEventROFrameMax());
+        accumulate(mDigits, mROFRecords, mLabels);
       }
-      mMC2ROFRecordsAccum.emplace_back(collID, -1, mDigitizer.getEventROFrameMin(), mDigitizer.getEventROFrameMax());
-      accumulate();
+      mDigitizer.fillOutputContainer();
+      accumulate(mDigits, mROFRecords, mLabels);
     }
-    mDigitizer.fillOutputContainer();
-    accumulate();
 
     // here we have all digits and labels and we can send them to consumer (aka snapshot it onto output)
 
     pc.outputs().snapshot(Output{mOrigin, "DIGITSROF", 0, Lifetime::Timeframe}, mROFRecordsAccum);
     if (mWithMCTruth) {
       pc.outputs().snapshot(Output{mOrigin, "DIGITSMC2ROF", 0, Lifetime::Timeframe}, mMC2ROFRecordsAccum);
-      auto& sharedlabels = pc.outputs().make<o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel>>(Output{mOrigin, "DIGITSMCTR", 0, Lifetime::Timeframe});
-      mLabelsAccum.flatten_to(sharedlabels);
+      labelsAccum.finalize();
       // free space of existing label containers
       mLabels.clear_andfreememory();
-      mLabelsAccum.clear_andfreememory();
     }
     LOG(info) << mID.getName() << ": Sending ROMode= " << mROMode << " to GRPUpdater";
     pc.outputs().snapshot(Output{mOrigin, "ROMode", 0, Lifetime::Timeframe}, mROMode);
@@ -204,10 +240,16 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
     if (matcher == ConcreteDataMatcher(mOrigin, "NOISEMAP", 0)) {
       LOG(info) << mID.getName() << " noise map updated";
       mDigitizer.setNoiseMap((const o2::itsmft::NoiseMap*)obj);
+      for (auto& digitizer : mWorkerDigitizers) {
+        digitizer->setNoiseMap((const o2::itsmft::NoiseMap*)obj);
+      }
     }
     if (matcher == ConcreteDataMatcher(mOrigin, "DEADMAP", 0)) {
       LOG(info) << mID.getName() << " dead map updated";
       mDigitizer.setDeadChannelsMap((const o2::itsmft::NoiseMap*)obj);
+      for (auto& digitizer : mWorkerDigitizers) {
+        digitizer->setDeadChannelsMap((const o2::itsmft::NoiseMap*)obj);
+      }
     }
   }
 
@@ -219,9 +261,57 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
     pc.inputs().get<o2::itsmft::NoiseMap*>("dead");
   }
 
+  void digitizeCollision(o2::itsmft::Digitizer& digitizer, std::vector<TChain*>& simChains, std::vector<o2::itsmft::Hit>& hits,
+                         const o2::steer::DigitizationContext& context, int collID, bool withQED)
+  {
+    // the event time of the digitizer must be set already
+    // for each collision, loop over the constituents event and source IDs
+    // (background signal merging is basically taking place here)
+    for (auto& part : context.getEventParts(withQED)[collID]) {
+
+      // get the hits for this event and this source
+      hits.clear();
+      context.retrieveHits(simChains, o2::detectors::SimTraits::DETECTORBRANCHNAMES[mID][0].c_str(), part.sourceID, part.entryID, &hits);
+
+      if (hits.size() > 0) {
+        LOG(debug) << "For collision " << collID << " eventID " << part.entryID
+                   << " found " << hits.size() << " hits ";
+        digitizer.process(&hits, part.entryID, part.sourceID); // call actual digitization procedure
+      }
+    }
+  }
+
+  std::vector<DigitizationChunk> defineChunks(const std::vector<o2::InteractionTimeRecord>& times)
+  {
+    // the splitting depends on the collision times only, the seeds of the chunks are drawn from gRandom
+    const bool continuous = mDigitizer.isContinuous();
+    std::vector<uint32_t> collROFs(times.size());
+    if (continuous) {
+      for (size_t collID = 0; collID < times.size(); collID++) {
+        collROFs[collID] = mDigitizer.getCollisionROFrame(times[collID]);
+      }
+    }
+    return DigitizationChunks::define(collROFs, continuous ? mDigitizer.getCollisionROFrameSpan() : 0, continuous, *gRandom);
+  }
+
+  void digitizeChunk(std::vector<DigitizationChunk>& chunks, int ic, int iThread, const o2::steer::DigitizationContext& context, bool withQED)
+  {
+    // every thread has its own digitizer, input chains and random generator
+    auto& digitizer = iThread ? *mWorkerDigitizers[iThread - 1] : mDigitizer;
+    auto& simChains = iThread ? mWorkerSimChains[iThread - 1] : mSimChains;
+    if (simChains.empty()) {
+      context.initSimChains(mID, simChains);
+    }
+    std::vector<o2::itsmft::Hit> hits;
+    DigitizationChunks::digitize(chunks, ic, digitizer, mRandom[iThread], context.getEventRecords(withQED),
+                                 [&](int collID) { digitizeCollision(digitizer, simChains, hits, context, collID, withQED); });
+  }
+
   bool mWithMCTruth = true;
   bool mFinished = false;
   bool mDisableQED = false;
+  bool mUseTimeChunks = false; ///< digitize the collisions in independent time chunks, with their own random seeds
+  int mNThreads = 1;
   o2::detectors::DetID mID;
   o2::header::DataOrigin mOrigin = o2::header::gDataOriginInvalid;
   o2::itsmft::Digitizer mDigitizer;
@@ -231,9 +321,11 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
   std::vector<o2::itsmft::Hit> mHits;
   std::vector<o2::itsmft::Hit>* mHitsP = &mHits;
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> mLabels;
-  o2::dataformats::MCTruthContainer<o2::MCCompLabel> mLabelsAccum;
   std::vector<o2::itsmft::MC2ROFRecord> mMC2ROFRecordsAccum;
   std::vector<TChain*> mSimChains;
+  std::vector<std::unique_ptr<o2::itsmft::Digitizer>> mWorkerDigitizers; ///< extra digitizers for the concurrent chunks processing
+  std::vector<std::vector<TChain*>> mWorkerSimChains;                     ///< hits input of extra digitizers
+  std::vector<TRandom3> mRandom;                                          ///< per thread random generators seeded for every chunk
 
   int mFixMC2ROF = 0;                                                             // 1st entry in mc2rofRecordsAccum to be fixed for ROFRecordID
   o2::parameters::GRPObject::ROMode mROMode = o2::parameters::GRPObject::PRESENT; // readout mode
@@ -356,7 +448,9 @@ DataProcessorSpec getITSDigitizerSpec(int channel, bool mctruth)
                            inputs, makeOutChannels(detOrig, mctruth),
                            AlgorithmSpec{adaptFromTask<ITSDPLDigitizerTask>(mctruth)},
                            Options{
-                             {"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}}}};
+                             {"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}},
+                             {"nthreads", o2::framework::VariantType::Int, 1, {"number of threads digitizing independent time chunks of collisions"}},
+                             {"time-chunks", o2::framework::VariantType::Bool, false, {"digitize in independent time chunks also with 1 thread (implied by nthreads>1)"}}}};
 }
 
 DataProcessorSpec getMFTDigitizerSpec(int channel, bool mctruth)
@@ -375,7 +469,9 @@ DataProcessorSpec getMFTDigitizerSpec(int channel, bool mctruth)
   return DataProcessorSpec{(detStr + "Digitizer").c_str(),
                            inputs, makeOutChannels(detOrig, mctruth),
                            AlgorithmSpec{adaptFromTask<MFTDPLDigitizerTask>(mctruth)},
-                           Options{{"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}}}};
+                           Options{{"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}},
+                                   {"nthreads", o2::framework::VariantType::Int, 1, {"number of threads digitizing independent time chunks of collisions"}},
+                                   {"time-chunks", o2::framework::VariantType::Bool, false, {"digitize in independent time chunks also with 1 thread (implied by nthreads>1)"}}}};
 }
 
 } // end namespace itsmft
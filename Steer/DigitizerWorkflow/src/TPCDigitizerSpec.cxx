@@ -172,6 +172,11 @@ class TPCDPLDigitizerTask : public BaseDPLDigitizer
       }
     }
     mDigitizer.setContinuousReadout(!triggeredMode);
+    mDigitizer.setNThreads(ic.options().get<int>("nthreads"));
+    mDigitizer.setSeedHitGroups(ic.options().get<bool>("seed-hit-groups"));
+    if (mDigitizer.getNThreads() > 1) {
+      LOG(info) << "TPC: electrons of the hits will be processed by " << mDigitizer.getNThreads() << " threads";
+    }
 
     // we send the GRP data once if the corresponding output channel is available
     // and set the flag to false after
@@ -507,6 +512,8 @@ o2::framework::DataProcessorSpec getTPCDigitizerSpec(int channel, bool writeGRP,
       {"readSpaceCharge", VariantType::String, "", {"Path to root file containing pre-calculated space-charge object and name of the object (comma separated)"}},
       {"TPCtriggered", VariantType::Bool, false, {"Impose triggered RO mode (default: continuous)"}},
       {"TPCuseCCDB", VariantType::Bool, false, {"true: load calibrations from CCDB; false: use random calibratoins"}},
+      {"nthreads", VariantType::Int, 1, {"number of threads for the drift, amplification and signal induction of the electrons"}},
+      {"seed-hit-groups", VariantType::Bool, false, {"seed the random streams per hit group also with 1 thread, to get the output of any number of threads"}},
     }};
 }
 
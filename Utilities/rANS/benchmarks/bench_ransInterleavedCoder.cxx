@@ -0,0 +1,107 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_ransInterleavedCoder.cxx
+/// @since  2021-11-02
+/// @brief  Throughput of the N-way interleaved rANS coders compared to the classic 2-way coder
+
+#include <vector>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "rANS/rans.h"
+
+template <typename source_T>
+class SourceMessage
+{
+ public:
+  explicit SourceMessage(size_t messageSize)
+  {
+    std::mt19937 mt(0);
+    // ~ the spread of a typical CTF column
+    std::binomial_distribution<int64_t> dist(sizeof(source_T) > 1 ? (1 << 12) : 255, 0.5);
+    mMessage.resize(messageSize);
+    for (auto& s : mMessage) {
+      s = static_cast<source_T>(dist(mt));
+    }
+    mFrequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(mMessage.begin(), mMessage.end()));
+  }
+
+  const auto& get() const { return mMessage; }
+  const auto& getFrequencyTable() const { return mFrequencyTable; }
+
+ private:
+  std::vector<source_T> mMessage{};
+  o2::rans::RenormedFrequencyTable mFrequencyTable{};
+};
+
+template <typename source_T>
+const SourceMessage<source_T>& getMessage()
+{
+  static SourceMessage<source_T> message{1 << 24};
+  return message;
+}
+
+void setThroughput(benchmark::State& state, size_t nBytes)
+{
+  state.SetBytesProcessed(int64_t(state.iterations()) * nBytes);
+  state.counters["MiBPerSecond"] = benchmark::Counter(double(state.iterations()) * nBytes / double(1 << 20), benchmark::Counter::kIsRate);
+}
+
+template <typename source_T>
+static void BM_Encode(benchmark::State& state)
+{
+  const auto& message = getMessage<source_T>();
+  o2::rans::LiteralEncoder64<source_T> encoder{message.getFrequencyTable()};
+  encoder.setNStreams(state.range(0));
+  std::vector<uint32_t> encodeBuffer(message.get().size() + 2 * state.range(0) + 2);
+  std::vector<source_T> literals;
+
+  for (auto _ : state) {
+    literals.clear();
+    benchmark::DoNotOptimize(encoder.process(message.get().begin(), message.get().end(), encodeBuffer.data(), literals));
+  }
+  setThroughput(state, message.get().size() * sizeof(source_T));
+}
+
+template <typename source_T>
+static void BM_Decode(benchmark::State& state)
+{
+  const auto& message = getMessage<source_T>();
+  const size_t nStreams = state.range(0);
+  o2::rans::LiteralEncoder64<source_T> encoder{message.getFrequencyTable()};
+  o2::rans::LiteralDecoder64<source_T> decoder{message.getFrequencyTable()};
+  encoder.setNStreams(nStreams);
+  std::vector<uint32_t> encodeBuffer(message.get().size() + 2 * nStreams + 2);
+  std::vector<source_T> literals;
+  const auto encodedEnd = encoder.process(message.get().begin(), message.get().end(), encodeBuffer.data(), literals);
+  std::vector<source_T> decodeBuffer(message.get().size());
+
+  for (auto _ : state) {
+    auto literalsCopy = literals;
+    decoder.process(encodedEnd, decodeBuffer.begin(), message.get().size(), literalsCopy, nStreams);
+    benchmark::ClobberMemory();
+  }
+  if (decodeBuffer != message.get()) {
+    state.SkipWithError("decoded message does not match the source");
+  }
+  setThroughput(state, message.get().size() * sizeof(source_T));
+}
+
+BENCHMARK_TEMPLATE(BM_Encode, uint8_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Encode, uint16_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Encode, uint32_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Decode, uint8_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Decode, uint16_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Decode, uint32_t)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+BENCHMARK_MAIN();
@@ -32,6 +32,7 @@
 #include "rANS/internal/SymbolTable.h"
 #include "rANS/internal/Decoder.h"
 #include "rANS/internal/DecoderBase.h"
+#include "rANS/internal/InterleavedCoder.h"
 
 namespace o2
 {
@@ -45,7 +46,7 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
-  void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
+  void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals, size_t nStreams = internal::DefaultNStreams) const;
 
  private:
   using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
@@ -53,7 +54,7 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
 
 template <typename coder_T, typename stream_T, typename source_T>
 template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
-void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
+void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals, size_t nStreams) const
 {
   using namespace internal;
   LOG(trace) << "start decoding";
@@ -70,6 +71,20 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
     return;
   }
 
+  if (nStreams != DefaultNStreams) {
+    if constexpr (needs64Bit<coder_T>()) {
+      decodeInterleaved(nStreams, this->mSymbolTable, this->mReverseLUT, inputEnd, outputBegin, messageLength, literals);
+      t.stop();
+      LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
+                  << " nStreams: " << nStreams << ", SIMD: " << simd::getName(simd::getSIMDLevel()) << ","
+                  << " inclusiveTimeMS: " << t.getDurationMS() << ","
+                  << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (messageLength * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+      return;
+    } else {
+      throw std::runtime_error(fmt::format("{} interleaved streams require the 64 Bit rANS coder", nStreams));
+    }
+  }
+
   stream_IT inputIter = inputEnd;
   source_IT it = outputBegin;
 
@@ -27,6 +27,7 @@
 #include "rANS/internal/EncoderBase.h"
 #include "rANS/internal/EncoderSymbol.h"
 #include "rANS/internal/helper.h"
+#include "rANS/internal/InterleavedCoder.h"
 #include "rANS/internal/SymbolTable.h"
 
 namespace o2
@@ -45,10 +46,26 @@ class LiteralEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
 
+  // number of interleaved rANS streams the message is split into, only the 64 Bit coder supports more than 2
+  inline size_t getNStreams() const noexcept { return mNStreams; };
+  void setNStreams(size_t nStreams);
+
  private:
   using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
+
+  size_t mNStreams{internal::DefaultNStreams};
 };
 
+template <typename coder_T, typename stream_T, typename source_T>
+void LiteralEncoder<coder_T, stream_T, source_T>::setNStreams(size_t nStreams)
+{
+  internal::checkNStreams(nStreams);
+  if (!internal::needs64Bit<coder_T>() && nStreams != internal::DefaultNStreams) {
+    throw std::runtime_error(fmt::format("{} interleaved streams require the 64 Bit rANS coder", nStreams));
+  }
+  mNStreams = nStreams;
+}
+
 template <typename coder_T, typename stream_T, typename source_T>
 template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
 stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const
@@ -68,14 +85,26 @@ stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBe
     return outputBegin;
   }
 
+  const auto inputBufferSize = std::distance(inputBegin, inputEnd);
+
+  if constexpr (needs64Bit<coder_T>()) {
+    if (mNStreams != DefaultNStreams) {
+      const auto outputEnd = encodeInterleaved(mNStreams, this->mSymbolTable, inputBegin, inputEnd, outputBegin, literals);
+      t.stop();
+      LOG(debug1) << "Encoder::" << __func__ << " {ProcessedBytes: " << inputBufferSize * sizeof(source_T) << ","
+                  << " nStreams: " << mNStreams << ","
+                  << " inclusiveTimeMS: " << t.getDurationMS() << ","
+                  << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (inputBufferSize * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+      return outputEnd;
+    }
+  }
+
   ransCoder_t rans0{this->mSymbolTable.getPrecision()};
   ransCoder_t rans1{this->mSymbolTable.getPrecision()};
 
   stream_IT outputIter = outputBegin;
   source_IT inputIT = inputEnd;
 
-  const auto inputBufferSize = std::distance(inputBegin, inputEnd);
-
   auto encode = [&, this](source_IT symbolIter, stream_IT outputIter, ransCoder_t& coder) {
     const source_T symbol = *symbolIter;
     const auto& encoderSymbol = (this->mSymbolTable)[symbol];
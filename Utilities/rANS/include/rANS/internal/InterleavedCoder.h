@@ -0,0 +1,291 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedCoder.h
+/// @since  2021-11-02
+/// @brief  N-way interleaved rANS encoding/decoding with escape symbols (literals) for the 64 Bit coder.
+
+#ifndef RANS_INTERNAL_INTERLEAVEDCODER_H
+#define RANS_INTERNAL_INTERLEAVEDCODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "rANS/definitions.h"
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/ReverseSymbolLookupTable.h"
+#include "rANS/internal/SymbolTable.h"
+#include "rANS/internal/simdKernel.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// The symbol at position i of a message is coded by lane (i % nStreams). The encoder works in reverse and
+// renormalizes the lanes of a group in descending order, the decoder works forward in ascending lane order.
+// All lanes share a single output stream, so the layout only depends on the number of streams, not on the
+// SIMD level used for the state updates. With 2 streams the layout is identical to the classic coders.
+inline constexpr size_t DefaultNStreams = 2;
+
+inline constexpr bool isSupportedNStreams(size_t nStreams) noexcept
+{
+  return nStreams == 2 || nStreams == 4 || nStreams == 8 || nStreams == 16 || nStreams == 32;
+}
+
+inline void checkNStreams(size_t nStreams)
+{
+  if (!isSupportedNStreams(nStreams)) {
+    throw std::runtime_error(fmt::format("unsupported number of interleaved rANS streams {}, allowed are 2, 4, 8, 16, 32", nStreams));
+  }
+}
+
+template <size_t nStreams_V>
+class InterleavedCoder
+{
+  static_assert(isSupportedNStreams(nStreams_V));
+
+  using state_t = uint64_t;
+  using stream_t = uint32_t;
+
+  // same normalization interval as the 64 Bit internal::Encoder/internal::Decoder
+  inline static constexpr state_t LOWER_BOUND = 1ull << 31;
+  inline static constexpr state_t STREAM_BITS = sizeof(stream_t) * 8;
+
+ public:
+  template <typename source_IT, typename stream_IT, typename literal_T>
+  static stream_IT encode(const SymbolTable<EncoderSymbol<state_t>>& symbolTable, source_IT inputBegin, source_IT inputEnd,
+                          stream_IT outputBegin, std::vector<literal_T>& literals, simd::SIMDLevel level);
+
+  template <typename stream_IT, typename source_IT, typename literal_T>
+  static void decode(const SymbolTable<DecoderSymbol>& symbolTable, const ReverseSymbolLookupTable& reverseLUT, stream_IT inputEnd,
+                     source_IT outputBegin, size_t messageLength, std::vector<literal_T>& literals, simd::SIMDLevel level);
+
+ private:
+  using lanes_t = std::array<uint64_t, nStreams_V>;
+};
+
+template <size_t nStreams_V>
+template <typename source_IT, typename stream_IT, typename literal_T>
+stream_IT InterleavedCoder<nStreams_V>::encode(const SymbolTable<EncoderSymbol<state_t>>& symbolTable, source_IT inputBegin, source_IT inputEnd,
+                                               stream_IT outputBegin, std::vector<literal_T>& literals, simd::SIMDLevel level)
+{
+  const size_t precision = symbolTable.getPrecision();
+  const state_t renormBase = (LOWER_BOUND >> precision) << STREAM_BITS;
+
+  alignas(32) lanes_t states;
+  alignas(32) lanes_t reciprocal;
+  alignas(32) lanes_t bias;
+  alignas(32) lanes_t complement;
+  alignas(32) lanes_t shift;
+  states.fill(LOWER_BOUND);
+
+  stream_IT outputIter = outputBegin;
+  source_IT inputIter = inputEnd;
+
+  // look up the symbol and stream out the lower bits of the state if it would overflow
+  auto prepare = [&](size_t lane) -> const EncoderSymbol<state_t>& {
+    const auto symbol = *(--inputIter);
+    const auto& encoderSymbol = symbolTable[symbol];
+    if (symbolTable.isEscapeSymbol(symbol)) {
+      literals.push_back(symbol);
+    }
+    assert(encoderSymbol.getFrequency() != 0);
+    const bool overflow = states[lane] >= renormBase * encoderSymbol.getFrequency();
+    if constexpr (std::is_pointer_v<stream_IT>) {
+      // branchless: the word is always written but only kept if the iterator advances. There is always
+      // room for it, since the flush writes 2 * nStreams words past the current position.
+      outputIter[1] = static_cast<stream_t>(states[lane]);
+      outputIter += overflow;
+      states[lane] >>= (overflow * STREAM_BITS);
+    } else if (overflow) {
+      ++outputIter;
+      *outputIter = static_cast<stream_t>(states[lane]);
+      states[lane] >>= STREAM_BITS;
+    }
+    return encoderSymbol;
+  };
+
+  auto update = [&](size_t lane, const EncoderSymbol<state_t>& encoderSymbol) {
+    const state_t quotient = static_cast<state_t>((static_cast<unsigned __int128>(states[lane]) * encoderSymbol.getReciprocalFrequency()) >> 64) >> encoderSymbol.getReciprocalShift();
+    states[lane] += encoderSymbol.getBias() + quotient * encoderSymbol.getFrequencyComplement();
+  };
+
+  // incomplete group at the end of the message, NB: working in reverse!
+  const size_t nTail = std::distance(inputBegin, inputEnd) % nStreams_V;
+  for (size_t lane = nTail; lane-- > 0;) {
+    update(lane, prepare(lane));
+  }
+
+  // complete groups
+  if (level == simd::SIMDLevel::Scalar) {
+    // the lanes are independent, so the state updates of a group overlap in the pipeline
+    while (inputIter != inputBegin) {
+      for (size_t lane = nStreams_V; lane-- > 0;) {
+        update(lane, prepare(lane));
+      }
+    }
+  }
+  while (inputIter != inputBegin) {
+    for (size_t lane = nStreams_V; lane-- > 0;) {
+      const auto& encoderSymbol = prepare(lane);
+      reciprocal[lane] = encoderSymbol.getReciprocalFrequency();
+      bias[lane] = encoderSymbol.getBias();
+      complement[lane] = encoderSymbol.getFrequencyComplement();
+      shift[lane] = encoderSymbol.getReciprocalShift();
+    }
+    simd::encodeLanes<nStreams_V>(level, states.data(), reciprocal.data(), bias.data(), complement.data(), shift.data());
+  }
+
+  // flush
+  for (size_t lane = nStreams_V; lane-- > 0;) {
+    ++outputIter;
+    *outputIter = static_cast<stream_t>(states[lane] >> 32);
+    ++outputIter;
+    *outputIter = static_cast<stream_t>(states[lane] >> 0);
+  }
+  // first iterator past the range so that sizes, distances and iterators work correctly.
+  ++outputIter;
+  return outputIter;
+}
+
+template <size_t nStreams_V>
+template <typename stream_IT, typename source_IT, typename literal_T>
+void InterleavedCoder<nStreams_V>::decode(const SymbolTable<DecoderSymbol>& symbolTable, const ReverseSymbolLookupTable& reverseLUT, stream_IT inputEnd,
+                                          source_IT outputBegin, size_t messageLength, std::vector<literal_T>& literals, simd::SIMDLevel level)
+{
+  const size_t precision = symbolTable.getPrecision();
+  const state_t mask = (1ull << precision) - 1;
+
+  alignas(32) lanes_t states;
+  alignas(32) lanes_t frequency;
+  alignas(32) lanes_t cumulative;
+
+  stream_IT inputIter = inputEnd;
+  source_IT outputIter = outputBegin;
+
+  // make Iter point to the last last element
+  --inputIter;
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    states[lane] = static_cast<state_t>(*inputIter);
+    --inputIter;
+    states[lane] |= static_cast<state_t>(*inputIter) << 32;
+    --inputIter;
+  }
+
+  // map the cumulative frequency of the lane to a symbol and write it out
+  auto lookup = [&](size_t lane) -> const DecoderSymbol& {
+    const auto streamSymbol = reverseLUT[states[lane] & mask];
+    if (symbolTable.isEscapeSymbol(streamSymbol)) {
+      *outputIter++ = literals.back();
+      literals.pop_back();
+    } else {
+      *outputIter++ = streamSymbol;
+    }
+    return symbolTable[streamSymbol];
+  };
+
+  auto renorm = [&](size_t lane) {
+    if constexpr (std::is_pointer_v<stream_IT>) {
+      // branchless: reading one word ahead is safe, the encoder never writes the first word of the buffer
+      const bool underflow = states[lane] < LOWER_BOUND;
+      const state_t next = *inputIter;
+      states[lane] = underflow ? (states[lane] << STREAM_BITS) | next : states[lane];
+      inputIter -= underflow;
+      assert(states[lane] >= LOWER_BOUND);
+    } else if (states[lane] < LOWER_BOUND) {
+      states[lane] = (states[lane] << STREAM_BITS) | *inputIter;
+      --inputIter;
+      assert(states[lane] >= LOWER_BOUND);
+    }
+  };
+
+  const size_t nGroups = messageLength / nStreams_V;
+  for (size_t group = 0; group < nGroups; ++group) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      const auto& decoderSymbol = lookup(lane);
+      frequency[lane] = decoderSymbol.getFrequency();
+      cumulative[lane] = decoderSymbol.getCumulative();
+    }
+    simd::decodeLanes<nStreams_V>(level, states.data(), frequency.data(), cumulative.data(), precision);
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      renorm(lane);
+    }
+  }
+
+  // incomplete group at the end of the message
+  const size_t nTail = messageLength % nStreams_V;
+  for (size_t lane = 0; lane < nTail; ++lane) {
+    const auto& decoderSymbol = lookup(lane);
+    states[lane] = decoderSymbol.getFrequency() * (states[lane] >> precision) + (states[lane] & mask) - decoderSymbol.getCumulative();
+    renorm(lane);
+  }
+}
+
+// runtime dispatch to the compiled stream counts.
+// NB: the encoder defaults to the scalar lane loop: neither SSE nor AVX2 have a 64x64->128 Bit multiply, and the
+// emulated multiply-high of the SIMD kernels is slower than the native one on the CPUs we run on.
+template <typename source_IT, typename stream_IT, typename literal_T>
+stream_IT encodeInterleaved(size_t nStreams, const SymbolTable<EncoderSymbol<uint64_t>>& symbolTable, source_IT inputBegin, source_IT inputEnd,
+                            stream_IT outputBegin, std::vector<literal_T>& literals, simd::SIMDLevel level = simd::SIMDLevel::Scalar)
+{
+  switch (nStreams) {
+    case 2:
+      return InterleavedCoder<2>::encode(symbolTable, inputBegin, inputEnd, outputBegin, literals, level);
+    case 4:
+      return InterleavedCoder<4>::encode(symbolTable, inputBegin, inputEnd, outputBegin, literals, level);
+    case 8:
+      return InterleavedCoder<8>::encode(symbolTable, inputBegin, inputEnd, outputBegin, literals, level);
+    case 16:
+      return InterleavedCoder<16>::encode(symbolTable, inputBegin, inputEnd, outputBegin, literals, level);
+    case 32:
+      return InterleavedCoder<32>::encode(symbolTable, inputBegin, inputEnd, outputBegin, literals, level);
+    default:
+      checkNStreams(nStreams);
+  }
+  return outputBegin;
+}
+
+template <typename stream_IT, typename source_IT, typename literal_T>
+void decodeInterleaved(size_t nStreams, const SymbolTable<DecoderSymbol>& symbolTable, const ReverseSymbolLookupTable& reverseLUT, stream_IT inputEnd,
+                       source_IT outputBegin, size_t messageLength, std::vector<literal_T>& literals, simd::SIMDLevel level = simd::getSIMDLevel())
+{
+  switch (nStreams) {
+    case 2:
+      return InterleavedCoder<2>::decode(symbolTable, reverseLUT, inputEnd, outputBegin, messageLength, literals, level);
+    case 4:
+      return InterleavedCoder<4>::decode(symbolTable, reverseLUT, inputEnd, outputBegin, messageLength, literals, level);
+    case 8:
+      return InterleavedCoder<8>::decode(symbolTable, reverseLUT, inputEnd, outputBegin, messageLength, literals, level);
+    case 16:
+      return InterleavedCoder<16>::decode(symbolTable, reverseLUT, inputEnd, outputBegin, messageLength, literals, level);
+    case 32:
+      return InterleavedCoder<32>::decode(symbolTable, reverseLUT, inputEnd, outputBegin, messageLength, literals, level);
+    default:
+      checkNStreams(nStreams);
+  }
+}
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDCODER_H */
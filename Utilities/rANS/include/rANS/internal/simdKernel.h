@@ -0,0 +1,257 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   simdKernel.h
+/// @since  2021-11-02
+/// @brief  State update kernels of the 64 Bit rANS coder operating on several independent lanes at once.
+
+#ifndef RANS_INTERNAL_SIMDKERNEL_H
+#define RANS_INTERNAL_SIMDKERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define RANS_HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+namespace simd
+{
+
+// Instruction set used by the lane kernels. All levels produce bit-identical states,
+// the level only decides how many lanes are processed per instruction.
+enum class SIMDLevel : uint8_t { Scalar,
+                                 SSE41,
+                                 AVX2 };
+
+inline const char* getName(SIMDLevel level) noexcept
+{
+  switch (level) {
+    case SIMDLevel::AVX2:
+      return "AVX2";
+    case SIMDLevel::SSE41:
+      return "SSE4.1";
+    default:
+      return "Scalar";
+  }
+}
+
+// highest instruction set supported by the CPU we are running on.
+inline SIMDLevel getSIMDLevel() noexcept
+{
+  static const SIMDLevel level = []() {
+#ifdef RANS_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SIMDLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+      return SIMDLevel::SSE41;
+    }
+#endif
+    return SIMDLevel::Scalar;
+  }();
+  return level;
+}
+
+namespace scalar
+{
+__extension__ using uint128_t = unsigned __int128;
+
+// x = x + bias + (mulhi(x, rcp) >> shift) * cmpl, see EncoderSymbol for the derivation
+template <size_t nLanes_V>
+inline void encodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ rcp, const uint64_t* __restrict__ bias,
+                        const uint64_t* __restrict__ cmpl, const uint64_t* __restrict__ shift)
+{
+  for (size_t lane = 0; lane < nLanes_V; ++lane) {
+    const uint64_t quotient = static_cast<uint64_t>((static_cast<uint128_t>(states[lane]) * rcp[lane]) >> 64) >> shift[lane];
+    states[lane] = states[lane] + bias[lane] + quotient * cmpl[lane];
+  }
+}
+
+// x = freq * (x >> precision) + (x & mask) - cumul
+template <size_t nLanes_V>
+inline void decodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ frequency, const uint64_t* __restrict__ cumulative, size_t precision)
+{
+  const uint64_t mask = (1ull << precision) - 1;
+  for (size_t lane = 0; lane < nLanes_V; ++lane) {
+    states[lane] = frequency[lane] * (states[lane] >> precision) + (states[lane] & mask) - cumulative[lane];
+  }
+}
+} // namespace scalar
+
+#ifdef RANS_HAS_X86_SIMD
+namespace sse41
+{
+// low 64 Bit of a * b for b < 2^32
+__attribute__((target("sse4.1"))) inline __m128i mul64x32(__m128i a, __m128i b)
+{
+  const __m128i lo = _mm_mul_epu32(a, b);
+  const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+  return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+}
+
+// high 64 Bit of the 128 Bit product a * b
+__attribute__((target("sse4.1"))) inline __m128i mulhi64(__m128i a, __m128i b)
+{
+  const __m128i lowMask = _mm_set1_epi64x(0xffffffff);
+  const __m128i aHi = _mm_srli_epi64(a, 32);
+  const __m128i bHi = _mm_srli_epi64(b, 32);
+  const __m128i ll = _mm_mul_epu32(a, b);
+  const __m128i lh = _mm_mul_epu32(a, bHi);
+  const __m128i hl = _mm_mul_epu32(aHi, b);
+  const __m128i hh = _mm_mul_epu32(aHi, bHi);
+  const __m128i mid = _mm_add_epi64(_mm_add_epi64(_mm_srli_epi64(ll, 32), _mm_and_si128(lh, lowMask)), _mm_and_si128(hl, lowMask));
+  return _mm_add_epi64(_mm_add_epi64(hh, _mm_srli_epi64(mid, 32)), _mm_add_epi64(_mm_srli_epi64(lh, 32), _mm_srli_epi64(hl, 32)));
+}
+
+// SSE has no per lane shift, shift both lanes separately and blend
+__attribute__((target("sse4.1"))) inline __m128i srlv64(__m128i a, const uint64_t* shift)
+{
+  const __m128i lane0 = _mm_srl_epi64(a, _mm_cvtsi64_si128(shift[0]));
+  const __m128i lane1 = _mm_srl_epi64(a, _mm_cvtsi64_si128(shift[1]));
+  return _mm_blend_epi16(lane0, lane1, 0xF0);
+}
+
+template <size_t nLanes_V>
+__attribute__((target("sse4.1"))) void encodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ rcp, const uint64_t* __restrict__ bias,
+                                                   const uint64_t* __restrict__ cmpl, const uint64_t* __restrict__ shift)
+{
+  static_assert(nLanes_V % 2 == 0);
+  for (size_t lane = 0; lane < nLanes_V; lane += 2) {
+    const __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(states + lane));
+    const __m128i quotient = srlv64(mulhi64(x, _mm_load_si128(reinterpret_cast<const __m128i*>(rcp + lane))), shift + lane);
+    const __m128i update = mul64x32(quotient, _mm_load_si128(reinterpret_cast<const __m128i*>(cmpl + lane)));
+    const __m128i newState = _mm_add_epi64(_mm_add_epi64(x, _mm_load_si128(reinterpret_cast<const __m128i*>(bias + lane))), update);
+    _mm_store_si128(reinterpret_cast<__m128i*>(states + lane), newState);
+  }
+}
+
+template <size_t nLanes_V>
+__attribute__((target("sse4.1"))) void decodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ frequency, const uint64_t* __restrict__ cumulative, size_t precision)
+{
+  static_assert(nLanes_V % 2 == 0);
+  const __m128i mask = _mm_set1_epi64x((1ull << precision) - 1);
+  const __m128i shift = _mm_cvtsi64_si128(precision);
+  for (size_t lane = 0; lane < nLanes_V; lane += 2) {
+    const __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(states + lane));
+    const __m128i product = mul64x32(_mm_srl_epi64(x, shift), _mm_load_si128(reinterpret_cast<const __m128i*>(frequency + lane)));
+    const __m128i newState = _mm_sub_epi64(_mm_add_epi64(product, _mm_and_si128(x, mask)), _mm_load_si128(reinterpret_cast<const __m128i*>(cumulative + lane)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(states + lane), newState);
+  }
+}
+} // namespace sse41
+
+namespace avx2
+{
+// low 64 Bit of a * b for b < 2^32
+__attribute__((target("avx2"))) inline __m256i mul64x32(__m256i a, __m256i b)
+{
+  const __m256i lo = _mm256_mul_epu32(a, b);
+  const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+}
+
+// high 64 Bit of the 128 Bit product a * b
+__attribute__((target("avx2"))) inline __m256i mulhi64(__m256i a, __m256i b)
+{
+  const __m256i lowMask = _mm256_set1_epi64x(0xffffffff);
+  const __m256i aHi = _mm256_srli_epi64(a, 32);
+  const __m256i bHi = _mm256_srli_epi64(b, 32);
+  const __m256i ll = _mm256_mul_epu32(a, b);
+  const __m256i lh = _mm256_mul_epu32(a, bHi);
+  const __m256i hl = _mm256_mul_epu32(aHi, b);
+  const __m256i hh = _mm256_mul_epu32(aHi, bHi);
+  const __m256i mid = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(ll, 32), _mm256_and_si256(lh, lowMask)), _mm256_and_si256(hl, lowMask));
+  return _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)), _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+}
+
+template <size_t nLanes_V>
+__attribute__((target("avx2"))) void encodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ rcp, const uint64_t* __restrict__ bias,
+                                                 const uint64_t* __restrict__ cmpl, const uint64_t* __restrict__ shift)
+{
+  static_assert(nLanes_V % 4 == 0);
+  for (size_t lane = 0; lane < nLanes_V; lane += 4) {
+    const __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(states + lane));
+    const __m256i quotient = _mm256_srlv_epi64(mulhi64(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(rcp + lane))),
+                                               _mm256_load_si256(reinterpret_cast<const __m256i*>(shift + lane)));
+    const __m256i update = mul64x32(quotient, _mm256_load_si256(reinterpret_cast<const __m256i*>(cmpl + lane)));
+    const __m256i newState = _mm256_add_epi64(_mm256_add_epi64(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(bias + lane))), update);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(states + lane), newState);
+  }
+}
+
+template <size_t nLanes_V>
+__attribute__((target("avx2"))) void decodeLanes(uint64_t* __restrict__ states, const uint64_t* __restrict__ frequency, const uint64_t* __restrict__ cumulative, size_t precision)
+{
+  static_assert(nLanes_V % 4 == 0);
+  const __m256i mask = _mm256_set1_epi64x((1ull << precision) - 1);
+  const __m128i shift = _mm_cvtsi64_si128(precision);
+  for (size_t lane = 0; lane < nLanes_V; lane += 4) {
+    const __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(states + lane));
+    const __m256i product = mul64x32(_mm256_srl_epi64(x, shift), _mm256_load_si256(reinterpret_cast<const __m256i*>(frequency + lane)));
+    const __m256i newState = _mm256_sub_epi64(_mm256_add_epi64(product, _mm256_and_si256(x, mask)), _mm256_load_si256(reinterpret_cast<const __m256i*>(cumulative + lane)));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(states + lane), newState);
+  }
+}
+} // namespace avx2
+#endif /* RANS_HAS_X86_SIMD */
+
+// Dispatch to the requested kernel. Lane arrays have to be aligned to 32 Bytes.
+template <size_t nLanes_V>
+inline void encodeLanes(SIMDLevel level, uint64_t* states, const uint64_t* rcp, const uint64_t* bias, const uint64_t* cmpl, const uint64_t* shift)
+{
+#ifdef RANS_HAS_X86_SIMD
+  if constexpr (nLanes_V % 4 == 0) {
+    if (level == SIMDLevel::AVX2) {
+      return avx2::encodeLanes<nLanes_V>(states, rcp, bias, cmpl, shift);
+    }
+  }
+  if constexpr (nLanes_V % 2 == 0) {
+    if (level >= SIMDLevel::SSE41) {
+      return sse41::encodeLanes<nLanes_V>(states, rcp, bias, cmpl, shift);
+    }
+  }
+#endif
+  scalar::encodeLanes<nLanes_V>(states, rcp, bias, cmpl, shift);
+}
+
+template <size_t nLanes_V>
+inline void decodeLanes(SIMDLevel level, uint64_t* states, const uint64_t* frequency, const uint64_t* cumulative, size_t precision)
+{
+#ifdef RANS_HAS_X86_SIMD
+  if constexpr (nLanes_V % 4 == 0) {
+    if (level == SIMDLevel::AVX2) {
+      return avx2::decodeLanes<nLanes_V>(states, frequency, cumulative, precision);
+    }
+  }
+  if constexpr (nLanes_V % 2 == 0) {
+    if (level >= SIMDLevel::SSE41) {
+      return sse41::decodeLanes<nLanes_V>(states, frequency, cumulative, precision);
+    }
+  }
+#endif
+  scalar::decodeLanes<nLanes_V>(states, frequency, cumulative, precision);
+}
+
+} // namespace simd
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_SIMDKERNEL_H */
@@ -0,0 +1,148 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   test_ransInterleavedCoder.cxx
+/// @since  2021-11-02
+/// @brief  Test N-way interleaved rANS coders and their SIMD kernels
+
+#define BOOST_TEST_MODULE Utility test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <vector>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include "rANS/rans.h"
+
+namespace
+{
+constexpr size_t SymbolTablePrecision = 16;
+constexpr size_t NStreams[] = {2, 4, 8, 16, 32};
+
+template <typename source_T>
+std::vector<source_T> makeMessage(size_t size)
+{
+  std::mt19937 mt(0);
+  std::binomial_distribution<int64_t> dist(std::numeric_limits<source_T>::max() >> (sizeof(source_T) > 1 ? 4 : 1), 0.5);
+  std::vector<source_T> message(size);
+  for (auto& s : message) {
+    s = static_cast<source_T>(dist(mt));
+  }
+  return message;
+}
+
+// dictionary from a different sample, such that some symbols of the message become literals
+template <typename source_T>
+o2::rans::RenormedFrequencyTable makeDictionary(const std::vector<source_T>& message)
+{
+  const size_t nSamples = message.size() / 3;
+  return o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(message.begin(), message.begin() + nSamples), SymbolTablePrecision);
+}
+} // namespace
+
+using source_t = boost::mpl::vector<uint8_t, uint16_t, uint32_t>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_interleavedEncodeDecode, source_T, source_t)
+{
+  // odd sizes to exercise the incomplete last group of lanes
+  for (size_t messageSize : {1ul, 31ul, 1000ul, 100003ul}) {
+    const auto message = makeMessage<source_T>(messageSize);
+    const auto dictionary = makeDictionary(message);
+    o2::rans::LiteralEncoder64<source_T> encoder{dictionary};
+    o2::rans::LiteralDecoder64<source_T> decoder{dictionary};
+
+    for (auto nStreams : NStreams) {
+      encoder.setNStreams(nStreams);
+      BOOST_CHECK_EQUAL(encoder.getNStreams(), nStreams);
+
+      std::vector<uint32_t> encodeBuffer(messageSize + 2 * nStreams + 2, 0);
+      std::vector<source_T> literals;
+      const auto encodedEnd = encoder.process(message.begin(), message.end(), encodeBuffer.data(), literals);
+      BOOST_CHECK(encodedEnd <= encodeBuffer.data() + encodeBuffer.size());
+
+      std::vector<source_T> decodeBuffer(messageSize);
+      decoder.process(encodedEnd, decodeBuffer.begin(), messageSize, literals, nStreams);
+      BOOST_CHECK(literals.empty());
+      BOOST_CHECK_EQUAL_COLLECTIONS(message.begin(), message.end(), decodeBuffer.begin(), decodeBuffer.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_legacyLayout)
+{
+  // two interleaved streams must reproduce the classic coder bit by bit
+  const auto message = makeMessage<uint16_t>(10001);
+  const auto dictionary = makeDictionary(message);
+  const o2::rans::internal::SymbolTable<o2::rans::internal::EncoderSymbol<uint64_t>> symbolTable{dictionary};
+  o2::rans::LiteralEncoder64<uint16_t> encoder{dictionary};
+
+  std::vector<uint32_t> legacy, interleaved;
+  std::vector<uint16_t> legacyLiterals, interleavedLiterals;
+  encoder.process(message.begin(), message.end(), std::back_inserter(legacy), legacyLiterals);
+  o2::rans::internal::encodeInterleaved(2, symbolTable, message.begin(), message.end(), std::back_inserter(interleaved), interleavedLiterals);
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(legacy.begin(), legacy.end(), interleaved.begin(), interleaved.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(legacyLiterals.begin(), legacyLiterals.end(), interleavedLiterals.begin(), interleavedLiterals.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_simdBitExact)
+{
+  using namespace o2::rans::internal;
+
+  const auto message = makeMessage<uint32_t>(50021);
+  const auto dictionary = makeDictionary(message);
+  const SymbolTable<EncoderSymbol<uint64_t>> encoderTable{dictionary};
+  const SymbolTable<DecoderSymbol> decoderTable{dictionary};
+  const ReverseSymbolLookupTable reverseLUT{dictionary};
+
+  std::vector<simd::SIMDLevel> levels{simd::SIMDLevel::Scalar};
+  if (simd::getSIMDLevel() >= simd::SIMDLevel::SSE41) {
+    levels.push_back(simd::SIMDLevel::SSE41);
+  }
+  if (simd::getSIMDLevel() >= simd::SIMDLevel::AVX2) {
+    levels.push_back(simd::SIMDLevel::AVX2);
+  }
+
+  for (auto nStreams : NStreams) {
+    std::vector<uint32_t> reference;
+    std::vector<uint32_t> referenceLiterals;
+    encodeInterleaved(nStreams, encoderTable, message.begin(), message.end(), std::back_inserter(reference), referenceLiterals, simd::SIMDLevel::Scalar);
+
+    for (auto level : levels) {
+      BOOST_TEST_CONTEXT("nStreams " << nStreams << ", SIMD " << simd::getName(level))
+      {
+        std::vector<uint32_t> encoded;
+        std::vector<uint32_t> literals;
+        encodeInterleaved(nStreams, encoderTable, message.begin(), message.end(), std::back_inserter(encoded), literals, level);
+        BOOST_CHECK_EQUAL_COLLECTIONS(reference.begin(), reference.end(), encoded.begin(), encoded.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(referenceLiterals.begin(), referenceLiterals.end(), literals.begin(), literals.end());
+
+        std::vector<uint32_t> decoded;
+        decodeInterleaved(nStreams, decoderTable, reverseLUT, encoded.end(), std::back_inserter(decoded), message.size(), literals, level);
+        BOOST_CHECK(literals.empty());
+        BOOST_CHECK_EQUAL_COLLECTIONS(message.begin(), message.end(), decoded.begin(), decoded.end());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_invalidNStreams)
+{
+  o2::rans::LiteralEncoder64<uint8_t> encoder64{};
+  BOOST_CHECK_THROW(encoder64.setNStreams(3), std::runtime_error);
+  BOOST_CHECK_THROW(encoder64.setNStreams(64), std::runtime_error);
+  o2::rans::LiteralEncoder32<uint8_t> encoder32{};
+  BOOST_CHECK_NO_THROW(encoder32.setNStreams(2));
+  BOOST_CHECK_THROW(encoder32.setNStreams(8), std::runtime_error);
+}
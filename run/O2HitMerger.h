@@ -64,6 +64,7 @@
 #include <list>
 #include <csignal>
 #include <mutex>
+#include <condition_variable>
 #include <filesystem>
 #include <functional>
 
@@ -76,6 +77,7 @@
 #endif
 
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/task_group.h>
 
 namespace o2
 {
@@ -113,6 +115,10 @@ class O2HitMerger : public FairMQDevice
   /// Default destructor
   ~O2HitMerger() override
   {
+    notifyMerger(true);
+    if (mMergerIOThread.joinable()) {
+      mMergerIOThread.join();
+    }
     FairSystemInfo sysinfo;
     LOG(info) << "TIME-STAMP " << mTimer.RealTime() << "\t";
     mTimer.Continue();
@@ -148,6 +154,7 @@ class O2HitMerger : public FairMQDevice
       o2::utils::ShmManager::Instance().attachToGlobalSegment();
       initHitFiles(o2::conf::SimConfig::Instance().getOutPrefix());
     }
+    startMergerThread();
 
     // init pipe
     auto pipeenv = getenv("ALICE_O2SIMMERGERTODRIVER_PIPE");
@@ -232,6 +239,7 @@ class O2HitMerger : public FairMQDevice
     mSubEventInfoBuffer.clear();
     mFlushableEvents.clear();
 
+    startMergerThread();
     return true;
   }
 
@@ -369,17 +377,9 @@ class O2HitMerger : public FairMQDevice
       LOG(info) << "Event " << info.eventID << " complete. Marking as flushable";
       mFlushableEvents[info.eventID] = true;
 
-      // check if previous flush finished
-      // start merging only when no merging currently happening
-      // Like this we don't have to join/wait on the thread here and do not block the outer ConditionalRun handling
-      // TODO: Let this run fully asynchronously (not even triggered by ConditionalRun)
-      if (!mergingInProgress) {
-        if (mMergerIOThread.joinable()) {
-          mMergerIOThread.join();
-        }
-        // start hit merging and flushing in a separate thread in order not to block
-        mMergerIOThread = std::thread([info, this]() { mergingInProgress = true; mergeAndFlushData(); mergingInProgress = false; });
-      }
+      // wake up the merger thread, which merges and flushes the complete events while the collection of the
+      // data of the next ones continues here
+      notifyMerger(false);
 
       mEventChecksum += info.eventID;
       // we also need to check if we have all events
@@ -387,10 +387,7 @@ class O2HitMerger : public FairMQDevice
         LOG(info) << "ALL EVENTS HERE; CHECKSUM " << mEventChecksum;
 
         // flush remaining data and close file
-        if (mMergerIOThread.joinable()) {
-          mMergerIOThread.join();
-        }
-        mMergerIOThread = std::thread([info, this]() { mergingInProgress = true; mergeAndFlushData(); mergingInProgress = false; });
+        notifyMerger(true);
         if (mMergerIOThread.joinable()) {
           mMergerIOThread.join();
         }
@@ -416,6 +413,40 @@ class O2HitMerger : public FairMQDevice
     // cleanup intermediate per-Event buffers
   }
 
+  // the merger thread waits for complete events and merges/flushes them until it is asked to stop
+  void startMergerThread()
+  {
+    if (mMergerIOThread.joinable()) {
+      return;
+    }
+    mMergerWakeUp = false;
+    mMergerStop = false;
+    mMergerIOThread = std::thread([this]() {
+      std::unique_lock<std::mutex> lock(mMergerMutex);
+      while (true) {
+        mMergerCV.wait(lock, [this]() { return mMergerWakeUp || mMergerStop; });
+        bool stop = mMergerStop;
+        mMergerWakeUp = false;
+        lock.unlock();
+        mergeAndFlushData();
+        lock.lock();
+        if (stop) {
+          break;
+        }
+      }
+    });
+  }
+
+  void notifyMerger(bool stop)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMergerMutex);
+      mMergerWakeUp = true;
+      mMergerStop = mMergerStop || stop;
+    }
+    mMergerCV.notify_one();
+  }
+
   template <typename T>
   void backInsert(T const& from, T& to)
   {
@@ -587,95 +618,70 @@ class O2HitMerger : public FairMQDevice
     mDetectorToTTreeMap[detID]->SetDirectory(mDetectorOutFiles[detID]);
   }
 
-  // This method goes over the buffers containing data for a given event; potentially merges
-  // them and flushes into the actual output file.
-  // The method can be called asynchronously to data collection
-  bool mergeAndFlushData()
-  {
-    auto checkIfNextFlushable = [this]() -> bool {
-      mNextFlushID++;
-      return mFlushableEvents.find(mNextFlushID) != mFlushableEvents.end() && mFlushableEvents[mNextFlushID] == true;
-    };
+  // the sub-event layout of an event ready to be merged
+  struct EventMergeInfo {
+    int eventID = 0;
+    std::vector<int> trackoffsets;                         // trackoffsets (per data arrival id) to be used for global track-ID correction pass
+    std::vector<int> nprimaries;                           // primary particles in each subevent (data arrival id)
+    std::vector<int> subevOrdered;                         // mapping of the sub-event id (or part) to the data arrival id
+    o2::dataformats::MCEventHeader* eventheader = nullptr; // The event header
+  };
 
-    LOG(info) << "Launching merge kernel ";
-    bool canflush = mFlushableEvents.find(mNextFlushID) != mFlushableEvents.end() && mFlushableEvents[mNextFlushID] == true;
-    if (!canflush) {
+  // collect the sub-event layout of the event, returns false if it should not be flushed
+  bool prepareEventMerge(int flusheventID, EventMergeInfo& evinfo)
+  {
+    auto iter = mSubEventInfoBuffer.find(flusheventID);
+    if (iter == mSubEventInfoBuffer.end()) {
+      LOG(error) << "No info/data found for event " << flusheventID;
       return false;
     }
-    while (canflush == true) {
-      auto flusheventID = mNextFlushID;
-      LOG(info) << "Merge and flush event " << flusheventID;
-      auto iter = mSubEventInfoBuffer.find(flusheventID);
-      if (iter == mSubEventInfoBuffer.end()) {
-        LOG(error) << "No info/data found for event " << flusheventID;
-        if (!checkIfNextFlushable()) {
-          return false;
-        }
-      }
-
-      auto& subEventInfoList = (*iter).second;
-      if (subEventInfoList.size() == 0 || mNExpectedEvents == 0) {
-        LOG(error) << "No data entries found for event " << flusheventID;
-        if (!checkIfNextFlushable()) {
-          return false;
-        }
+    auto& subEventInfoList = (*iter).second;
+    if (subEventInfoList.size() == 0 || mNExpectedEvents == 0) {
+      LOG(error) << "No data entries found for event " << flusheventID;
+      return false;
+    }
+    evinfo.eventID = flusheventID;
+    // mapping of id to actual sub-event id (or part)
+    std::vector<int> nsubevents;
+    for (auto info : subEventInfoList) {
+      assert(info->npersistenttracks >= 0);
+      evinfo.trackoffsets.emplace_back(info->npersistenttracks);
+      evinfo.nprimaries.emplace_back(info->nprimarytracks);
+      nsubevents.emplace_back(info->part);
+      if (evinfo.eventheader == nullptr) {
+        evinfo.eventheader = &info->mMCEventHeader;
+      } else {
+        evinfo.eventheader->getMCEventStats().add(info->mMCEventHeader.getMCEventStats());
       }
+    }
 
-      TStopwatch timer;
-      timer.Start();
-
-      // calculate trackoffsets
-      auto& confref = o2::conf::SimConfig::Instance();
-
-      // collecting trackoffsets (per data arrival id) to be used for global track-ID correction pass
-      std::vector<int> trackoffsets;
-      // collecting primary particles in each subevent (data arrival id)
-      std::vector<int> nprimaries;
-      // mapping of id to actual sub-event id (or part)
-      std::vector<int> nsubevents;
-
-      o2::dataformats::MCEventHeader* eventheader = nullptr; // The event header
-
-      // the MC labels (trackID) for hits
-      for (auto info : subEventInfoList) {
-        assert(info->npersistenttracks >= 0);
-        trackoffsets.emplace_back(info->npersistenttracks);
-        nprimaries.emplace_back(info->nprimarytracks);
-        nsubevents.emplace_back(info->part);
-        if (eventheader == nullptr) {
-          eventheader = &info->mMCEventHeader;
-        } else {
-          eventheader->getMCEventStats().add(info->mMCEventHeader.getMCEventStats());
-        }
+    // now see which events can be discarded in any case due to no hits
+    if (o2::conf::SimConfig::Instance().isFilterOutNoHitEvents()) {
+      if (evinfo.eventheader && evinfo.eventheader->getMCEventStats().getNHits() == 0) {
+        LOG(info) << " Taking out event " << flusheventID << " due to no hits ";
+        return false;
       }
+    }
 
-      // now see which events can be discarded in any case due to no hits
-      if (confref.isFilterOutNoHitEvents()) {
-        if (eventheader && eventheader->getMCEventStats().getNHits() == 0) {
-          LOG(info) << " Taking out event " << flusheventID << " due to no hits ";
-          cleanEvent(flusheventID);
-          if (!checkIfNextFlushable()) {
-            return true;
-          }
-        }
-      }
+    // attention: We need to make sure that we write everything in the same event order
+    // but iteration over keys of a standard map in C++ is ordered
+    const auto entries = subEventInfoList.size();
+    evinfo.subevOrdered.resize(nsubevents.size());
+    for (int entry = entries - 1; entry >= 0; --entry) {
+      evinfo.subevOrdered[nsubevents[entry] - 1] = entry;
+      printf("HitMerger entry: %d nprimry: %5d trackoffset: %5d \n", entry, evinfo.nprimaries[entry], evinfo.trackoffsets[entry]);
+    }
+    return true;
+  }
 
+  // merge and write the kinematics, track references and headers of the events
+  void mergeAndFlushKinematics(std::vector<EventMergeInfo> const& events)
+  {
+    for (auto& evinfo : events) {
+      auto eventheader = evinfo.eventheader;
       // put the event headers into the new TTree
       auto headerbr = o2::base::getOrMakeBranch(*mOutTree, "MCEventHeader.", &eventheader);
 
-      // attention: We need to make sure that we write everything in the same event order
-      // but iteration over keys of a standard map in C++ is ordered
-
-      // b) merge the general data
-      //
-      // for MCTrack remap the motherIds and merge at the same go
-      const auto entries = subEventInfoList.size();
-      std::vector<int> subevOrdered((int)(nsubevents.size()));
-      for (int entry = entries - 1; entry >= 0; --entry) {
-        subevOrdered[nsubevents[entry] - 1] = entry;
-        printf("HitMerger entry: %d nprimry: %5d trackoffset: %5d \n", entry, nprimaries[entry], trackoffsets[entry]);
-      }
-
       // This is a hook that collects some useful statistics/properties on the event
       // for use by other components;
       // Properties are attached making use of the extensible "Info" feature which is already
@@ -727,47 +733,79 @@ class O2HitMerger : public FairMQDevice
         eventheader->putInfo("prims_total", prims);
       };
 
-      reorderAndMergeMCTracks(flusheventID, *mOutTree, nprimaries, subevOrdered, mcheaderhook);
-      remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
+      // for MCTrack remap the motherIds and merge at the same go
+      reorderAndMergeMCTracks(evinfo.eventID, *mOutTree, evinfo.nprimaries, evinfo.subevOrdered, mcheaderhook);
+      remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", evinfo.eventID, *mOutTree, evinfo.trackoffsets, evinfo.nprimaries, evinfo.subevOrdered, mTrackRefBuffer);
 
       // header can be written
       headerbr->SetAddress(&eventheader);
       headerbr->Fill();
       headerbr->ResetAddress();
 
-      // c) do the merge procedure for all hits ... delegate this to detector specific functions
-      // since they know about types; number of branches; etc.
-      // this will also fix the trackIDs inside the hits
-      for (int id = 0; id < mDetectorInstances.size(); ++id) {
-        auto& det = mDetectorInstances[id];
-        if (det) {
-          auto hittree = mDetectorToTTreeMap[id];
-          // det->mergeHitEntries(*tree, *hittree, trackoffsets, nprimaries, subevOrdered);
-          det->mergeHitEntriesAndFlush(flusheventID, *hittree, trackoffsets, nprimaries, subevOrdered);
-          hittree->SetEntries(hittree->GetEntries() + 1);
-          LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
-        }
-      }
-
       // increase the entry count in the tree
       mOutTree->SetEntries(mOutTree->GetEntries() + 1);
-      LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
+    }
+    LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
+    mOutFile->Write("", TObject::kOverwrite);
+  }
+
+  // merge the hits of the events for one detector ... delegate this to detector specific functions
+  // since they know about types; number of branches; etc.
+  // this will also fix the trackIDs inside the hits
+  void mergeAndFlushHits(int id, std::vector<EventMergeInfo> const& events)
+  {
+    auto& det = mDetectorInstances[id];
+    auto hittree = mDetectorToTTreeMap[id];
+    for (auto& evinfo : events) {
+      det->mergeHitEntriesAndFlush(evinfo.eventID, *hittree, evinfo.trackoffsets, evinfo.nprimaries, evinfo.subevOrdered);
+      hittree->SetEntries(hittree->GetEntries() + 1);
+    }
+    LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
+    mDetectorOutFiles[id]->Write("", TObject::kOverwrite);
+  }
 
-      cleanEvent(flusheventID);
-      LOG(info) << "Merge/flush for event " << flusheventID << " took " << timer.RealTime();
-      if (!checkIfNextFlushable()) {
-        break;
+  // This method goes over the buffers containing data for the events which can be flushed; merges
+  // them and flushes into the actual output files.
+  // The method is called asynchronously to data collection. The kinematics and the hits of every
+  // detector go to different files, hence they are merged and written concurrently, as tasks of the
+  // TBB worker pool rather than by threads created at every flush.
+  bool mergeAndFlushData()
+  {
+    auto isFlushable = [this](int eventID) -> bool {
+      auto iter = mFlushableEvents.find(eventID);
+      return iter != mFlushableEvents.end() && iter->second == true;
+    };
+
+    LOG(info) << "Launching merge kernel ";
+    std::vector<EventMergeInfo> events;
+    while (isFlushable(mNextFlushID)) {
+      auto flusheventID = mNextFlushID++;
+      LOG(info) << "Merge and flush event " << flusheventID;
+      EventMergeInfo evinfo;
+      if (prepareEventMerge(flusheventID, evinfo)) {
+        events.emplace_back(std::move(evinfo));
+      } else {
+        cleanEvent(flusheventID);
       }
-    } // end while
-    LOG(info) << "Writing TTrees";
-    mOutFile->Write("", TObject::kOverwrite);
+    }
+    if (events.empty()) {
+      return false;
+    }
+
+    TStopwatch timer;
+    timer.Start();
+    tbb::task_group tasks;
+    tasks.run([this, &events]() { mergeAndFlushKinematics(events); });
     for (int id = 0; id < mDetectorInstances.size(); ++id) {
-      auto& det = mDetectorInstances[id];
-      if (det) {
-        mDetectorOutFiles[id]->Write("", TObject::kOverwrite);
+      if (mDetectorInstances[id]) {
+        tasks.run([this, &events, id]() { mergeAndFlushHits(id, events); });
       }
     }
-
+    tasks.wait();
+    for (auto& evinfo : events) {
+      cleanEvent(evinfo.eventID);
+    }
+    LOG(info) << "Merge/flush for events " << events.front().eventID << " : " << events.back().eventID << " took " << timer.RealTime();
     return true;
   }
 
@@ -784,8 +822,11 @@ class O2HitMerger : public FairMQDevice
   Hashtable<int, TTree*> mDetectorToTTreeMap; //! the trees
 
   // intermediate structures to collect data per event
-  std::thread mMergerIOThread; //! a thread used to do hit merging and IO flushing asynchronously
-  bool mergingInProgress = false;
+  std::thread mMergerIOThread;       //! a thread used to do hit merging and IO flushing asynchronously
+  std::mutex mMergerMutex;           //! protects the wake-up flags of the merger thread
+  std::condition_variable mMergerCV; //! to wake up the merger thread
+  bool mMergerWakeUp = false;        //! there are new complete events
+  bool mMergerStop = false;          //! all events are complete, stop after flushing them
 
   Hashtable<int, std::vector<std::vector<o2::MCTrack>*>> mMCTrackBuffer;         //! vector of sub-event track vectors; one per event
   Hashtable<int, std::vector<std::vector<o2::TrackReference>*>> mTrackRefBuffer; //!
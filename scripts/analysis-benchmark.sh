@@ -47,3 +47,22 @@ for x in $HISTO_ATTEMPTS ; do
   echo "o2-analysis-vertexing-hf with 2 jobs (readers),$x,$T,$FILES_SIZE,$FILES,$TP,$TPP,$DATE,$HOST"
   echo "o2-analysis-vertexing-hf (total),$(($x + 6)),$T,$FILES_SIZE,$FILES,$TP,$TPP,$DATE,$HOST"
 done
+
+BENCHMARK=`which o2-analysistutorial-filters`
+[ "X$BENCHMARK" = X ] && { echo "Unable to find o2-analysistutorial-filters"; exit 1; }
+for x in $HISTO_ATTEMPTS ; do
+  for FILTERS in kernels gandiva ; do
+    [ $FILTERS = gandiva ] && export O2_DPL_GANDIVA_FILTERS=1 || unset O2_DPL_GANDIVA_FILTERS
+    T=`(time -p $BENCHMARK -b --aod-file @$FILELIST --readers $x > log$x.txt) 2>&1 | grep real | sed -e 's/real //'`
+    TP=$(bc -l <<< "scale=2; $FILES_SIZE/$T")
+    TPP=$(bc -l <<< "scale=2; $FILES_SIZE/$T/$x")
+    echo "filters with $FILTERS (readers),$x,$T,$FILES_SIZE,$FILES,$TP,$TPP,$DATE,$HOST"
+  done
+  unset O2_DPL_GANDIVA_FILTERS
+done
+
+# per row throughput and start-up time (JIT compilation for gandiva) of the filters
+BENCHMARK=`which o2-bench-framework-benchmark-GandivaExpressions`
+[ "X$BENCHMARK" = X ] && { echo "Unable to find o2-bench-framework-benchmark-GandivaExpressions"; exit 1; }
+echo "benchmark,time,time unit,rows per second,date,host"
+$BENCHMARK --benchmark_format=csv 2> /dev/null | grep '^"BM_' | awk -F, -v date=$DATE -v host=$HOST '{print $1","$3","$5","$7","date","host}'